@@ -0,0 +1,271 @@
+import json
+import os
+import re
+import numpy as np
+import pandas as pd
+from concurrent.futures import ProcessPoolExecutor
+from pathlib import Path
+from typing import Dict, Iterator, List, Optional, Tuple
+
+from feature_extraction import DEVICE_FEATURE_NAMES, extract_device_features
+
+
+ARCHIVE_FORMAT = 'eqarchive'
+ARCHIVE_FORMAT_VERSION = 1
+META_FILE = 'chunk.json'
+TIMESTAMP_COLUMN = 'timestamp_us.i64'
+AXIS_COLUMNS = ('x.i16', 'y.i16', 'z.i16')
+TIMESTAMP_DTYPE = np.dtype('<i8')
+COUNT_DTYPE = np.dtype('<i2')
+CHUNK_KINDS = ('stream', 'capture')
+TIMESTAMP_DIGITS = 17
+
+
+def device_directory(device_id: str) -> str:
+    safe = re.sub(r'[^A-Za-z0-9_-]', '_', device_id)
+    return safe if safe else '_'
+
+
+def chunk_name(timestamp_us: int, suffix: Optional[int] = None) -> str:
+    name = str(max(0, int(timestamp_us))).zfill(TIMESTAMP_DIGITS)
+    return name if suffix is None else f"{name}-{suffix}"
+
+
+def _map_column(path: Path, dtype: np.dtype, length: int) -> np.ndarray:
+    if length == 0:
+        return np.zeros(0, dtype=dtype)
+    return np.memmap(path, dtype=dtype, mode='r', shape=(length,))
+
+
+class ArchiveChunk:
+
+    def __init__(self, path: Path):
+        self.path = Path(path)
+        with open(self.path / META_FILE) as f:
+            self.meta = json.load(f)
+
+        if self.meta.get('format') != ARCHIVE_FORMAT or self.meta.get('version') != ARCHIVE_FORMAT_VERSION:
+            raise ValueError(f"Unsupported archive chunk: {self.path}")
+
+        self.device_id: str = self.meta['device_id']
+        self.kind: str = self.meta['kind']
+        self.sample_rate: float = float(self.meta['sample_rate'])
+        self.scale: float = float(self.meta['scale'])
+        self.clock_synced: bool = bool(self.meta['clock_synced'])
+        self.first_timestamp_us: int = int(self.meta['first_timestamp_us'])
+        self._columns: Dict[str, np.ndarray] = {}
+
+    @property
+    def sample_count(self) -> int:
+        lengths = [os.path.getsize(self.path / TIMESTAMP_COLUMN) // TIMESTAMP_DTYPE.itemsize]
+        lengths += [os.path.getsize(self.path / column) // COUNT_DTYPE.itemsize for column in AXIS_COLUMNS]
+        return min(lengths)
+
+    def _column(self, name: str, dtype: np.dtype) -> np.ndarray:
+        if name not in self._columns:
+            self._columns[name] = _map_column(self.path / name, dtype, self.sample_count)
+        return self._columns[name]
+
+    @property
+    def timestamps_us(self) -> np.ndarray:
+        return self._column(TIMESTAMP_COLUMN, TIMESTAMP_DTYPE)
+
+    def counts(self, axis: int) -> np.ndarray:
+        return self._column(AXIS_COLUMNS[axis], COUNT_DTYPE)
+
+    def time_range(self) -> Tuple[int, int]:
+        timestamps = self.timestamps_us
+        if len(timestamps) == 0:
+            return self.first_timestamp_us, self.first_timestamp_us
+        return int(timestamps[0]), int(timestamps[-1])
+
+    def index_range(self, start_us: Optional[int] = None, end_us: Optional[int] = None) -> Tuple[int, int]:
+        timestamps = self.timestamps_us
+        start = 0 if start_us is None else int(np.searchsorted(timestamps, start_us, side='left'))
+        end = len(timestamps) if end_us is None else int(np.searchsorted(timestamps, end_us, side='left'))
+        return start, max(start, end)
+
+    def acceleration(
+        self,
+        start: int = 0,
+        end: Optional[int] = None
+    ) -> Tuple[np.ndarray, np.ndarray, np.ndarray]:
+        end = self.sample_count if end is None else end
+        return tuple(np.asarray(self.counts(axis)[start:end], dtype=np.float64) * self.scale for axis in range(3))
+
+    def close(self) -> None:
+        self._columns.clear()
+
+
+class EventArchive:
+
+    def __init__(self, root: str):
+        self.root = Path(root)
+
+    def devices(self) -> List[str]:
+        if not self.root.exists():
+            return []
+        return sorted(entry.name for entry in self.root.iterdir() if entry.is_dir())
+
+    def chunk_paths(self, device: Optional[str] = None, kind: Optional[str] = None) -> List[Path]:
+        devices = [device_directory(device)] if device is not None else self.devices()
+        kinds = [kind] if kind is not None else list(CHUNK_KINDS)
+
+        paths = []
+        for name in devices:
+            for chunk_kind in kinds:
+                directory = self.root / name / chunk_kind
+                if directory.exists():
+                    paths.extend(sorted(p for p in directory.iterdir() if (p / META_FILE).exists()))
+        return paths
+
+    def chunks(
+        self,
+        device: Optional[str] = None,
+        kind: Optional[str] = None,
+        start_us: Optional[int] = None,
+        end_us: Optional[int] = None
+    ) -> Iterator[ArchiveChunk]:
+        for path in self.chunk_paths(device, kind):
+            chunk = ArchiveChunk(path)
+            if start_us is not None or end_us is not None:
+                first, last = chunk.time_range()
+                if (end_us is not None and first >= end_us) or (start_us is not None and last < start_us):
+                    continue
+            yield chunk
+
+
+class ArchiveWriter:
+
+    def __init__(self, root: str):
+        self.root = Path(root)
+
+    def _create(self, directory: Path, meta: Dict) -> Path:
+        directory.mkdir(parents=True, exist_ok=True)
+        for column in (TIMESTAMP_COLUMN,) + AXIS_COLUMNS:
+            (directory / column).write_bytes(b'')
+        with open(directory / META_FILE, 'w') as f:
+            json.dump(meta, f, indent=2)
+        return directory
+
+    def _meta(self, device_id: str, kind: str, sample_rate: float, scale: float,
+              clock_synced: bool, first_timestamp_us: int) -> Dict:
+        return {
+            'format': ARCHIVE_FORMAT,
+            'version': ARCHIVE_FORMAT_VERSION,
+            'device_id': device_id,
+            'kind': kind,
+            'sample_rate': sample_rate,
+            'scale': scale,
+            'clock_synced': clock_synced,
+            'first_timestamp_us': int(first_timestamp_us),
+        }
+
+    def append(self, directory: Path, counts: np.ndarray, first_timestamp_us: int, sample_rate: float) -> None:
+        counts = np.asarray(counts, dtype=COUNT_DTYPE).reshape(-1, 3)
+        timestamps = first_timestamp_us + np.round(np.arange(len(counts)) * 1e6 / sample_rate)
+
+        for axis, column in enumerate(AXIS_COLUMNS):
+            with open(directory / column, 'ab') as f:
+                f.write(np.ascontiguousarray(counts[:, axis]).tobytes())
+        with open(directory / TIMESTAMP_COLUMN, 'ab') as f:
+            f.write(timestamps.astype(TIMESTAMP_DTYPE).tobytes())
+
+    def write_stream(
+        self,
+        device_id: str,
+        counts: np.ndarray,
+        first_timestamp_us: int,
+        sample_rate: float = 100,
+        scale: float = 1.0,
+        clock_synced: bool = True
+    ) -> Path:
+        directory = self.root / device_directory(device_id) / 'stream' / chunk_name(first_timestamp_us)
+        self._create(directory, self._meta(device_id, 'stream', sample_rate, scale,
+                                           clock_synced, first_timestamp_us))
+        self.append(directory, counts, first_timestamp_us, sample_rate)
+        return directory
+
+    def write_capture(
+        self,
+        device_id: str,
+        capture_id: int,
+        counts: np.ndarray,
+        first_timestamp_us: int,
+        trigger_time_us: int,
+        pre_trigger_samples: int,
+        sample_rate: float = 100,
+        scale: float = 1.0,
+        clock_synced: bool = True,
+        manual: bool = False,
+        truncated: bool = False
+    ) -> Path:
+        directory = self.root / device_directory(device_id) / 'capture' / chunk_name(trigger_time_us, capture_id)
+        meta = self._meta(device_id, 'capture', sample_rate, scale, clock_synced, first_timestamp_us)
+        meta.update({
+            'capture_id': capture_id,
+            'trigger_time_us': int(trigger_time_us),
+            'pre_trigger_samples': pre_trigger_samples,
+            'manual': manual,
+            'truncated': truncated,
+        })
+        self._create(directory, meta)
+        self.append(directory, counts, first_timestamp_us, sample_rate)
+        return directory
+
+
+def extract_chunk_features(
+    path: str,
+    window_sec: float = 10.0,
+    step_sec: Optional[float] = None,
+    start_us: Optional[int] = None,
+    end_us: Optional[int] = None
+) -> List[Dict]:
+    chunk = ArchiveChunk(Path(path))
+    window = max(1, int(round(window_sec * chunk.sample_rate)))
+    step = window if step_sec is None else max(1, int(round(step_sec * chunk.sample_rate)))
+    first, last = chunk.index_range(start_us, end_us)
+    timestamps = chunk.timestamps_us
+
+    rows = []
+    for start in range(first, last - window + 1, step):
+        ax, ay, az = chunk.acceleration(start, start + window)
+        features = extract_device_features(az, chunk.sample_rate, ax, ay)
+        row = {
+            'device_id': chunk.device_id,
+            'kind': chunk.kind,
+            'chunk': chunk.path.name,
+            'clock_synced': chunk.clock_synced,
+            'start_us': int(timestamps[start]),
+            'end_us': int(timestamps[start + window - 1]),
+        }
+        row.update(zip(DEVICE_FEATURE_NAMES, features))
+        rows.append(row)
+
+    chunk.close()
+    return rows
+
+
+def extract_archive_features(
+    root: str,
+    window_sec: float = 10.0,
+    step_sec: Optional[float] = None,
+    device: Optional[str] = None,
+    kind: Optional[str] = None,
+    start_us: Optional[int] = None,
+    end_us: Optional[int] = None,
+    workers: Optional[int] = None
+) -> pd.DataFrame:
+    archive = EventArchive(root)
+    paths = [str(chunk.path) for chunk in archive.chunks(device, kind, start_us, end_us)]
+    args = [(path, window_sec, step_sec, start_us, end_us) for path in paths]
+
+    if workers == 1 or len(paths) <= 1:
+        results = [extract_chunk_features(*arg) for arg in args]
+    else:
+        with ProcessPoolExecutor(max_workers=workers) as executor:
+            results = list(executor.map(extract_chunk_features, *zip(*args)))
+
+    columns = ['device_id', 'kind', 'chunk', 'clock_synced', 'start_us', 'end_us'] + DEVICE_FEATURE_NAMES
+    rows = [row for result in results for row in result]
+    return pd.DataFrame(rows, columns=columns)
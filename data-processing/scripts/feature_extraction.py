@@ -231,6 +231,60 @@ def process_multiaxis_data(
     return features
 
 
+DEVICE_FEATURE_NAMES = [
+    'duration',
+    'pga',
+    'cav',
+    'rms',
+    'crest_factor',
+    'log_energy',
+    'zero_crossing_rate',
+    'dominant_frequency',
+    'kurtosis',
+]
+
+
+def extract_device_features(
+    az: np.ndarray,
+    sampling_rate: int = 100,
+    ax: Optional[np.ndarray] = None,
+    ay: Optional[np.ndarray] = None
+) -> np.ndarray:
+    az = np.asarray(az, dtype=np.float64)
+    if ax is None or ay is None:
+        magnitude = np.abs(az)
+    else:
+        magnitude = np.sqrt(np.asarray(ax, dtype=np.float64)**2 +
+                            np.asarray(ay, dtype=np.float64)**2 + az**2)
+
+    features = np.zeros(len(DEVICE_FEATURE_NAMES))
+    n = len(az)
+    if n == 0:
+        return features
+
+    peak = np.max(magnitude)
+    energy = np.sum(magnitude**2)
+    rms = np.sqrt(energy / n)
+
+    features[0] = n / sampling_rate
+    features[1] = peak / 9.81
+    features[2] = np.sum(magnitude) / sampling_rate / 9.81
+    features[3] = rms / 9.81
+    features[4] = peak / rms if rms > 0 else 0.0
+    features[5] = np.log(energy / sampling_rate + 1e-10)
+    features[6] = np.sum(az[:-1] * az[1:] < 0) / n
+
+    z_energy = np.sum(az**2)
+    if z_energy > 0:
+        features[7] = np.sqrt(np.sum(np.diff(az)**2) / z_energy) * sampling_rate / (2 * np.pi)
+
+    m2 = np.mean((az - np.mean(az))**2)
+    if m2 > 0:
+        features[8] = np.mean((az - np.mean(az))**4) / m2**2 - 3.0
+
+    return features
+
+
 class FeatureExtractor:
     def __init__(self, sampling_rate: int = 100):
         self.sampling_rate = sampling_rate
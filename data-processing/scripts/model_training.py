@@ -4,6 +4,7 @@ from typing import Dict, List, Tuple, Optional
 from sklearn.model_selection import train_test_split, cross_val_score, GridSearchCV
 from sklearn.preprocessing import StandardScaler
 from sklearn.ensemble import RandomForestClassifier, GradientBoostingClassifier
+from sklearn.neural_network import MLPClassifier
 from sklearn.metrics import (
     classification_report, confusion_matrix, roc_auc_score,
     precision_recall_curve, average_precision_score
@@ -11,7 +12,9 @@ from sklearn.metrics import (
 import joblib
 from pathlib import Path
 
-from feature_extraction import FeatureExtractor, extract_all_features
+from feature_extraction import (
+    FeatureExtractor, extract_all_features, extract_device_features, DEVICE_FEATURE_NAMES
+)
 from data_loader import SyntheticDataGenerator
 
 
@@ -292,6 +295,167 @@ def convert_to_tflite(
         print("TensorFlow not available. Skipping TFLite conversion.")
 
 
+DEVICE_INPUT_RANGE = 4.0
+
+
+def extract_device_feature_matrix(X: np.ndarray, sampling_rate: int = 100) -> np.ndarray:
+    if X.ndim == 3:
+        return np.array([
+            extract_device_features(x[:, 2], sampling_rate, x[:, 0], x[:, 1]) for x in X
+        ])
+    return np.array([extract_device_features(x, sampling_rate) for x in X])
+
+
+def train_device_model(
+    X: np.ndarray,
+    y: np.ndarray,
+    sampling_rate: int = 100,
+    hidden_units: int = 16
+) -> Tuple[MLPClassifier, StandardScaler, np.ndarray]:
+    features = extract_device_feature_matrix(X, sampling_rate)
+    scaler = StandardScaler().fit(features)
+    standardized = np.clip(scaler.transform(features), -DEVICE_INPUT_RANGE, DEVICE_INPUT_RANGE)
+
+    model = MLPClassifier(
+        hidden_layer_sizes=(hidden_units,),
+        activation='relu',
+        max_iter=2000,
+        random_state=42
+    )
+    model.fit(standardized, y)
+    return model, scaler, features
+
+
+def _round_half_away(values: np.ndarray) -> np.ndarray:
+    return np.sign(values) * np.floor(np.abs(values) + 0.5)
+
+
+def _quantize_int8(values: np.ndarray, scale: float) -> np.ndarray:
+    return np.clip(_round_half_away(values / scale), -127, 127).astype(np.int8)
+
+
+def quantize_device_model(
+    model: MLPClassifier,
+    scaler: StandardScaler,
+    calibration_features: np.ndarray
+) -> Dict:
+    hidden_weights = model.coefs_[0].T
+    hidden_bias = model.intercepts_[0]
+    output_weights = model.coefs_[1][:, 0]
+    output_bias = model.intercepts_[1][0]
+
+    input_scale = DEVICE_INPUT_RANGE / 127
+    hidden_weight_scale = max(np.max(np.abs(hidden_weights)), 1e-8) / 127
+    output_weight_scale = max(np.max(np.abs(output_weights)), 1e-8) / 127
+
+    standardized = np.clip(scaler.transform(calibration_features),
+                           -DEVICE_INPUT_RANGE, DEVICE_INPUT_RANGE)
+    activations = np.maximum(standardized @ hidden_weights.T + hidden_bias, 0)
+    hidden_scale = max(np.max(activations), 1e-8) / 127
+
+    multiplier = input_scale * hidden_weight_scale / hidden_scale
+    shift = 0
+    while multiplier < 0.5:
+        multiplier *= 2
+        shift += 1
+    while multiplier >= 1.0:
+        multiplier /= 2
+        shift -= 1
+    fixed_multiplier = int(round(multiplier * (1 << 31)))
+    if fixed_multiplier == 1 << 31:
+        fixed_multiplier //= 2
+        shift -= 1
+
+    return {
+        'feature_mean': scaler.mean_.astype(np.float32),
+        'feature_inv_std': (1.0 / scaler.scale_).astype(np.float32),
+        'input_scale': input_scale,
+        'hidden_weights': _quantize_int8(hidden_weights, hidden_weight_scale),
+        'hidden_bias': _round_half_away(
+            hidden_bias / (input_scale * hidden_weight_scale)).astype(np.int32),
+        'hidden_multiplier': fixed_multiplier,
+        'hidden_shift': shift,
+        'output_weights': _quantize_int8(output_weights, output_weight_scale),
+        'output_bias': int(_round_half_away(output_bias / (hidden_scale * output_weight_scale))),
+        'output_scale': hidden_scale * output_weight_scale,
+    }
+
+
+def quantized_predict_proba(params: Dict, features: np.ndarray) -> np.ndarray:
+    features = np.atleast_2d(features)
+    standardized = (features - params['feature_mean']) * params['feature_inv_std']
+    inputs = np.clip(_round_half_away(standardized / params['input_scale']), -127, 127)
+    inputs = inputs.astype(np.int64)
+
+    shift = params['hidden_shift']
+    accumulators = inputs @ params['hidden_weights'].astype(np.int64).T + params['hidden_bias']
+    accumulators = np.maximum(accumulators, 0)
+    hidden = (accumulators * params['hidden_multiplier'] + (1 << (30 + shift))) >> (31 + shift)
+    hidden = np.minimum(hidden, 127)
+
+    output = hidden @ params['output_weights'].astype(np.int64) + params['output_bias']
+    return 1.0 / (1.0 + np.exp(-output * params['output_scale']))
+
+
+def _format_array(values, per_line: int, formatter) -> str:
+    items = [formatter(v) for v in np.ravel(values)]
+    lines = [', '.join(items[i:i + per_line]) for i in range(0, len(items), per_line)]
+    return ',\n    '.join(lines)
+
+
+def export_device_model_header(params: Dict, output_path: str) -> None:
+    feature_count = len(params['feature_mean'])
+    hidden_units = len(params['hidden_bias'])
+    as_float = lambda v: f"{float(v)!r}f"
+    as_int = lambda v: str(int(v))
+
+    header = f"""#ifndef ML_MODEL_DATA_H
+#define ML_MODEL_DATA_H
+
+#include <stdint.h>
+
+#define ML_MODEL_VERSION 1
+#define ML_FEATURE_COUNT {feature_count}
+#define ML_HIDDEN_UNITS {hidden_units}
+
+constexpr float ML_FEATURE_MEAN[ML_FEATURE_COUNT] = {{
+    {_format_array(params['feature_mean'], feature_count, as_float)}
+}};
+
+constexpr float ML_FEATURE_INV_STD[ML_FEATURE_COUNT] = {{
+    {_format_array(params['feature_inv_std'], feature_count, as_float)}
+}};
+
+constexpr float ML_INPUT_SCALE = {as_float(params['input_scale'])};
+
+constexpr int8_t ML_HIDDEN_WEIGHTS[ML_HIDDEN_UNITS * ML_FEATURE_COUNT] = {{
+    {_format_array(params['hidden_weights'], feature_count, as_int)}
+}};
+
+constexpr int32_t ML_HIDDEN_BIAS[ML_HIDDEN_UNITS] = {{
+    {_format_array(params['hidden_bias'], hidden_units, as_int)}
+}};
+
+constexpr int32_t ML_HIDDEN_MULTIPLIER = {params['hidden_multiplier']};
+constexpr int ML_HIDDEN_SHIFT = {params['hidden_shift']};
+
+constexpr int8_t ML_OUTPUT_WEIGHTS[ML_HIDDEN_UNITS] = {{
+    {_format_array(params['output_weights'], hidden_units, as_int)}
+}};
+
+constexpr int32_t ML_OUTPUT_BIAS = {params['output_bias']};
+constexpr float ML_OUTPUT_SCALE = {as_float(params['output_scale'])};
+
+#endif
+"""
+
+    Path(output_path).parent.mkdir(parents=True, exist_ok=True)
+    with open(output_path, 'w') as f:
+        f.write(header)
+
+    print(f"Device model header saved to {output_path}")
+
+
 if __name__ == "__main__":
     print("Generating synthetic training data...")
     generator = SyntheticDataGenerator(sampling_rate=100, duration=60.0)
@@ -333,3 +497,20 @@ if __name__ == "__main__":
             print(f"  {name}: {value:.4f}")
         else:
             print(f"  {name}: {value}")
+
+    print("\n" + "="*60)
+    print("Training On-Device Confirmation Model")
+    print("="*60)
+
+    device_model, device_scaler, device_features = train_device_model(X, y, sampling_rate=100)
+    device_params = quantize_device_model(device_model, device_scaler, device_features)
+
+    float_labels = device_model.predict(
+        np.clip(device_scaler.transform(device_features), -DEVICE_INPUT_RANGE, DEVICE_INPUT_RANGE)
+    )
+    quantized_labels = (quantized_predict_proba(device_params, device_features) >= 0.5).astype(int)
+    print(f"  Quantized agreement: {np.mean(float_labels == quantized_labels):.4f}")
+    print(f"  Quantized accuracy: {np.mean(quantized_labels == y):.4f}")
+
+    header_path = Path(__file__).resolve().parents[2] / 'firmware' / 'include' / 'ml_model_data.h'
+    export_device_model_header(device_params, str(header_path))
@@ -0,0 +1,155 @@
+import json
+import struct
+import pytest
+import numpy as np
+from event_archive import (
+    ArchiveChunk,
+    ArchiveWriter,
+    EventArchive,
+    chunk_name,
+    device_directory,
+    extract_archive_features,
+    extract_chunk_features
+)
+from feature_extraction import DEVICE_FEATURE_NAMES, extract_device_features
+
+
+SYNCED_US = 1700000000000000
+
+
+def random_counts(samples: int, seed: int = 0) -> np.ndarray:
+    rng = np.random.default_rng(seed)
+    return rng.integers(-2000, 2000, size=(samples, 3)).astype(np.int16)
+
+
+class TestArchiveChunk:
+    def test_roundtrip(self, tmp_path):
+        counts = random_counts(500)
+        path = ArchiveWriter(tmp_path).write_stream('ESP32_A', counts, SYNCED_US, sample_rate=100, scale=0.001)
+        chunk = ArchiveChunk(path)
+
+        assert chunk.device_id == 'ESP32_A'
+        assert chunk.kind == 'stream'
+        assert chunk.sample_count == 500
+        assert chunk.time_range() == (SYNCED_US, SYNCED_US + 499 * 10000)
+        np.testing.assert_array_equal(chunk.counts(1), counts[:, 1])
+
+        ax, ay, az = chunk.acceleration()
+        np.testing.assert_allclose(az, counts[:, 2] * 0.001)
+
+    def test_columns_are_memory_mapped(self, tmp_path):
+        path = ArchiveWriter(tmp_path).write_stream('ESP32_A', random_counts(100), SYNCED_US)
+        chunk = ArchiveChunk(path)
+
+        assert isinstance(chunk.counts(0), np.memmap)
+        assert isinstance(chunk.timestamps_us, np.memmap)
+
+    def test_index_range_slices_by_time(self, tmp_path):
+        path = ArchiveWriter(tmp_path).write_stream('ESP32_A', random_counts(100), SYNCED_US, sample_rate=100)
+        chunk = ArchiveChunk(path)
+
+        assert chunk.index_range(SYNCED_US + 100000, SYNCED_US + 200000) == (10, 20)
+        assert chunk.index_range(None, SYNCED_US) == (0, 0)
+        assert chunk.index_range(SYNCED_US + 10**9) == (100, 100)
+
+    def test_torn_append_is_ignored(self, tmp_path):
+        path = ArchiveWriter(tmp_path).write_stream('ESP32_A', random_counts(10), SYNCED_US)
+        with open(path / 'x.i16', 'ab') as f:
+            f.write(struct.pack('<hh', 1, 2))
+
+        assert ArchiveChunk(path).sample_count == 10
+
+    def test_empty_chunk(self, tmp_path):
+        path = ArchiveWriter(tmp_path).write_stream('ESP32_A', np.zeros((0, 3)), SYNCED_US)
+        chunk = ArchiveChunk(path)
+
+        assert chunk.sample_count == 0
+        assert len(chunk.acceleration()[0]) == 0
+
+    def test_rejects_unknown_version(self, tmp_path):
+        path = ArchiveWriter(tmp_path).write_stream('ESP32_A', random_counts(10), SYNCED_US)
+        meta = json.loads((path / 'chunk.json').read_text())
+        meta['version'] = 99
+        (path / 'chunk.json').write_text(json.dumps(meta))
+
+        with pytest.raises(ValueError):
+            ArchiveChunk(path)
+
+    def test_reads_server_layout(self, tmp_path):
+        directory = tmp_path / 'ESP32_B' / 'capture' / f"{SYNCED_US + 10000:017d}-7"
+        directory.mkdir(parents=True)
+        (directory / 'chunk.json').write_text(json.dumps({
+            'format': 'eqarchive', 'version': 1, 'device_id': 'ESP32/B', 'kind': 'capture',
+            'sample_rate': 100, 'scale': 0.001, 'clock_synced': True,
+            'first_timestamp_us': SYNCED_US, 'capture_id': 7, 'trigger_time_us': SYNCED_US + 10000,
+            'pre_trigger_samples': 1, 'manual': True, 'truncated': False
+        }))
+        (directory / 'timestamp_us.i64').write_bytes(struct.pack('<qq', SYNCED_US, SYNCED_US + 10000))
+        (directory / 'x.i16').write_bytes(struct.pack('<hh', 1, 4))
+        (directory / 'y.i16').write_bytes(struct.pack('<hh', 2, 5))
+        (directory / 'z.i16').write_bytes(struct.pack('<hh', 3, 6))
+
+        [chunk] = EventArchive(tmp_path).chunks(device='ESP32/B', kind='capture')
+        assert chunk.meta['capture_id'] == 7
+        np.testing.assert_array_equal(chunk.counts(2), [3, 6])
+
+
+class TestEventArchive:
+    def test_naming(self):
+        assert device_directory('ESP32/B') == 'ESP32_B'
+        assert chunk_name(5000000) == '00000000005000000'
+        assert chunk_name(5000000, 3) == '00000000005000000-3'
+
+    def test_chunks_filter_by_device_kind_and_time(self, tmp_path):
+        writer = ArchiveWriter(tmp_path)
+        writer.write_stream('ESP32_A', random_counts(100), SYNCED_US)
+        writer.write_stream('ESP32_A', random_counts(100), SYNCED_US + 10**7)
+        writer.write_stream('ESP32_B', random_counts(100), SYNCED_US)
+        writer.write_capture('ESP32_A', 1, random_counts(50), SYNCED_US, SYNCED_US + 250000, 25)
+
+        archive = EventArchive(tmp_path)
+        assert archive.devices() == ['ESP32_A', 'ESP32_B']
+        assert len(list(archive.chunks())) == 4
+        assert len(list(archive.chunks(device='ESP32_A', kind='stream'))) == 2
+        assert len(list(archive.chunks(start_us=SYNCED_US + 10**7))) == 1
+
+
+class TestArchiveFeatures:
+    def test_matches_device_features(self, tmp_path):
+        counts = random_counts(2000)
+        path = ArchiveWriter(tmp_path).write_stream('ESP32_A', counts, SYNCED_US, sample_rate=100, scale=0.001)
+
+        rows = extract_chunk_features(str(path), window_sec=10.0)
+        assert len(rows) == 2
+
+        window = counts[1000:2000] * 0.001
+        expected = extract_device_features(window[:, 2], 100, window[:, 0], window[:, 1])
+        np.testing.assert_allclose([rows[1][name] for name in DEVICE_FEATURE_NAMES], expected)
+        assert rows[1]['start_us'] == SYNCED_US + 1000 * 10000
+
+    def test_parallel_matches_serial(self, tmp_path):
+        writer = ArchiveWriter(tmp_path)
+        for device in range(4):
+            writer.write_stream(f'ESP32_{device}', random_counts(3000, seed=device), SYNCED_US, scale=0.001)
+
+        serial = extract_archive_features(str(tmp_path), window_sec=5.0, step_sec=2.5, workers=1)
+        parallel = extract_archive_features(str(tmp_path), window_sec=5.0, step_sec=2.5, workers=2)
+
+        assert len(serial) == 4 * 11
+        assert list(serial.columns[-len(DEVICE_FEATURE_NAMES):]) == DEVICE_FEATURE_NAMES
+        np.testing.assert_allclose(serial[DEVICE_FEATURE_NAMES].values, parallel[DEVICE_FEATURE_NAMES].values)
+
+    def test_time_window(self, tmp_path):
+        ArchiveWriter(tmp_path).write_stream('ESP32_A', random_counts(3000), SYNCED_US)
+
+        features = extract_archive_features(str(tmp_path), window_sec=1.0, workers=1,
+                                            start_us=SYNCED_US + 10**7, end_us=SYNCED_US + 2 * 10**7)
+
+        assert len(features) == 10
+        assert features['start_us'].min() == SYNCED_US + 10**7
+
+    def test_empty_archive(self, tmp_path):
+        features = extract_archive_features(str(tmp_path / 'missing'))
+
+        assert len(features) == 0
+        assert 'pga' in features.columns
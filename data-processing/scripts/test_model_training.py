@@ -0,0 +1,92 @@
+import pytest
+import numpy as np
+from data_loader import SyntheticDataGenerator
+from feature_extraction import extract_device_features, DEVICE_FEATURE_NAMES
+from model_training import (
+    DEVICE_INPUT_RANGE,
+    train_device_model,
+    quantize_device_model,
+    quantized_predict_proba,
+    export_device_model_header
+)
+
+
+@pytest.fixture(scope='module')
+def device_model():
+    np.random.seed(42)
+    generator = SyntheticDataGenerator(sampling_rate=100, duration=20.0)
+    X, y, _ = generator.generate_dataset(num_earthquakes=30, num_non_earthquakes=30)
+    model, scaler, features = train_device_model(X, y, sampling_rate=100)
+    params = quantize_device_model(model, scaler, features)
+    return model, scaler, features, params
+
+
+class TestDeviceFeatures:
+    def test_feature_count(self):
+        features = extract_device_features(np.random.randn(500), sampling_rate=100)
+
+        assert len(features) == len(DEVICE_FEATURE_NAMES)
+        assert np.all(np.isfinite(features))
+
+    def test_dominant_frequency_of_sine(self):
+        t = np.arange(1000) / 100
+        features = extract_device_features(np.sin(2 * np.pi * 3 * t), sampling_rate=100)
+
+        assert features[DEVICE_FEATURE_NAMES.index('dominant_frequency')] == pytest.approx(3.0, abs=0.1)
+        assert features[DEVICE_FEATURE_NAMES.index('kurtosis')] == pytest.approx(-1.5, abs=0.05)
+
+    def test_duration_and_pga(self):
+        segment = np.zeros(250)
+        segment[100] = 9.81
+        features = extract_device_features(segment, sampling_rate=100)
+
+        assert features[DEVICE_FEATURE_NAMES.index('duration')] == pytest.approx(2.5)
+        assert features[DEVICE_FEATURE_NAMES.index('pga')] == pytest.approx(1.0)
+
+    def test_empty_segment(self):
+        features = extract_device_features(np.array([]), sampling_rate=100)
+
+        assert np.all(features == 0)
+
+
+class TestQuantizedDeviceModel:
+    def test_quantized_matches_float_model(self, device_model):
+        model, scaler, features, params = device_model
+        standardized = np.clip(scaler.transform(features), -DEVICE_INPUT_RANGE, DEVICE_INPUT_RANGE)
+
+        float_proba = model.predict_proba(standardized)[:, 1]
+        quantized_proba = quantized_predict_proba(params, features)
+
+        agreement = np.mean((float_proba >= 0.5) == (quantized_proba >= 0.5))
+        assert agreement >= 0.9
+
+    def test_requantization_multiplier_range(self, device_model):
+        _, _, _, params = device_model
+
+        assert (1 << 30) <= params['hidden_multiplier'] < (1 << 31)
+        assert 30 + params['hidden_shift'] >= 0
+
+    def test_weights_are_int8(self, device_model):
+        _, _, _, params = device_model
+
+        assert params['hidden_weights'].dtype == np.int8
+        assert params['output_weights'].dtype == np.int8
+        assert np.all(np.abs(params['hidden_weights'].astype(int)) <= 127)
+
+    def test_header_export(self, device_model, tmp_path):
+        _, _, _, params = device_model
+        path = tmp_path / 'ml_model_data.h'
+
+        export_device_model_header(params, str(path))
+        header = path.read_text()
+
+        assert f'#define ML_FEATURE_COUNT {len(DEVICE_FEATURE_NAMES)}' in header
+        assert '#define ML_HIDDEN_UNITS 16' in header
+        for name in ['ML_FEATURE_MEAN', 'ML_FEATURE_INV_STD', 'ML_HIDDEN_WEIGHTS',
+                     'ML_HIDDEN_BIAS', 'ML_HIDDEN_MULTIPLIER', 'ML_OUTPUT_WEIGHTS',
+                     'ML_OUTPUT_BIAS', 'ML_OUTPUT_SCALE']:
+            assert name in header
+
+
+if __name__ == "__main__":
+    pytest.main([__file__, "-v"])
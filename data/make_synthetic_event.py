@@ -0,0 +1,52 @@
+import argparse
+import math
+import random
+import struct
+from pathlib import Path
+
+SAMPLE_RATE = 100
+DURATION_SEC = 60.0
+GRAVITY = 9.80665
+NOISE_RMS = 0.02
+P_ONSET_SEC = 40.0
+S_ONSET_SEC = 43.0
+
+
+def envelope(t: float, onset: float, rise: float, decay: float) -> float:
+    offset = t - onset
+    if offset <= 0.0:
+        return 0.0
+    ramp = 0.5 - 0.5 * math.cos(math.pi * offset / rise) if offset < rise else 1.0
+    return ramp * math.exp(-max(0.0, offset - rise) / decay)
+
+
+def frames(seed: int):
+    rng = random.Random(seed)
+    for index in range(int(DURATION_SEC * SAMPLE_RATE)):
+        t = index / SAMPLE_RATE
+        p = 0.15 * envelope(t, P_ONSET_SEC, 0.5, 2.0) * math.sin(2.0 * math.pi * 6.0 * t)
+        s = 1.5 * envelope(t, S_ONSET_SEC, 1.0, 5.0)
+        x = rng.gauss(0.0, NOISE_RMS) + 0.3 * p + s * math.sin(2.0 * math.pi * 2.5 * t)
+        y = rng.gauss(0.0, NOISE_RMS) + 0.3 * p + 0.7 * s * math.cos(2.0 * math.pi * 2.1 * t)
+        z = GRAVITY + rng.gauss(0.0, NOISE_RMS) + p + 0.3 * s * math.sin(2.0 * math.pi * 3.3 * t)
+        yield x, y, z
+
+
+def write_npy(path: Path, rows) -> None:
+    data = b''.join(struct.pack('<3f', *row) for row in rows)
+    header = "{'descr': '<f4', 'fortran_order': False, 'shape': (%d, 3), }" % (len(data) // 12)
+    header += ' ' * (63 - (len(header) + 10) % 64) + '\n'
+    path.write_bytes(b'\x93NUMPY\x01\x00' + struct.pack('<H', len(header)) + header.encode('latin1') + data)
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description='Write the synthetic three-axis event used by the replay tests.')
+    parser.add_argument('output', nargs='?', default=str(Path(__file__).with_name('synthetic_event.npy')))
+    parser.add_argument('--seed', type=int, default=2026)
+    args = parser.parse_args()
+
+    write_npy(Path(args.output), list(frames(args.seed)))
+
+
+if __name__ == '__main__':
+    main()
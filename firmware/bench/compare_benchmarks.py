@@ -0,0 +1,111 @@
+import argparse
+import json
+import sys
+from pathlib import Path
+from typing import Dict, List, Tuple
+
+
+def parse_results(paths: List[str]) -> Tuple[str, Dict[str, Dict[str, float]]]:
+    unit = None
+    results: Dict[str, Dict[str, float]] = {}
+
+    for path in paths:
+        stream = sys.stdin if path == '-' else open(path, encoding='utf-8', errors='replace')
+        with stream:
+            for line in stream:
+                line = line.strip()
+                if not line.startswith('{'):
+                    continue
+                try:
+                    entry = json.loads(line)
+                except json.JSONDecodeError:
+                    continue
+                if 'name' not in entry or 'per_op' not in entry:
+                    continue
+
+                if unit is None:
+                    unit = entry['unit']
+                elif entry['unit'] != unit:
+                    raise ValueError(f"mixed units in results: {unit} and {entry['unit']}")
+
+                previous = results.get(entry['name'])
+                if previous is None or entry['per_op'] < previous['per_op']:
+                    results[entry['name']] = {'per_op': entry['per_op'], 'bytes': entry.get('bytes', 0)}
+
+    return unit, results
+
+
+def compare(
+    baseline: Dict[str, Dict[str, float]],
+    results: Dict[str, Dict[str, float]],
+    tolerance: float
+) -> Tuple[List[str], List[str], List[str]]:
+    regressions = []
+    improvements = []
+    missing = []
+
+    for name, expected in sorted(baseline.items()):
+        actual = results.get(name)
+        if actual is None:
+            missing.append(name)
+            continue
+
+        change = actual['per_op'] / expected['per_op'] - 1.0 if expected['per_op'] > 0 else 0.0
+        line = f"{name}: {expected['per_op']:.1f} -> {actual['per_op']:.1f} ({change:+.1%})"
+
+        if change > tolerance:
+            regressions.append(line)
+        elif change < -tolerance:
+            improvements.append(line)
+
+        if actual['bytes'] > expected['bytes']:
+            regressions.append(f"{name}: {expected['bytes']:.0f} -> {actual['bytes']:.0f} bytes")
+
+    return regressions, improvements, missing
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description='Compare detector benchmark output against a stored baseline')
+    parser.add_argument('baseline', help='baseline JSON file, e.g. bench/baselines/native.json')
+    parser.add_argument('results', nargs='+', help="benchmark output files ('-' for stdin); the fastest run wins")
+    parser.add_argument('--tolerance', type=float, default=0.15, help='allowed slowdown as a fraction')
+    parser.add_argument('--update', action='store_true', help='write the results as the new baseline')
+    args = parser.parse_args()
+
+    unit, results = parse_results(args.results)
+    if not results:
+        print('no benchmark results found', file=sys.stderr)
+        return 2
+
+    baseline_path = Path(args.baseline)
+    if args.update:
+        baseline_path.parent.mkdir(parents=True, exist_ok=True)
+        baseline_path.write_text(json.dumps({'unit': unit, 'benchmarks': results}, indent=2, sort_keys=True) + '\n')
+        print(f'wrote {len(results)} benchmarks to {baseline_path}')
+        return 0
+
+    baseline = json.loads(baseline_path.read_text())
+    if baseline['unit'] != unit:
+        print(f"baseline unit {baseline['unit']} does not match results unit {unit}", file=sys.stderr)
+        return 2
+
+    regressions, improvements, missing = compare(baseline['benchmarks'], results, args.tolerance)
+
+    for line in improvements:
+        print(f'faster   {line}')
+    for name in missing:
+        print(f'missing  {name}')
+    for line in regressions:
+        print(f'SLOWER   {line}')
+
+    added = sorted(set(results) - set(baseline['benchmarks']))
+    for name in added:
+        print(f'new      {name}: {results[name]["per_op"]:.1f} {unit}')
+
+    print(f'{len(results)} benchmarks, {len(regressions)} regressions, {len(improvements)} improvements '
+          f'(tolerance {args.tolerance:.0%}, unit {unit})')
+    return 1 if regressions or missing else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,42 @@
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+#include <ctype.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+#include <cmath>
+#include "hal_clock.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define IRAM_ATTR
+#define RTC_NOINIT_ATTR
+
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux) ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux) ((void)(mux))
+
+unsigned long millis();
+unsigned long micros();
+uint64_t micros64();
+
+class HalSerial {
+public:
+    size_t print(const char* text);
+    size_t println(const char* text = "");
+    int printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+extern HalSerial Serial;
+
+#endif
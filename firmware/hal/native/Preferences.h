@@ -0,0 +1,27 @@
+#ifndef NATIVE_PREFERENCES_H
+#define NATIVE_PREFERENCES_H
+
+#include <Arduino.h>
+#include <string>
+
+class Preferences {
+public:
+    Preferences();
+
+    bool begin(const char* name, bool readOnly = false);
+    void end();
+    size_t getBytes(const char* key, void* buffer, size_t length);
+    size_t putBytes(const char* key, const void* value, size_t length);
+    bool remove(const char* key);
+
+private:
+    std::string space;
+    bool open;
+    bool readOnly;
+
+    std::string path(const char* key) const;
+};
+
+void halPreferencesReset();
+
+#endif
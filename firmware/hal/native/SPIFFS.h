@@ -0,0 +1,50 @@
+#ifndef NATIVE_SPIFFS_H
+#define NATIVE_SPIFFS_H
+
+#include <Arduino.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+class File {
+public:
+    File();
+    File(std::shared_ptr<std::vector<uint8_t>> data, bool writable, size_t position);
+
+    explicit operator bool() const;
+    size_t read(uint8_t* buffer, size_t length);
+    size_t write(const uint8_t* buffer, size_t length);
+    bool seek(uint32_t position);
+    size_t position() const;
+    size_t size() const;
+    void close();
+
+private:
+    std::shared_ptr<std::vector<uint8_t>> data;
+    bool writable;
+    size_t offset;
+};
+
+class HalSpiffs {
+public:
+    bool begin(bool formatOnFail = false);
+    bool format();
+    File open(const char* path, const char* mode = FILE_READ);
+    bool exists(const char* path) const;
+    bool remove(const char* path);
+    bool rename(const char* from, const char* to);
+
+private:
+    std::map<std::string, std::shared_ptr<std::vector<uint8_t>>> files;
+};
+
+extern HalSpiffs SPIFFS;
+
+void halSpiffsLimitWrites(size_t bytes);
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef HAL_CLOCK_H
+#define HAL_CLOCK_H
+
+#include <stdint.h>
+
+typedef uint64_t (*HalClockSource)();
+
+void halSetClockSource(HalClockSource source);
+uint64_t halSystemMicros();
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef WAVEFORM_REPLAY_H
+#define WAVEFORM_REPLAY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "config.h"
+
+struct ReplayOptions {
+    const char* path = nullptr;
+    int sampleRate = SAMPLE_RATE_HZ;
+    float gain = 1.0f;
+    int axis = 2;
+    bool fixedPoint = false;
+    int repeat = 1;
+    int expectedEvents = -1;
+    bool quiet = false;
+};
+
+struct Waveform {
+    std::vector<double> values;
+    size_t channels = 1;
+
+    size_t frames() const {
+        return values.size() / channels;
+    }
+};
+
+struct ReplayStats {
+    size_t triggers = 0;
+    size_t confirmedEvents = 0;
+    size_t preliminaryAlerts = 0;
+    float peakRatio = 0.0f;
+    float peakPga = 0.0f;
+    float peakCav = 0.0f;
+    uint64_t firstOnset = 0;
+};
+
+bool loadNpy(const char* path, Waveform& waveform);
+ReplayStats replayWaveform(const Waveform& waveform, const ReplayOptions& options);
+
+#endif
@@ -5,7 +5,15 @@
 #include <WiFi.h>
 #include <PubSubClient.h>
 #include <HTTPClient.h>
+#include <WiFiClientSecure.h>
+#include <ArduinoJson.h>
+#include "config.h"
+#include "command_dispatcher.h"
 #include "earthquake_detector.h"
+#include "instrumentation.h"
+#include "json_pool.h"
+#include "pwave_estimator.h"
+#include "timebase.h"
 
 enum AlertChannel {
     ALERT_LOCAL,
@@ -13,18 +21,27 @@ enum AlertChannel {
     ALERT_PUSHOVER,
     ALERT_TELEGRAM,
     ALERT_DISCORD,
+    ALERT_REMOTE,
     ALERT_ALL
 };
 
+enum BuzzerPattern {
+    BUZZER_IDLE,
+    BUZZER_TONE,
+    BUZZER_SIREN
+};
+
 class LocalAlertSystem {
 public:
     LocalAlertSystem(int buzzerPin, int redLedPin, int yellowLedPin, int greenLedPin);
     void init();
-    void setAlertLevel(const String& level);
-    void displayStatus(const String& status);
+    void setAlertLevel(AlertLevel level);
+    void displayStatus(const char* status);
     void soundAlarm(int frequency, int durationMs);
     void sirenPattern();
     void stopAlarm();
+    void update();
+    bool isSounding() const;
 
 private:
     int buzzerPin;
@@ -32,6 +49,27 @@ private:
     int yellowLedPin;
     int greenLedPin;
     int buzzerChannel;
+
+    BuzzerPattern pattern;
+    unsigned long patternStartTime;
+    unsigned long toneDurationMs;
+    int sirenStep;
+
+    int sirenFrequency(int step) const;
+};
+
+class MqttPublishWriter : public Print {
+public:
+    explicit MqttPublishWriter(PubSubClient& client);
+    size_t write(uint8_t byte) override;
+    size_t write(const uint8_t* data, size_t length) override;
+    bool drain();
+
+private:
+    PubSubClient& client;
+    uint8_t buffer[MQTT_PUBLISH_CHUNK_SIZE];
+    size_t pending;
+    bool failed;
 };
 
 class MQTTAlertSystem {
@@ -41,40 +79,88 @@ public:
     bool connect(const char* clientId);
     bool isConnected();
     void loop();
-    bool publishAlert(const EarthquakeEvent& event, const String& deviceId);
-    bool publishData(float ax, float ay, float az, const String& deviceId);
-    bool publishStatus(const String& status, const String& deviceId);
+    bool publishAlert(const EarthquakeEvent& event, const char* deviceId);
+    bool publishAlertBatch(const EarthquakeEvent* const* events, size_t count, const char* deviceId);
+    bool publishPreliminaryAlert(const PreliminaryEvent& event, const char* deviceId);
+    bool publishData(float ax, float ay, float az, const char* deviceId);
+    bool publishWaveform(const uint8_t* payload, size_t length, const char* deviceId);
+    bool publishCapture(const uint8_t* payload, size_t length, const char* deviceId);
+    bool publishStatus(const char* status, const char* deviceId, const MetricsReport* metrics = nullptr);
+    bool publishCommandResult(const CommandResult& result, const char* deviceId);
+    bool subscribeCommands(const char* deviceId);
     void setCallback(MQTT_CALLBACK_SIGNATURE);
+    void setTimebase(const Timebase* source);
 
 private:
+    bool publishDeviceTopic(const char* baseTopic, const uint8_t* payload, size_t length, const char* deviceId);
+    bool publishDocument(const char* topic, bool retained);
+    void addMetrics(const MetricsReport& metrics);
+    bool addTimestamp();
+
     WiFiClient wifiClient;
     PubSubClient mqttClient;
+    StaticJsonPool<MQTT_JSON_POOL_SIZE> jsonPool;
+    JsonDocument document;
     const char* server;
     int port;
     const char* user;
     const char* password;
+    const Timebase* timebase;
+};
+
+enum WebhookService {
+    WEBHOOK_PUSHOVER,
+    WEBHOOK_TELEGRAM,
+    WEBHOOK_DISCORD,
+    WEBHOOK_SERVICE_COUNT
+};
+
+struct WebhookJob {
+    char title[WEBHOOK_TITLE_LENGTH];
+    char message[WEBHOOK_MESSAGE_LENGTH];
+    int priority;
 };
 
 class WebhookAlertSystem {
 public:
     WebhookAlertSystem();
-    void setPushoverCredentials(const String& token, const String& user);
-    void setTelegramCredentials(const String& botToken, const String& chatId);
-    void setDiscordWebhook(const String& webhookUrl);
+    void setPushoverCredentials(const char* token, const char* user);
+    void setTelegramCredentials(const char* botToken, const char* chatId);
+    void setDiscordWebhook(const char* webhookUrl);
+    bool begin();
 
-    bool sendPushover(const String& title, const String& message, int priority);
-    bool sendTelegram(const String& message);
-    bool sendDiscord(const String& message);
+    bool sendPushover(const char* title, const char* message, int priority);
+    bool sendTelegram(const char* message);
+    bool sendDiscord(const char* message);
     void broadcastAlert(const EarthquakeEvent& event);
 
 private:
-    String pushoverToken;
-    String pushoverUser;
-    String telegramBotToken;
-    String telegramChatId;
-    String discordWebhookUrl;
+    struct ServiceWorker {
+        WebhookAlertSystem* owner;
+        WebhookService service;
+        QueueHandle_t jobs;
+        TaskHandle_t task;
+        WiFiClientSecure client;
+        HTTPClient http;
+        StaticJsonPool<WEBHOOK_JSON_POOL_SIZE> jsonPool;
+    };
+
+    const char* pushoverToken;
+    const char* pushoverUser;
+    const char* telegramBotToken;
+    const char* telegramChatId;
+    const char* discordWebhookUrl;
+    ServiceWorker workers[WEBHOOK_SERVICE_COUNT];
 
-    String urlEncode(const String& str);
+    static void workerTask(void* parameter);
+    bool isConfigured(WebhookService service) const;
+    bool enqueue(WebhookService service, const char* title, const char* message, int priority);
+    bool deliver(ServiceWorker& worker, const WebhookJob& job);
+    int post(ServiceWorker& worker, const WebhookJob& job);
+    int postPushover(ServiceWorker& worker, const WebhookJob& job);
+    int postTelegram(ServiceWorker& worker, const WebhookJob& job);
+    int postDiscord(ServiceWorker& worker, const WebhookJob& job);
+    static size_t urlEncode(const char* input, char* output, size_t capacity);
 };
 
 class AlertManager {
@@ -82,14 +168,14 @@ public:
     AlertManager();
     void init(LocalAlertSystem* local, MQTTAlertSystem* mqtt, WebhookAlertSystem* webhook);
     void sendAlert(const EarthquakeEvent& event, AlertChannel channel = ALERT_ALL);
-    void sendStatus(const String& status);
-    void setDeviceId(const String& id);
+    void sendStatus(const char* status, const MetricsReport* metrics = nullptr);
+    void setDeviceId(const char* id);
 
 private:
     LocalAlertSystem* localAlert;
     MQTTAlertSystem* mqttAlert;
     WebhookAlertSystem* webhookAlert;
-    String deviceId;
+    const char* deviceId;
 };
 
 #endif
@@ -0,0 +1,173 @@
+#ifndef BUTTERWORTH_DESIGN_H
+#define BUTTERWORTH_DESIGN_H
+
+#include <stddef.h>
+
+#define FILTER_MAX_SECTIONS 4
+
+struct BiquadCoefficients {
+    float b0;
+    float b1;
+    float b2;
+    float a1;
+    float a2;
+};
+
+struct BandpassDesign {
+    BiquadCoefficients sections[FILTER_MAX_SECTIONS];
+    int sectionCount;
+};
+
+namespace butterworth_detail {
+
+constexpr double kPi = 3.14159265358979323846;
+
+struct Complex {
+    double re;
+    double im;
+};
+
+constexpr Complex add(Complex a, Complex b) {
+    return {a.re + b.re, a.im + b.im};
+}
+
+constexpr Complex subtract(Complex a, Complex b) {
+    return {a.re - b.re, a.im - b.im};
+}
+
+constexpr Complex multiply(Complex a, Complex b) {
+    return {a.re * b.re - a.im * b.im, a.re * b.im + a.im * b.re};
+}
+
+constexpr Complex divide(Complex a, Complex b) {
+    double denominator = b.re * b.re + b.im * b.im;
+    return {(a.re * b.re + a.im * b.im) / denominator, (a.im * b.re - a.re * b.im) / denominator};
+}
+
+constexpr Complex scale(Complex a, double factor) {
+    return {a.re * factor, a.im * factor};
+}
+
+constexpr double squareRoot(double value) {
+    if (value <= 0.0) {
+        return 0.0;
+    }
+
+    double guess = value > 1.0 ? value : 1.0;
+    for (int i = 0; i < 128; i++) {
+        double next = 0.5 * (guess + value / guess);
+        if (next == guess) {
+            break;
+        }
+        guess = next;
+    }
+    return guess;
+}
+
+constexpr double magnitude(Complex a) {
+    return squareRoot(a.re * a.re + a.im * a.im);
+}
+
+constexpr Complex complexSquareRoot(Complex a) {
+    double modulus = magnitude(a);
+    double re = squareRoot((modulus + a.re) / 2.0);
+    double im = squareRoot((modulus - a.re) / 2.0);
+    return {re, a.im < 0.0 ? -im : im};
+}
+
+constexpr double wrapAngle(double angle) {
+    while (angle > kPi) {
+        angle -= 2.0 * kPi;
+    }
+    while (angle < -kPi) {
+        angle += 2.0 * kPi;
+    }
+    return angle;
+}
+
+constexpr double sine(double angle) {
+    double x = wrapAngle(angle);
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 24; n++) {
+        term *= -x * x / ((2.0 * n) * (2.0 * n + 1.0));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double cosine(double angle) {
+    double x = wrapAngle(angle);
+    double term = 1.0;
+    double sum = 1.0;
+    for (int n = 1; n < 24; n++) {
+        term *= -x * x / ((2.0 * n - 1.0) * (2.0 * n));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double tangent(double angle) {
+    return sine(angle) / cosine(angle);
+}
+
+constexpr Complex bilinear(Complex s, double twiceSampleRate) {
+    return divide({twiceSampleRate + s.re, s.im}, {twiceSampleRate - s.re, -s.im});
+}
+
+constexpr BiquadCoefficients normalizedSection(double a1, double a2, Complex center) {
+    Complex inverse = {center.re, -center.im};
+    Complex inverseSquared = multiply(inverse, inverse);
+    Complex numerator = subtract({1.0, 0.0}, inverseSquared);
+    Complex denominator = add(add({1.0, 0.0}, scale(inverse, a1)), scale(inverseSquared, a2));
+    double gain = magnitude(denominator) / magnitude(numerator);
+
+    return {static_cast<float>(gain), 0.0f, static_cast<float>(-gain),
+            static_cast<float>(a1), static_cast<float>(a2)};
+}
+
+constexpr BiquadCoefficients conjugatePairSection(Complex pole, Complex center) {
+    return normalizedSection(-2.0 * pole.re, pole.re * pole.re + pole.im * pole.im, center);
+}
+
+}
+
+constexpr BandpassDesign designButterworthBandpass(double sampleRate, double lowCutoff, double highCutoff,
+                                                   int order) {
+    using namespace butterworth_detail;
+
+    BandpassDesign design = {};
+    int prototypeOrder = order < 1 ? 1 : (order > FILTER_MAX_SECTIONS ? FILTER_MAX_SECTIONS : order);
+
+    double twiceSampleRate = 2.0 * sampleRate;
+    double warpedLow = twiceSampleRate * tangent(kPi * lowCutoff / sampleRate);
+    double warpedHigh = twiceSampleRate * tangent(kPi * highCutoff / sampleRate);
+    double bandwidth = warpedHigh - warpedLow;
+    double centerSquared = warpedLow * warpedHigh;
+    Complex center = bilinear({0.0, squareRoot(centerSquared)}, twiceSampleRate);
+
+    for (int k = 0; k < prototypeOrder / 2; k++) {
+        double theta = kPi * (2.0 * k + prototypeOrder + 1.0) / (2.0 * prototypeOrder);
+        Complex half = scale({cosine(theta), sine(theta)}, bandwidth / 2.0);
+        Complex discriminant = complexSquareRoot(subtract(multiply(half, half), {centerSquared, 0.0}));
+
+        design.sections[design.sectionCount++] =
+            conjugatePairSection(bilinear(add(half, discriminant), twiceSampleRate), center);
+        design.sections[design.sectionCount++] =
+            conjugatePairSection(bilinear(subtract(half, discriminant), twiceSampleRate), center);
+    }
+
+    if (prototypeOrder % 2 == 1) {
+        Complex half = {-bandwidth / 2.0, 0.0};
+        Complex discriminant = complexSquareRoot({bandwidth * bandwidth / 4.0 - centerSquared, 0.0});
+        Complex first = bilinear(add(half, discriminant), twiceSampleRate);
+        Complex second = bilinear(subtract(half, discriminant), twiceSampleRate);
+
+        design.sections[design.sectionCount++] =
+            normalizedSection(-add(first, second).re, multiply(first, second).re, center);
+    }
+
+    return design;
+}
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef CAPTURE_STORE_H
+#define CAPTURE_STORE_H
+
+#include <Arduino.h>
+#include <SPIFFS.h>
+#include <functional>
+#include "config.h"
+#include "event_recorder.h"
+#include "timebase.h"
+
+#define CAPTURE_CHUNK_VERSION 1
+#define CAPTURE_CHUNK_FLAG_FINAL 0x01
+#define CAPTURE_CHUNK_HEADER_SIZE 16
+#define CAPTURE_CHUNK_MAX_PAYLOAD (CAPTURE_CHUNK_HEADER_SIZE + CAPTURE_CHUNK_SIZE)
+#define CAPTURE_PATH_LENGTH 24
+
+class CaptureStore {
+public:
+    CaptureStore();
+
+    bool init();
+    bool save(const EventRecorder& recorder, const Timebase& timebase);
+    bool uploadNextChunk(std::function<bool(const uint8_t* payload, size_t length)> publishFunction);
+    int getPendingCount() const;
+
+private:
+    int findFreeSlot() const;
+    int findPendingSlot() const;
+    uint32_t readSentOffset(int slot) const;
+    bool writeSentOffset(int slot, uint32_t offset);
+    void removeSlot(int slot);
+    static void dataPath(int slot, char* path);
+    static void sentOffsetPath(int slot, char* path);
+
+    uint32_t nextCaptureId;
+    uint8_t chunkBuffer[CAPTURE_CHUNK_MAX_PAYLOAD];
+};
+
+#endif
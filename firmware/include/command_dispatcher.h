@@ -0,0 +1,82 @@
+#ifndef COMMAND_DISPATCHER_H
+#define COMMAND_DISPATCHER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+#define COMMAND_NAME_MAX_LENGTH 24
+#define COMMAND_MAX_ARGUMENTS 8
+#define COMMAND_NUMBER_MAX_LENGTH 24
+
+enum CommandStatus : uint8_t {
+    COMMAND_OK,
+    COMMAND_UNKNOWN,
+    COMMAND_MALFORMED,
+    COMMAND_REJECTED,
+    COMMAND_BUSY
+};
+
+const char* commandStatusName(CommandStatus status);
+
+enum CommandValueType : uint8_t {
+    COMMAND_VALUE_STRING,
+    COMMAND_VALUE_NUMBER,
+    COMMAND_VALUE_BOOL,
+    COMMAND_VALUE_NULL
+};
+
+struct CommandArgument {
+    const char* key;
+    size_t keyLength;
+    const char* value;
+    size_t valueLength;
+    CommandValueType type;
+};
+
+class CommandArguments {
+public:
+    CommandArguments();
+    bool parse(const char* text, size_t length);
+    void clear();
+
+    bool has(const char* key) const;
+    bool getString(const char* key, const char*& value, size_t& length) const;
+    bool getNumber(const char* key, float& value) const;
+    bool getUnsigned(const char* key, uint32_t& value) const;
+    bool getBool(const char* key, bool fallback) const;
+    size_t size() const;
+
+private:
+    CommandArgument entries[COMMAND_MAX_ARGUMENTS];
+    size_t count;
+
+    const CommandArgument* find(const char* key) const;
+};
+
+typedef CommandStatus (*CommandFunction)(const CommandArguments& arguments);
+
+struct CommandHandler {
+    const char* name;
+    CommandFunction handle;
+};
+
+struct CommandResult {
+    char name[COMMAND_NAME_MAX_LENGTH + 1];
+    CommandStatus status;
+};
+
+class CommandDispatcher {
+public:
+    CommandDispatcher(const CommandHandler* table, size_t count);
+    CommandResult dispatch(uint8_t* payload, size_t length);
+
+private:
+    const CommandHandler* table;
+    size_t count;
+    CommandArguments arguments;
+
+    const CommandHandler* find(const char* name, size_t length) const;
+    static void copyName(CommandResult& result, const char* name, size_t length);
+};
+
+#endif
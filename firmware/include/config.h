@@ -11,27 +11,119 @@
 #define MQTT_TOPIC_ALERT "earthquake/alert"
 #define MQTT_TOPIC_DATA "earthquake/data"
 #define MQTT_TOPIC_STATUS "earthquake/status"
+#define MQTT_TOPIC_ALERT_BATCH "earthquake/alert/batch"
+#define MQTT_TOPIC_ALERT_PRELIMINARY "earthquake/alert/preliminary"
+#define MQTT_TOPIC_WAVEFORM "earthquake/waveform"
+#define MQTT_TOPIC_CAPTURE "earthquake/capture"
+#define MQTT_TOPIC_COMMAND "earthquake/command"
+#define MQTT_TOPIC_COMMAND_ACK "earthquake/command/ack"
+#define MQTT_COMMAND_BROADCAST_ID "all"
+#define MQTT_TOPIC_MAX_LENGTH 64
+#define DEVICE_ID_LENGTH 24
+#define MQTT_BUFFER_SIZE 512
+#define MQTT_JSON_POOL_SIZE 8192
+#define MQTT_PUBLISH_CHUNK_SIZE 256
+#define MQTT_BATCH_MAX_EVENTS 10
 
 #define MPU6050_I2C_ADDRESS 0x68
 #define I2C_SDA_PIN 21
 #define I2C_SCL_PIN 22
 #define INTERRUPT_PIN 32
+#define I2C_CLOCK_HZ 400000
+
+#define ACQUISITION_USE_FIFO true
+#define FIFO_BURST_MAX_SAMPLES 64
+#define FIFO_DRAIN_INTERVAL_MS 20
+#define MPU_DLPF_CONFIG 4
+
+#define LOW_POWER_MODE_ENABLED false
+#define LOW_POWER_SAMPLE_RATE_HZ 25
+#define LOW_POWER_DLPF_CONFIG 5
+#define LOW_POWER_DRAIN_INTERVAL_MS 2000
+#define LOW_POWER_WAKE_RATIO 2.5f
+#define LOW_POWER_MOTION_THRESHOLD_MG 20
+#define LOW_POWER_MOTION_DURATION_MS 1
+#define LOW_POWER_FULL_RATE_HOLD_MS 60000
+#define LOW_POWER_HEARTBEAT_INTERVAL_MS 900000
+#define LOW_POWER_RADIO_WINDOW_MS 30000
+
+#define ACQUISITION_TASK_CORE 1
+#define ACQUISITION_TASK_PRIORITY 20
+#define ACQUISITION_TASK_STACK_SIZE 8192
+#define ACQUISITION_WAIT_TIMEOUT_MS 100
+#define NETWORK_TASK_CORE 0
+#define NETWORK_TASK_PRIORITY 5
+#define NETWORK_TASK_STACK_SIZE 12288
+#define NETWORK_TASK_PERIOD_MS 10
+#define STATUS_INTERVAL_MS 60000
+
+#define TIMEBASE_NTP_SERVER "pool.ntp.org"
+#define TIMEBASE_NTP_SERVER_BACKUP "time.google.com"
+#define TIMEBASE_SNTP_INTERVAL_MS 60000
+#define TIMEBASE_PPS_PIN -1
+#define TIMEBASE_PPS_TIMEOUT_MS 3000
+#define TIMEBASE_PPS_CAPTURE_US 200000
+#define TIMEBASE_STEP_THRESHOLD_US 500000
+#define TIMEBASE_PHASE_GAIN 0.5f
+#define TIMEBASE_DRIFT_GAIN 0.25f
+#define TIMEBASE_MAX_DRIFT_PPM 200
+
+#define CONFIRMED_EVENT_QUEUE_DEPTH 8
+#define PRELIMINARY_EVENT_QUEUE_DEPTH 8
+#define SAMPLE_STREAM_QUEUE_DEPTH 256
+#define DETECTOR_COMMAND_QUEUE_DEPTH 8
+#define MQTT_STREAM_SAMPLES false
+#define MQTT_STREAM_BINARY true
+#define WAVEFORM_BLOCK_SAMPLES 100
+#define WAVEFORM_SCALE 0.001f
+
+#define CAPTURE_PRE_TRIGGER_SEC 5
+#define CAPTURE_POST_TRIGGER_SEC 5
+#define CAPTURE_MAX_SEC 60
+#define CAPTURE_SLOT_COUNT 4
+#define CAPTURE_CHUNK_SIZE 1024
+#define CAPTURE_UPLOAD_INTERVAL_MS 50
 
 #define BUZZER_PIN 25
 #define RED_LED_PIN 26
 #define YELLOW_LED_PIN 27
 #define GREEN_LED_PIN 14
 
+#define SIREN_MIN_FREQUENCY_HZ 800
+#define SIREN_MAX_FREQUENCY_HZ 2000
+#define SIREN_FREQUENCY_STEP_HZ 100
+#define SIREN_STEP_MS 30
+#define SIREN_CYCLES 3
+
 #define LCD_I2C_ADDRESS 0x27
 #define LCD_COLS 16
 #define LCD_ROWS 2
 
 #define SAMPLE_RATE_HZ 100
+#define DETECTION_FIXED_POINT false
+#define ACCEL_COUNTS_PER_G 16384
 #define STA_WINDOW_SEC 1.0f
 #define LTA_WINDOW_SEC 30.0f
 #define STA_LTA_TRIGGER_THRESHOLD 5.0f
 #define STA_LTA_DETRIGGER_THRESHOLD 2.0f
+#define STA_LTA_MODE STA_LTA_SLIDING
+
+#define DETECTOR_MAX_CHANNELS 4
+#define DETECTOR_VOTES_REQUIRED 1
+#define LOCAL_CHANNEL_ENABLED false
+#define LOCAL_STA_WINDOW_SEC 0.5f
+#define LOCAL_LTA_WINDOW_SEC 10.0f
+#define LOCAL_TRIGGER_THRESHOLD 6.0f
+#define LOCAL_DETRIGGER_THRESHOLD 2.0f
+#define BAND_CHANNEL_ENABLED false
+#define BAND_CHANNEL_LOW_HZ 2.0f
+#define BAND_CHANNEL_HIGH_HZ 10.0f
+#define BAND_STA_WINDOW_SEC 0.5f
+#define BAND_LTA_WINDOW_SEC 20.0f
+#define BAND_TRIGGER_THRESHOLD 6.0f
+#define BAND_DETRIGGER_THRESHOLD 2.0f
 
+#define PGA_WINDOW_SEC 3.0f
 #define PGA_THRESHOLD_LIGHT 0.03f
 #define PGA_THRESHOLD_MODERATE 0.08f
 #define PGA_THRESHOLD_STRONG 0.15f
@@ -39,20 +131,56 @@
 #define PGA_THRESHOLD_VIOLENT 0.45f
 
 #define CAV_THRESHOLD 0.16f
+#define CAV_MODE CAV_CUMULATIVE
+#define CAV_STANDARDIZED_THRESHOLD_G 0.0051f
+#define CAV_STANDARDIZED_BIN_SEC 1.0f
 
 #define MIN_EVENT_DURATION_SEC 5.0f
 
+#define WARM_START_ENABLED true
+#define WARM_START_SNAPSHOT_INTERVAL_MS 10000
+#define WARM_START_FLASH_INTERVAL_MS 3600000
+#define WARM_START_MAX_AGE_MS 7200000
+
+#define PWAVE_ENABLED true
+#define PWAVE_MIN_WINDOW_SEC 0.5f
+#define PWAVE_MAX_WINDOW_SEC 3.0f
+#define PWAVE_UPDATE_INTERVAL_SEC 0.5f
+#define PWAVE_HIGHPASS_HZ 0.075f
+#define PWAVE_PD_DAMAGING_CM 0.5f
+#define PWAVE_MAGNITUDE_DAMAGING 6.0f
+
+#define ML_CONFIRMATION_ENABLED false
+#define ML_CONFIRM_THRESHOLD 0.5f
+#define ML_INFERENCE_BUDGET_US 2000
+
 #define FILTER_LOW_CUTOFF_HZ 0.1f
 #define FILTER_HIGH_CUTOFF_HZ 25.0f
 #define FILTER_ORDER 2
+#define KALMAN_PROCESS_NOISE 0.01f
+#define KALMAN_MEASUREMENT_NOISE 0.1f
 
 #define DEVICE_LATITUDE 0.0f
 #define DEVICE_LONGITUDE 0.0f
 
+#define WEBHOOK_DEVICE_NOTIFICATIONS false
 #define PUSHOVER_TOKEN ""
 #define PUSHOVER_USER ""
 #define TELEGRAM_BOT_TOKEN ""
 #define TELEGRAM_CHAT_ID ""
 #define DISCORD_WEBHOOK_URL ""
 
+#define WEBHOOK_QUEUE_DEPTH 4
+#define WEBHOOK_TASK_CORE 0
+#define WEBHOOK_TASK_PRIORITY 3
+#define WEBHOOK_TASK_STACK_SIZE 8192
+#define WEBHOOK_HTTP_TIMEOUT_MS 5000
+#define WEBHOOK_MAX_ATTEMPTS 4
+#define WEBHOOK_RETRY_BASE_DELAY_MS 500
+#define WEBHOOK_TITLE_LENGTH 48
+#define WEBHOOK_MESSAGE_LENGTH 256
+#define WEBHOOK_URL_LENGTH 192
+#define WEBHOOK_PAYLOAD_LENGTH 1024
+#define WEBHOOK_JSON_POOL_SIZE 2048
+
 #endif
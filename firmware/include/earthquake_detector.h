@@ -2,76 +2,274 @@
 #define EARTHQUAKE_DETECTOR_H
 
 #include <Arduino.h>
-#include <vector>
+#include "config.h"
+#include "ring_buffer.h"
+#include "sliding_max.h"
+#include "butterworth_design.h"
 
 struct AccelSample {
     float x;
     float y;
     float z;
-    unsigned long timestamp;
+    uint64_t timestamp;
 };
 
+constexpr size_t DETECTOR_BUFFER_CAPACITY =
+    static_cast<size_t>(SAMPLE_RATE_HZ * (LTA_WINDOW_SEC + STA_WINDOW_SEC));
+
+constexpr size_t PGA_WINDOW_CAPACITY =
+    static_cast<size_t>(SAMPLE_RATE_HZ * PGA_WINDOW_SEC);
+
+struct AxisPeaks {
+    float x;
+    float y;
+    float z;
+};
+
+enum class AlertLevel : uint8_t {
+    NEGLIGIBLE,
+    LIGHT,
+    MODERATE,
+    STRONG,
+    SEVERE,
+    EXTREME
+};
+
+const char* alertLevelName(AlertLevel level);
+AlertLevel parseAlertLevel(const char* name);
+
 struct EarthquakeEvent {
     float magnitude;
     float pga;
+    AxisPeaks pgaAxes;
     float pgv;
     float cav;
-    unsigned long startTime;
+    uint64_t startTime;
     unsigned long duration;
-    String alertLevel;
+    AlertLevel alertLevel;
     bool confirmed;
 };
 
+enum StaLtaMode {
+    STA_LTA_SLIDING,
+    STA_LTA_RECURSIVE
+};
+
+#define STA_LTA_RATIO_FRACTION_BITS 8
+
+template <typename Energy>
+using BasicEnergyBuffer = RingBuffer<Energy, DETECTOR_BUFFER_CAPACITY>;
+
+typedef BasicEnergyBuffer<float> EnergyBuffer;
+
+template <typename Energy, typename Accumulator>
+class BasicStaLtaEngine {
+public:
+    typedef BasicEnergyBuffer<Energy> Buffer;
+
+    BasicStaLtaEngine(int staWindowSamples, int ltaWindowSamples, StaLtaMode mode);
+    void update(const Buffer& energies);
+    void updateUnbuffered(Energy energy);
+    bool isReady() const;
+    float getSTA() const;
+    float getLTA() const;
+    float getRatio() const;
+    bool ratioExceeds(uint32_t thresholdQ8) const;
+    int getStaWindowSamples() const;
+    int getLtaWindowSamples() const;
+    void seed(const Buffer& energies, Energy background);
+    void reset();
+
+private:
+    int staWindowSamples;
+    int ltaWindowSamples;
+    StaLtaMode mode;
+    float staCoefficient;
+    float ltaCoefficient;
+    int samplesSeen;
+    int samplesSinceResync;
+    Accumulator staSum;
+    Accumulator ltaSum;
+    Accumulator staAverage;
+    Accumulator ltaAverage;
+
+    void updateSliding(const Buffer& energies);
+    void updateRecursive(Energy energy);
+    void resync(const Buffer& energies);
+};
+
+typedef BasicStaLtaEngine<float, float> StaLtaEngine;
+typedef BasicStaLtaEngine<uint32_t, int64_t> FixedStaLtaEngine;
+
+constexpr uint32_t staLtaThresholdQ8(float threshold) {
+    return static_cast<uint32_t>(threshold * (1 << STA_LTA_RATIO_FRACTION_BITS) + 0.5f);
+}
+
+struct DetectorWarmState {
+    uint16_t sampleRate;
+    uint16_t channelCount;
+    uint16_t staWindowSamples[DETECTOR_MAX_CHANNELS];
+    uint16_t ltaWindowSamples[DETECTOR_MAX_CHANNELS];
+    float background[DETECTOR_MAX_CHANNELS];
+};
+
+class PgaTracker {
+public:
+    explicit PgaTracker(int windowSamples);
+    void update(const AccelSample& sample, float magnitude);
+    float getPGA() const;
+    AxisPeaks getAxisPeaks() const;
+    void reset();
+
+private:
+    SlidingWindowMax<PGA_WINDOW_CAPACITY> magnitudePeak;
+    SlidingWindowMax<PGA_WINDOW_CAPACITY> xPeak;
+    SlidingWindowMax<PGA_WINDOW_CAPACITY> yPeak;
+    SlidingWindowMax<PGA_WINDOW_CAPACITY> zPeak;
+};
+
+enum CavMode {
+    CAV_CUMULATIVE,
+    CAV_STANDARDIZED
+};
+
+class CavAccumulator {
+public:
+    CavAccumulator(int sampleRate, CavMode mode);
+    void start();
+    void update(float accelerationG);
+    float getCAV() const;
+    void reset();
+
+private:
+    float dt;
+    CavMode mode;
+    int binSamples;
+    int samplesInBin;
+    float binIntegral;
+    float binPeak;
+    float completedCav;
+
+    float openBinContribution() const;
+};
+
+class ButterworthFilter {
+public:
+    ButterworthFilter(float sampleRate, float lowCutoff, float highCutoff, int order);
+    explicit ButterworthFilter(const BandpassDesign& design);
+    float process(float input);
+    void reset();
+
+private:
+    BandpassDesign design;
+    float z1[FILTER_MAX_SECTIONS];
+    float z2[FILTER_MAX_SECTIONS];
+};
+
+struct DetectorChannelConfig {
+    float staWindowSec;
+    float ltaWindowSec;
+    float triggerThreshold;
+    float detriggerThreshold;
+    StaLtaMode mode;
+    float bandLowHz;
+    float bandHighHz;
+};
+
+constexpr DetectorChannelConfig LOCAL_DETECTOR_CHANNEL = {
+    LOCAL_STA_WINDOW_SEC, LOCAL_LTA_WINDOW_SEC, LOCAL_TRIGGER_THRESHOLD, LOCAL_DETRIGGER_THRESHOLD,
+    STA_LTA_MODE, 0.0f, 0.0f
+};
+
+constexpr DetectorChannelConfig BAND_DETECTOR_CHANNEL = {
+    BAND_STA_WINDOW_SEC, BAND_LTA_WINDOW_SEC, BAND_TRIGGER_THRESHOLD, BAND_DETRIGGER_THRESHOLD,
+    STA_LTA_RECURSIVE, BAND_CHANNEL_LOW_HZ, BAND_CHANNEL_HIGH_HZ
+};
+
+class DetectorChannel {
+public:
+    DetectorChannel();
+    void configure(int sampleRate, const DetectorChannelConfig& config, size_t bufferCapacity);
+    void update(const AccelSample& sample, const EnergyBuffer& energies);
+    bool updateTrigger(uint64_t timestamp);
+    bool isTriggered() const;
+    bool isBanded() const;
+    uint64_t getTriggerTime() const;
+    float getRatio() const;
+    float getNormalizedRatio(float referenceThreshold) const;
+    const StaLtaEngine& getEngine() const;
+    void setThresholds(float trigger, float detrigger);
+    void seed(const EnergyBuffer& energies, float background);
+    void rearm();
+    void reset();
+
+private:
+    StaLtaEngine staLta;
+    float triggerThreshold;
+    float detriggerThreshold;
+    bool banded;
+    ButterworthFilter bandX;
+    ButterworthFilter bandY;
+    ButterworthFilter bandZ;
+    bool triggered;
+    uint64_t triggerTime;
+};
+
 class EarthquakeDetector {
 public:
     EarthquakeDetector(int sampleRate, float staWindowSec, float ltaWindowSec,
-                       float triggerThreshold, float detriggerThreshold);
+                       float triggerThreshold, float detriggerThreshold,
+                       StaLtaMode staLtaMode = STA_LTA_MODE,
+                       CavMode cavMode = CAV_MODE);
 
     void init();
+    bool addChannel(const DetectorChannelConfig& config);
+    void addConfiguredChannels();
+    void setVotesRequired(size_t votes);
+    bool setChannelThresholds(size_t channel, float trigger, float detrigger);
+    size_t getChannelCount() const;
+    float getChannelRatio(size_t channel) const;
+    uint32_t getTriggeredChannels() const;
     void addSample(float ax, float ay, float az);
+    void addSample(const AccelSample& sample);
     bool isTriggered() const;
+    bool hasConfirmedEvent() const;
     EarthquakeEvent getCurrentEvent() const;
+    size_t copyRecentSamples(AccelSample* output, size_t maxSamples) const;
     float getStaLtaRatio() const;
     float getCurrentPGA() const;
+    AxisPeaks getCurrentAxisPeaks() const;
     float getCurrentCAV() const;
+    bool captureWarmState(DetectorWarmState& state) const;
+    bool restoreWarmState(const DetectorWarmState& state);
+    void rearm();
     void reset();
 
     float calculateSTA() const;
     float calculateLTA() const;
     float calculatePGA() const;
     float calculateCAV() const;
-    float calculateMagnitudeEstimate(float pga, float distance) const;
-    String determineAlertLevel(float pga) const;
+    static float calculateMagnitudeEstimate(float pga, float distance);
+    static AlertLevel determineAlertLevel(float pga);
 
 private:
     int sampleRate;
-    int staWindowSamples;
-    int ltaWindowSamples;
     float triggerThreshold;
-    float detriggerThreshold;
 
-    std::vector<AccelSample> sampleBuffer;
+    RingBuffer<AccelSample, DETECTOR_BUFFER_CAPACITY> sampleBuffer;
+    EnergyBuffer energyBuffer;
+    DetectorChannel channels[DETECTOR_MAX_CHANNELS];
+    size_t channelCount;
+    size_t votesRequired;
+    PgaTracker pgaTracker;
+    CavAccumulator cavAccumulator;
     bool triggered;
-    unsigned long triggerTime;
+    uint64_t triggerTime;
     EarthquakeEvent currentEvent;
 
     float applyButterworthFilter(float input);
     float calculateMagnitude(float ax, float ay, float az) const;
-    void updateBuffers(const AccelSample& sample);
-};
-
-class ButterworthFilter {
-public:
-    ButterworthFilter(float sampleRate, float lowCutoff, float highCutoff, int order);
-    float process(float input);
-    void reset();
-
-private:
-    float a[5];
-    float b[5];
-    float x[5];
-    float y[5];
-    int order;
+    float updateBuffers(const AccelSample& sample);
 };
 
 class KalmanFilter {
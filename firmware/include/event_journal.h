@@ -0,0 +1,74 @@
+#ifndef EVENT_JOURNAL_H
+#define EVENT_JOURNAL_H
+
+#include <Arduino.h>
+#include "earthquake_detector.h"
+
+#define JOURNAL_RECORD_MAGIC 0x324A5145UL
+#define JOURNAL_LEGACY_RECORD_MAGIC 0x314A5145UL
+#define JOURNAL_ALERT_LEVEL_LENGTH 12
+#define JOURNAL_DEVICE_ID_LENGTH DEVICE_ID_LENGTH
+
+enum JournalRecordType {
+    JOURNAL_RECORD_EVENT = 1,
+    JOURNAL_RECORD_SENT = 2,
+    JOURNAL_RECORD_SENT_THROUGH = 3
+};
+
+struct JournalRecord {
+    uint32_t magic;
+    uint32_t sequence;
+    uint8_t type;
+    uint8_t confirmed;
+    uint16_t reserved;
+    float magnitude;
+    float pga;
+    float pgaX;
+    float pgaY;
+    float pgaZ;
+    float pgv;
+    float cav;
+    uint64_t startTime;
+    uint32_t duration;
+    char alertLevel[JOURNAL_ALERT_LEVEL_LENGTH];
+    char deviceId[JOURNAL_DEVICE_ID_LENGTH];
+    uint32_t padding;
+    uint32_t crc;
+};
+
+struct LegacyJournalRecord {
+    uint32_t magic;
+    uint32_t sequence;
+    uint8_t type;
+    uint8_t confirmed;
+    uint16_t reserved;
+    float magnitude;
+    float pga;
+    float pgaX;
+    float pgaY;
+    float pgaZ;
+    float pgv;
+    float cav;
+    uint32_t startTime;
+    uint32_t duration;
+    char alertLevel[JOURNAL_ALERT_LEVEL_LENGTH];
+    char deviceId[JOURNAL_DEVICE_ID_LENGTH];
+    uint32_t crc;
+};
+
+static_assert(sizeof(JournalRecord) % 8 == 0, "JournalRecord must stay doubleword aligned");
+static_assert(offsetof(JournalRecord, crc) + sizeof(uint32_t) == sizeof(JournalRecord),
+              "JournalRecord crc must be the last field");
+static_assert(sizeof(LegacyJournalRecord) % 4 == 0, "LegacyJournalRecord must stay word aligned");
+
+uint32_t journalCrc32(const uint8_t* data, size_t length);
+void encodeEventRecord(uint32_t sequence, const EarthquakeEvent& event, const char* deviceId,
+                       JournalRecord& record);
+void encodeSentRecord(uint32_t sequence, JournalRecord& record);
+void encodeSentThroughRecord(uint32_t sequence, JournalRecord& record);
+bool isValidRecord(const JournalRecord& record);
+bool upgradeLegacyRecord(const LegacyJournalRecord& legacy, JournalRecord& record);
+void decodeEventRecord(const JournalRecord& record, EarthquakeEvent& event, char* deviceId,
+                       size_t deviceIdCapacity);
+
+#endif
@@ -3,15 +3,21 @@
 
 #include <Arduino.h>
 #include <SPIFFS.h>
+#include <functional>
 #include <vector>
 #include "earthquake_detector.h"
+#include "config.h"
+#include "event_journal.h"
 
 #define MAX_QUEUE_SIZE 100
-#define QUEUE_FILE "/event_queue.json"
+#define JOURNAL_FILE "/event_queue.log"
+#define JOURNAL_COMPACT_FILE "/event_queue.tmp"
+#define JOURNAL_COMPACT_THRESHOLD (MAX_QUEUE_SIZE * 2)
 
 struct QueuedEvent {
     EarthquakeEvent event;
-    String deviceId;
+    char deviceId[DEVICE_ID_LENGTH + 1];
+    uint32_t sequence;
     bool sent;
 };
 
@@ -19,8 +25,10 @@ class EventQueue {
 public:
     EventQueue();
     bool init();
-    bool addEvent(const EarthquakeEvent& event, const String& deviceId);
+    bool addEvent(const EarthquakeEvent& event, const char* deviceId);
     bool processQueue(std::function<bool(const QueuedEvent&)> sendFunction);
+    bool processBatch(size_t maxBatchSize,
+                      std::function<bool(const QueuedEvent* const* batch, size_t count)> sendFunction);
     int getQueueSize() const;
     int getUnsentCount() const;
     void clearSentEvents();
@@ -28,8 +36,15 @@ public:
 
 private:
     std::vector<QueuedEvent> queue;
-    bool saveToDisk();
+    uint32_t nextSequence;
+    size_t journalRecords;
+    bool journalTorn;
+
+    bool appendRecords(const JournalRecord* records, size_t count);
+    bool compact();
     bool loadFromDisk();
+    void markSent(uint32_t sequence);
+    void markSentThrough(uint32_t sequence);
 };
 
 #endif
@@ -0,0 +1,143 @@
+#ifndef EVENT_RECORDER_H
+#define EVENT_RECORDER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "config.h"
+#include "earthquake_detector.h"
+
+#define CAPTURE_MAGIC 0x50414345UL
+#define CAPTURE_FORMAT_VERSION 2
+#define CAPTURE_FLAG_TRUNCATED 0x01
+#define CAPTURE_FLAG_MANUAL 0x02
+#define CAPTURE_PRE_TRIGGER_SAMPLES (SAMPLE_RATE_HZ * CAPTURE_PRE_TRIGGER_SEC)
+#define CAPTURE_POST_TRIGGER_SAMPLES (SAMPLE_RATE_HZ * CAPTURE_POST_TRIGGER_SEC)
+#define CAPTURE_MAX_SAMPLES (SAMPLE_RATE_HZ * CAPTURE_MAX_SEC)
+
+static_assert(CAPTURE_PRE_TRIGGER_SAMPLES < DETECTOR_BUFFER_CAPACITY,
+              "Pre-trigger capture must fit in the detector sample buffer");
+static_assert(CAPTURE_PRE_TRIGGER_SAMPLES + CAPTURE_POST_TRIGGER_SAMPLES < CAPTURE_MAX_SAMPLES,
+              "Capture must have room beyond the pre- and post-roll");
+
+struct CaptureHeader {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t flags;
+    uint16_t sampleRate;
+    float scale;
+    uint32_t captureId;
+    uint32_t sampleCount;
+    uint32_t preTriggerSamples;
+    uint64_t triggerTime;
+    uint64_t firstTimestamp;
+};
+
+static_assert(sizeof(CaptureHeader) == 40, "CaptureHeader layout is part of the upload format");
+
+enum CaptureState : uint8_t {
+    CAPTURE_IDLE,
+    CAPTURE_RECORDING,
+    CAPTURE_POST_ROLL,
+    CAPTURE_READY
+};
+
+class EventRecorder {
+public:
+    EventRecorder(uint16_t sampleRate, float scale);
+    ~EventRecorder();
+
+    bool begin();
+    template <typename Detector>
+    void addSample(const AccelSample& sample, const Detector& detector);
+    void requestCapture();
+    bool isCapturePending() const;
+    void cancel();
+
+    bool isReady() const;
+    CaptureState getState() const;
+    const CaptureHeader& getHeader() const;
+    const int16_t* getSamples() const;
+    size_t getSampleBytes() const;
+    bool usesPsram() const;
+    void release();
+
+private:
+    template <typename Detector>
+    void start(const Detector& detector, uint64_t triggerTime);
+    void append(const AccelSample& sample);
+    void finish();
+
+    uint16_t sampleRate;
+    float scale;
+    int16_t* samples;
+    bool psram;
+    size_t postRollRemaining;
+    bool capturePending;
+    CaptureHeader header;
+    std::atomic<uint8_t> state;
+    AccelSample preTrigger[CAPTURE_PRE_TRIGGER_SAMPLES];
+};
+
+template <typename Detector>
+void EventRecorder::addSample(const AccelSample& sample, const Detector& detector) {
+    if (samples == nullptr) {
+        return;
+    }
+
+    switch (state.load(std::memory_order_acquire)) {
+        case CAPTURE_IDLE:
+            if (detector.isTriggered()) {
+                start(detector, detector.getCurrentEvent().startTime);
+            } else if (capturePending) {
+                start(detector, sample.timestamp);
+                header.flags |= CAPTURE_FLAG_MANUAL;
+                postRollRemaining = CAPTURE_POST_TRIGGER_SAMPLES;
+                state.store(CAPTURE_POST_ROLL, std::memory_order_relaxed);
+            }
+            capturePending = false;
+            break;
+
+        case CAPTURE_RECORDING:
+            append(sample);
+            if (!detector.isTriggered()) {
+                if (detector.hasConfirmedEvent()) {
+                    postRollRemaining = CAPTURE_POST_TRIGGER_SAMPLES;
+                    state.store(CAPTURE_POST_ROLL, std::memory_order_relaxed);
+                } else {
+                    state.store(CAPTURE_IDLE, std::memory_order_relaxed);
+                }
+            }
+            break;
+
+        case CAPTURE_POST_ROLL:
+            append(sample);
+            if (--postRollRemaining == 0) {
+                finish();
+            }
+            break;
+
+        case CAPTURE_READY:
+            break;
+    }
+}
+
+template <typename Detector>
+void EventRecorder::start(const Detector& detector, uint64_t triggerTime) {
+    memset(&header, 0, sizeof(header));
+    header.magic = CAPTURE_MAGIC;
+    header.version = CAPTURE_FORMAT_VERSION;
+    header.sampleRate = sampleRate;
+    header.scale = scale;
+    header.triggerTime = triggerTime;
+
+    size_t copied = detector.copyRecentSamples(preTrigger, CAPTURE_PRE_TRIGGER_SAMPLES);
+    for (size_t i = 0; i < copied; i++) {
+        append(preTrigger[i]);
+    }
+    header.preTriggerSamples = copied;
+    header.firstTimestamp = copied > 0 ? preTrigger[0].timestamp : header.triggerTime;
+
+    state.store(CAPTURE_RECORDING, std::memory_order_relaxed);
+}
+
+#endif
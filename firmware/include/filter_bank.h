@@ -0,0 +1,117 @@
+#ifndef FILTER_BANK_H
+#define FILTER_BANK_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "earthquake_detector.h"
+#include "butterworth_design.h"
+#include "fixed_point.h"
+
+#define FILTER_BANK_LANES 4
+#define KALMAN_GAIN_SCHEDULE_LENGTH 64
+
+static_assert(FILTER_ORDER >= 1 && FILTER_ORDER <= FILTER_MAX_SECTIONS,
+              "FILTER_ORDER must be between 1 and FILTER_MAX_SECTIONS");
+
+constexpr BandpassDesign FILTER_BANDPASS_DESIGN =
+    designButterworthBandpass(SAMPLE_RATE_HZ, FILTER_LOW_CUTOFF_HZ, FILTER_HIGH_CUTOFF_HZ, FILTER_ORDER);
+
+struct FixedBiquadCoefficients {
+    int32_t b0;
+    int32_t b1;
+    int32_t b2;
+    int32_t a1;
+    int32_t a2;
+};
+
+struct FixedBandpassDesign {
+    FixedBiquadCoefficients sections[FILTER_MAX_SECTIONS];
+    int sectionCount;
+};
+
+struct KalmanGainSchedule {
+    int32_t gains[KALMAN_GAIN_SCHEDULE_LENGTH];
+};
+
+constexpr FixedBandpassDesign toFixedDesign(const BandpassDesign& design) {
+    FixedBandpassDesign fixed = {};
+    fixed.sectionCount = design.sectionCount;
+
+    for (int i = 0; i < design.sectionCount; i++) {
+        const BiquadCoefficients& c = design.sections[i];
+        fixed.sections[i] = {toFixed(c.b0, FIXED_COEFFICIENT_FRACTION_BITS),
+                             toFixed(c.b1, FIXED_COEFFICIENT_FRACTION_BITS),
+                             toFixed(c.b2, FIXED_COEFFICIENT_FRACTION_BITS),
+                             toFixed(c.a1, FIXED_COEFFICIENT_FRACTION_BITS),
+                             toFixed(c.a2, FIXED_COEFFICIENT_FRACTION_BITS)};
+    }
+
+    return fixed;
+}
+
+constexpr KalmanGainSchedule designKalmanGainSchedule(double processNoise, double measurementNoise) {
+    KalmanGainSchedule schedule = {};
+    double errorCovariance = 1.0;
+
+    for (int i = 0; i < KALMAN_GAIN_SCHEDULE_LENGTH; i++) {
+        double predicted = errorCovariance + processNoise;
+        double gain = predicted / (predicted + measurementNoise);
+        errorCovariance = (1.0 - gain) * predicted;
+        schedule.gains[i] = toFixed(gain, FIXED_GAIN_FRACTION_BITS);
+    }
+
+    return schedule;
+}
+
+constexpr FixedBandpassDesign FIXED_BANDPASS_DESIGN = toFixedDesign(FILTER_BANDPASS_DESIGN);
+
+constexpr BandpassDesign LOW_POWER_BANDPASS_DESIGN =
+    designButterworthBandpass(LOW_POWER_SAMPLE_RATE_HZ, FILTER_LOW_CUTOFF_HZ,
+                              std::min(FILTER_HIGH_CUTOFF_HZ, 0.45f * LOW_POWER_SAMPLE_RATE_HZ), FILTER_ORDER);
+constexpr FixedBandpassDesign FIXED_LOW_POWER_BANDPASS_DESIGN = toFixedDesign(LOW_POWER_BANDPASS_DESIGN);
+constexpr KalmanGainSchedule FIXED_KALMAN_GAINS =
+    designKalmanGainSchedule(KALMAN_PROCESS_NOISE, KALMAN_MEASUREMENT_NOISE);
+
+class AxisFilterBank {
+public:
+    explicit AxisFilterBank(const BandpassDesign& design,
+                            float processNoise = 0.01f, float measurementNoise = 0.1f);
+
+    void process(const AccelSample* input, AccelSample* output, size_t count);
+    AccelSample process(const AccelSample& input);
+    void prime(const AccelSample& level);
+    void reset();
+
+private:
+    void step(float* lanes);
+
+    BandpassDesign design;
+    float processNoise;
+    float measurementNoise;
+    float errorCovariance;
+    alignas(16) float z1[FILTER_MAX_SECTIONS][FILTER_BANK_LANES];
+    alignas(16) float z2[FILTER_MAX_SECTIONS][FILTER_BANK_LANES];
+    alignas(16) float estimate[FILTER_BANK_LANES];
+};
+
+class FixedAxisFilterBank {
+public:
+    FixedAxisFilterBank(const FixedBandpassDesign& design, const KalmanGainSchedule& gains);
+
+    void process(const RawAccelSample* input, RawAccelSample* output, size_t count);
+    RawAccelSample process(const RawAccelSample& input);
+    void prime(const RawAccelSample& level);
+    void reset();
+
+private:
+    void step(int32_t* lanes);
+
+    FixedBandpassDesign design;
+    KalmanGainSchedule gains;
+    int gainStep;
+    int32_t z1[FILTER_MAX_SECTIONS][FILTER_BANK_LANES];
+    int32_t z2[FILTER_MAX_SECTIONS][FILTER_BANK_LANES];
+    int32_t estimate[FILTER_BANK_LANES];
+};
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+#include "earthquake_detector.h"
+
+#define FIXED_COEFFICIENT_FRACTION_BITS 28
+#define FIXED_SIGNAL_FRACTION_BITS 8
+#define FIXED_GAIN_FRACTION_BITS 15
+
+struct RawAccelSample {
+    int16_t x;
+    int16_t y;
+    int16_t z;
+    uint64_t timestamp;
+};
+
+constexpr int32_t toFixed(double value, int fractionBits) {
+    double scaled = value * static_cast<double>(1LL << fractionBits);
+    return static_cast<int32_t>(scaled < 0.0 ? scaled - 0.5 : scaled + 0.5);
+}
+
+constexpr int32_t accelerationToCounts(float accelerationG) {
+    return static_cast<int32_t>(accelerationG * ACCEL_COUNTS_PER_G + 0.5f);
+}
+
+inline int16_t saturateInt16(int32_t value) {
+    if (value > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (value < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return static_cast<int16_t>(value);
+}
+
+inline uint32_t isqrt64(uint64_t value) {
+    uint64_t root = 0;
+    uint64_t bit = 1ULL << 62;
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return static_cast<uint32_t>(root);
+}
+
+inline const AccelSample& toAccelSample(const AccelSample& sample) {
+    return sample;
+}
+
+inline AccelSample toAccelSample(const RawAccelSample& raw) {
+    const float metersPerSecondSquaredPerCount = 9.80665f / ACCEL_COUNTS_PER_G;
+
+    AccelSample sample;
+    sample.x = raw.x * metersPerSecondSquaredPerCount;
+    sample.y = raw.y * metersPerSecondSquaredPerCount;
+    sample.z = raw.z * metersPerSecondSquaredPerCount;
+    sample.timestamp = raw.timestamp;
+    return sample;
+}
+
+inline RawAccelSample toRawAccelSample(const AccelSample& sample) {
+    const float countsPerMetersPerSecondSquared = ACCEL_COUNTS_PER_G / 9.80665f;
+
+    RawAccelSample raw;
+    raw.x = saturateInt16(lroundf(sample.x * countsPerMetersPerSecondSquared));
+    raw.y = saturateInt16(lroundf(sample.y * countsPerMetersPerSecondSquared));
+    raw.z = saturateInt16(lroundf(sample.z * countsPerMetersPerSecondSquared));
+    raw.timestamp = sample.timestamp;
+    return raw;
+}
+
+template <typename Sample>
+Sample convertSample(const AccelSample& sample);
+
+template <>
+inline AccelSample convertSample<AccelSample>(const AccelSample& sample) {
+    return sample;
+}
+
+template <>
+inline RawAccelSample convertSample<RawAccelSample>(const AccelSample& sample) {
+    return toRawAccelSample(sample);
+}
+
+#endif
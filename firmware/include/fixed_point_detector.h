@@ -0,0 +1,75 @@
+#ifndef FIXED_POINT_DETECTOR_H
+#define FIXED_POINT_DETECTOR_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "earthquake_detector.h"
+#include "fixed_point.h"
+#include "ring_buffer.h"
+#include "sliding_max.h"
+
+class FixedPointDetector {
+public:
+    FixedPointDetector(int sampleRate, float staWindowSec, float ltaWindowSec,
+                       float triggerThreshold, float detriggerThreshold,
+                       StaLtaMode staLtaMode = STA_LTA_MODE,
+                       CavMode cavMode = CAV_MODE);
+
+    void init();
+    bool setChannelThresholds(size_t channel, float trigger, float detrigger);
+    size_t getChannelCount() const;
+    void addSample(const RawAccelSample& sample);
+    bool isTriggered() const;
+    bool hasConfirmedEvent() const;
+    EarthquakeEvent getCurrentEvent() const;
+    size_t copyRecentSamples(AccelSample* output, size_t maxSamples) const;
+    float getStaLtaRatio() const;
+    float getCurrentPGA() const;
+    AxisPeaks getCurrentAxisPeaks() const;
+    float getCurrentCAV() const;
+    bool captureWarmState(DetectorWarmState& state) const;
+    bool restoreWarmState(const DetectorWarmState& state);
+    void rearm();
+    void reset();
+
+private:
+    int sampleRate;
+    int staWindowSamples;
+    int ltaWindowSamples;
+    uint32_t triggerThresholdQ8;
+    uint32_t detriggerThresholdQ8;
+    CavMode cavMode;
+    int cavBinSamples;
+    int32_t cavThresholdCounts;
+
+    RingBuffer<RawAccelSample, DETECTOR_BUFFER_CAPACITY> sampleBuffer;
+    BasicEnergyBuffer<uint32_t> energyBuffer;
+    FixedStaLtaEngine staLta;
+    SlidingWindowMax<PGA_WINDOW_CAPACITY, int32_t> magnitudePeak;
+    SlidingWindowMax<PGA_WINDOW_CAPACITY, int32_t> xPeak;
+    SlidingWindowMax<PGA_WINDOW_CAPACITY, int32_t> yPeak;
+    SlidingWindowMax<PGA_WINDOW_CAPACITY, int32_t> zPeak;
+
+    bool triggered;
+    bool confirmed;
+    uint64_t triggerTime;
+    unsigned long duration;
+    int32_t eventPeak;
+    int32_t eventPeakX;
+    int32_t eventPeakY;
+    int32_t eventPeakZ;
+    int64_t cavCompleted;
+    int64_t cavBinSum;
+    int32_t cavBinPeak;
+    int cavSamplesInBin;
+    float magnitude;
+    AlertLevel alertLevel;
+
+    int32_t updateBuffers(const RawAccelSample& sample);
+    void updateEvent(int32_t magnitudeCounts);
+    void updateCav(int32_t magnitudeCounts);
+    int64_t cavCounts() const;
+    static float countsToG(int32_t counts);
+};
+
+#endif
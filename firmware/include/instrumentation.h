@@ -0,0 +1,103 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <Arduino.h>
+#include <atomic>
+
+#define METRICS_BUCKET_COUNT 12
+
+enum MetricStage {
+    STAGE_SENSOR_READ,
+    STAGE_FILTER,
+    STAGE_DETECTOR,
+    STAGE_MQTT_LOOP,
+    STAGE_ALERT_BROADCAST,
+    STAGE_COUNT
+};
+
+extern const uint32_t METRICS_BUCKET_BOUNDS_US[METRICS_BUCKET_COUNT - 1];
+
+const char* metricStageName(MetricStage stage);
+
+struct HistogramWindow {
+    uint32_t buckets[METRICS_BUCKET_COUNT];
+    uint32_t count;
+    uint32_t totalMicros;
+    uint32_t maxMicros;
+
+    uint32_t averageMicros() const;
+    uint32_t percentileMicros(float quantile) const;
+};
+
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+    void record(uint32_t micros);
+    void collect(HistogramWindow& window);
+
+private:
+    std::atomic<uint32_t> buckets[METRICS_BUCKET_COUNT];
+    std::atomic<uint32_t> totalMicros;
+    std::atomic<uint32_t> maxMicros;
+    uint32_t collectedBuckets[METRICS_BUCKET_COUNT];
+    uint32_t collectedTotal;
+
+    static size_t bucketFor(uint32_t micros);
+};
+
+struct HeapMetrics {
+    uint32_t freeBytes;
+    uint32_t minFreeBytes;
+    uint32_t largestBlock;
+    uint8_t fragmentation;
+};
+
+struct MetricsReport {
+    HistogramWindow stages[STAGE_COUNT];
+    HistogramWindow jitter;
+    HeapMetrics heap;
+    uint32_t windowMillis;
+    uint32_t samples;
+    uint32_t droppedSamples;
+    uint32_t fifoOverflows;
+    uint32_t queueDrops;
+};
+
+class Instrumentation {
+public:
+    explicit Instrumentation(int sampleRate);
+    void begin();
+
+    static inline uint32_t cycles() {
+        return ESP.getCycleCount();
+    }
+
+    void record(MetricStage stage, uint32_t startCycles);
+    void recordWake(uint32_t nowMicros, uint32_t expectedIntervalMicros);
+    void recordSample(uint64_t timestamp);
+    void collect(MetricsReport& report, uint32_t fifoOverflows, uint32_t queueDrops);
+
+private:
+    LatencyHistogram stages[STAGE_COUNT];
+    LatencyHistogram jitter;
+    uint32_t cyclesPerMicro;
+    uint32_t samplePeriodMicros;
+
+    uint64_t lastSampleTime;
+    uint32_t lastWakeMicros;
+    bool hasSample;
+    bool hasWake;
+
+    std::atomic<uint32_t> samples;
+    std::atomic<uint32_t> droppedSamples;
+
+    uint32_t collectedSamples;
+    uint32_t collectedDropped;
+    uint32_t collectedFifoOverflows;
+    uint32_t collectedQueueDrops;
+    unsigned long lastCollectTime;
+
+    static HeapMetrics sampleHeap();
+};
+
+#endif
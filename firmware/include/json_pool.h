@@ -0,0 +1,115 @@
+#ifndef JSON_POOL_H
+#define JSON_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <ArduinoJson.h>
+
+template <size_t Capacity>
+class StaticJsonPool : public ArduinoJson::Allocator {
+public:
+    StaticJsonPool() : used(0), live(0) {}
+
+    void* allocate(size_t size) override {
+        if (size > Capacity) {
+            return nullptr;
+        }
+
+        size_t blockSize = align(size);
+        if (blockSize > Capacity - HEADER_SIZE || used > Capacity - HEADER_SIZE - blockSize) {
+            return nullptr;
+        }
+
+        uint8_t* block = buffer + used;
+        writeSize(block, blockSize);
+        used += HEADER_SIZE + blockSize;
+        live++;
+        return block + HEADER_SIZE;
+    }
+
+    void deallocate(void* pointer) override {
+        if (pointer == nullptr) {
+            return;
+        }
+
+        uint8_t* block = static_cast<uint8_t*>(pointer) - HEADER_SIZE;
+        if (isLast(block)) {
+            used = block - buffer;
+        }
+        if (--live == 0) {
+            used = 0;
+        }
+    }
+
+    void* reallocate(void* pointer, size_t size) override {
+        if (pointer == nullptr) {
+            return allocate(size);
+        }
+
+        uint8_t* block = static_cast<uint8_t*>(pointer) - HEADER_SIZE;
+        size_t oldSize = readSize(block);
+        if (size > Capacity) {
+            return nullptr;
+        }
+
+        size_t blockSize = align(size);
+        if (isLast(block)) {
+            size_t offset = block - buffer;
+            if (blockSize > Capacity - HEADER_SIZE - offset) {
+                return nullptr;
+            }
+            writeSize(block, blockSize);
+            used = offset + HEADER_SIZE + blockSize;
+            return pointer;
+        }
+
+        if (blockSize <= oldSize) {
+            return pointer;
+        }
+
+        void* moved = allocate(size);
+        if (moved == nullptr) {
+            return nullptr;
+        }
+        memcpy(moved, pointer, oldSize);
+        deallocate(pointer);
+        return moved;
+    }
+
+    size_t getUsed() const {
+        return used;
+    }
+
+    static constexpr size_t capacity() {
+        return Capacity;
+    }
+
+private:
+    static constexpr size_t HEADER_SIZE = 8;
+
+    static size_t align(size_t size) {
+        return (size + HEADER_SIZE - 1) & ~(HEADER_SIZE - 1);
+    }
+
+    static size_t readSize(const uint8_t* block) {
+        uint32_t size;
+        memcpy(&size, block, sizeof(size));
+        return size;
+    }
+
+    static void writeSize(uint8_t* block, size_t size) {
+        uint32_t stored = size;
+        memcpy(block, &stored, sizeof(stored));
+    }
+
+    bool isLast(const uint8_t* block) const {
+        return block + HEADER_SIZE + readSize(block) == buffer + used;
+    }
+
+    alignas(8) uint8_t buffer[Capacity];
+    size_t used;
+    size_t live;
+};
+
+#endif
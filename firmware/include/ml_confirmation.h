@@ -0,0 +1,80 @@
+#ifndef ML_CONFIRMATION_H
+#define ML_CONFIRMATION_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "earthquake_detector.h"
+#include "ml_model_data.h"
+
+enum DeviceFeature {
+    FEATURE_DURATION,
+    FEATURE_PGA,
+    FEATURE_CAV,
+    FEATURE_RMS,
+    FEATURE_CREST_FACTOR,
+    FEATURE_LOG_ENERGY,
+    FEATURE_ZERO_CROSSING_RATE,
+    FEATURE_DOMINANT_FREQUENCY,
+    FEATURE_KURTOSIS,
+    DEVICE_FEATURE_COUNT
+};
+
+static_assert(DEVICE_FEATURE_COUNT == ML_FEATURE_COUNT,
+              "ml_model_data.h was exported for a different feature set");
+
+class DeviceFeatureAccumulator {
+public:
+    explicit DeviceFeatureAccumulator(uint16_t sampleRate);
+
+    void reset();
+    void update(const AccelSample& sample);
+    uint32_t getSampleCount() const;
+    void finalize(float* features) const;
+
+private:
+    float sampleRate;
+    uint32_t count;
+    float peak;
+    double sumMagnitude;
+    double sumMagnitudeSquared;
+    double sumZ;
+    double sumZSquared;
+    double sumZCubed;
+    double sumZFourth;
+    double sumDeltaZSquared;
+    float lastZ;
+    uint32_t zeroCrossings;
+};
+
+class QuantizedClassifier {
+public:
+    float predict(const float* features);
+
+private:
+    int8_t arena[ML_FEATURE_COUNT + ML_HIDDEN_UNITS];
+};
+
+struct MlDecision {
+    bool accepted;
+    bool overBudget;
+    float probability;
+    uint32_t inferenceMicros;
+};
+
+class MlConfirmation {
+public:
+    explicit MlConfirmation(uint16_t sampleRate);
+
+    void update(const AccelSample& sample);
+    void cancel();
+    MlDecision evaluate();
+    uint32_t getOverrunCount() const;
+
+private:
+    DeviceFeatureAccumulator accumulator;
+    QuantizedClassifier classifier;
+    bool active;
+    uint32_t overruns;
+};
+
+#endif
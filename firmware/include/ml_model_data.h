@@ -0,0 +1,53 @@
+#ifndef ML_MODEL_DATA_H
+#define ML_MODEL_DATA_H
+
+#include <stdint.h>
+
+#define ML_MODEL_VERSION 1
+#define ML_FEATURE_COUNT 9
+#define ML_HIDDEN_UNITS 16
+
+constexpr float ML_FEATURE_MEAN[ML_FEATURE_COUNT] = {
+    10.0f, 0.05f, 0.05f, 0.02f, 4.0f, -2.0f, 0.1f, 8.0f, 2.0f
+};
+
+constexpr float ML_FEATURE_INV_STD[ML_FEATURE_COUNT] = {
+    0.125f, 10.0f, 10.0f, 25.0f, 0.5f, 0.3333333333333333f, 10.0f, 0.2f, 0.2f
+};
+
+constexpr float ML_INPUT_SCALE = 0.031496062992125984f;
+
+constexpr int8_t ML_HIDDEN_WEIGHTS[ML_HIDDEN_UNITS * ML_FEATURE_COUNT] = {
+    127, 0, 42, 0, -68, 0, 0, -85, -85,
+    -127, 0, -42, 0, 68, 0, 0, 85, 85,
+    0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+constexpr int32_t ML_HIDDEN_BIAS[ML_HIDDEN_UNITS] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+constexpr int32_t ML_HIDDEN_MULTIPLIER = 1352745605;
+constexpr int ML_HIDDEN_SHIFT = 8;
+
+constexpr int8_t ML_OUTPUT_WEIGHTS[ML_HIDDEN_UNITS] = {
+    127, -127, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+constexpr int32_t ML_OUTPUT_BIAS = 0;
+constexpr float ML_OUTPUT_SCALE = 0.0011904023808047615f;
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef MPU_FIFO_H
+#define MPU_FIFO_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "earthquake_detector.h"
+#include "fixed_point.h"
+#include "timebase.h"
+
+#define MPU_FIFO_TIMESTAMP_SLOTS 256
+
+class MPU6050Fifo {
+public:
+    MPU6050Fifo(TwoWire& wire, uint8_t address);
+    bool begin(int sampleRateHz);
+    uint32_t IRAM_ATTR recordInterrupt();
+    size_t drain(AccelSample* samples, size_t maxSamples);
+    size_t drain(RawAccelSample* samples, size_t maxSamples);
+    bool setSampleRate(int sampleRateHz);
+    bool setLowPassFilter(uint8_t dlpfConfig);
+    bool setMotionWake(bool enabled, uint16_t thresholdMg, uint8_t durationMs);
+    bool takeMotion();
+    int getSampleRate() const;
+    uint32_t getOverflowCount() const;
+
+private:
+    TwoWire& wire;
+    uint8_t address;
+    int sampleRateHz;
+    unsigned long samplePeriodUs;
+    float metersPerSecondSquaredPerCount;
+
+    volatile uint32_t interruptCount;
+    volatile uint64_t interruptMicros[MPU_FIFO_TIMESTAMP_SLOTS];
+    uint32_t samplesDrained;
+    uint64_t lastSampleMicros;
+    uint32_t overflowCount;
+    bool motionWake;
+    bool motionSeen;
+
+    bool writeRegister(uint8_t reg, uint8_t value);
+    bool readRegisters(uint8_t reg, uint8_t* buffer, size_t length);
+    bool updateRegister(uint8_t reg, uint8_t mask, uint8_t value);
+    uint16_t readFifoCount();
+    void resetFifo();
+    uint64_t timestampFor(uint32_t sampleIndex);
+};
+
+#endif
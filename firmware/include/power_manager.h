@@ -0,0 +1,57 @@
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "config.h"
+
+#define LOW_POWER_UPSAMPLE_FACTOR (SAMPLE_RATE_HZ / LOW_POWER_SAMPLE_RATE_HZ)
+
+static_assert(LOW_POWER_SAMPLE_RATE_HZ > 0 && SAMPLE_RATE_HZ % LOW_POWER_SAMPLE_RATE_HZ == 0,
+              "LOW_POWER_SAMPLE_RATE_HZ must divide SAMPLE_RATE_HZ");
+static_assert(LOW_POWER_SAMPLE_RATE_HZ * LOW_POWER_DRAIN_INTERVAL_MS / 1000 <= FIFO_BURST_MAX_SAMPLES,
+              "A low-power drain interval must fit in one FIFO burst");
+
+enum PowerMode : uint8_t {
+    POWER_FULL_RATE,
+    POWER_LOW_RATE
+};
+
+enum WakeReason : uint8_t {
+    WAKE_TIMER,
+    WAKE_INTERRUPT
+};
+
+class PowerManager {
+public:
+    PowerManager(uint8_t wakePin, float wakeRatio, unsigned long holdMillis);
+
+    void begin(bool enabled, unsigned long now);
+    bool isEnabled() const;
+    PowerMode getMode() const;
+    bool isLowPower() const;
+    int getSampleRate() const;
+
+    bool update(float staLtaRatio, bool active, bool motion, unsigned long now);
+    void holdFullRate(unsigned long now);
+    WakeReason sleep(uint32_t timeoutMs);
+
+    void setRadioActive(bool active);
+    bool isRadioActive() const;
+    uint32_t getSleepCount() const;
+    uint32_t getMotionWakeCount() const;
+
+private:
+    uint8_t wakePin;
+    float wakeRatio;
+    unsigned long holdMillis;
+    bool enabled;
+    unsigned long lastActivity;
+
+    std::atomic<uint8_t> mode;
+    std::atomic<bool> radioActive;
+    std::atomic<uint32_t> sleepCount;
+    std::atomic<uint32_t> motionWakeCount;
+};
+
+#endif
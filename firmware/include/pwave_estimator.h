@@ -0,0 +1,71 @@
+#ifndef PWAVE_ESTIMATOR_H
+#define PWAVE_ESTIMATOR_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "earthquake_detector.h"
+
+struct PreliminaryEvent {
+    uint64_t onsetTime;
+    uint64_t issuedTime;
+    float window;
+    uint8_t update;
+    float tauC;
+    float pd;
+    float magnitude;
+    float pga;
+    bool damaging;
+};
+
+struct DcBlocker {
+    float output;
+    float lastInput;
+
+    void reset() {
+        output = 0.0f;
+        lastInput = 0.0f;
+    }
+
+    float process(float input, float pole) {
+        output = pole * (output + input - lastInput);
+        lastInput = input;
+        return output;
+    }
+};
+
+class PWaveEstimator {
+public:
+    PWaveEstimator(int sampleRate, float minWindowSec = PWAVE_MIN_WINDOW_SEC,
+                   float maxWindowSec = PWAVE_MAX_WINDOW_SEC,
+                   float updateIntervalSec = PWAVE_UPDATE_INTERVAL_SEC);
+
+    bool update(const AccelSample& sample, uint64_t now);
+    void cancel();
+    bool isActive() const;
+    PreliminaryEvent getEstimate() const;
+
+    static float magnitudeFromTauC(float tauC);
+
+private:
+    int sampleRate;
+    float dt;
+    float pole;
+    uint32_t minWindowSamples;
+    uint32_t maxWindowSamples;
+    uint32_t updateIntervalSamples;
+
+    bool active;
+    uint32_t count;
+    uint32_t nextIssue;
+    float velocity;
+    float displacement;
+    DcBlocker velocityHighPass;
+    DcBlocker displacementHighPass[2];
+    double sumVelocitySquared;
+    double sumDisplacementSquared;
+    float peakDisplacement;
+    float peakAcceleration;
+    PreliminaryEvent estimate;
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <stddef.h>
+
+template <typename T, size_t Capacity>
+class RingBuffer {
+public:
+    RingBuffer() : head(0), count(0) {}
+
+    void push(const T& item) {
+        buffer[head] = item;
+        head++;
+        if (head == Capacity) {
+            head = 0;
+        }
+        if (count < Capacity) {
+            count++;
+        }
+    }
+
+    const T& operator[](size_t index) const {
+        size_t position = head + Capacity - count + index;
+        if (position >= Capacity) {
+            position -= Capacity;
+        }
+        return buffer[position];
+    }
+
+    const T& newest(size_t age = 0) const {
+        size_t position = head + Capacity - 1 - age;
+        if (position >= Capacity) {
+            position -= Capacity;
+        }
+        return buffer[position];
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    bool full() const {
+        return count == Capacity;
+    }
+
+    static constexpr size_t capacity() {
+        return Capacity;
+    }
+
+    void clear() {
+        head = 0;
+        count = 0;
+    }
+
+private:
+    T buffer[Capacity];
+    size_t head;
+    size_t count;
+};
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef SLIDING_MAX_H
+#define SLIDING_MAX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+template <size_t Capacity, typename T = float>
+class SlidingWindowMax {
+public:
+    SlidingWindowMax() : window(Capacity), front(0), count(0), sequence(0) {}
+
+    void setWindow(size_t samples) {
+        window = (samples == 0) ? 1 : (samples > Capacity ? Capacity : samples);
+        clear();
+    }
+
+    void push(T value) {
+        while (count > 0 && back().value <= value) {
+            count--;
+        }
+
+        while (count > 0 && sequence - entries[front].sequence >= window) {
+            front = wrap(front + 1);
+            count--;
+        }
+
+        Entry& entry = entries[wrap(front + count)];
+        entry.sequence = sequence;
+        entry.value = value;
+        count++;
+        sequence++;
+    }
+
+    T max() const {
+        return (count > 0) ? entries[front].value : T();
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    void clear() {
+        front = 0;
+        count = 0;
+        sequence = 0;
+    }
+
+private:
+    struct Entry {
+        uint32_t sequence;
+        T value;
+    };
+
+    Entry entries[Capacity];
+    size_t window;
+    size_t front;
+    size_t count;
+    uint32_t sequence;
+
+    static size_t wrap(size_t position) {
+        return (position >= Capacity) ? position - Capacity : position;
+    }
+
+    const Entry& back() const {
+        return entries[wrap(front + count - 1)];
+    }
+};
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+template <typename T, size_t Capacity>
+class SpscQueue {
+public:
+    SpscQueue() : head(0), tail(0), dropped(0) {}
+
+    bool push(const T& item) {
+        size_t currentTail = tail.load(std::memory_order_relaxed);
+        size_t nextTail = advance(currentTail);
+
+        if (nextTail == head.load(std::memory_order_acquire)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        slots[currentTail] = item;
+        tail.store(nextTail, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item) {
+        size_t currentHead = head.load(std::memory_order_relaxed);
+
+        if (currentHead == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        item = slots[currentHead];
+        head.store(advance(currentHead), std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+    size_t size() const {
+        size_t currentHead = head.load(std::memory_order_acquire);
+        size_t currentTail = tail.load(std::memory_order_acquire);
+        return (currentTail >= currentHead) ? currentTail - currentHead
+                                            : currentTail + Capacity + 1 - currentHead;
+    }
+
+    uint32_t getDroppedCount() const {
+        return dropped.load(std::memory_order_relaxed);
+    }
+
+    static constexpr size_t capacity() {
+        return Capacity;
+    }
+
+private:
+    T slots[Capacity + 1];
+    std::atomic<size_t> head;
+    std::atomic<size_t> tail;
+    std::atomic<uint32_t> dropped;
+
+    static size_t advance(size_t index) {
+        return (index == Capacity) ? 0 : index + 1;
+    }
+};
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "config.h"
+
+#ifdef ARDUINO
+#include <esp_timer.h>
+
+static inline uint64_t IRAM_ATTR micros64() {
+    return static_cast<uint64_t>(esp_timer_get_time());
+}
+#endif
+
+#define TIMEBASE_UTC_MIN_MICROS 1577836800000000ULL
+
+enum TimeSource : uint8_t {
+    TIME_SOURCE_NONE,
+    TIME_SOURCE_SNTP,
+    TIME_SOURCE_PPS
+};
+
+const char* timeSourceName(TimeSource source);
+uint64_t systemUtcMicros();
+
+static inline bool isUtcMicros(uint64_t micros) {
+    return micros >= TIMEBASE_UTC_MIN_MICROS;
+}
+
+class Timebase {
+public:
+    Timebase();
+
+    void begin(int ppsPin);
+    void update();
+
+    uint64_t toUtcMicros(uint64_t localMicros) const;
+    uint64_t nowMicros() const;
+    bool isSynchronized() const;
+    TimeSource getSource() const;
+    int32_t getLastErrorMicros() const;
+    float getDriftPpm() const;
+    uint32_t getSyncCount() const;
+
+    void recordSntp(uint64_t localMicros, uint64_t utcMicros);
+
+private:
+    struct Mapping {
+        uint64_t anchorLocal;
+        int64_t offset;
+        int32_t driftPpb;
+        TimeSource source;
+    };
+
+    void discipline(uint64_t localMicros, uint64_t utcMicros, TimeSource source);
+    void publish(const Mapping& next);
+    Mapping load() const;
+    static uint64_t apply(const Mapping& mapping, uint64_t localMicros);
+    static void IRAM_ATTR handlePps(void* arg);
+
+    Mapping mapping;
+    std::atomic<uint32_t> sequence;
+    uint64_t lastMeasureLocal;
+    std::atomic<int32_t> lastErrorMicros;
+    std::atomic<uint32_t> syncCount;
+
+    portMUX_TYPE edgeLock = portMUX_INITIALIZER_UNLOCKED;
+    uint32_t sntpCount;
+    uint32_t sntpSeen;
+    uint64_t sntpLocal;
+    uint64_t sntpUtc;
+
+    uint64_t ppsLocal;
+    uint32_t ppsCount;
+    uint32_t ppsSeen;
+    uint64_t lastPpsLocal;
+    int ppsPin;
+};
+
+#endif
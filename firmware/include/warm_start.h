@@ -0,0 +1,64 @@
+#ifndef WARM_START_H
+#define WARM_START_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include "config.h"
+#include "earthquake_detector.h"
+#include "timebase.h"
+
+#define WARM_START_MAGIC 0x4D524157UL
+#define WARM_START_VERSION 2
+#define WARM_START_NAMESPACE "warmstart"
+#define WARM_START_KEY "detector"
+
+struct WarmStartRecord {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t fixedPoint;
+    uint16_t reserved;
+    uint64_t savedAtMicros;
+    uint32_t sequence;
+    DetectorWarmState detector;
+    uint32_t padding;
+    uint32_t crc;
+};
+
+static_assert(sizeof(WarmStartRecord) % 8 == 0, "WarmStartRecord must stay doubleword aligned");
+static_assert(offsetof(WarmStartRecord, crc) + sizeof(uint32_t) == sizeof(WarmStartRecord),
+              "WarmStartRecord crc must be the last field");
+
+enum WarmStartSource {
+    WARM_START_NONE,
+    WARM_START_RTC,
+    WARM_START_FLASH
+};
+
+const char* warmStartSourceName(WarmStartSource source);
+
+class WarmStartStore {
+public:
+    WarmStartStore();
+    bool begin();
+    WarmStartSource load(DetectorWarmState& state, uint64_t nowUtcMicros);
+    bool hasPending() const;
+    WarmStartSource loadPending(DetectorWarmState& state, uint64_t nowUtcMicros);
+    void save(const DetectorWarmState& state, unsigned long now, uint64_t utcMicros);
+    void clear();
+
+    static void encode(uint32_t sequence, const DetectorWarmState& state, uint64_t utcMicros,
+                       WarmStartRecord& record);
+    static bool isValid(const WarmStartRecord& record);
+    static bool isFresh(const WarmStartRecord& record, uint64_t nowUtcMicros, bool persistent);
+
+private:
+    Preferences preferences;
+    bool flashReady;
+    uint32_t sequence;
+    unsigned long lastFlashWrite;
+    bool flashWritten;
+    bool pending;
+    WarmStartRecord pendingRecord;
+};
+
+#endif
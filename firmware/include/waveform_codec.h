@@ -0,0 +1,39 @@
+#ifndef WAVEFORM_CODEC_H
+#define WAVEFORM_CODEC_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "earthquake_detector.h"
+
+#define WAVEFORM_FORMAT_VERSION 2
+#define WAVEFORM_FLAG_DELTA_ZIGZAG 0x01
+#define WAVEFORM_HEADER_SIZE 18
+#define WAVEFORM_AXIS_COUNT 3
+#define WAVEFORM_MAX_VARINT_BYTES 3
+#define WAVEFORM_MAX_PAYLOAD_SIZE \
+    (WAVEFORM_HEADER_SIZE + WAVEFORM_AXIS_COUNT * WAVEFORM_BLOCK_SAMPLES * WAVEFORM_MAX_VARINT_BYTES)
+
+int16_t quantizeCounts(float value, float scale);
+
+class WaveformBlockEncoder {
+public:
+    WaveformBlockEncoder(uint16_t sampleRate, float scale);
+
+    bool add(const AccelSample& sample);
+    bool full() const;
+    bool empty() const;
+    bool isContinuous(const AccelSample& sample) const;
+    size_t getSampleCount() const;
+    size_t encode(uint8_t* output, size_t capacity) const;
+    void reset();
+
+private:
+    uint16_t sampleRate;
+    float scale;
+    uint64_t baseTimestamp;
+    uint64_t lastTimestamp;
+    size_t sampleCount;
+    int16_t counts[WAVEFORM_AXIS_COUNT][WAVEFORM_BLOCK_SAMPLES];
+};
+
+#endif
@@ -1,13 +1,16 @@
 #include "alert_system.h"
 #include "config.h"
-#include <ArduinoJson.h>
 
 LocalAlertSystem::LocalAlertSystem(int buzzerPin, int redLedPin, int yellowLedPin, int greenLedPin)
     : buzzerPin(buzzerPin),
       redLedPin(redLedPin),
       yellowLedPin(yellowLedPin),
       greenLedPin(greenLedPin),
-      buzzerChannel(0) {}
+      buzzerChannel(0),
+      pattern(BUZZER_IDLE),
+      patternStartTime(0),
+      toneDurationMs(0),
+      sirenStep(-1) {}
 
 void LocalAlertSystem::init() {
     pinMode(redLedPin, OUTPUT);
@@ -22,58 +25,134 @@ void LocalAlertSystem::init() {
     digitalWrite(redLedPin, LOW);
 }
 
-void LocalAlertSystem::setAlertLevel(const String& level) {
+void LocalAlertSystem::setAlertLevel(AlertLevel level) {
     digitalWrite(redLedPin, LOW);
     digitalWrite(yellowLedPin, LOW);
     digitalWrite(greenLedPin, LOW);
 
-    if (level == "EXTREME" || level == "SEVERE" || level == "STRONG") {
-        digitalWrite(redLedPin, HIGH);
-        sirenPattern();
-    } else if (level == "MODERATE") {
-        digitalWrite(yellowLedPin, HIGH);
-        soundAlarm(1500, 500);
-    } else if (level == "LIGHT") {
-        digitalWrite(yellowLedPin, HIGH);
-        soundAlarm(1000, 300);
-    } else {
-        digitalWrite(greenLedPin, HIGH);
+    switch (level) {
+        case AlertLevel::EXTREME:
+        case AlertLevel::SEVERE:
+        case AlertLevel::STRONG:
+            digitalWrite(redLedPin, HIGH);
+            sirenPattern();
+            break;
+        case AlertLevel::MODERATE:
+            digitalWrite(yellowLedPin, HIGH);
+            soundAlarm(1500, 500);
+            break;
+        case AlertLevel::LIGHT:
+            digitalWrite(yellowLedPin, HIGH);
+            soundAlarm(1000, 300);
+            break;
+        default:
+            digitalWrite(greenLedPin, HIGH);
+            break;
     }
 }
 
-void LocalAlertSystem::displayStatus(const String& status) {
-    Serial.println("Status: " + status);
+void LocalAlertSystem::displayStatus(const char* status) {
+    Serial.printf("Status: %s\n", status);
 }
 
 void LocalAlertSystem::soundAlarm(int frequency, int durationMs) {
+    pattern = BUZZER_TONE;
+    patternStartTime = millis();
+    toneDurationMs = durationMs;
     ledcWriteTone(buzzerChannel, frequency);
-    delay(durationMs);
-    ledcWriteTone(buzzerChannel, 0);
 }
 
 void LocalAlertSystem::sirenPattern() {
-    for (int i = 0; i < 3; i++) {
-        for (int freq = 800; freq <= 2000; freq += 100) {
-            ledcWriteTone(buzzerChannel, freq);
-            delay(30);
+    pattern = BUZZER_SIREN;
+    patternStartTime = millis();
+    sirenStep = 0;
+    ledcWriteTone(buzzerChannel, sirenFrequency(0));
+}
+
+void LocalAlertSystem::stopAlarm() {
+    pattern = BUZZER_IDLE;
+    sirenStep = -1;
+    ledcWriteTone(buzzerChannel, 0);
+}
+
+void LocalAlertSystem::update() {
+    if (pattern == BUZZER_IDLE) {
+        return;
+    }
+
+    unsigned long elapsed = millis() - patternStartTime;
+
+    if (pattern == BUZZER_TONE) {
+        if (elapsed >= toneDurationMs) {
+            stopAlarm();
         }
-        for (int freq = 2000; freq >= 800; freq -= 100) {
-            ledcWriteTone(buzzerChannel, freq);
-            delay(30);
+        return;
+    }
+
+    int stepsPerRamp = (SIREN_MAX_FREQUENCY_HZ - SIREN_MIN_FREQUENCY_HZ) / SIREN_FREQUENCY_STEP_HZ + 1;
+    int totalSteps = SIREN_CYCLES * stepsPerRamp * 2;
+    int step = static_cast<int>(elapsed / SIREN_STEP_MS);
+
+    if (step >= totalSteps) {
+        stopAlarm();
+    } else if (step != sirenStep) {
+        sirenStep = step;
+        ledcWriteTone(buzzerChannel, sirenFrequency(step));
+    }
+}
+
+bool LocalAlertSystem::isSounding() const {
+    return pattern != BUZZER_IDLE;
+}
+
+int LocalAlertSystem::sirenFrequency(int step) const {
+    int stepsPerRamp = (SIREN_MAX_FREQUENCY_HZ - SIREN_MIN_FREQUENCY_HZ) / SIREN_FREQUENCY_STEP_HZ + 1;
+    int cycleStep = step % (stepsPerRamp * 2);
+
+    if (cycleStep < stepsPerRamp) {
+        return SIREN_MIN_FREQUENCY_HZ + cycleStep * SIREN_FREQUENCY_STEP_HZ;
+    }
+    return SIREN_MAX_FREQUENCY_HZ - (cycleStep - stepsPerRamp) * SIREN_FREQUENCY_STEP_HZ;
+}
+
+MqttPublishWriter::MqttPublishWriter(PubSubClient& client) : client(client), pending(0), failed(false) {}
+
+size_t MqttPublishWriter::write(uint8_t byte) {
+    return write(&byte, 1);
+}
+
+size_t MqttPublishWriter::write(const uint8_t* data, size_t length) {
+    size_t accepted = 0;
+
+    while (accepted < length) {
+        if (pending == sizeof(buffer) && !drain()) {
+            break;
         }
+
+        size_t count = std::min(length - accepted, sizeof(buffer) - pending);
+        memcpy(buffer + pending, data + accepted, count);
+        pending += count;
+        accepted += count;
     }
-    ledcWriteTone(buzzerChannel, 0);
+
+    return accepted;
 }
 
-void LocalAlertSystem::stopAlarm() {
-    ledcWriteTone(buzzerChannel, 0);
+bool MqttPublishWriter::drain() {
+    if (pending > 0 && !failed) {
+        failed = client.write(buffer, pending) != pending;
+    }
+    pending = 0;
+    return !failed;
 }
 
 MQTTAlertSystem::MQTTAlertSystem(const char* server, int port, const char* user, const char* password)
-    : server(server), port(port), user(user), password(password), mqttClient(wifiClient) {}
+    : server(server), port(port), user(user), password(password), mqttClient(wifiClient),
+      document(&jsonPool), timebase(nullptr) {}
 
 void MQTTAlertSystem::init() {
     mqttClient.setServer(server, port);
+    mqttClient.setBufferSize(MQTT_BUFFER_SIZE);
 }
 
 bool MQTTAlertSystem::connect(const char* clientId) {
@@ -108,197 +187,525 @@ void MQTTAlertSystem::loop() {
     mqttClient.loop();
 }
 
-bool MQTTAlertSystem::publishAlert(const EarthquakeEvent& event, const String& deviceId) {
-    StaticJsonDocument<512> doc;
+static void addStartTime(JsonObject event, uint64_t startTime, bool synced) {
+    if (isUtcMicros(startTime) != synced) {
+        return;
+    }
+
+    event["start_time"] = startTime / 1000ULL;
+    if (synced) {
+        event["start_time_us"] = startTime;
+    }
+}
+
+bool MQTTAlertSystem::addTimestamp() {
+    uint64_t now = timebase != nullptr ? timebase->nowMicros() : micros64();
+    bool synced = isUtcMicros(now);
 
-    doc["device_id"] = deviceId;
-    doc["timestamp"] = millis();
-    doc["event"]["magnitude"] = event.magnitude;
-    doc["event"]["pga"] = event.pga;
-    doc["event"]["pgv"] = event.pgv;
-    doc["event"]["cav"] = event.cav;
-    doc["event"]["duration"] = event.duration;
-    doc["event"]["alert_level"] = event.alertLevel;
-    doc["event"]["confirmed"] = event.confirmed;
-    doc["location"]["lat"] = DEVICE_LATITUDE;
-    doc["location"]["lon"] = DEVICE_LONGITUDE;
+    document["timestamp"] = now / 1000ULL;
+    document["clock_synced"] = synced;
+    if (synced) {
+        document["timestamp_us"] = now;
+    }
+    return synced;
+}
+
+bool MQTTAlertSystem::publishAlert(const EarthquakeEvent& event, const char* deviceId) {
+    document.clear();
+
+    document["device_id"] = deviceId;
+    bool synced = addTimestamp();
+    document["event"]["magnitude"] = event.magnitude;
+    document["event"]["pga"] = event.pga;
+    document["event"]["pgv"] = event.pgv;
+    document["event"]["cav"] = event.cav;
+    addStartTime(document["event"].as<JsonObject>(), event.startTime, synced);
+    document["event"]["duration"] = event.duration;
+    document["event"]["alert_level"] = alertLevelName(event.alertLevel);
+    document["event"]["confirmed"] = event.confirmed;
+    document["location"]["lat"] = DEVICE_LATITUDE;
+    document["location"]["lon"] = DEVICE_LONGITUDE;
+
+    return publishDocument(MQTT_TOPIC_ALERT, true);
+}
 
-    char buffer[512];
-    serializeJson(doc, buffer);
+bool MQTTAlertSystem::publishAlertBatch(const EarthquakeEvent* const* events, size_t count,
+                                        const char* deviceId) {
+    document.clear();
+
+    document["device_id"] = deviceId;
+    bool synced = addTimestamp();
+    document["location"]["lat"] = DEVICE_LATITUDE;
+    document["location"]["lon"] = DEVICE_LONGITUDE;
+
+    JsonArray batch = document["events"].to<JsonArray>();
+    for (size_t i = 0; i < count; i++) {
+        const EarthquakeEvent& event = *events[i];
+        JsonObject e = batch.add<JsonObject>();
+        e["magnitude"] = event.magnitude;
+        e["pga"] = event.pga;
+        e["pgv"] = event.pgv;
+        e["cav"] = event.cav;
+        addStartTime(e, event.startTime, synced);
+        e["duration"] = event.duration;
+        e["alert_level"] = alertLevelName(event.alertLevel);
+        e["confirmed"] = event.confirmed;
+    }
 
-    return mqttClient.publish(MQTT_TOPIC_ALERT, buffer, true);
+    return publishDocument(MQTT_TOPIC_ALERT_BATCH, false);
 }
 
-bool MQTTAlertSystem::publishData(float ax, float ay, float az, const String& deviceId) {
-    StaticJsonDocument<256> doc;
+bool MQTTAlertSystem::publishPreliminaryAlert(const PreliminaryEvent& event, const char* deviceId) {
+    document.clear();
 
-    doc["device_id"] = deviceId;
-    doc["timestamp"] = millis();
-    doc["acceleration"]["x"] = ax;
-    doc["acceleration"]["y"] = ay;
-    doc["acceleration"]["z"] = az;
+    document["device_id"] = deviceId;
+    bool synced = addTimestamp();
+    document["onset_time"] = event.onsetTime / 1000ULL;
+    if (synced && isUtcMicros(event.onsetTime)) {
+        document["onset_time_us"] = event.onsetTime;
+    }
+    document["latency_ms"] = (event.issuedTime - event.onsetTime) / 1000ULL;
+    document["window"] = event.window;
+    document["update"] = event.update;
+    document["tau_c"] = event.tauC;
+    document["pd"] = event.pd;
+    document["magnitude_estimate"] = event.magnitude;
+    document["pga"] = event.pga;
+    document["alert_level"] = alertLevelName(EarthquakeDetector::determineAlertLevel(event.pga));
+    document["damaging"] = event.damaging;
+    document["location"]["lat"] = DEVICE_LATITUDE;
+    document["location"]["lon"] = DEVICE_LONGITUDE;
+
+    return publishDocument(MQTT_TOPIC_ALERT_PRELIMINARY, false);
+}
 
-    char buffer[256];
-    serializeJson(doc, buffer);
+bool MQTTAlertSystem::publishData(float ax, float ay, float az, const char* deviceId) {
+    document.clear();
 
-    return mqttClient.publish(MQTT_TOPIC_DATA, buffer);
+    document["device_id"] = deviceId;
+    addTimestamp();
+    document["acceleration"]["x"] = ax;
+    document["acceleration"]["y"] = ay;
+    document["acceleration"]["z"] = az;
+
+    return publishDocument(MQTT_TOPIC_DATA, false);
 }
 
-bool MQTTAlertSystem::publishStatus(const String& status, const String& deviceId) {
-    StaticJsonDocument<128> doc;
+bool MQTTAlertSystem::publishWaveform(const uint8_t* payload, size_t length, const char* deviceId) {
+    return publishDeviceTopic(MQTT_TOPIC_WAVEFORM, payload, length, deviceId);
+}
 
-    doc["device_id"] = deviceId;
-    doc["status"] = status;
-    doc["timestamp"] = millis();
+bool MQTTAlertSystem::publishCapture(const uint8_t* payload, size_t length, const char* deviceId) {
+    return publishDeviceTopic(MQTT_TOPIC_CAPTURE, payload, length, deviceId);
+}
 
-    char buffer[128];
-    serializeJson(doc, buffer);
+bool MQTTAlertSystem::publishDeviceTopic(const char* baseTopic, const uint8_t* payload, size_t length,
+                                         const char* deviceId) {
+    char topic[MQTT_TOPIC_MAX_LENGTH];
+    int topicLength = snprintf(topic, sizeof(topic), "%s/%s", baseTopic, deviceId);
+    if (topicLength <= 0 || topicLength >= static_cast<int>(sizeof(topic))) {
+        return false;
+    }
 
-    return mqttClient.publish(MQTT_TOPIC_STATUS, buffer, true);
+    if (!mqttClient.beginPublish(topic, length, false)) {
+        return false;
+    }
+
+    size_t written = mqttClient.write(payload, length);
+    return mqttClient.endPublish() && written == length;
+}
+
+bool MQTTAlertSystem::publishDocument(const char* topic, bool retained) {
+    if (document.overflowed()) {
+        return false;
+    }
+
+    size_t length = measureJson(document);
+    if (!mqttClient.beginPublish(topic, length, retained)) {
+        return false;
+    }
+
+    MqttPublishWriter writer(mqttClient);
+    size_t written = serializeJson(document, writer);
+    bool sent = writer.drain();
+    return mqttClient.endPublish() && sent && written == length;
+}
+
+static void addHistogram(JsonObject histogram, const HistogramWindow& window) {
+    histogram["n"] = window.count;
+    histogram["avg"] = window.averageMicros();
+    histogram["p50"] = window.percentileMicros(0.5f);
+    histogram["p99"] = window.percentileMicros(0.99f);
+    histogram["max"] = window.maxMicros;
+
+    JsonArray buckets = histogram["h"].to<JsonArray>();
+    for (size_t i = 0; i < METRICS_BUCKET_COUNT; i++) {
+        buckets.add(window.buckets[i]);
+    }
+}
+
+void MQTTAlertSystem::addMetrics(const MetricsReport& metrics) {
+    JsonObject root = document["metrics"].to<JsonObject>();
+    root["window_ms"] = metrics.windowMillis;
+    root["samples"] = metrics.samples;
+    root["dropped"] = metrics.droppedSamples;
+    root["fifo_overflows"] = metrics.fifoOverflows;
+    root["queue_drops"] = metrics.queueDrops;
+
+    JsonObject heap = root["heap"].to<JsonObject>();
+    heap["free"] = metrics.heap.freeBytes;
+    heap["min_free"] = metrics.heap.minFreeBytes;
+    heap["largest"] = metrics.heap.largestBlock;
+    heap["frag"] = metrics.heap.fragmentation;
+
+    JsonArray bounds = root["bounds_us"].to<JsonArray>();
+    for (size_t i = 0; i < METRICS_BUCKET_COUNT - 1; i++) {
+        bounds.add(METRICS_BUCKET_BOUNDS_US[i]);
+    }
+
+    JsonObject stages = root["stages"].to<JsonObject>();
+    for (size_t i = 0; i < STAGE_COUNT; i++) {
+        addHistogram(stages[metricStageName(static_cast<MetricStage>(i))].to<JsonObject>(), metrics.stages[i]);
+    }
+    addHistogram(root["jitter"].to<JsonObject>(), metrics.jitter);
+}
+
+bool MQTTAlertSystem::publishStatus(const char* status, const char* deviceId, const MetricsReport* metrics) {
+    document.clear();
+
+    document["device_id"] = deviceId;
+    document["status"] = status;
+    addTimestamp();
+    document["location"]["lat"] = DEVICE_LATITUDE;
+    document["location"]["lon"] = DEVICE_LONGITUDE;
+
+    if (timebase != nullptr) {
+        JsonObject clock = document["clock"].to<JsonObject>();
+        clock["source"] = timeSourceName(timebase->getSource());
+        clock["drift_ppm"] = timebase->getDriftPpm();
+        clock["error_us"] = timebase->getLastErrorMicros();
+        clock["syncs"] = timebase->getSyncCount();
+    }
+
+    if (metrics != nullptr) {
+        addMetrics(*metrics);
+    }
+
+    return publishDocument(MQTT_TOPIC_STATUS, true);
+}
+
+bool MQTTAlertSystem::publishCommandResult(const CommandResult& result, const char* deviceId) {
+    document.clear();
+
+    document["device_id"] = deviceId;
+    document["command"] = result.name;
+    document["status"] = commandStatusName(result.status);
+    addTimestamp();
+
+    return publishDocument(MQTT_TOPIC_COMMAND_ACK, false);
+}
+
+bool MQTTAlertSystem::subscribeCommands(const char* deviceId) {
+    char deviceTopic[MQTT_TOPIC_MAX_LENGTH];
+    char broadcastTopic[MQTT_TOPIC_MAX_LENGTH];
+    snprintf(deviceTopic, sizeof(deviceTopic), "%s/%s", MQTT_TOPIC_COMMAND, deviceId);
+    snprintf(broadcastTopic, sizeof(broadcastTopic), "%s/%s", MQTT_TOPIC_COMMAND, MQTT_COMMAND_BROADCAST_ID);
+
+    bool subscribed = mqttClient.subscribe(deviceTopic) && mqttClient.subscribe(broadcastTopic);
+
+    if (!subscribed) {
+        Serial.println("MQTT command subscription failed");
+    }
+    return subscribed;
 }
 
 void MQTTAlertSystem::setCallback(MQTT_CALLBACK_SIGNATURE) {
     mqttClient.setCallback(callback);
 }
 
-WebhookAlertSystem::WebhookAlertSystem() {}
+void MQTTAlertSystem::setTimebase(const Timebase* source) {
+    timebase = source;
+}
+
+WebhookAlertSystem::WebhookAlertSystem()
+    : pushoverToken(""),
+      pushoverUser(""),
+      telegramBotToken(""),
+      telegramChatId(""),
+      discordWebhookUrl("") {
+    for (int i = 0; i < WEBHOOK_SERVICE_COUNT; i++) {
+        workers[i].owner = this;
+        workers[i].service = static_cast<WebhookService>(i);
+        workers[i].jobs = nullptr;
+        workers[i].task = nullptr;
+    }
+}
 
-void WebhookAlertSystem::setPushoverCredentials(const String& token, const String& user) {
+void WebhookAlertSystem::setPushoverCredentials(const char* token, const char* user) {
     pushoverToken = token;
     pushoverUser = user;
 }
 
-void WebhookAlertSystem::setTelegramCredentials(const String& botToken, const String& chatId) {
+void WebhookAlertSystem::setTelegramCredentials(const char* botToken, const char* chatId) {
     telegramBotToken = botToken;
     telegramChatId = chatId;
 }
 
-void WebhookAlertSystem::setDiscordWebhook(const String& webhookUrl) {
+void WebhookAlertSystem::setDiscordWebhook(const char* webhookUrl) {
     discordWebhookUrl = webhookUrl;
 }
 
-String WebhookAlertSystem::urlEncode(const String& str) {
-    String encoded = "";
-    char c;
-    char code0;
-    char code1;
+bool WebhookAlertSystem::begin() {
+    static const char* const taskNames[WEBHOOK_SERVICE_COUNT] = {
+        "pushover", "telegram", "discord"
+    };
 
-    for (int i = 0; i < str.length(); i++) {
-        c = str.charAt(i);
-        if (c == ' ') {
-            encoded += '+';
-        } else if (isalnum(c)) {
-            encoded += c;
-        } else {
-            code1 = (c & 0xf) + '0';
-            if ((c & 0xf) > 9) {
-                code1 = (c & 0xf) - 10 + 'A';
-            }
-            c = (c >> 4) & 0xf;
-            code0 = c + '0';
-            if (c > 9) {
-                code0 = c - 10 + 'A';
-            }
-            encoded += '%';
-            encoded += code0;
-            encoded += code1;
+    bool started = true;
+
+    for (int i = 0; i < WEBHOOK_SERVICE_COUNT; i++) {
+        ServiceWorker& worker = workers[i];
+        if (!isConfigured(worker.service) || worker.task != nullptr) {
+            continue;
+        }
+
+        worker.client.setInsecure();
+        worker.http.setReuse(true);
+        worker.http.setTimeout(WEBHOOK_HTTP_TIMEOUT_MS);
+        worker.http.setConnectTimeout(WEBHOOK_HTTP_TIMEOUT_MS);
+
+        worker.jobs = xQueueCreate(WEBHOOK_QUEUE_DEPTH, sizeof(WebhookJob));
+        if (worker.jobs == nullptr ||
+            xTaskCreatePinnedToCore(workerTask, taskNames[i], WEBHOOK_TASK_STACK_SIZE, &worker,
+                                    WEBHOOK_TASK_PRIORITY, &worker.task, WEBHOOK_TASK_CORE) != pdPASS) {
+            Serial.printf("Failed to start %s webhook worker\n", taskNames[i]);
+            started = false;
         }
     }
 
-    return encoded;
+    return started;
+}
+
+bool WebhookAlertSystem::isConfigured(WebhookService service) const {
+    switch (service) {
+        case WEBHOOK_PUSHOVER:
+            return pushoverToken[0] != '\0' && pushoverUser[0] != '\0';
+        case WEBHOOK_TELEGRAM:
+            return telegramBotToken[0] != '\0' && telegramChatId[0] != '\0';
+        case WEBHOOK_DISCORD:
+            return discordWebhookUrl[0] != '\0';
+        default:
+            return false;
+    }
 }
 
-bool WebhookAlertSystem::sendPushover(const String& title, const String& message, int priority) {
-    if (pushoverToken.length() == 0 || pushoverUser.length() == 0) {
+bool WebhookAlertSystem::enqueue(WebhookService service, const char* title,
+                                 const char* message, int priority) {
+    ServiceWorker& worker = workers[service];
+    if (worker.jobs == nullptr) {
         return false;
     }
 
-    HTTPClient http;
-    http.begin("https://api.pushover.net/1/messages.json");
-    http.addHeader("Content-Type", "application/x-www-form-urlencoded");
+    WebhookJob job;
+    strncpy(job.title, title, sizeof(job.title) - 1);
+    job.title[sizeof(job.title) - 1] = '\0';
+    strncpy(job.message, message, sizeof(job.message) - 1);
+    job.message[sizeof(job.message) - 1] = '\0';
+    job.priority = priority;
 
-    String payload = "token=" + pushoverToken +
-                     "&user=" + pushoverUser +
-                     "&title=" + urlEncode(title) +
-                     "&message=" + urlEncode(message) +
-                     "&priority=" + String(priority) +
-                     "&sound=siren";
+    return xQueueSend(worker.jobs, &job, 0) == pdTRUE;
+}
 
-    int httpCode = http.POST(payload);
-    http.end();
+void WebhookAlertSystem::workerTask(void* parameter) {
+    ServiceWorker* worker = static_cast<ServiceWorker*>(parameter);
+    WebhookJob job;
 
-    return httpCode == 200;
+    for (;;) {
+        if (xQueueReceive(worker->jobs, &job, portMAX_DELAY) == pdTRUE) {
+            worker->owner->deliver(*worker, job);
+        }
+    }
 }
 
-bool WebhookAlertSystem::sendTelegram(const String& message) {
-    if (telegramBotToken.length() == 0 || telegramChatId.length() == 0) {
-        return false;
+bool WebhookAlertSystem::deliver(ServiceWorker& worker, const WebhookJob& job) {
+    unsigned long backoffMs = WEBHOOK_RETRY_BASE_DELAY_MS;
+
+    for (int attempt = 1; attempt <= WEBHOOK_MAX_ATTEMPTS; attempt++) {
+        int httpCode = post(worker, job);
+
+        if (httpCode >= 200 && httpCode < 300) {
+            return true;
+        }
+
+        bool retryable = httpCode <= 0 || httpCode == 429 || httpCode >= 500;
+        if (!retryable || attempt == WEBHOOK_MAX_ATTEMPTS) {
+            Serial.printf("Webhook %d failed with code %d after %d attempts\n",
+                          worker.service, httpCode, attempt);
+            return false;
+        }
+
+        worker.client.stop();
+        vTaskDelay(pdMS_TO_TICKS(backoffMs));
+        backoffMs *= 2;
     }
 
-    HTTPClient http;
-    String url = "https://api.telegram.org/bot" + telegramBotToken + "/sendMessage";
+    return false;
+}
 
-    http.begin(url);
-    http.addHeader("Content-Type", "application/json");
+int WebhookAlertSystem::post(ServiceWorker& worker, const WebhookJob& job) {
+    switch (worker.service) {
+        case WEBHOOK_PUSHOVER:
+            return postPushover(worker, job);
+        case WEBHOOK_TELEGRAM:
+            return postTelegram(worker, job);
+        case WEBHOOK_DISCORD:
+            return postDiscord(worker, job);
+        default:
+            return -1;
+    }
+}
 
-    StaticJsonDocument<512> doc;
-    doc["chat_id"] = telegramChatId;
-    doc["text"] = message;
-    doc["parse_mode"] = "Markdown";
+size_t WebhookAlertSystem::urlEncode(const char* input, char* output, size_t capacity) {
+    static const char hex[] = "0123456789ABCDEF";
+    size_t length = 0;
 
-    String payload;
-    serializeJson(doc, payload);
+    for (; *input != '\0'; input++) {
+        unsigned char c = static_cast<unsigned char>(*input);
+        size_t needed = (c == ' ' || isalnum(c)) ? 1 : 3;
+        if (length + needed >= capacity) {
+            break;
+        }
 
-    int httpCode = http.POST(payload);
-    http.end();
+        if (c == ' ') {
+            output[length++] = '+';
+        } else if (isalnum(c)) {
+            output[length++] = static_cast<char>(c);
+        } else {
+            output[length++] = '%';
+            output[length++] = hex[c >> 4];
+            output[length++] = hex[c & 0xF];
+        }
+    }
 
-    return httpCode == 200;
+    output[length] = '\0';
+    return length;
 }
 
-bool WebhookAlertSystem::sendDiscord(const String& message) {
-    if (discordWebhookUrl.length() == 0) {
-        return false;
+bool WebhookAlertSystem::sendPushover(const char* title, const char* message, int priority) {
+    return enqueue(WEBHOOK_PUSHOVER, title, message, priority);
+}
+
+bool WebhookAlertSystem::sendTelegram(const char* message) {
+    return enqueue(WEBHOOK_TELEGRAM, "", message, 0);
+}
+
+bool WebhookAlertSystem::sendDiscord(const char* message) {
+    return enqueue(WEBHOOK_DISCORD, "", message, 0);
+}
+
+int WebhookAlertSystem::postPushover(ServiceWorker& worker, const WebhookJob& job) {
+    char title[WEBHOOK_TITLE_LENGTH * 3];
+    char message[WEBHOOK_MESSAGE_LENGTH * 3];
+    urlEncode(job.title, title, sizeof(title));
+    urlEncode(job.message, message, sizeof(message));
+
+    char payload[WEBHOOK_PAYLOAD_LENGTH];
+    int length = snprintf(payload, sizeof(payload),
+                          "token=%s&user=%s&title=%s&message=%s&priority=%d&sound=siren",
+                          pushoverToken, pushoverUser, title, message, job.priority);
+    if (length <= 0 || length >= static_cast<int>(sizeof(payload))) {
+        return -1;
+    }
+
+    worker.http.begin(worker.client, "https://api.pushover.net/1/messages.json");
+    worker.http.addHeader("Content-Type", "application/x-www-form-urlencoded");
+
+    int httpCode = worker.http.POST(reinterpret_cast<uint8_t*>(payload), length);
+    worker.http.end();
+
+    return httpCode;
+}
+
+int WebhookAlertSystem::postTelegram(ServiceWorker& worker, const WebhookJob& job) {
+    char url[WEBHOOK_URL_LENGTH];
+    int urlLength = snprintf(url, sizeof(url), "https://api.telegram.org/bot%s/sendMessage", telegramBotToken);
+    if (urlLength <= 0 || urlLength >= static_cast<int>(sizeof(url))) {
+        return -1;
+    }
+
+    JsonDocument doc(&worker.jsonPool);
+    doc["chat_id"] = telegramChatId;
+    doc["text"] = job.message;
+    doc["parse_mode"] = "Markdown";
+
+    if (doc.overflowed()) {
+        return -1;
+    }
+
+    char payload[WEBHOOK_PAYLOAD_LENGTH];
+    size_t length = serializeJson(doc, payload, sizeof(payload));
+    if (length == 0 || length >= sizeof(payload)) {
+        return -1;
     }
 
-    HTTPClient http;
-    http.begin(discordWebhookUrl);
-    http.addHeader("Content-Type", "application/json");
+    worker.http.begin(worker.client, url);
+    worker.http.addHeader("Content-Type", "application/json");
+
+    int httpCode = worker.http.POST(reinterpret_cast<uint8_t*>(payload), length);
+    worker.http.end();
 
-    StaticJsonDocument<512> doc;
-    doc["content"] = message;
+    return httpCode;
+}
+
+int WebhookAlertSystem::postDiscord(ServiceWorker& worker, const WebhookJob& job) {
+    JsonDocument doc(&worker.jsonPool);
+    doc["content"] = job.message;
     doc["username"] = "Earthquake Alert Bot";
 
-    JsonArray embeds = doc.createNestedArray("embeds");
-    JsonObject embed = embeds.createNestedObject();
+    JsonArray embeds = doc["embeds"].to<JsonArray>();
+    JsonObject embed = embeds.add<JsonObject>();
     embed["title"] = "Earthquake Detected!";
-    embed["description"] = message;
+    embed["description"] = job.message;
     embed["color"] = 16711680;
 
-    String payload;
-    serializeJson(doc, payload);
+    if (doc.overflowed()) {
+        return -1;
+    }
 
-    int httpCode = http.POST(payload);
-    http.end();
+    char payload[WEBHOOK_PAYLOAD_LENGTH];
+    size_t length = serializeJson(doc, payload, sizeof(payload));
+    if (length == 0 || length >= sizeof(payload)) {
+        return -1;
+    }
+
+    worker.http.begin(worker.client, discordWebhookUrl);
+    worker.http.addHeader("Content-Type", "application/json");
 
-    return httpCode == 204 || httpCode == 200;
+    int httpCode = worker.http.POST(reinterpret_cast<uint8_t*>(payload), length);
+    worker.http.end();
+
+    return httpCode;
 }
 
 void WebhookAlertSystem::broadcastAlert(const EarthquakeEvent& event) {
-    String message = "EARTHQUAKE DETECTED!\n";
-    message += "Magnitude: " + String(event.magnitude, 2) + "\n";
-    message += "PGA: " + String(event.pga, 3) + " g\n";
-    message += "CAV: " + String(event.cav, 3) + " g*s\n";
-    message += "Alert Level: " + event.alertLevel + "\n";
-    message += "Duration: " + String(event.duration / 1000.0, 1) + " seconds";
-
-    int priority = (event.alertLevel == "EXTREME" || event.alertLevel == "SEVERE") ? 2 : 1;
+    char message[WEBHOOK_MESSAGE_LENGTH];
+    snprintf(message, sizeof(message),
+             "EARTHQUAKE DETECTED!\n"
+             "Magnitude: %.2f\n"
+             "PGA: %.3f g\n"
+             "CAV: %.3f g*s\n"
+             "Alert Level: %s\n"
+             "Duration: %.1f seconds",
+             event.magnitude, event.pga, event.cav, alertLevelName(event.alertLevel),
+             event.duration / 1000.0);
+
+    int priority = (event.alertLevel == AlertLevel::EXTREME || event.alertLevel == AlertLevel::SEVERE) ? 2 : 1;
 
     sendPushover("Earthquake Alert", message, priority);
     sendTelegram(message);
     sendDiscord(message);
 }
 
-AlertManager::AlertManager() : localAlert(nullptr), mqttAlert(nullptr), webhookAlert(nullptr) {}
+AlertManager::AlertManager() : localAlert(nullptr), mqttAlert(nullptr), webhookAlert(nullptr), deviceId("") {}
 
 void AlertManager::init(LocalAlertSystem* local, MQTTAlertSystem* mqtt, WebhookAlertSystem* webhook) {
     localAlert = local;
@@ -306,7 +713,7 @@ void AlertManager::init(LocalAlertSystem* local, MQTTAlertSystem* mqtt, WebhookA
     webhookAlert = webhook;
 }
 
-void AlertManager::setDeviceId(const String& id) {
+void AlertManager::setDeviceId(const char* id) {
     deviceId = id;
 }
 
@@ -317,25 +724,25 @@ void AlertManager::sendAlert(const EarthquakeEvent& event, AlertChannel channel)
         }
     }
 
-    if (channel == ALERT_ALL || channel == ALERT_MQTT) {
+    if (channel == ALERT_ALL || channel == ALERT_REMOTE || channel == ALERT_MQTT) {
         if (mqttAlert && mqttAlert->isConnected()) {
             mqttAlert->publishAlert(event, deviceId);
         }
     }
 
-    if (channel == ALERT_ALL) {
+    if (channel == ALERT_ALL || channel == ALERT_REMOTE) {
         if (webhookAlert) {
             webhookAlert->broadcastAlert(event);
         }
     }
 }
 
-void AlertManager::sendStatus(const String& status) {
+void AlertManager::sendStatus(const char* status, const MetricsReport* metrics) {
     if (localAlert) {
         localAlert->displayStatus(status);
     }
 
     if (mqttAlert && mqttAlert->isConnected()) {
-        mqttAlert->publishStatus(status, deviceId);
+        mqttAlert->publishStatus(status, deviceId, metrics);
     }
 }
@@ -0,0 +1,416 @@
+#include <Arduino.h>
+#include <algorithm>
+#include <memory>
+#include "config.h"
+#include "earthquake_detector.h"
+#include "event_journal.h"
+#include "filter_bank.h"
+#include "fixed_point.h"
+#include "fixed_point_detector.h"
+#include "waveform_codec.h"
+
+#ifdef ARDUINO
+#include "event_queue.h"
+#else
+#include <chrono>
+#endif
+
+#define BENCH_REPEATS 15
+#define BENCH_MEASURE_SAMPLES 4000
+#define BENCH_QUERY_CALLS 200
+#define BENCH_SERIALIZE_EVENTS 500
+#define BENCH_FILTER_BURST 20
+#define BENCH_LINE_LENGTH 192
+
+#ifdef ARDUINO
+static const char* BENCH_UNIT = "cycles";
+
+static inline uint32_t benchTicks() {
+    return ESP.getCycleCount();
+}
+#else
+static const char* BENCH_UNIT = "ns";
+
+static inline uint32_t benchTicks() {
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+#endif
+
+struct DetectorConfig {
+    int sampleRate;
+    float ltaWindowSec;
+    StaLtaMode mode;
+};
+
+static const DetectorConfig DETECTOR_CONFIGS[] = {
+    {50, 30.0f, STA_LTA_SLIDING},
+    {100, 10.0f, STA_LTA_SLIDING},
+    {100, 30.0f, STA_LTA_SLIDING},
+    {100, 30.0f, STA_LTA_RECURSIVE},
+    {200, 10.0f, STA_LTA_SLIDING},
+    {200, 15.0f, STA_LTA_RECURSIVE},
+};
+
+static const int FILTER_SAMPLE_RATES[] = {50, 100, 200};
+
+static volatile float benchSink = 0.0f;
+
+static void emit(const char* name, double perOp, size_t bytes = 0) {
+    char line[BENCH_LINE_LENGTH];
+    snprintf(line, sizeof(line), "{\"name\":\"%s\",\"unit\":\"%s\",\"per_op\":%.1f,\"bytes\":%u}",
+             name, BENCH_UNIT, perOp, static_cast<unsigned>(bytes));
+#ifdef ARDUINO
+    Serial.println(line);
+#else
+    puts(line);
+#endif
+}
+
+static double fastest(double* values, size_t count) {
+    return *std::min_element(values, values + count);
+}
+
+class NoiseSource {
+public:
+    explicit NoiseSource(int sampleRate) : sampleRate(sampleRate), index(0), state(0x2545F491UL) {}
+
+    AccelSample next(float eventAmplitude = 0.0f) {
+        AccelSample sample;
+        float phase = 2.0f * static_cast<float>(M_PI) * 2.0f * index / sampleRate;
+        sample.x = uniform() * 0.02f + eventAmplitude * sinf(phase);
+        sample.y = uniform() * 0.02f + eventAmplitude * cosf(phase);
+        sample.z = uniform() * 0.02f + eventAmplitude * 0.5f * sinf(phase);
+        sample.timestamp = index * 1000000ULL / sampleRate;
+        index++;
+        return sample;
+    }
+
+private:
+    int sampleRate;
+    uint32_t index;
+    uint32_t state;
+
+    float uniform() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return static_cast<float>(state) / 4294967295.0f * 2.0f - 1.0f;
+    }
+};
+
+template <typename Detector, typename Sample>
+static double measureDetector(Detector& detector, NoiseSource& noise, float eventAmplitude) {
+    double perSample[BENCH_REPEATS];
+    Sample samples[BENCH_FILTER_BURST];
+
+    for (int repeat = 0; repeat < BENCH_REPEATS; repeat++) {
+        uint64_t ticks = 0;
+        for (size_t done = 0; done < BENCH_MEASURE_SAMPLES; done += BENCH_FILTER_BURST) {
+            for (size_t i = 0; i < BENCH_FILTER_BURST; i++) {
+                samples[i] = convertSample<Sample>(noise.next(eventAmplitude));
+            }
+
+            uint32_t start = benchTicks();
+            for (size_t i = 0; i < BENCH_FILTER_BURST; i++) {
+                detector.addSample(samples[i]);
+            }
+            ticks += benchTicks() - start;
+        }
+        perSample[repeat] = static_cast<double>(ticks) / BENCH_MEASURE_SAMPLES;
+    }
+
+    benchSink = benchSink + detector.getStaLtaRatio();
+    return fastest(perSample, BENCH_REPEATS);
+}
+
+template <typename Detector, typename Sample>
+static void warmDetector(Detector& detector, NoiseSource& noise, const DetectorConfig& config) {
+    detector.init();
+    size_t warmup = static_cast<size_t>(config.sampleRate * (config.ltaWindowSec + STA_WINDOW_SEC));
+    for (size_t i = 0; i < warmup; i++) {
+        detector.addSample(convertSample<Sample>(noise.next()));
+    }
+}
+
+static void formatConfigName(char* name, size_t capacity, const char* prefix, const DetectorConfig& config) {
+    snprintf(name, capacity, "%s/%s/%dhz/lta%d", prefix,
+             config.mode == STA_LTA_RECURSIVE ? "recursive" : "sliding", config.sampleRate,
+             static_cast<int>(config.ltaWindowSec));
+}
+
+template <typename T>
+static inline const T* benchOpaque(const T* pointer) {
+    asm volatile("" : "+r"(pointer) : : "memory");
+    return pointer;
+}
+
+template <typename T, typename Query>
+static double measureQuery(const T& target, Query query) {
+    double perCall[BENCH_REPEATS];
+
+    for (int repeat = 0; repeat < BENCH_REPEATS; repeat++) {
+        float sum = 0.0f;
+        uint32_t start = benchTicks();
+        for (int i = 0; i < BENCH_QUERY_CALLS; i++) {
+            sum += query(*benchOpaque(&target));
+        }
+        perCall[repeat] = static_cast<double>(benchTicks() - start) / BENCH_QUERY_CALLS;
+        benchSink = benchSink + sum;
+    }
+
+    return fastest(perCall, BENCH_REPEATS);
+}
+
+static void benchFloatDetector(const DetectorConfig& config) {
+    char name[64];
+    std::unique_ptr<EarthquakeDetector> detector(new EarthquakeDetector(
+        config.sampleRate, STA_WINDOW_SEC, config.ltaWindowSec, STA_LTA_TRIGGER_THRESHOLD,
+        STA_LTA_DETRIGGER_THRESHOLD, config.mode));
+    NoiseSource noise(config.sampleRate);
+
+    warmDetector<EarthquakeDetector, AccelSample>(*detector, noise, config);
+    formatConfigName(name, sizeof(name), "detector/float/quiet", config);
+    emit(name, measureDetector<EarthquakeDetector, AccelSample>(*detector, noise, 0.0f));
+
+    formatConfigName(name, sizeof(name), "detector/float/event", config);
+    emit(name, measureDetector<EarthquakeDetector, AccelSample>(*detector, noise, 2.0f));
+
+    if (config.sampleRate != SAMPLE_RATE_HZ || config.ltaWindowSec != LTA_WINDOW_SEC ||
+        config.mode != STA_LTA_MODE) {
+        return;
+    }
+
+    std::unique_ptr<EarthquakeDetector> bank(new EarthquakeDetector(
+        config.sampleRate, STA_WINDOW_SEC, config.ltaWindowSec, STA_LTA_TRIGGER_THRESHOLD,
+        STA_LTA_DETRIGGER_THRESHOLD, config.mode));
+    bank->addChannel(LOCAL_DETECTOR_CHANNEL);
+    bank->addChannel(BAND_DETECTOR_CHANNEL);
+    NoiseSource bankNoise(config.sampleRate);
+
+    warmDetector<EarthquakeDetector, AccelSample>(*bank, bankNoise, config);
+    formatConfigName(name, sizeof(name), "detector/bank3/quiet", config);
+    emit(name, measureDetector<EarthquakeDetector, AccelSample>(*bank, bankNoise, 0.0f));
+
+    emit("query/calculateSTA", measureQuery(*detector, [](const EarthquakeDetector& queried) {
+        return queried.calculateSTA();
+    }));
+    emit("query/calculateLTA", measureQuery(*detector, [](const EarthquakeDetector& queried) {
+        return queried.calculateLTA();
+    }));
+    emit("query/calculatePGA", measureQuery(*detector, [](const EarthquakeDetector& queried) {
+        return queried.calculatePGA();
+    }));
+    emit("query/calculateCAV", measureQuery(*detector, [](const EarthquakeDetector& queried) {
+        return queried.calculateCAV();
+    }));
+}
+
+static void benchFixedDetector(const DetectorConfig& config) {
+    char name[64];
+    std::unique_ptr<FixedPointDetector> detector(new FixedPointDetector(
+        config.sampleRate, STA_WINDOW_SEC, config.ltaWindowSec, STA_LTA_TRIGGER_THRESHOLD,
+        STA_LTA_DETRIGGER_THRESHOLD, config.mode));
+    NoiseSource noise(config.sampleRate);
+
+    warmDetector<FixedPointDetector, RawAccelSample>(*detector, noise, config);
+    formatConfigName(name, sizeof(name), "detector/fixed/quiet", config);
+    emit(name, measureDetector<FixedPointDetector, RawAccelSample>(*detector, noise, 0.0f));
+
+    formatConfigName(name, sizeof(name), "detector/fixed/event", config);
+    emit(name, measureDetector<FixedPointDetector, RawAccelSample>(*detector, noise, 2.0f));
+}
+
+template <typename Step>
+static double measurePerSample(int sampleRate, Step step) {
+    double perSample[BENCH_REPEATS];
+    NoiseSource noise(sampleRate);
+    AccelSample samples[BENCH_FILTER_BURST];
+
+    for (int repeat = 0; repeat < BENCH_REPEATS; repeat++) {
+        uint64_t ticks = 0;
+        for (size_t done = 0; done < BENCH_MEASURE_SAMPLES; done += BENCH_FILTER_BURST) {
+            for (size_t i = 0; i < BENCH_FILTER_BURST; i++) {
+                samples[i] = noise.next(0.5f);
+            }
+
+            uint32_t start = benchTicks();
+            step(samples, BENCH_FILTER_BURST);
+            ticks += benchTicks() - start;
+        }
+        perSample[repeat] = static_cast<double>(ticks) / BENCH_MEASURE_SAMPLES;
+    }
+
+    return fastest(perSample, BENCH_REPEATS);
+}
+
+static void benchFilters(int sampleRate) {
+    char name[64];
+    float highCutoff = std::min(FILTER_HIGH_CUTOFF_HZ, 0.45f * sampleRate);
+    BandpassDesign design = designButterworthBandpass(sampleRate, FILTER_LOW_CUTOFF_HZ, highCutoff, FILTER_ORDER);
+
+    ButterworthFilter butterworth(design);
+    snprintf(name, sizeof(name), "filter/butterworth/%dhz", sampleRate);
+    emit(name, measurePerSample(sampleRate, [&](AccelSample* samples, size_t count) {
+        float sum = 0.0f;
+        for (size_t i = 0; i < count; i++) {
+            sum += butterworth.process(samples[i].z);
+        }
+        benchSink = benchSink + sum;
+    }));
+
+    KalmanFilter kalman(KALMAN_PROCESS_NOISE, KALMAN_MEASUREMENT_NOISE);
+    snprintf(name, sizeof(name), "filter/kalman/%dhz", sampleRate);
+    emit(name, measurePerSample(sampleRate, [&](AccelSample* samples, size_t count) {
+        float sum = 0.0f;
+        for (size_t i = 0; i < count; i++) {
+            sum += kalman.update(samples[i].z);
+        }
+        benchSink = benchSink + sum;
+    }));
+
+    AxisFilterBank bank(design, KALMAN_PROCESS_NOISE, KALMAN_MEASUREMENT_NOISE);
+    snprintf(name, sizeof(name), "filter/bank_float/%dhz", sampleRate);
+    emit(name, measurePerSample(sampleRate, [&](AccelSample* samples, size_t count) {
+        bank.process(samples, samples, count);
+        benchSink = benchSink + samples[count - 1].z;
+    }));
+
+    FixedAxisFilterBank fixedBank(toFixedDesign(design), FIXED_KALMAN_GAINS);
+    snprintf(name, sizeof(name), "filter/bank_fixed/%dhz", sampleRate);
+    emit(name, measurePerSample(sampleRate, [&](AccelSample* samples, size_t count) {
+        RawAccelSample raw[BENCH_FILTER_BURST];
+        for (size_t i = 0; i < count; i++) {
+            raw[i] = convertSample<RawAccelSample>(samples[i]);
+        }
+        fixedBank.process(raw, raw, count);
+        benchSink = benchSink + raw[count - 1].z;
+    }));
+}
+
+static EarthquakeEvent sampleEvent(uint32_t index) {
+    EarthquakeEvent event = {};
+    event.magnitude = 4.5f + (index % 10) * 0.1f;
+    event.pga = 0.12f;
+    event.pgaAxes = {0.08f, 0.07f, 0.05f};
+    event.pgv = 3.2f;
+    event.cav = 0.21f;
+    event.startTime = 1000000ULL * index;
+    event.duration = 12000;
+    event.alertLevel = AlertLevel::MODERATE;
+    event.confirmed = true;
+    return event;
+}
+
+template <typename Operation>
+static double measurePerEvent(Operation operation) {
+    double perEvent[BENCH_REPEATS];
+
+    for (int repeat = 0; repeat < BENCH_REPEATS; repeat++) {
+        uint32_t start = benchTicks();
+        for (uint32_t i = 0; i < BENCH_SERIALIZE_EVENTS; i++) {
+            operation(i);
+        }
+        perEvent[repeat] = static_cast<double>(benchTicks() - start) / BENCH_SERIALIZE_EVENTS;
+    }
+
+    return fastest(perEvent, BENCH_REPEATS);
+}
+
+static void benchSerialization() {
+    const char* deviceId = "ESP32_BENCH00000000";
+    JournalRecord record;
+    EarthquakeEvent decoded;
+    char decodedId[DEVICE_ID_LENGTH + 1];
+
+    emit("serialize/journal_encode", measurePerEvent([&](uint32_t i) {
+        encodeEventRecord(i, sampleEvent(i), deviceId, record);
+        benchSink = benchSink + record.crc;
+    }), sizeof(JournalRecord));
+
+    encodeEventRecord(1, sampleEvent(1), deviceId, record);
+    emit("serialize/journal_decode", measurePerEvent([&](uint32_t) {
+        if (isValidRecord(record)) {
+            decodeEventRecord(record, decoded, decodedId, sizeof(decodedId));
+        }
+        benchSink = benchSink + decoded.pga;
+    }), sizeof(JournalRecord));
+
+    WaveformBlockEncoder encoder(SAMPLE_RATE_HZ, WAVEFORM_SCALE);
+    NoiseSource noise(SAMPLE_RATE_HZ);
+    while (!encoder.full()) {
+        encoder.add(noise.next(0.5f));
+    }
+
+    uint8_t payload[WAVEFORM_MAX_PAYLOAD_SIZE];
+    size_t length = encoder.encode(payload, sizeof(payload));
+    emit("serialize/waveform_block", measurePerEvent([&](uint32_t) {
+        benchSink = benchSink + encoder.encode(payload, sizeof(payload));
+    }), length);
+
+#ifdef ARDUINO
+    EventQueue queue;
+    if (!queue.init()) {
+        Serial.println("Event queue init failed, skipping journal benchmarks");
+        return;
+    }
+    queue.clearAll();
+
+    double perSave[BENCH_REPEATS];
+    for (int repeat = 0; repeat < BENCH_REPEATS; repeat++) {
+        uint32_t start = benchTicks();
+        for (uint32_t i = 0; i < MAX_QUEUE_SIZE / 2; i++) {
+            queue.addEvent(sampleEvent(i), deviceId);
+        }
+        perSave[repeat] = static_cast<double>(benchTicks() - start) / (MAX_QUEUE_SIZE / 2);
+        if (repeat + 1 < BENCH_REPEATS) {
+            queue.clearAll();
+        }
+    }
+    emit("event_queue/save", fastest(perSave, BENCH_REPEATS), sizeof(JournalRecord));
+
+    EventQueue reloaded;
+    uint32_t start = benchTicks();
+    reloaded.init();
+    uint32_t elapsed = benchTicks() - start;
+    emit("event_queue/load", static_cast<double>(elapsed) / std::max(1, reloaded.getQueueSize()),
+         sizeof(JournalRecord));
+    reloaded.clearAll();
+#endif
+}
+
+static void runBenchmarks() {
+    for (const DetectorConfig& config : DETECTOR_CONFIGS) {
+        benchFloatDetector(config);
+        benchFixedDetector(config);
+    }
+
+    for (int sampleRate : FILTER_SAMPLE_RATES) {
+        benchFilters(sampleRate);
+    }
+
+    benchSerialization();
+}
+
+#ifdef ARDUINO
+void setup() {
+    Serial.begin(115200);
+    while (!Serial) {
+        delay(10);
+    }
+    delay(500);
+
+    Serial.println("BENCH START");
+    runBenchmarks();
+    Serial.println("BENCH DONE");
+}
+
+void loop() {
+    vTaskDelete(nullptr);
+}
+#else
+int main() {
+    runBenchmarks();
+    return 0;
+}
+#endif
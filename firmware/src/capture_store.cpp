@@ -0,0 +1,222 @@
+#include "capture_store.h"
+
+static void writeLe32(uint8_t* output, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        output[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+CaptureStore::CaptureStore() : nextCaptureId(1) {}
+
+bool CaptureStore::init() {
+    char path[CAPTURE_PATH_LENGTH];
+
+    for (int slot = 0; slot < CAPTURE_SLOT_COUNT; slot++) {
+        dataPath(slot, path);
+        if (!SPIFFS.exists(path)) {
+            continue;
+        }
+
+        File file = SPIFFS.open(path, FILE_READ);
+        CaptureHeader header;
+        bool valid = file && file.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) == sizeof(header) &&
+                     header.magic == CAPTURE_MAGIC && header.version == CAPTURE_FORMAT_VERSION;
+        file.close();
+
+        if (!valid) {
+            removeSlot(slot);
+            continue;
+        }
+
+        if (header.captureId >= nextCaptureId) {
+            nextCaptureId = header.captureId + 1;
+        }
+    }
+
+    return true;
+}
+
+bool CaptureStore::save(const EventRecorder& recorder, const Timebase& timebase) {
+    int slot = findFreeSlot();
+    if (slot < 0) {
+        Serial.println("Capture spool full, waveform dropped");
+        return false;
+    }
+
+    char path[CAPTURE_PATH_LENGTH];
+    dataPath(slot, path);
+    File file = SPIFFS.open(path, FILE_WRITE);
+    if (!file) {
+        Serial.println("Failed to open capture file for writing");
+        return false;
+    }
+
+    CaptureHeader header = recorder.getHeader();
+    header.captureId = nextCaptureId++;
+    header.triggerTime = timebase.toUtcMicros(header.triggerTime);
+    header.firstTimestamp = timebase.toUtcMicros(header.firstTimestamp);
+
+    size_t sampleBytes = recorder.getSampleBytes();
+    bool written = file.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) == sizeof(header) &&
+                   file.write(reinterpret_cast<const uint8_t*>(recorder.getSamples()), sampleBytes) == sampleBytes;
+    file.close();
+
+    if (!written) {
+        Serial.println("Failed to write capture file");
+        removeSlot(slot);
+        return false;
+    }
+
+    return writeSentOffset(slot, 0);
+}
+
+bool CaptureStore::uploadNextChunk(std::function<bool(const uint8_t* payload, size_t length)> publishFunction) {
+    int slot = findPendingSlot();
+    if (slot < 0) {
+        return false;
+    }
+
+    char path[CAPTURE_PATH_LENGTH];
+    dataPath(slot, path);
+    File file = SPIFFS.open(path, FILE_READ);
+    if (!file) {
+        removeSlot(slot);
+        return false;
+    }
+
+    CaptureHeader header;
+    uint32_t totalBytes = file.size();
+    uint32_t offset = readSentOffset(slot);
+    if (file.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) != sizeof(header) || offset >= totalBytes) {
+        file.close();
+        removeSlot(slot);
+        return false;
+    }
+
+    file.seek(offset);
+    size_t length = file.read(chunkBuffer + CAPTURE_CHUNK_HEADER_SIZE, CAPTURE_CHUNK_SIZE);
+    file.close();
+
+    uint32_t nextOffset = offset + length;
+    bool final = nextOffset >= totalBytes;
+
+    chunkBuffer[0] = CAPTURE_CHUNK_VERSION;
+    chunkBuffer[1] = final ? CAPTURE_CHUNK_FLAG_FINAL : 0;
+    chunkBuffer[2] = 0;
+    chunkBuffer[3] = 0;
+    writeLe32(chunkBuffer + 4, header.captureId);
+    writeLe32(chunkBuffer + 8, offset);
+    writeLe32(chunkBuffer + 12, totalBytes);
+
+    if (!publishFunction(chunkBuffer, CAPTURE_CHUNK_HEADER_SIZE + length)) {
+        return false;
+    }
+
+    if (final) {
+        removeSlot(slot);
+        return true;
+    }
+
+    return writeSentOffset(slot, nextOffset);
+}
+
+int CaptureStore::getPendingCount() const {
+    int count = 0;
+    char path[CAPTURE_PATH_LENGTH];
+
+    for (int slot = 0; slot < CAPTURE_SLOT_COUNT; slot++) {
+        dataPath(slot, path);
+        if (SPIFFS.exists(path)) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+int CaptureStore::findFreeSlot() const {
+    char path[CAPTURE_PATH_LENGTH];
+
+    for (int slot = 0; slot < CAPTURE_SLOT_COUNT; slot++) {
+        dataPath(slot, path);
+        if (!SPIFFS.exists(path)) {
+            return slot;
+        }
+    }
+
+    return -1;
+}
+
+int CaptureStore::findPendingSlot() const {
+    char path[CAPTURE_PATH_LENGTH];
+    int oldestSlot = -1;
+    uint32_t oldestId = 0;
+
+    for (int slot = 0; slot < CAPTURE_SLOT_COUNT; slot++) {
+        dataPath(slot, path);
+        File file = SPIFFS.open(path, FILE_READ);
+        if (!file) {
+            continue;
+        }
+
+        CaptureHeader header;
+        if (file.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) == sizeof(header) &&
+            (oldestSlot < 0 || header.captureId < oldestId)) {
+            oldestSlot = slot;
+            oldestId = header.captureId;
+        }
+        file.close();
+    }
+
+    return oldestSlot;
+}
+
+uint32_t CaptureStore::readSentOffset(int slot) const {
+    char path[CAPTURE_PATH_LENGTH];
+    sentOffsetPath(slot, path);
+
+    File file = SPIFFS.open(path, FILE_READ);
+    if (!file) {
+        return 0;
+    }
+
+    uint32_t offset = 0;
+    if (file.read(reinterpret_cast<uint8_t*>(&offset), sizeof(offset)) != sizeof(offset)) {
+        offset = 0;
+    }
+    file.close();
+
+    return offset;
+}
+
+bool CaptureStore::writeSentOffset(int slot, uint32_t offset) {
+    char path[CAPTURE_PATH_LENGTH];
+    sentOffsetPath(slot, path);
+
+    File file = SPIFFS.open(path, FILE_WRITE);
+    if (!file) {
+        return false;
+    }
+
+    bool written = file.write(reinterpret_cast<const uint8_t*>(&offset), sizeof(offset)) == sizeof(offset);
+    file.close();
+
+    return written;
+}
+
+void CaptureStore::removeSlot(int slot) {
+    char path[CAPTURE_PATH_LENGTH];
+
+    dataPath(slot, path);
+    SPIFFS.remove(path);
+    sentOffsetPath(slot, path);
+    SPIFFS.remove(path);
+}
+
+void CaptureStore::dataPath(int slot, char* path) {
+    snprintf(path, CAPTURE_PATH_LENGTH, "/capture%d.bin", slot);
+}
+
+void CaptureStore::sentOffsetPath(int slot, char* path) {
+    snprintf(path, CAPTURE_PATH_LENGTH, "/capture%d.pos", slot);
+}
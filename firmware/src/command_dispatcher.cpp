@@ -0,0 +1,319 @@
+#include "command_dispatcher.h"
+#include <cmath>
+
+const char* commandStatusName(CommandStatus status) {
+    switch (status) {
+        case COMMAND_OK: return "ok";
+        case COMMAND_UNKNOWN: return "unknown";
+        case COMMAND_MALFORMED: return "malformed";
+        case COMMAND_REJECTED: return "rejected";
+        case COMMAND_BUSY: return "busy";
+        default: return "unknown";
+    }
+}
+
+static size_t skipSpace(const char* text, size_t length, size_t position) {
+    while (position < length && isspace(static_cast<unsigned char>(text[position]))) {
+        position++;
+    }
+    return position;
+}
+
+static size_t skipDigits(const char* text, size_t length, size_t position) {
+    while (position < length && isdigit(static_cast<unsigned char>(text[position]))) {
+        position++;
+    }
+    return position;
+}
+
+static bool scanString(const char* text, size_t length, size_t& position, const char*& value, size_t& valueLength) {
+    size_t index = position + 1;
+    while (index < length && text[index] != '"') {
+        if (static_cast<unsigned char>(text[index]) < 0x20) {
+            return false;
+        }
+        if (text[index] == '\\') {
+            index++;
+        }
+        index++;
+    }
+    if (index >= length) {
+        return false;
+    }
+
+    value = text + position + 1;
+    valueLength = index - position - 1;
+    position = index + 1;
+    return true;
+}
+
+static bool scanNumber(const char* text, size_t length, size_t& position) {
+    size_t index = position;
+    if (index < length && text[index] == '-') {
+        index++;
+    }
+
+    size_t integer = index;
+    index = skipDigits(text, length, index);
+    if (index == integer || (text[integer] == '0' && index - integer > 1)) {
+        return false;
+    }
+
+    if (index < length && text[index] == '.') {
+        size_t fraction = ++index;
+        index = skipDigits(text, length, index);
+        if (index == fraction) {
+            return false;
+        }
+    }
+
+    if (index < length && (text[index] == 'e' || text[index] == 'E')) {
+        index++;
+        if (index < length && (text[index] == '+' || text[index] == '-')) {
+            index++;
+        }
+        size_t exponent = index;
+        index = skipDigits(text, length, index);
+        if (index == exponent) {
+            return false;
+        }
+    }
+
+    position = index;
+    return true;
+}
+
+static bool scanLiteral(const char* text, size_t length, size_t& position, const char* literal) {
+    size_t literalLength = strlen(literal);
+    if (length - position < literalLength || memcmp(text + position, literal, literalLength) != 0) {
+        return false;
+    }
+    position += literalLength;
+    return true;
+}
+
+static bool scanValue(const char* text, size_t length, size_t& position, CommandArgument& argument) {
+    size_t start = position;
+
+    switch (text[position]) {
+        case '"':
+            argument.type = COMMAND_VALUE_STRING;
+            return scanString(text, length, position, argument.value, argument.valueLength);
+        case 't':
+        case 'f':
+            argument.type = COMMAND_VALUE_BOOL;
+            if (!scanLiteral(text, length, position, text[position] == 't' ? "true" : "false")) {
+                return false;
+            }
+            break;
+        case 'n':
+            argument.type = COMMAND_VALUE_NULL;
+            if (!scanLiteral(text, length, position, "null")) {
+                return false;
+            }
+            break;
+        default:
+            argument.type = COMMAND_VALUE_NUMBER;
+            if (!scanNumber(text, length, position)) {
+                return false;
+            }
+            break;
+    }
+
+    argument.value = text + start;
+    argument.valueLength = position - start;
+    return true;
+}
+
+static bool parseObject(const char* text, size_t length, CommandArgument* entries, size_t& count) {
+    size_t position = skipSpace(text, length, 0);
+    if (position >= length || text[position] != '{') {
+        return false;
+    }
+
+    position = skipSpace(text, length, position + 1);
+    if (position < length && text[position] == '}') {
+        return skipSpace(text, length, position + 1) == length;
+    }
+
+    while (position < length) {
+        if (count == COMMAND_MAX_ARGUMENTS || text[position] != '"') {
+            return false;
+        }
+
+        CommandArgument& argument = entries[count];
+        if (!scanString(text, length, position, argument.key, argument.keyLength)) {
+            return false;
+        }
+
+        position = skipSpace(text, length, position);
+        if (position >= length || text[position] != ':') {
+            return false;
+        }
+
+        position = skipSpace(text, length, position + 1);
+        if (position >= length || !scanValue(text, length, position, argument)) {
+            return false;
+        }
+        count++;
+
+        position = skipSpace(text, length, position);
+        if (position >= length) {
+            return false;
+        }
+        if (text[position] == '}') {
+            return skipSpace(text, length, position + 1) == length;
+        }
+        if (text[position] != ',') {
+            return false;
+        }
+        position = skipSpace(text, length, position + 1);
+    }
+
+    return false;
+}
+
+CommandArguments::CommandArguments() : count(0) {}
+
+bool CommandArguments::parse(const char* text, size_t length) {
+    count = 0;
+    if (!parseObject(text, length, entries, count)) {
+        count = 0;
+        return false;
+    }
+    return true;
+}
+
+void CommandArguments::clear() {
+    count = 0;
+}
+
+bool CommandArguments::has(const char* key) const {
+    return find(key) != nullptr;
+}
+
+bool CommandArguments::getString(const char* key, const char*& value, size_t& length) const {
+    const CommandArgument* argument = find(key);
+    if (argument == nullptr || argument->type != COMMAND_VALUE_STRING) {
+        return false;
+    }
+
+    value = argument->value;
+    length = argument->valueLength;
+    return true;
+}
+
+bool CommandArguments::getNumber(const char* key, float& value) const {
+    const CommandArgument* argument = find(key);
+    if (argument == nullptr || argument->type != COMMAND_VALUE_NUMBER ||
+        argument->valueLength > COMMAND_NUMBER_MAX_LENGTH) {
+        return false;
+    }
+
+    char number[COMMAND_NUMBER_MAX_LENGTH + 1];
+    memcpy(number, argument->value, argument->valueLength);
+    number[argument->valueLength] = '\0';
+
+    float parsed = strtof(number, nullptr);
+    if (!std::isfinite(parsed)) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+bool CommandArguments::getUnsigned(const char* key, uint32_t& value) const {
+    const CommandArgument* argument = find(key);
+    if (argument == nullptr || argument->type != COMMAND_VALUE_NUMBER || argument->valueLength > 10) {
+        return false;
+    }
+
+    uint64_t parsed = 0;
+    for (size_t i = 0; i < argument->valueLength; i++) {
+        char digit = argument->value[i];
+        if (!isdigit(static_cast<unsigned char>(digit))) {
+            return false;
+        }
+        parsed = parsed * 10 + (digit - '0');
+    }
+    if (parsed > UINT32_MAX) {
+        return false;
+    }
+
+    value = static_cast<uint32_t>(parsed);
+    return true;
+}
+
+bool CommandArguments::getBool(const char* key, bool fallback) const {
+    const CommandArgument* argument = find(key);
+    if (argument == nullptr || argument->type != COMMAND_VALUE_BOOL) {
+        return fallback;
+    }
+    return argument->value[0] == 't';
+}
+
+size_t CommandArguments::size() const {
+    return count;
+}
+
+const CommandArgument* CommandArguments::find(const char* key) const {
+    size_t keyLength = strlen(key);
+    for (size_t i = 0; i < count; i++) {
+        if (entries[i].keyLength == keyLength && memcmp(entries[i].key, key, keyLength) == 0) {
+            return &entries[i];
+        }
+    }
+    return nullptr;
+}
+
+CommandDispatcher::CommandDispatcher(const CommandHandler* table, size_t count) : table(table), count(count) {}
+
+CommandResult CommandDispatcher::dispatch(uint8_t* payload, size_t length) {
+    CommandResult result;
+    result.name[0] = '\0';
+    result.status = COMMAND_MALFORMED;
+
+    char* text = reinterpret_cast<char*>(payload);
+    while (length > 0 && isspace(static_cast<unsigned char>(text[length - 1]))) {
+        length--;
+    }
+    while (length > 0 && isspace(static_cast<unsigned char>(*text))) {
+        text++;
+        length--;
+    }
+    if (length == 0 || memchr(text, '\0', length) != nullptr) {
+        return result;
+    }
+
+    arguments.clear();
+
+    const char* name = text;
+    size_t nameLength = length;
+
+    if (text[0] == '{') {
+        if (!arguments.parse(text, length) || !arguments.getString("command", name, nameLength)) {
+            return result;
+        }
+    }
+
+    copyName(result, name, nameLength);
+
+    const CommandHandler* handler = find(name, nameLength);
+    result.status = handler != nullptr ? handler->handle(arguments) : COMMAND_UNKNOWN;
+    return result;
+}
+
+const CommandHandler* CommandDispatcher::find(const char* name, size_t length) const {
+    for (size_t i = 0; i < count; i++) {
+        if (strlen(table[i].name) == length && memcmp(table[i].name, name, length) == 0) {
+            return &table[i];
+        }
+    }
+    return nullptr;
+}
+
+void CommandDispatcher::copyName(CommandResult& result, const char* name, size_t length) {
+    size_t copied = std::min(length, sizeof(result.name) - 1);
+    memcpy(result.name, name, copied);
+    result.name[copied] = '\0';
+}
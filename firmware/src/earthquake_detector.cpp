@@ -1,170 +1,558 @@
 #include "earthquake_detector.h"
 #include "config.h"
+#include "timebase.h"
 #include <cmath>
+#include <type_traits>
+
+template <typename Energy, typename Accumulator>
+BasicStaLtaEngine<Energy, Accumulator>::BasicStaLtaEngine(int staWindowSamples, int ltaWindowSamples,
+                                                          StaLtaMode mode)
+    : staWindowSamples(std::max(1, staWindowSamples)),
+      ltaWindowSamples(std::max(1, ltaWindowSamples)),
+      mode(mode) {
+    staCoefficient = 1.0f / this->staWindowSamples;
+    ltaCoefficient = 1.0f / this->ltaWindowSamples;
+    reset();
+}
 
-EarthquakeDetector::EarthquakeDetector(int sampleRate, float staWindowSec, float ltaWindowSec,
-                                       float triggerThreshold, float detriggerThreshold)
-    : sampleRate(sampleRate),
-      staWindowSamples(static_cast<int>(staWindowSec * sampleRate)),
-      ltaWindowSamples(static_cast<int>(ltaWindowSec * sampleRate)),
-      triggerThreshold(triggerThreshold),
-      detriggerThreshold(detriggerThreshold),
-      triggered(false),
-      triggerTime(0) {
-    sampleBuffer.reserve(ltaWindowSamples + staWindowSamples);
+template <typename Energy, typename Accumulator>
+void BasicStaLtaEngine<Energy, Accumulator>::update(const Buffer& energies) {
+    if (samplesSeen <= ltaWindowSamples) {
+        samplesSeen++;
+    }
+
+    if (mode == STA_LTA_RECURSIVE) {
+        updateRecursive(energies.newest());
+    } else {
+        updateSliding(energies);
+    }
 }
 
-void EarthquakeDetector::init() {
-    reset();
+template <typename Energy, typename Accumulator>
+void BasicStaLtaEngine<Energy, Accumulator>::updateUnbuffered(Energy energy) {
+    if (samplesSeen <= ltaWindowSamples) {
+        samplesSeen++;
+    }
+
+    updateRecursive(energy);
 }
 
-void EarthquakeDetector::addSample(float ax, float ay, float az) {
-    AccelSample sample;
-    sample.x = ax;
-    sample.y = ay;
-    sample.z = az;
-    sample.timestamp = millis();
+template <typename Energy, typename Accumulator>
+void BasicStaLtaEngine<Energy, Accumulator>::updateSliding(const Buffer& energies) {
+    staSum += energies.newest();
 
-    updateBuffers(sample);
+    if (samplesSeen > staWindowSamples) {
+        Accumulator leavingSta = energies.newest(staWindowSamples);
+        staSum -= leavingSta;
+        ltaSum += leavingSta;
+    }
 
-    if (sampleBuffer.size() >= ltaWindowSamples) {
-        float sta = calculateSTA();
-        float lta = calculateLTA();
-        float ratio = (lta > 0.0001f) ? sta / lta : 0.0f;
+    if (samplesSeen > ltaWindowSamples) {
+        ltaSum -= energies.newest(ltaWindowSamples);
+    }
 
-        if (!triggered && ratio > triggerThreshold) {
-            triggered = true;
-            triggerTime = sample.timestamp;
-            currentEvent.startTime = triggerTime;
-            currentEvent.pga = 0.0f;
-            currentEvent.cav = 0.0f;
+    if constexpr (!std::is_integral<Accumulator>::value) {
+        samplesSinceResync++;
+        if (samplesSinceResync >= ltaWindowSamples) {
+            resync(energies);
         }
+    }
+}
 
-        if (triggered) {
-            float currentMag = calculateMagnitude(ax, ay, az);
-            float pga = calculatePGA();
+template <typename Energy, typename Accumulator>
+void BasicStaLtaEngine<Energy, Accumulator>::updateRecursive(Energy energy) {
+    Accumulator value = energy;
 
-            if (pga > currentEvent.pga) {
-                currentEvent.pga = pga;
-            }
+    if (samplesSeen == 1) {
+        staAverage = value;
+        ltaAverage = value;
+        return;
+    }
 
-            currentEvent.cav = calculateCAV();
-            currentEvent.alertLevel = determineAlertLevel(currentEvent.pga);
+    if constexpr (std::is_integral<Accumulator>::value) {
+        staAverage += (value - staAverage) / staWindowSamples;
+        ltaAverage += (value - ltaAverage) / ltaWindowSamples;
+    } else {
+        staAverage += (value - staAverage) * staCoefficient;
+        ltaAverage += (value - ltaAverage) * ltaCoefficient;
+    }
+}
 
-            if (ratio < detriggerThreshold) {
-                currentEvent.duration = sample.timestamp - triggerTime;
+template <typename Energy, typename Accumulator>
+void BasicStaLtaEngine<Energy, Accumulator>::resync(const Buffer& energies) {
+    int available = static_cast<int>(energies.size());
+    int staEnd = std::min(staWindowSamples, available);
+    int ltaEnd = std::min(ltaWindowSamples, available);
 
-                if (currentEvent.duration >= MIN_EVENT_DURATION_SEC * 1000) {
-                    currentEvent.confirmed = true;
-                    currentEvent.magnitude = calculateMagnitudeEstimate(currentEvent.pga, 10.0f);
-                }
+    staSum = 0;
+    for (int age = 0; age < staEnd; age++) {
+        staSum += energies.newest(age);
+    }
 
-                triggered = false;
-            }
+    ltaSum = 0;
+    for (int age = staWindowSamples; age < ltaEnd; age++) {
+        ltaSum += energies.newest(age);
+    }
+
+    samplesSinceResync = 0;
+}
+
+template <typename Energy, typename Accumulator>
+bool BasicStaLtaEngine<Energy, Accumulator>::isReady() const {
+    return samplesSeen >= ltaWindowSamples;
+}
+
+template <typename Energy, typename Accumulator>
+float BasicStaLtaEngine<Energy, Accumulator>::getSTA() const {
+    if (mode == STA_LTA_RECURSIVE) {
+        return static_cast<float>(staAverage);
+    }
+
+    if (samplesSeen < staWindowSamples) {
+        return 0.0f;
+    }
+    return std::max(0.0f, static_cast<float>(staSum)) / staWindowSamples;
+}
+
+template <typename Energy, typename Accumulator>
+float BasicStaLtaEngine<Energy, Accumulator>::getLTA() const {
+    if (mode == STA_LTA_RECURSIVE) {
+        return isReady() ? static_cast<float>(ltaAverage) : 0.0f;
+    }
+
+    int ltaSamples = ltaWindowSamples - staWindowSamples;
+    if (!isReady() || ltaSamples <= 0) {
+        return 0.0f;
+    }
+    return std::max(0.0f, static_cast<float>(ltaSum)) / ltaSamples;
+}
+
+template <typename Energy, typename Accumulator>
+float BasicStaLtaEngine<Energy, Accumulator>::getRatio() const {
+    float lta = getLTA();
+    return (lta > 0.0001f) ? getSTA() / lta : 0.0f;
+}
+
+template <typename Energy, typename Accumulator>
+bool BasicStaLtaEngine<Energy, Accumulator>::ratioExceeds(uint32_t thresholdQ8) const {
+    if constexpr (!std::is_integral<Accumulator>::value) {
+        return getRatio() * (1 << STA_LTA_RATIO_FRACTION_BITS) > thresholdQ8;
+    } else {
+        if (!isReady()) {
+            return false;
+        }
+
+        if (mode == STA_LTA_RECURSIVE) {
+            return ltaAverage > 0 &&
+                   (staAverage << STA_LTA_RATIO_FRACTION_BITS) > ltaAverage * thresholdQ8;
         }
+
+        Accumulator ltaSamples = ltaWindowSamples - staWindowSamples;
+        if (ltaSamples <= 0 || ltaSum <= 0) {
+            return false;
+        }
+
+        return (staSum * ltaSamples) << STA_LTA_RATIO_FRACTION_BITS >
+               ltaSum * staWindowSamples * thresholdQ8;
     }
 }
 
-void EarthquakeDetector::updateBuffers(const AccelSample& sample) {
-    sampleBuffer.push_back(sample);
+template <typename Energy, typename Accumulator>
+int BasicStaLtaEngine<Energy, Accumulator>::getStaWindowSamples() const {
+    return staWindowSamples;
+}
+
+template <typename Energy, typename Accumulator>
+int BasicStaLtaEngine<Energy, Accumulator>::getLtaWindowSamples() const {
+    return ltaWindowSamples;
+}
+
+template <typename Energy, typename Accumulator>
+void BasicStaLtaEngine<Energy, Accumulator>::seed(const Buffer& energies, Energy background) {
+    samplesSeen = ltaWindowSamples + 1;
+    staAverage = background;
+    ltaAverage = background;
+    resync(energies);
+}
 
-    int maxBufferSize = ltaWindowSamples + staWindowSamples;
-    if (sampleBuffer.size() > maxBufferSize) {
-        sampleBuffer.erase(sampleBuffer.begin());
+template <typename Energy, typename Accumulator>
+void BasicStaLtaEngine<Energy, Accumulator>::reset() {
+    samplesSeen = 0;
+    samplesSinceResync = 0;
+    staSum = 0;
+    ltaSum = 0;
+    staAverage = 0;
+    ltaAverage = 0;
+}
+
+template class BasicStaLtaEngine<float, float>;
+template class BasicStaLtaEngine<uint32_t, int64_t>;
+
+PgaTracker::PgaTracker(int windowSamples) {
+    size_t window = static_cast<size_t>(std::max(1, windowSamples));
+    magnitudePeak.setWindow(window);
+    xPeak.setWindow(window);
+    yPeak.setWindow(window);
+    zPeak.setWindow(window);
+}
+
+void PgaTracker::update(const AccelSample& sample, float magnitude) {
+    magnitudePeak.push(magnitude / 9.81f);
+    xPeak.push(std::abs(sample.x) / 9.81f);
+    yPeak.push(std::abs(sample.y) / 9.81f);
+    zPeak.push(std::abs(sample.z) / 9.81f);
+}
+
+float PgaTracker::getPGA() const {
+    return magnitudePeak.max();
+}
+
+AxisPeaks PgaTracker::getAxisPeaks() const {
+    AxisPeaks peaks;
+    peaks.x = xPeak.max();
+    peaks.y = yPeak.max();
+    peaks.z = zPeak.max();
+    return peaks;
+}
+
+void PgaTracker::reset() {
+    magnitudePeak.clear();
+    xPeak.clear();
+    yPeak.clear();
+    zPeak.clear();
+}
+
+CavAccumulator::CavAccumulator(int sampleRate, CavMode mode)
+    : dt(1.0f / sampleRate),
+      mode(mode),
+      binSamples(std::max(1, static_cast<int>(CAV_STANDARDIZED_BIN_SEC * sampleRate))) {
+    reset();
+}
+
+void CavAccumulator::start() {
+    reset();
+}
+
+void CavAccumulator::update(float accelerationG) {
+    float absolute = std::abs(accelerationG);
+
+    if (mode == CAV_CUMULATIVE) {
+        completedCav += absolute * dt;
+        return;
+    }
+
+    binIntegral += absolute * dt;
+    binPeak = std::max(binPeak, absolute);
+    samplesInBin++;
+
+    if (samplesInBin >= binSamples) {
+        completedCav += openBinContribution();
+        samplesInBin = 0;
+        binIntegral = 0.0f;
+        binPeak = 0.0f;
     }
 }
 
-float EarthquakeDetector::calculateMagnitude(float ax, float ay, float az) const {
-    float gravityCompensated = std::sqrt(ax*ax + ay*ay + az*az) - 9.81f;
-    return std::abs(gravityCompensated);
+float CavAccumulator::openBinContribution() const {
+    return (binPeak >= CAV_STANDARDIZED_THRESHOLD_G) ? binIntegral : 0.0f;
 }
 
-float EarthquakeDetector::calculateSTA() const {
-    if (sampleBuffer.size() < staWindowSamples) {
-        return 0.0f;
+float CavAccumulator::getCAV() const {
+    if (mode == CAV_CUMULATIVE) {
+        return completedCav;
     }
+    return completedCav + openBinContribution();
+}
 
-    float sum = 0.0f;
-    int startIdx = sampleBuffer.size() - staWindowSamples;
+void CavAccumulator::reset() {
+    samplesInBin = 0;
+    binIntegral = 0.0f;
+    binPeak = 0.0f;
+    completedCav = 0.0f;
+}
 
-    for (int i = startIdx; i < sampleBuffer.size(); i++) {
-        const AccelSample& s = sampleBuffer[i];
-        float mag = calculateMagnitude(s.x, s.y, s.z);
-        sum += mag * mag;
+DetectorChannel::DetectorChannel()
+    : staLta(1, 1, STA_LTA_SLIDING),
+      triggerThreshold(STA_LTA_TRIGGER_THRESHOLD),
+      detriggerThreshold(STA_LTA_DETRIGGER_THRESHOLD),
+      banded(false),
+      bandX(BandpassDesign()),
+      bandY(BandpassDesign()),
+      bandZ(BandpassDesign()),
+      triggered(false),
+      triggerTime(0) {}
+
+void DetectorChannel::configure(int sampleRate, const DetectorChannelConfig& config, size_t bufferCapacity) {
+    int staWindowSamples = static_cast<int>(config.staWindowSec * sampleRate);
+    int ltaWindowSamples = static_cast<int>(config.ltaWindowSec * sampleRate);
+    StaLtaMode mode = config.mode;
+
+    banded = config.bandHighHz > config.bandLowHz && config.bandLowHz > 0.0f;
+    if (banded) {
+        BandpassDesign design = designButterworthBandpass(
+            sampleRate, config.bandLowHz, std::min(config.bandHighHz, 0.45f * sampleRate), FILTER_ORDER);
+        bandX = ButterworthFilter(design);
+        bandY = ButterworthFilter(design);
+        bandZ = ButterworthFilter(design);
+        mode = STA_LTA_RECURSIVE;
+    } else {
+        int bufferWindowSamples = std::min(ltaWindowSamples + staWindowSamples,
+                                           static_cast<int>(bufferCapacity));
+        ltaWindowSamples = std::min(ltaWindowSamples, bufferWindowSamples - 1);
+        staWindowSamples = std::min(staWindowSamples, ltaWindowSamples);
     }
 
-    return sum / staWindowSamples;
+    staLta = StaLtaEngine(staWindowSamples, ltaWindowSamples, mode);
+    triggerThreshold = config.triggerThreshold;
+    detriggerThreshold = config.detriggerThreshold;
+    reset();
 }
 
-float EarthquakeDetector::calculateLTA() const {
-    if (sampleBuffer.size() < ltaWindowSamples) {
-        return 0.0f;
+void DetectorChannel::update(const AccelSample& sample, const EnergyBuffer& energies) {
+    if (!banded) {
+        staLta.update(energies);
+        return;
     }
 
-    float sum = 0.0f;
-    int startIdx = sampleBuffer.size() - ltaWindowSamples;
+    float x = bandX.process(sample.x);
+    float y = bandY.process(sample.y);
+    float z = bandZ.process(sample.z);
+    staLta.updateUnbuffered(x * x + y * y + z * z);
+}
 
-    for (int i = startIdx; i < sampleBuffer.size() - staWindowSamples; i++) {
-        const AccelSample& s = sampleBuffer[i];
-        float mag = calculateMagnitude(s.x, s.y, s.z);
-        sum += mag * mag;
+bool DetectorChannel::updateTrigger(uint64_t timestamp) {
+    if (!staLta.isReady()) {
+        return false;
     }
 
-    int ltaSamples = ltaWindowSamples - staWindowSamples;
-    return (ltaSamples > 0) ? sum / ltaSamples : 0.0f;
+    float ratio = staLta.getRatio();
+    if (!triggered && ratio > triggerThreshold) {
+        triggered = true;
+        triggerTime = timestamp;
+    } else if (triggered && ratio < detriggerThreshold) {
+        triggered = false;
+    }
+
+    return triggered;
 }
 
-float EarthquakeDetector::calculatePGA() const {
-    if (sampleBuffer.empty()) {
-        return 0.0f;
+bool DetectorChannel::isTriggered() const {
+    return triggered;
+}
+
+bool DetectorChannel::isBanded() const {
+    return banded;
+}
+
+uint64_t DetectorChannel::getTriggerTime() const {
+    return triggerTime;
+}
+
+float DetectorChannel::getRatio() const {
+    return staLta.getRatio();
+}
+
+float DetectorChannel::getNormalizedRatio(float referenceThreshold) const {
+    return staLta.getRatio() * referenceThreshold / triggerThreshold;
+}
+
+const StaLtaEngine& DetectorChannel::getEngine() const {
+    return staLta;
+}
+
+void DetectorChannel::setThresholds(float trigger, float detrigger) {
+    triggerThreshold = trigger;
+    detriggerThreshold = detrigger;
+}
+
+void DetectorChannel::seed(const EnergyBuffer& energies, float background) {
+    staLta.seed(energies, background);
+    rearm();
+}
+
+void DetectorChannel::rearm() {
+    triggered = false;
+    triggerTime = 0;
+}
+
+void DetectorChannel::reset() {
+    staLta.reset();
+    bandX.reset();
+    bandY.reset();
+    bandZ.reset();
+    rearm();
+}
+
+EarthquakeDetector::EarthquakeDetector(int sampleRate, float staWindowSec, float ltaWindowSec,
+                                       float triggerThreshold, float detriggerThreshold,
+                                       StaLtaMode staLtaMode, CavMode cavMode)
+    : sampleRate(sampleRate),
+      triggerThreshold(triggerThreshold),
+      channelCount(1),
+      votesRequired(1),
+      pgaTracker(static_cast<int>(PGA_WINDOW_SEC * sampleRate)),
+      cavAccumulator(sampleRate, cavMode),
+      triggered(false),
+      triggerTime(0) {
+    DetectorChannelConfig primary = {
+        staWindowSec, ltaWindowSec, triggerThreshold, detriggerThreshold, staLtaMode, 0.0f, 0.0f
+    };
+    channels[0].configure(sampleRate, primary, sampleBuffer.capacity());
+}
+
+void EarthquakeDetector::init() {
+    reset();
+}
+
+bool EarthquakeDetector::addChannel(const DetectorChannelConfig& config) {
+    if (channelCount >= DETECTOR_MAX_CHANNELS) {
+        return false;
+    }
+
+    channels[channelCount].configure(sampleRate, config, sampleBuffer.capacity());
+    channelCount++;
+    return true;
+}
+
+void EarthquakeDetector::addConfiguredChannels() {
+    if (LOCAL_CHANNEL_ENABLED) {
+        addChannel(LOCAL_DETECTOR_CHANNEL);
+    }
+    if (BAND_CHANNEL_ENABLED) {
+        addChannel(BAND_DETECTOR_CHANNEL);
     }
+    setVotesRequired(DETECTOR_VOTES_REQUIRED);
+}
+
+void EarthquakeDetector::setVotesRequired(size_t votes) {
+    votesRequired = std::max<size_t>(1, std::min(votes, channelCount));
+}
 
-    float maxPGA = 0.0f;
-    int windowSize = std::min(static_cast<int>(sampleBuffer.size()),
-                              static_cast<int>(3 * sampleRate));
-    int startIdx = sampleBuffer.size() - windowSize;
+bool EarthquakeDetector::setChannelThresholds(size_t channel, float trigger, float detrigger) {
+    if (channel >= channelCount || !(detrigger > 0.0f) || !(trigger > detrigger)) {
+        return false;
+    }
+
+    channels[channel].setThresholds(trigger, detrigger);
+    if (channel == 0) {
+        triggerThreshold = trigger;
+    }
+    return true;
+}
+
+size_t EarthquakeDetector::getChannelCount() const {
+    return channelCount;
+}
+
+float EarthquakeDetector::getChannelRatio(size_t channel) const {
+    return channel < channelCount ? channels[channel].getRatio() : 0.0f;
+}
 
-    for (int i = startIdx; i < sampleBuffer.size(); i++) {
-        const AccelSample& s = sampleBuffer[i];
-        float mag = calculateMagnitude(s.x, s.y, s.z);
-        float pgaG = mag / 9.81f;
-        if (pgaG > maxPGA) {
-            maxPGA = pgaG;
+uint32_t EarthquakeDetector::getTriggeredChannels() const {
+    uint32_t mask = 0;
+    for (size_t i = 0; i < channelCount; i++) {
+        if (channels[i].isTriggered()) {
+            mask |= 1UL << i;
         }
     }
+    return mask;
+}
+
+void EarthquakeDetector::addSample(float ax, float ay, float az) {
+    AccelSample sample;
+    sample.x = ax;
+    sample.y = ay;
+    sample.z = az;
+    sample.timestamp = micros64();
 
-    return maxPGA;
+    addSample(sample);
 }
 
-float EarthquakeDetector::calculateCAV() const {
-    if (sampleBuffer.empty()) {
-        return 0.0f;
+void EarthquakeDetector::addSample(const AccelSample& sample) {
+    float mag = updateBuffers(sample);
+
+    size_t votes = 0;
+    uint64_t onset = sample.timestamp;
+    for (size_t i = 0; i < channelCount; i++) {
+        if (channels[i].updateTrigger(sample.timestamp)) {
+            votes++;
+            onset = std::min(onset, channels[i].getTriggerTime());
+        }
     }
 
-    float cav = 0.0f;
-    float dt = 1.0f / sampleRate;
-    int startIdx = 0;
+    if (!triggered && votes >= votesRequired) {
+        triggered = true;
+        triggerTime = onset;
+        currentEvent.startTime = triggerTime;
+        currentEvent.pga = 0.0f;
+        currentEvent.pgaAxes = AxisPeaks();
+        currentEvent.cav = 0.0f;
+        cavAccumulator.start();
+    }
+
+    if (triggered) {
+        float pga = calculatePGA();
+
+        if (pga > currentEvent.pga) {
+            currentEvent.pga = pga;
+        }
 
-    if (triggerTime > 0) {
-        for (int i = 0; i < sampleBuffer.size(); i++) {
-            if (sampleBuffer[i].timestamp >= triggerTime) {
-                startIdx = i;
-                break;
+        AxisPeaks axisPeaks = pgaTracker.getAxisPeaks();
+        currentEvent.pgaAxes.x = std::max(currentEvent.pgaAxes.x, axisPeaks.x);
+        currentEvent.pgaAxes.y = std::max(currentEvent.pgaAxes.y, axisPeaks.y);
+        currentEvent.pgaAxes.z = std::max(currentEvent.pgaAxes.z, axisPeaks.z);
+
+        cavAccumulator.update(mag / 9.81f);
+        currentEvent.cav = calculateCAV();
+        currentEvent.alertLevel = determineAlertLevel(currentEvent.pga);
+
+        if (votes == 0) {
+            currentEvent.duration = static_cast<unsigned long>((sample.timestamp - triggerTime) / 1000ULL);
+
+            if (currentEvent.duration >= MIN_EVENT_DURATION_SEC * 1000) {
+                currentEvent.confirmed = true;
+                currentEvent.magnitude = calculateMagnitudeEstimate(currentEvent.pga, 10.0f);
             }
+
+            triggered = false;
         }
     }
+}
+
+float EarthquakeDetector::updateBuffers(const AccelSample& sample) {
+    sampleBuffer.push(sample);
 
-    for (int i = startIdx; i < sampleBuffer.size(); i++) {
-        const AccelSample& s = sampleBuffer[i];
-        float mag = calculateMagnitude(s.x, s.y, s.z);
-        float pgaG = mag / 9.81f;
-        cav += std::abs(pgaG) * dt;
+    float mag = calculateMagnitude(sample.x, sample.y, sample.z);
+    energyBuffer.push(mag * mag);
+    for (size_t i = 0; i < channelCount; i++) {
+        channels[i].update(sample, energyBuffer);
     }
+    pgaTracker.update(sample, mag);
+
+    return mag;
+}
+
+float EarthquakeDetector::calculateMagnitude(float ax, float ay, float az) const {
+    return std::sqrt(ax*ax + ay*ay + az*az);
+}
+
+float EarthquakeDetector::calculateSTA() const {
+    return channels[0].getEngine().getSTA();
+}
 
-    return cav;
+float EarthquakeDetector::calculateLTA() const {
+    return channels[0].getEngine().getLTA();
+}
+
+float EarthquakeDetector::calculatePGA() const {
+    return pgaTracker.getPGA();
 }
 
-float EarthquakeDetector::calculateMagnitudeEstimate(float pga, float distance) const {
+float EarthquakeDetector::calculateCAV() const {
+    return cavAccumulator.getCAV();
+}
+
+float EarthquakeDetector::calculateMagnitudeEstimate(float pga, float distance) {
     float pgaCmS2 = pga * 981.0f;
 
     float C1 = 2.0f;
@@ -178,97 +566,180 @@ float EarthquakeDetector::calculateMagnitudeEstimate(float pga, float distance)
     return std::max(0.0f, std::min(10.0f, Mw));
 }
 
-String EarthquakeDetector::determineAlertLevel(float pga) const {
+AlertLevel EarthquakeDetector::determineAlertLevel(float pga) {
     if (pga >= PGA_THRESHOLD_VIOLENT) {
-        return "EXTREME";
+        return AlertLevel::EXTREME;
     } else if (pga >= PGA_THRESHOLD_SEVERE) {
-        return "SEVERE";
+        return AlertLevel::SEVERE;
     } else if (pga >= PGA_THRESHOLD_STRONG) {
-        return "STRONG";
+        return AlertLevel::STRONG;
     } else if (pga >= PGA_THRESHOLD_MODERATE) {
-        return "MODERATE";
+        return AlertLevel::MODERATE;
     } else if (pga >= PGA_THRESHOLD_LIGHT) {
-        return "LIGHT";
+        return AlertLevel::LIGHT;
+    }
+    return AlertLevel::NEGLIGIBLE;
+}
+
+static const char* const ALERT_LEVEL_NAMES[] = {
+    "NEGLIGIBLE", "LIGHT", "MODERATE", "STRONG", "SEVERE", "EXTREME"
+};
+
+constexpr size_t ALERT_LEVEL_COUNT = sizeof(ALERT_LEVEL_NAMES) / sizeof(ALERT_LEVEL_NAMES[0]);
+
+const char* alertLevelName(AlertLevel level) {
+    size_t index = static_cast<size_t>(level);
+    return index < ALERT_LEVEL_COUNT ? ALERT_LEVEL_NAMES[index] : ALERT_LEVEL_NAMES[0];
+}
+
+AlertLevel parseAlertLevel(const char* name) {
+    for (size_t i = 0; i < ALERT_LEVEL_COUNT; i++) {
+        if (strcmp(name, ALERT_LEVEL_NAMES[i]) == 0) {
+            return static_cast<AlertLevel>(i);
+        }
     }
-    return "NEGLIGIBLE";
+    return AlertLevel::NEGLIGIBLE;
 }
 
 bool EarthquakeDetector::isTriggered() const {
     return triggered;
 }
 
+bool EarthquakeDetector::hasConfirmedEvent() const {
+    return currentEvent.confirmed;
+}
+
+size_t EarthquakeDetector::copyRecentSamples(AccelSample* output, size_t maxSamples) const {
+    size_t count = std::min(maxSamples, sampleBuffer.size());
+    size_t first = sampleBuffer.size() - count;
+
+    for (size_t i = 0; i < count; i++) {
+        output[i] = sampleBuffer[first + i];
+    }
+
+    return count;
+}
+
 EarthquakeEvent EarthquakeDetector::getCurrentEvent() const {
     return currentEvent;
 }
 
 float EarthquakeDetector::getStaLtaRatio() const {
-    float sta = calculateSTA();
-    float lta = calculateLTA();
-    return (lta > 0.0001f) ? sta / lta : 0.0f;
+    float ratio = channels[0].getRatio();
+    for (size_t i = 1; i < channelCount; i++) {
+        ratio = std::max(ratio, channels[i].getNormalizedRatio(triggerThreshold));
+    }
+    return ratio;
 }
 
 float EarthquakeDetector::getCurrentPGA() const {
     return calculatePGA();
 }
 
+AxisPeaks EarthquakeDetector::getCurrentAxisPeaks() const {
+    return pgaTracker.getAxisPeaks();
+}
+
 float EarthquakeDetector::getCurrentCAV() const {
     return calculateCAV();
 }
 
-void EarthquakeDetector::reset() {
-    sampleBuffer.clear();
-    triggered = false;
-    triggerTime = 0;
-    currentEvent = EarthquakeEvent();
-}
+bool EarthquakeDetector::captureWarmState(DetectorWarmState& state) const {
+    if (triggered) {
+        return false;
+    }
 
-ButterworthFilter::ButterworthFilter(float sampleRate, float lowCutoff, float highCutoff, int order)
-    : order(order) {
+    state = DetectorWarmState();
+    state.sampleRate = static_cast<uint16_t>(sampleRate);
+    state.channelCount = static_cast<uint16_t>(channelCount);
 
-    float wl = 2.0f * lowCutoff / sampleRate;
-    float wh = 2.0f * highCutoff / sampleRate;
+    for (size_t i = 0; i < channelCount; i++) {
+        const StaLtaEngine& engine = channels[i].getEngine();
+        if (!engine.isReady()) {
+            return false;
+        }
 
-    float bw = wh - wl;
-    float w0 = std::sqrt(wl * wh);
+        state.staWindowSamples[i] = static_cast<uint16_t>(engine.getStaWindowSamples());
+        state.ltaWindowSamples[i] = static_cast<uint16_t>(engine.getLtaWindowSamples());
+        state.background[i] = engine.getLTA();
+    }
 
-    float alpha = std::sin(PI * w0) * std::sinh(std::log(2.0f) / 2.0f * bw * PI * w0 / std::sin(PI * w0));
+    return state.background[0] > 0.0f;
+}
 
-    float cosW0 = std::cos(PI * w0);
+bool EarthquakeDetector::restoreWarmState(const DetectorWarmState& state) {
+    if (state.sampleRate != sampleRate || state.channelCount != channelCount) {
+        return false;
+    }
 
-    b[0] = alpha;
-    b[1] = 0.0f;
-    b[2] = -alpha;
+    for (size_t i = 0; i < channelCount; i++) {
+        const StaLtaEngine& engine = channels[i].getEngine();
+        if (state.staWindowSamples[i] != engine.getStaWindowSamples() ||
+            state.ltaWindowSamples[i] != engine.getLtaWindowSamples() ||
+            !(state.background[i] > 0.0f)) {
+            return false;
+        }
+    }
 
-    a[0] = 1.0f + alpha;
-    a[1] = -2.0f * cosW0;
-    a[2] = 1.0f - alpha;
+    reset();
+    while (!energyBuffer.full()) {
+        energyBuffer.push(state.background[0]);
+    }
+    for (size_t i = 0; i < channelCount; i++) {
+        channels[i].seed(energyBuffer, state.background[i]);
+    }
 
-    for (int i = 0; i < 3; i++) {
-        b[i] /= a[0];
+    return true;
+}
+
+void EarthquakeDetector::rearm() {
+    for (size_t i = 0; i < channelCount; i++) {
+        channels[i].rearm();
     }
-    a[1] /= a[0];
-    a[2] /= a[0];
-    a[0] = 1.0f;
+    cavAccumulator.reset();
+    triggered = false;
+    triggerTime = 0;
+    currentEvent = EarthquakeEvent();
+}
+
+void EarthquakeDetector::reset() {
+    sampleBuffer.clear();
+    energyBuffer.clear();
+    for (size_t i = 0; i < channelCount; i++) {
+        channels[i].reset();
+    }
+    pgaTracker.reset();
+    cavAccumulator.reset();
+    triggered = false;
+    triggerTime = 0;
+    currentEvent = EarthquakeEvent();
+}
 
+ButterworthFilter::ButterworthFilter(float sampleRate, float lowCutoff, float highCutoff, int order)
+    : ButterworthFilter(designButterworthBandpass(sampleRate, lowCutoff, highCutoff, order)) {}
+
+ButterworthFilter::ButterworthFilter(const BandpassDesign& design) : design(design) {
     reset();
 }
 
 float ButterworthFilter::process(float input) {
-    for (int i = 4; i > 0; i--) {
-        x[i] = x[i-1];
-        y[i] = y[i-1];
+    float signal = input;
+
+    for (int i = 0; i < design.sectionCount; i++) {
+        const BiquadCoefficients& c = design.sections[i];
+        float output = c.b0 * signal + z1[i];
+        z1[i] = c.b1 * signal - c.a1 * output + z2[i];
+        z2[i] = c.b2 * signal - c.a2 * output;
+        signal = output;
     }
-    x[0] = input;
-
-    y[0] = b[0]*x[0] + b[1]*x[1] + b[2]*x[2] - a[1]*y[1] - a[2]*y[2];
 
-    return y[0];
+    return signal;
 }
 
 void ButterworthFilter::reset() {
-    for (int i = 0; i < 5; i++) {
-        x[i] = 0.0f;
-        y[i] = 0.0f;
+    for (int i = 0; i < FILTER_MAX_SECTIONS; i++) {
+        z1[i] = 0.0f;
+        z2[i] = 0.0f;
     }
 }
 
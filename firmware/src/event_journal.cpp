@@ -0,0 +1,121 @@
+#include "event_journal.h"
+
+static void copyBounded(char* destination, size_t capacity, const char* source) {
+    strncpy(destination, source, capacity - 1);
+    destination[capacity - 1] = '\0';
+}
+
+static uint32_t recordCrc(const JournalRecord& record) {
+    return journalCrc32(reinterpret_cast<const uint8_t*>(&record),
+                        sizeof(JournalRecord) - sizeof(record.crc));
+}
+
+uint32_t journalCrc32(const uint8_t* data, size_t length) {
+    uint32_t crc = 0xFFFFFFFFUL;
+
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0U - (crc & 1U)));
+        }
+    }
+
+    return ~crc;
+}
+
+void encodeEventRecord(uint32_t sequence, const EarthquakeEvent& event, const char* deviceId,
+                       JournalRecord& record) {
+    memset(&record, 0, sizeof(record));
+    record.magic = JOURNAL_RECORD_MAGIC;
+    record.sequence = sequence;
+    record.type = JOURNAL_RECORD_EVENT;
+    record.confirmed = event.confirmed ? 1 : 0;
+    record.magnitude = event.magnitude;
+    record.pga = event.pga;
+    record.pgaX = event.pgaAxes.x;
+    record.pgaY = event.pgaAxes.y;
+    record.pgaZ = event.pgaAxes.z;
+    record.pgv = event.pgv;
+    record.cav = event.cav;
+    record.startTime = event.startTime;
+    record.duration = event.duration;
+    copyBounded(record.alertLevel, sizeof(record.alertLevel), alertLevelName(event.alertLevel));
+    copyBounded(record.deviceId, sizeof(record.deviceId), deviceId);
+    record.crc = recordCrc(record);
+}
+
+void encodeSentRecord(uint32_t sequence, JournalRecord& record) {
+    memset(&record, 0, sizeof(record));
+    record.magic = JOURNAL_RECORD_MAGIC;
+    record.sequence = sequence;
+    record.type = JOURNAL_RECORD_SENT;
+    record.crc = recordCrc(record);
+}
+
+void encodeSentThroughRecord(uint32_t sequence, JournalRecord& record) {
+    encodeSentRecord(sequence, record);
+    record.type = JOURNAL_RECORD_SENT_THROUGH;
+    record.crc = recordCrc(record);
+}
+
+bool isValidRecord(const JournalRecord& record) {
+    if (record.magic != JOURNAL_RECORD_MAGIC) {
+        return false;
+    }
+    if (record.type != JOURNAL_RECORD_EVENT && record.type != JOURNAL_RECORD_SENT &&
+        record.type != JOURNAL_RECORD_SENT_THROUGH) {
+        return false;
+    }
+    return record.crc == recordCrc(record);
+}
+
+bool upgradeLegacyRecord(const LegacyJournalRecord& legacy, JournalRecord& record) {
+    if (legacy.magic != JOURNAL_LEGACY_RECORD_MAGIC ||
+        legacy.crc != journalCrc32(reinterpret_cast<const uint8_t*>(&legacy), sizeof(legacy) - sizeof(legacy.crc))) {
+        return false;
+    }
+
+    memset(&record, 0, sizeof(record));
+    record.magic = JOURNAL_RECORD_MAGIC;
+    record.sequence = legacy.sequence;
+    record.type = legacy.type;
+    record.confirmed = legacy.confirmed;
+    record.magnitude = legacy.magnitude;
+    record.pga = legacy.pga;
+    record.pgaX = legacy.pgaX;
+    record.pgaY = legacy.pgaY;
+    record.pgaZ = legacy.pgaZ;
+    record.pgv = legacy.pgv;
+    record.cav = legacy.cav;
+    record.startTime = static_cast<uint64_t>(legacy.startTime) * 1000ULL;
+    record.duration = legacy.duration;
+    memcpy(record.alertLevel, legacy.alertLevel, sizeof(record.alertLevel));
+    memcpy(record.deviceId, legacy.deviceId, sizeof(record.deviceId));
+    record.crc = recordCrc(record);
+    return isValidRecord(record);
+}
+
+void decodeEventRecord(const JournalRecord& record, EarthquakeEvent& event, char* deviceId,
+                       size_t deviceIdCapacity) {
+    char alertLevel[JOURNAL_ALERT_LEVEL_LENGTH + 1];
+    memcpy(alertLevel, record.alertLevel, JOURNAL_ALERT_LEVEL_LENGTH);
+    alertLevel[JOURNAL_ALERT_LEVEL_LENGTH] = '\0';
+
+    size_t deviceIdLength = std::min<size_t>(strnlen(record.deviceId, JOURNAL_DEVICE_ID_LENGTH),
+                                             deviceIdCapacity - 1);
+    memcpy(deviceId, record.deviceId, deviceIdLength);
+    deviceId[deviceIdLength] = '\0';
+
+    event = EarthquakeEvent();
+    event.magnitude = record.magnitude;
+    event.pga = record.pga;
+    event.pgaAxes.x = record.pgaX;
+    event.pgaAxes.y = record.pgaY;
+    event.pgaAxes.z = record.pgaZ;
+    event.pgv = record.pgv;
+    event.cav = record.cav;
+    event.startTime = record.startTime;
+    event.duration = record.duration;
+    event.alertLevel = parseAlertLevel(alertLevel);
+    event.confirmed = record.confirmed != 0;
+}
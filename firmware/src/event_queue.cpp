@@ -1,7 +1,8 @@
 #include "event_queue.h"
-#include <ArduinoJson.h>
 
-EventQueue::EventQueue() {}
+EventQueue::EventQueue() : nextSequence(1), journalRecords(0), journalTorn(false) {
+    queue.reserve(MAX_QUEUE_SIZE + 1);
+}
 
 bool EventQueue::init() {
     if (!SPIFFS.begin(true)) {
@@ -12,19 +13,26 @@ bool EventQueue::init() {
     return loadFromDisk();
 }
 
-bool EventQueue::addEvent(const EarthquakeEvent& event, const String& deviceId) {
+bool EventQueue::addEvent(const EarthquakeEvent& event, const char* deviceId) {
     QueuedEvent queuedEvent;
     queuedEvent.event = event;
-    queuedEvent.deviceId = deviceId;
+    strncpy(queuedEvent.deviceId, deviceId, sizeof(queuedEvent.deviceId) - 1);
+    queuedEvent.deviceId[sizeof(queuedEvent.deviceId) - 1] = '\0';
+    queuedEvent.sequence = nextSequence++;
     queuedEvent.sent = false;
 
     queue.push_back(queuedEvent);
 
+    JournalRecord records[2];
+    size_t recordCount = 0;
+    encodeEventRecord(queuedEvent.sequence, event, deviceId, records[recordCount++]);
+
     if (queue.size() > MAX_QUEUE_SIZE) {
+        encodeSentRecord(queue.front().sequence, records[recordCount++]);
         queue.erase(queue.begin());
     }
 
-    return saveToDisk();
+    return appendRecords(records, recordCount);
 }
 
 bool EventQueue::processQueue(std::function<bool(const QueuedEvent&)> sendFunction) {
@@ -32,17 +40,56 @@ bool EventQueue::processQueue(std::function<bool(const QueuedEvent&)> sendFuncti
 
     for (auto& queuedEvent : queue) {
         if (!queuedEvent.sent) {
-            if (sendFunction(queuedEvent)) {
-                queuedEvent.sent = true;
-                anyProcessed = true;
-            } else {
+            if (!sendFunction(queuedEvent)) {
+                break;
+            }
+
+            queuedEvent.sent = true;
+            anyProcessed = true;
+
+            JournalRecord tombstone;
+            encodeSentRecord(queuedEvent.sequence, tombstone);
+            if (!appendRecords(&tombstone, 1)) {
+                Serial.println("Failed to journal sent event, pausing queue flush");
                 break;
             }
         }
     }
 
-    if (anyProcessed) {
-        saveToDisk();
+    return anyProcessed;
+}
+
+bool EventQueue::processBatch(size_t maxBatchSize,
+                              std::function<bool(const QueuedEvent* const* batch, size_t count)> sendFunction) {
+    QueuedEvent* batch[MQTT_BATCH_MAX_EVENTS];
+    size_t batchLimit = std::min(maxBatchSize, static_cast<size_t>(MQTT_BATCH_MAX_EVENTS));
+    bool anyProcessed = false;
+    size_t index = 0;
+
+    while (index < queue.size()) {
+        size_t count = 0;
+        for (; index < queue.size() && count < batchLimit; index++) {
+            if (!queue[index].sent) {
+                batch[count++] = &queue[index];
+            }
+        }
+
+        if (count == 0 || !sendFunction(batch, count)) {
+            break;
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            batch[i]->sent = true;
+        }
+
+        anyProcessed = true;
+
+        JournalRecord watermark;
+        encodeSentThroughRecord(batch[count - 1]->sequence, watermark);
+        if (!appendRecords(&watermark, 1)) {
+            Serial.println("Failed to journal sent batch, pausing backlog flush");
+            break;
+        }
     }
 
     return anyProcessed;
@@ -68,86 +115,209 @@ void EventQueue::clearSentEvents() {
             [](const QueuedEvent& e) { return e.sent; }),
         queue.end()
     );
-    saveToDisk();
+
+    if (journalRecords > JOURNAL_COMPACT_THRESHOLD) {
+        compact();
+    }
 }
 
 void EventQueue::clearAll() {
     queue.clear();
-    saveToDisk();
+
+    File journal = SPIFFS.open(JOURNAL_FILE, FILE_WRITE);
+    if (journal) {
+        journal.close();
+        journalTorn = false;
+    }
+    journalRecords = 0;
 }
 
-bool EventQueue::saveToDisk() {
-    File file = SPIFFS.open(QUEUE_FILE, FILE_WRITE);
-    if (!file) {
-        Serial.println("Failed to open queue file for writing");
+bool EventQueue::appendRecords(const JournalRecord* records, size_t count) {
+    if (journalTorn) {
+        if (compact()) {
+            return true;
+        }
+        Serial.println("Event journal has a torn tail and could not be compacted");
+        return false;
+    }
+
+    File journal = SPIFFS.open(JOURNAL_FILE, FILE_APPEND);
+    if (!journal) {
+        Serial.println("Failed to open event journal for appending");
         return false;
     }
 
-    DynamicJsonDocument doc(8192);
-    JsonArray events = doc.createNestedArray("events");
+    size_t bytes = count * sizeof(JournalRecord);
+    size_t written = journal.write(reinterpret_cast<const uint8_t*>(records), bytes);
+    journal.close();
+
+    journalRecords += count;
+    if (written != bytes) {
+        journalTorn = true;
+        return false;
+    }
+    return true;
+}
+
+bool EventQueue::compact() {
+    File compacted = SPIFFS.open(JOURNAL_COMPACT_FILE, FILE_WRITE);
+    if (!compacted) {
+        Serial.println("Failed to open event journal for compaction");
+        return false;
+    }
+
+    size_t liveRecords = 0;
+    bool complete = true;
 
     for (const auto& queuedEvent : queue) {
-        JsonObject e = events.createNestedObject();
-        e["deviceId"] = queuedEvent.deviceId;
-        e["sent"] = queuedEvent.sent;
+        if (queuedEvent.sent) {
+            continue;
+        }
 
-        JsonObject evt = e.createNestedObject("event");
-        evt["magnitude"] = queuedEvent.event.magnitude;
-        evt["pga"] = queuedEvent.event.pga;
-        evt["pgv"] = queuedEvent.event.pgv;
-        evt["cav"] = queuedEvent.event.cav;
-        evt["startTime"] = queuedEvent.event.startTime;
-        evt["duration"] = queuedEvent.event.duration;
-        evt["alertLevel"] = queuedEvent.event.alertLevel;
-        evt["confirmed"] = queuedEvent.event.confirmed;
+        JournalRecord record;
+        encodeEventRecord(queuedEvent.sequence, queuedEvent.event, queuedEvent.deviceId, record);
+        if (compacted.write(reinterpret_cast<const uint8_t*>(&record), sizeof(record)) != sizeof(record)) {
+            complete = false;
+            break;
+        }
+        liveRecords++;
     }
 
-    serializeJson(doc, file);
-    file.close();
+    compacted.close();
 
+    if (!complete) {
+        SPIFFS.remove(JOURNAL_COMPACT_FILE);
+        return false;
+    }
+
+    SPIFFS.remove(JOURNAL_FILE);
+    if (!SPIFFS.rename(JOURNAL_COMPACT_FILE, JOURNAL_FILE)) {
+        Serial.println("Failed to replace event journal after compaction");
+        return false;
+    }
+
+    journalRecords = liveRecords;
+    journalTorn = false;
     return true;
 }
 
-bool EventQueue::loadFromDisk() {
-    if (!SPIFFS.exists(QUEUE_FILE)) {
-        return true;
+void EventQueue::markSent(uint32_t sequence) {
+    for (auto& queuedEvent : queue) {
+        if (queuedEvent.sequence == sequence) {
+            queuedEvent.sent = true;
+            return;
+        }
+    }
+}
+
+void EventQueue::markSentThrough(uint32_t sequence) {
+    for (auto& queuedEvent : queue) {
+        if (queuedEvent.sequence <= sequence) {
+            queuedEvent.sent = true;
+        }
+    }
+}
+
+static bool readJournalRecord(File& journal, bool legacy, JournalRecord& record) {
+    if (!legacy) {
+        return journal.read(reinterpret_cast<uint8_t*>(&record), sizeof(record)) == sizeof(record);
     }
 
-    File file = SPIFFS.open(QUEUE_FILE, FILE_READ);
-    if (!file) {
-        Serial.println("Failed to open queue file for reading");
+    LegacyJournalRecord legacyRecord;
+    if (journal.read(reinterpret_cast<uint8_t*>(&legacyRecord), sizeof(legacyRecord)) != sizeof(legacyRecord)) {
         return false;
     }
+    if (!upgradeLegacyRecord(legacyRecord, record)) {
+        memset(&record, 0, sizeof(record));
+    }
+    return true;
+}
 
-    DynamicJsonDocument doc(8192);
-    DeserializationError error = deserializeJson(doc, file);
-    file.close();
+bool EventQueue::loadFromDisk() {
+    if (!SPIFFS.exists(JOURNAL_FILE)) {
+        if (SPIFFS.exists(JOURNAL_COMPACT_FILE)) {
+            SPIFFS.rename(JOURNAL_COMPACT_FILE, JOURNAL_FILE);
+        } else {
+            return true;
+        }
+    }
 
-    if (error) {
-        Serial.println("Failed to parse queue file");
+    File journal = SPIFFS.open(JOURNAL_FILE, FILE_READ);
+    if (!journal) {
+        Serial.println("Failed to open event journal for reading");
         return false;
     }
 
     queue.clear();
-    JsonArray events = doc["events"];
+    journalRecords = 0;
+    size_t corruptRecords = 0;
 
-    for (JsonObject e : events) {
-        QueuedEvent queuedEvent;
-        queuedEvent.deviceId = e["deviceId"].as<String>();
-        queuedEvent.sent = e["sent"];
-
-        JsonObject evt = e["event"];
-        queuedEvent.event.magnitude = evt["magnitude"];
-        queuedEvent.event.pga = evt["pga"];
-        queuedEvent.event.pgv = evt["pgv"];
-        queuedEvent.event.cav = evt["cav"];
-        queuedEvent.event.startTime = evt["startTime"];
-        queuedEvent.event.duration = evt["duration"];
-        queuedEvent.event.alertLevel = evt["alertLevel"].as<String>();
-        queuedEvent.event.confirmed = evt["confirmed"];
+    uint32_t magic = 0;
+    bool legacy = journal.read(reinterpret_cast<uint8_t*>(&magic), sizeof(magic)) == sizeof(magic) &&
+                  magic == JOURNAL_LEGACY_RECORD_MAGIC;
+    journal.seek(0);
+
+    size_t tornBytes = journal.size() % (legacy ? sizeof(LegacyJournalRecord) : sizeof(JournalRecord));
+    journalTorn = tornBytes > 0;
+
+    JournalRecord record;
+    while (readJournalRecord(journal, legacy, record)) {
+        journalRecords++;
+
+        if (!isValidRecord(record)) {
+            corruptRecords++;
+            continue;
+        }
+
+        if (record.sequence >= nextSequence) {
+            nextSequence = record.sequence + 1;
+        }
 
+        if (record.type == JOURNAL_RECORD_SENT) {
+            markSent(record.sequence);
+            continue;
+        }
+
+        if (record.type == JOURNAL_RECORD_SENT_THROUGH) {
+            markSentThrough(record.sequence);
+            continue;
+        }
+
+        QueuedEvent queuedEvent;
+        decodeEventRecord(record, queuedEvent.event, queuedEvent.deviceId, sizeof(queuedEvent.deviceId));
+        queuedEvent.sequence = record.sequence;
+        queuedEvent.sent = false;
         queue.push_back(queuedEvent);
     }
 
+    journal.close();
+
+    if (corruptRecords > 0) {
+        Serial.printf("Skipped %u corrupt event journal records\n", static_cast<unsigned>(corruptRecords));
+    }
+
+    if (journalTorn) {
+        Serial.printf("Dropped %u bytes of a torn event journal record\n", static_cast<unsigned>(tornBytes));
+    }
+
+    if (legacy) {
+        Serial.println("Upgrading event journal to 64-bit timestamps");
+    }
+
+    queue.erase(
+        std::remove_if(queue.begin(), queue.end(),
+            [](const QueuedEvent& e) { return e.sent; }),
+        queue.end()
+    );
+
+    bool trimmed = queue.size() > MAX_QUEUE_SIZE;
+    while (queue.size() > MAX_QUEUE_SIZE) {
+        queue.erase(queue.begin());
+    }
+
+    if (journalRecords > JOURNAL_COMPACT_THRESHOLD || corruptRecords > 0 || trimmed || legacy || journalTorn) {
+        compact();
+    }
+
     return true;
 }
@@ -0,0 +1,84 @@
+#include "event_recorder.h"
+#include "waveform_codec.h"
+
+EventRecorder::EventRecorder(uint16_t sampleRate, float scale)
+    : sampleRate(sampleRate), scale(scale), samples(nullptr), psram(false),
+      postRollRemaining(0), capturePending(false), header(), state(CAPTURE_IDLE) {}
+
+EventRecorder::~EventRecorder() {
+    free(samples);
+}
+
+bool EventRecorder::begin() {
+    size_t bytes = CAPTURE_MAX_SAMPLES * 3 * sizeof(int16_t);
+
+    psram = psramFound();
+    samples = static_cast<int16_t*>(psram ? ps_malloc(bytes) : malloc(bytes));
+    if (samples == nullptr) {
+        psram = false;
+        return false;
+    }
+
+    return true;
+}
+
+void EventRecorder::requestCapture() {
+    capturePending = samples != nullptr;
+}
+
+bool EventRecorder::isCapturePending() const {
+    return capturePending;
+}
+
+void EventRecorder::cancel() {
+    uint8_t current = state.load(std::memory_order_acquire);
+    if ((current == CAPTURE_RECORDING || current == CAPTURE_POST_ROLL) &&
+        (header.flags & CAPTURE_FLAG_MANUAL) == 0) {
+        state.store(CAPTURE_IDLE, std::memory_order_relaxed);
+    }
+}
+
+bool EventRecorder::isReady() const {
+    return getState() == CAPTURE_READY;
+}
+
+CaptureState EventRecorder::getState() const {
+    return static_cast<CaptureState>(state.load(std::memory_order_acquire));
+}
+
+const CaptureHeader& EventRecorder::getHeader() const {
+    return header;
+}
+
+const int16_t* EventRecorder::getSamples() const {
+    return samples;
+}
+
+size_t EventRecorder::getSampleBytes() const {
+    return header.sampleCount * 3 * sizeof(int16_t);
+}
+
+bool EventRecorder::usesPsram() const {
+    return psram;
+}
+
+void EventRecorder::release() {
+    state.store(CAPTURE_IDLE, std::memory_order_release);
+}
+
+void EventRecorder::append(const AccelSample& sample) {
+    if (header.sampleCount >= CAPTURE_MAX_SAMPLES) {
+        header.flags |= CAPTURE_FLAG_TRUNCATED;
+        return;
+    }
+
+    int16_t* slot = samples + header.sampleCount * 3;
+    slot[0] = quantizeCounts(sample.x, scale);
+    slot[1] = quantizeCounts(sample.y, scale);
+    slot[2] = quantizeCounts(sample.z, scale);
+    header.sampleCount++;
+}
+
+void EventRecorder::finish() {
+    state.store(CAPTURE_READY, std::memory_order_release);
+}
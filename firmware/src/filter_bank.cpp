@@ -0,0 +1,181 @@
+#include "filter_bank.h"
+
+AxisFilterBank::AxisFilterBank(const BandpassDesign& design, float processNoise, float measurementNoise)
+    : design(design), processNoise(processNoise), measurementNoise(measurementNoise) {
+    reset();
+}
+
+void AxisFilterBank::process(const AccelSample* input, AccelSample* output, size_t count) {
+    alignas(16) float lanes[FILTER_BANK_LANES];
+
+    for (size_t i = 0; i < count; i++) {
+        lanes[0] = input[i].x;
+        lanes[1] = input[i].y;
+        lanes[2] = input[i].z;
+        lanes[3] = 0.0f;
+
+        step(lanes);
+
+        output[i].x = lanes[0];
+        output[i].y = lanes[1];
+        output[i].z = lanes[2];
+        output[i].timestamp = input[i].timestamp;
+    }
+}
+
+AccelSample AxisFilterBank::process(const AccelSample& input) {
+    AccelSample output;
+    process(&input, &output, 1);
+    return output;
+}
+
+void AxisFilterBank::prime(const AccelSample& level) {
+    const float input[FILTER_BANK_LANES] = {level.x, level.y, level.z, 0.0f};
+
+    reset();
+    for (int lane = 0; lane < FILTER_BANK_LANES; lane++) {
+        float x = input[lane];
+
+        for (int section = 0; section < design.sectionCount; section++) {
+            const BiquadCoefficients& c = design.sections[section];
+            float y = x * (c.b0 + c.b1 + c.b2) / (1.0f + c.a1 + c.a2);
+            z2[section][lane] = c.b2 * x - c.a2 * y;
+            z1[section][lane] = c.b1 * x - c.a1 * y + z2[section][lane];
+            x = y;
+        }
+
+        estimate[lane] = x;
+    }
+}
+
+void AxisFilterBank::reset() {
+    errorCovariance = 1.0f;
+    for (int lane = 0; lane < FILTER_BANK_LANES; lane++) {
+        for (int section = 0; section < FILTER_MAX_SECTIONS; section++) {
+            z1[section][lane] = 0.0f;
+            z2[section][lane] = 0.0f;
+        }
+        estimate[lane] = 0.0f;
+    }
+}
+
+void AxisFilterBank::step(float* lanes) {
+    for (int section = 0; section < design.sectionCount; section++) {
+        const BiquadCoefficients& c = design.sections[section];
+        float* s1 = z1[section];
+        float* s2 = z2[section];
+
+        for (int lane = 0; lane < FILTER_BANK_LANES; lane++) {
+            float input = lanes[lane];
+            float output = c.b0 * input + s1[lane];
+            s1[lane] = c.b1 * input - c.a1 * output + s2[lane];
+            s2[lane] = c.b2 * input - c.a2 * output;
+            lanes[lane] = output;
+        }
+    }
+
+    float predicted = errorCovariance + processNoise;
+    float gain = predicted / (predicted + measurementNoise);
+    errorCovariance = (1.0f - gain) * predicted;
+
+    for (int lane = 0; lane < FILTER_BANK_LANES; lane++) {
+        estimate[lane] += gain * (lanes[lane] - estimate[lane]);
+        lanes[lane] = estimate[lane];
+    }
+}
+
+FixedAxisFilterBank::FixedAxisFilterBank(const FixedBandpassDesign& design, const KalmanGainSchedule& gains)
+    : design(design), gains(gains) {
+    reset();
+}
+
+void FixedAxisFilterBank::process(const RawAccelSample* input, RawAccelSample* output, size_t count) {
+    int32_t lanes[FILTER_BANK_LANES];
+    const int32_t rounding = 1 << (FIXED_SIGNAL_FRACTION_BITS - 1);
+
+    for (size_t i = 0; i < count; i++) {
+        lanes[0] = static_cast<int32_t>(input[i].x) * (1 << FIXED_SIGNAL_FRACTION_BITS);
+        lanes[1] = static_cast<int32_t>(input[i].y) * (1 << FIXED_SIGNAL_FRACTION_BITS);
+        lanes[2] = static_cast<int32_t>(input[i].z) * (1 << FIXED_SIGNAL_FRACTION_BITS);
+        lanes[3] = 0;
+
+        step(lanes);
+
+        output[i].x = saturateInt16((lanes[0] + rounding) >> FIXED_SIGNAL_FRACTION_BITS);
+        output[i].y = saturateInt16((lanes[1] + rounding) >> FIXED_SIGNAL_FRACTION_BITS);
+        output[i].z = saturateInt16((lanes[2] + rounding) >> FIXED_SIGNAL_FRACTION_BITS);
+        output[i].timestamp = input[i].timestamp;
+    }
+}
+
+RawAccelSample FixedAxisFilterBank::process(const RawAccelSample& input) {
+    RawAccelSample output;
+    process(&input, &output, 1);
+    return output;
+}
+
+void FixedAxisFilterBank::prime(const RawAccelSample& level) {
+    const int32_t input[FILTER_BANK_LANES] = {level.x, level.y, level.z, 0};
+    const double coefficientScale = 1.0 / (1 << FIXED_COEFFICIENT_FRACTION_BITS);
+
+    reset();
+    for (int lane = 0; lane < FILTER_BANK_LANES; lane++) {
+        double x = static_cast<double>(input[lane]) * (1 << FIXED_SIGNAL_FRACTION_BITS);
+
+        for (int section = 0; section < design.sectionCount; section++) {
+            const FixedBiquadCoefficients& c = design.sections[section];
+            double b0 = c.b0 * coefficientScale;
+            double b1 = c.b1 * coefficientScale;
+            double b2 = c.b2 * coefficientScale;
+            double a1 = c.a1 * coefficientScale;
+            double a2 = c.a2 * coefficientScale;
+            double y = x * (b0 + b1 + b2) / (1.0 + a1 + a2);
+            double s2 = b2 * x - a2 * y;
+
+            z2[section][lane] = static_cast<int32_t>(lround(s2));
+            z1[section][lane] = static_cast<int32_t>(lround(b1 * x - a1 * y + s2));
+            x = y;
+        }
+
+        estimate[lane] = static_cast<int32_t>(lround(x));
+    }
+}
+
+void FixedAxisFilterBank::reset() {
+    gainStep = 0;
+    for (int lane = 0; lane < FILTER_BANK_LANES; lane++) {
+        for (int section = 0; section < FILTER_MAX_SECTIONS; section++) {
+            z1[section][lane] = 0;
+            z2[section][lane] = 0;
+        }
+        estimate[lane] = 0;
+    }
+}
+
+void FixedAxisFilterBank::step(int32_t* lanes) {
+    for (int section = 0; section < design.sectionCount; section++) {
+        const FixedBiquadCoefficients& c = design.sections[section];
+        int32_t* s1 = z1[section];
+        int32_t* s2 = z2[section];
+
+        for (int lane = 0; lane < FILTER_BANK_LANES; lane++) {
+            int64_t input = lanes[lane];
+            int32_t output = static_cast<int32_t>((c.b0 * input) >> FIXED_COEFFICIENT_FRACTION_BITS) + s1[lane];
+            s1[lane] = static_cast<int32_t>((c.b1 * input - static_cast<int64_t>(c.a1) * output) >>
+                                            FIXED_COEFFICIENT_FRACTION_BITS) + s2[lane];
+            s2[lane] = static_cast<int32_t>((c.b2 * input - static_cast<int64_t>(c.a2) * output) >>
+                                            FIXED_COEFFICIENT_FRACTION_BITS);
+            lanes[lane] = output;
+        }
+    }
+
+    int64_t gain = gains.gains[gainStep];
+    if (gainStep < KALMAN_GAIN_SCHEDULE_LENGTH - 1) {
+        gainStep++;
+    }
+
+    for (int lane = 0; lane < FILTER_BANK_LANES; lane++) {
+        estimate[lane] += static_cast<int32_t>((gain * (lanes[lane] - estimate[lane])) >> FIXED_GAIN_FRACTION_BITS);
+        lanes[lane] = estimate[lane];
+    }
+}
@@ -0,0 +1,263 @@
+#include "fixed_point_detector.h"
+
+FixedPointDetector::FixedPointDetector(int sampleRate, float staWindowSec, float ltaWindowSec,
+                                       float triggerThreshold, float detriggerThreshold,
+                                       StaLtaMode staLtaMode, CavMode cavMode)
+    : sampleRate(sampleRate),
+      staWindowSamples(static_cast<int>(staWindowSec * sampleRate)),
+      ltaWindowSamples(static_cast<int>(ltaWindowSec * sampleRate)),
+      triggerThresholdQ8(staLtaThresholdQ8(triggerThreshold)),
+      detriggerThresholdQ8(staLtaThresholdQ8(detriggerThreshold)),
+      cavMode(cavMode),
+      cavBinSamples(std::max(1, static_cast<int>(CAV_STANDARDIZED_BIN_SEC * sampleRate))),
+      cavThresholdCounts(accelerationToCounts(CAV_STANDARDIZED_THRESHOLD_G)),
+      staLta(staWindowSamples, ltaWindowSamples, staLtaMode) {
+    int bufferWindowSamples = std::min(ltaWindowSamples + staWindowSamples,
+                                       static_cast<int>(sampleBuffer.capacity()));
+    ltaWindowSamples = std::min(ltaWindowSamples, bufferWindowSamples - 1);
+    staWindowSamples = std::min(staWindowSamples, ltaWindowSamples);
+    staLta = FixedStaLtaEngine(staWindowSamples, ltaWindowSamples, staLtaMode);
+
+    size_t pgaWindow = static_cast<size_t>(std::max(1, static_cast<int>(PGA_WINDOW_SEC * sampleRate)));
+    magnitudePeak.setWindow(pgaWindow);
+    xPeak.setWindow(pgaWindow);
+    yPeak.setWindow(pgaWindow);
+    zPeak.setWindow(pgaWindow);
+
+    reset();
+}
+
+void FixedPointDetector::init() {
+    reset();
+}
+
+bool FixedPointDetector::setChannelThresholds(size_t channel, float trigger, float detrigger) {
+    if (channel != 0 || !(detrigger > 0.0f) || !(trigger > detrigger)) {
+        return false;
+    }
+
+    triggerThresholdQ8 = staLtaThresholdQ8(trigger);
+    detriggerThresholdQ8 = staLtaThresholdQ8(detrigger);
+    return true;
+}
+
+size_t FixedPointDetector::getChannelCount() const {
+    return 1;
+}
+
+void FixedPointDetector::addSample(const RawAccelSample& sample) {
+    int32_t magnitudeCounts = updateBuffers(sample);
+
+    if (!staLta.isReady()) {
+        return;
+    }
+
+    if (!triggered && staLta.ratioExceeds(triggerThresholdQ8)) {
+        triggered = true;
+        triggerTime = sample.timestamp;
+        eventPeak = 0;
+        eventPeakX = 0;
+        eventPeakY = 0;
+        eventPeakZ = 0;
+        cavCompleted = 0;
+        cavBinSum = 0;
+        cavBinPeak = 0;
+        cavSamplesInBin = 0;
+        duration = 0;
+        alertLevel = AlertLevel::NEGLIGIBLE;
+    }
+
+    if (!triggered) {
+        return;
+    }
+
+    updateEvent(magnitudeCounts);
+
+    if (!staLta.ratioExceeds(detriggerThresholdQ8)) {
+        duration = static_cast<unsigned long>((sample.timestamp - triggerTime) / 1000ULL);
+
+        if (duration >= MIN_EVENT_DURATION_SEC * 1000) {
+            confirmed = true;
+            magnitude = EarthquakeDetector::calculateMagnitudeEstimate(countsToG(eventPeak), 10.0f);
+        }
+
+        triggered = false;
+    }
+}
+
+int32_t FixedPointDetector::updateBuffers(const RawAccelSample& sample) {
+    sampleBuffer.push(sample);
+
+    int32_t x = sample.x;
+    int32_t y = sample.y;
+    int32_t z = sample.z;
+    uint32_t energy = static_cast<uint32_t>(x * x) + static_cast<uint32_t>(y * y) + static_cast<uint32_t>(z * z);
+    int32_t magnitudeCounts = static_cast<int32_t>(isqrt64(energy));
+
+    energyBuffer.push(energy);
+    staLta.update(energyBuffer);
+
+    magnitudePeak.push(magnitudeCounts);
+    xPeak.push(x < 0 ? -x : x);
+    yPeak.push(y < 0 ? -y : y);
+    zPeak.push(z < 0 ? -z : z);
+
+    return magnitudeCounts;
+}
+
+void FixedPointDetector::updateEvent(int32_t magnitudeCounts) {
+    int32_t peak = magnitudePeak.max();
+    if (peak > eventPeak) {
+        eventPeak = std::max(eventPeak, peak);
+        alertLevel = EarthquakeDetector::determineAlertLevel(countsToG(eventPeak));
+    }
+
+    eventPeakX = std::max(eventPeakX, xPeak.max());
+    eventPeakY = std::max(eventPeakY, yPeak.max());
+    eventPeakZ = std::max(eventPeakZ, zPeak.max());
+
+    updateCav(magnitudeCounts);
+}
+
+void FixedPointDetector::updateCav(int32_t magnitudeCounts) {
+    if (cavMode == CAV_CUMULATIVE) {
+        cavCompleted += magnitudeCounts;
+        return;
+    }
+
+    cavBinSum += magnitudeCounts;
+    cavBinPeak = std::max(cavBinPeak, magnitudeCounts);
+    cavSamplesInBin++;
+
+    if (cavSamplesInBin >= cavBinSamples) {
+        if (cavBinPeak >= cavThresholdCounts) {
+            cavCompleted += cavBinSum;
+        }
+        cavBinSum = 0;
+        cavBinPeak = 0;
+        cavSamplesInBin = 0;
+    }
+}
+
+int64_t FixedPointDetector::cavCounts() const {
+    if (cavMode == CAV_STANDARDIZED && cavBinPeak >= cavThresholdCounts) {
+        return cavCompleted + cavBinSum;
+    }
+    return cavCompleted;
+}
+
+float FixedPointDetector::countsToG(int32_t counts) {
+    return static_cast<float>(counts) / ACCEL_COUNTS_PER_G;
+}
+
+bool FixedPointDetector::isTriggered() const {
+    return triggered;
+}
+
+bool FixedPointDetector::hasConfirmedEvent() const {
+    return confirmed;
+}
+
+EarthquakeEvent FixedPointDetector::getCurrentEvent() const {
+    EarthquakeEvent event = EarthquakeEvent();
+    event.startTime = triggerTime;
+    event.duration = duration;
+    event.pga = countsToG(eventPeak);
+    event.pgaAxes.x = countsToG(eventPeakX);
+    event.pgaAxes.y = countsToG(eventPeakY);
+    event.pgaAxes.z = countsToG(eventPeakZ);
+    event.cav = getCurrentCAV();
+    event.magnitude = magnitude;
+    event.alertLevel = alertLevel;
+    event.confirmed = confirmed;
+    return event;
+}
+
+size_t FixedPointDetector::copyRecentSamples(AccelSample* output, size_t maxSamples) const {
+    size_t count = std::min(maxSamples, sampleBuffer.size());
+    size_t first = sampleBuffer.size() - count;
+
+    for (size_t i = 0; i < count; i++) {
+        output[i] = toAccelSample(sampleBuffer[first + i]);
+    }
+
+    return count;
+}
+
+float FixedPointDetector::getStaLtaRatio() const {
+    return staLta.getRatio();
+}
+
+float FixedPointDetector::getCurrentPGA() const {
+    return countsToG(magnitudePeak.max());
+}
+
+AxisPeaks FixedPointDetector::getCurrentAxisPeaks() const {
+    AxisPeaks peaks;
+    peaks.x = countsToG(xPeak.max());
+    peaks.y = countsToG(yPeak.max());
+    peaks.z = countsToG(zPeak.max());
+    return peaks;
+}
+
+float FixedPointDetector::getCurrentCAV() const {
+    return static_cast<float>(cavCounts()) / (static_cast<float>(ACCEL_COUNTS_PER_G) * sampleRate);
+}
+
+bool FixedPointDetector::captureWarmState(DetectorWarmState& state) const {
+    if (triggered || !staLta.isReady()) {
+        return false;
+    }
+
+    state = DetectorWarmState();
+    state.sampleRate = static_cast<uint16_t>(sampleRate);
+    state.channelCount = 1;
+    state.staWindowSamples[0] = static_cast<uint16_t>(staWindowSamples);
+    state.ltaWindowSamples[0] = static_cast<uint16_t>(ltaWindowSamples);
+    state.background[0] = staLta.getLTA();
+    return state.background[0] > 0.0f;
+}
+
+bool FixedPointDetector::restoreWarmState(const DetectorWarmState& state) {
+    if (state.sampleRate != sampleRate || state.channelCount != 1 ||
+        state.staWindowSamples[0] != staWindowSamples || state.ltaWindowSamples[0] != ltaWindowSamples ||
+        !(state.background[0] >= 1.0f)) {
+        return false;
+    }
+
+    reset();
+    uint32_t background = static_cast<uint32_t>(state.background[0] + 0.5f);
+    while (!energyBuffer.full()) {
+        energyBuffer.push(background);
+    }
+    staLta.seed(energyBuffer, background);
+    return true;
+}
+
+void FixedPointDetector::rearm() {
+    triggered = false;
+    confirmed = false;
+    triggerTime = 0;
+    duration = 0;
+    eventPeak = 0;
+    eventPeakX = 0;
+    eventPeakY = 0;
+    eventPeakZ = 0;
+    cavCompleted = 0;
+    cavBinSum = 0;
+    cavBinPeak = 0;
+    cavSamplesInBin = 0;
+    magnitude = 0.0f;
+    alertLevel = AlertLevel::NEGLIGIBLE;
+}
+
+void FixedPointDetector::reset() {
+    sampleBuffer.clear();
+    energyBuffer.clear();
+    staLta.reset();
+    magnitudePeak.clear();
+    xPeak.clear();
+    yPeak.clear();
+    zPeak.clear();
+    rearm();
+}
@@ -0,0 +1,164 @@
+#include "instrumentation.h"
+
+const uint32_t METRICS_BUCKET_BOUNDS_US[METRICS_BUCKET_COUNT - 1] = {
+    2, 5, 10, 20, 50, 100, 200, 500, 1000, 5000, 20000
+};
+
+const char* metricStageName(MetricStage stage) {
+    switch (stage) {
+        case STAGE_SENSOR_READ: return "sensor_read";
+        case STAGE_FILTER: return "filter";
+        case STAGE_DETECTOR: return "detector";
+        case STAGE_MQTT_LOOP: return "mqtt_loop";
+        case STAGE_ALERT_BROADCAST: return "alert_broadcast";
+        default: return "unknown";
+    }
+}
+
+uint32_t HistogramWindow::averageMicros() const {
+    return count > 0 ? totalMicros / count : 0;
+}
+
+uint32_t HistogramWindow::percentileMicros(float quantile) const {
+    if (count == 0) {
+        return 0;
+    }
+
+    uint32_t rank = static_cast<uint32_t>(ceilf(quantile * count));
+    uint32_t seen = 0;
+    for (size_t i = 0; i < METRICS_BUCKET_COUNT - 1; i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return std::min(METRICS_BUCKET_BOUNDS_US[i], maxMicros);
+        }
+    }
+
+    return maxMicros;
+}
+
+LatencyHistogram::LatencyHistogram() : totalMicros(0), maxMicros(0), collectedTotal(0) {
+    for (size_t i = 0; i < METRICS_BUCKET_COUNT; i++) {
+        buckets[i].store(0, std::memory_order_relaxed);
+        collectedBuckets[i] = 0;
+    }
+}
+
+size_t LatencyHistogram::bucketFor(uint32_t micros) {
+    size_t bucket = 0;
+    while (bucket < METRICS_BUCKET_COUNT - 1 && micros > METRICS_BUCKET_BOUNDS_US[bucket]) {
+        bucket++;
+    }
+    return bucket;
+}
+
+void LatencyHistogram::record(uint32_t micros) {
+    std::atomic<uint32_t>& bucket = buckets[bucketFor(micros)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    totalMicros.store(totalMicros.load(std::memory_order_relaxed) + micros, std::memory_order_relaxed);
+
+    if (micros > maxMicros.load(std::memory_order_relaxed)) {
+        maxMicros.store(micros, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::collect(HistogramWindow& window) {
+    window.count = 0;
+    for (size_t i = 0; i < METRICS_BUCKET_COUNT; i++) {
+        uint32_t current = buckets[i].load(std::memory_order_relaxed);
+        window.buckets[i] = current - collectedBuckets[i];
+        window.count += window.buckets[i];
+        collectedBuckets[i] = current;
+    }
+
+    uint32_t total = totalMicros.load(std::memory_order_relaxed);
+    window.totalMicros = total - collectedTotal;
+    collectedTotal = total;
+    window.maxMicros = maxMicros.exchange(0, std::memory_order_relaxed);
+}
+
+Instrumentation::Instrumentation(int sampleRate)
+    : cyclesPerMicro(1),
+      samplePeriodMicros(1000000UL / std::max(1, sampleRate)),
+      lastSampleTime(0),
+      lastWakeMicros(0),
+      hasSample(false),
+      hasWake(false),
+      samples(0),
+      droppedSamples(0),
+      collectedSamples(0),
+      collectedDropped(0),
+      collectedFifoOverflows(0),
+      collectedQueueDrops(0),
+      lastCollectTime(0) {}
+
+void Instrumentation::begin() {
+    cyclesPerMicro = std::max<uint32_t>(1, ESP.getCpuFreqMHz());
+    lastCollectTime = millis();
+}
+
+void Instrumentation::record(MetricStage stage, uint32_t startCycles) {
+    stages[stage].record((cycles() - startCycles) / cyclesPerMicro);
+}
+
+void Instrumentation::recordWake(uint32_t nowMicros, uint32_t expectedIntervalMicros) {
+    if (hasWake) {
+        uint32_t interval = nowMicros - lastWakeMicros;
+        jitter.record(interval > expectedIntervalMicros ? interval - expectedIntervalMicros
+                                                        : expectedIntervalMicros - interval);
+    }
+
+    lastWakeMicros = nowMicros;
+    hasWake = true;
+}
+
+void Instrumentation::recordSample(uint64_t timestamp) {
+    if (hasSample) {
+        uint32_t gapMicros = static_cast<uint32_t>(timestamp - lastSampleTime);
+        if (gapMicros >= samplePeriodMicros + samplePeriodMicros / 2) {
+            uint32_t missed = (gapMicros + samplePeriodMicros / 2) / samplePeriodMicros - 1;
+            droppedSamples.store(droppedSamples.load(std::memory_order_relaxed) + missed,
+                                 std::memory_order_relaxed);
+        }
+    }
+
+    lastSampleTime = timestamp;
+    hasSample = true;
+    samples.store(samples.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+HeapMetrics Instrumentation::sampleHeap() {
+    HeapMetrics heap;
+    heap.freeBytes = ESP.getFreeHeap();
+    heap.minFreeBytes = ESP.getMinFreeHeap();
+    heap.largestBlock = ESP.getMaxAllocHeap();
+    heap.fragmentation = heap.freeBytes > 0
+        ? static_cast<uint8_t>(100 - std::min<uint32_t>(100, heap.largestBlock * 100ULL / heap.freeBytes))
+        : 0;
+    return heap;
+}
+
+void Instrumentation::collect(MetricsReport& report, uint32_t fifoOverflows, uint32_t queueDrops) {
+    for (size_t i = 0; i < STAGE_COUNT; i++) {
+        stages[i].collect(report.stages[i]);
+    }
+    jitter.collect(report.jitter);
+
+    unsigned long now = millis();
+    report.windowMillis = now - lastCollectTime;
+    lastCollectTime = now;
+
+    uint32_t totalSamples = samples.load(std::memory_order_relaxed);
+    report.samples = totalSamples - collectedSamples;
+    collectedSamples = totalSamples;
+
+    uint32_t totalDropped = droppedSamples.load(std::memory_order_relaxed);
+    report.droppedSamples = totalDropped - collectedDropped;
+    collectedDropped = totalDropped;
+
+    report.fifoOverflows = fifoOverflows - collectedFifoOverflows;
+    collectedFifoOverflows = fifoOverflows;
+    report.queueDrops = queueDrops - collectedQueueDrops;
+    collectedQueueDrops = queueDrops;
+
+    report.heap = sampleHeap();
+}
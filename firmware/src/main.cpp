@@ -3,41 +3,115 @@
 #include <Adafruit_MPU6050.h>
 #include <Adafruit_Sensor.h>
 #include <WiFi.h>
+#include <atomic>
 
 #include "config.h"
 #include "earthquake_detector.h"
 #include "alert_system.h"
 #include "event_queue.h"
+#include "mpu_fifo.h"
+#include "spsc_queue.h"
+#include "waveform_codec.h"
+#include "event_recorder.h"
+#include "capture_store.h"
+#include "command_dispatcher.h"
+#include "filter_bank.h"
+#include "fixed_point.h"
+#include "fixed_point_detector.h"
+#include "instrumentation.h"
+#include "ml_confirmation.h"
+#include "power_manager.h"
+#include "pwave_estimator.h"
+#include "timebase.h"
+#include "warm_start.h"
+
+enum DetectorCommandType {
+    COMMAND_RESET_DETECTOR,
+    COMMAND_SET_THRESHOLDS,
+    COMMAND_SET_STREAMING,
+    COMMAND_TRIGGER_CAPTURE,
+    COMMAND_SET_LOW_POWER,
+    COMMAND_RESTORE_WARM_STATE
+};
+
+struct DetectorCommand {
+    DetectorCommandType type;
+    uint8_t channel;
+    bool enabled;
+    float trigger;
+    float detrigger;
+    DetectorWarmState warmState;
+};
 
 Adafruit_MPU6050 mpu;
-
-EarthquakeDetector detector(SAMPLE_RATE_HZ, STA_WINDOW_SEC, LTA_WINDOW_SEC,
-                             STA_LTA_TRIGGER_THRESHOLD, STA_LTA_DETRIGGER_THRESHOLD);
+MPU6050Fifo mpuFifo(Wire, MPU6050_I2C_ADDRESS);
+
+#if DETECTION_FIXED_POINT
+typedef FixedPointDetector Detector;
+typedef RawAccelSample DetectorSample;
+FixedAxisFilterBank filterBank(FIXED_BANDPASS_DESIGN, FIXED_KALMAN_GAINS);
+FixedAxisFilterBank lowRateFilterBank(FIXED_LOW_POWER_BANDPASS_DESIGN, FIXED_KALMAN_GAINS);
+#else
+typedef EarthquakeDetector Detector;
+typedef AccelSample DetectorSample;
+AxisFilterBank filterBank(FILTER_BANDPASS_DESIGN, KALMAN_PROCESS_NOISE, KALMAN_MEASUREMENT_NOISE);
+AxisFilterBank lowRateFilterBank(LOW_POWER_BANDPASS_DESIGN, KALMAN_PROCESS_NOISE, KALMAN_MEASUREMENT_NOISE);
+#endif
+
+Detector detector(SAMPLE_RATE_HZ, STA_WINDOW_SEC, LTA_WINDOW_SEC,
+                  STA_LTA_TRIGGER_THRESHOLD, STA_LTA_DETRIGGER_THRESHOLD, STA_LTA_MODE);
 
 LocalAlertSystem localAlert(BUZZER_PIN, RED_LED_PIN, YELLOW_LED_PIN, GREEN_LED_PIN);
 MQTTAlertSystem mqttAlert(MQTT_SERVER, MQTT_PORT, MQTT_USER, MQTT_PASSWORD);
 WebhookAlertSystem webhookAlert;
 AlertManager alertManager;
 EventQueue eventQueue;
-
-ButterworthFilter filterX(SAMPLE_RATE_HZ, FILTER_LOW_CUTOFF_HZ, FILTER_HIGH_CUTOFF_HZ, FILTER_ORDER);
-ButterworthFilter filterY(SAMPLE_RATE_HZ, FILTER_LOW_CUTOFF_HZ, FILTER_HIGH_CUTOFF_HZ, FILTER_ORDER);
-ButterworthFilter filterZ(SAMPLE_RATE_HZ, FILTER_LOW_CUTOFF_HZ, FILTER_HIGH_CUTOFF_HZ, FILTER_ORDER);
-
-KalmanFilter kalmanX(0.01, 0.1);
-KalmanFilter kalmanY(0.01, 0.1);
-KalmanFilter kalmanZ(0.01, 0.1);
-
-String deviceId;
-unsigned long lastSampleTime = 0;
-unsigned long sampleInterval = 1000 / SAMPLE_RATE_HZ;
+EventRecorder eventRecorder(SAMPLE_RATE_HZ, WAVEFORM_SCALE);
+MlConfirmation mlConfirmation(SAMPLE_RATE_HZ);
+PWaveEstimator pWaveEstimator(SAMPLE_RATE_HZ);
+CaptureStore captureStore;
+Instrumentation instrumentation(SAMPLE_RATE_HZ);
+PowerManager powerManager(INTERRUPT_PIN, LOW_POWER_WAKE_RATIO, LOW_POWER_FULL_RATE_HOLD_MS);
+WarmStartStore warmStartStore;
+Timebase timebase;
+
+SpscQueue<EarthquakeEvent, CONFIRMED_EVENT_QUEUE_DEPTH> confirmedEvents;
+SpscQueue<PreliminaryEvent, PRELIMINARY_EVENT_QUEUE_DEPTH> preliminaryEvents;
+SpscQueue<AccelSample, SAMPLE_STREAM_QUEUE_DEPTH> sampleStream;
+SpscQueue<DetectorCommand, DETECTOR_COMMAND_QUEUE_DEPTH> detectorCommands;
+SpscQueue<DetectorWarmState, 2> warmStateSnapshots;
+
+std::atomic<float> statusStaLtaRatio(0.0f);
+std::atomic<float> statusPga(0.0f);
+
+TaskHandle_t acquisitionTaskHandle = nullptr;
+TaskHandle_t networkTaskHandle = nullptr;
+
+char deviceId[DEVICE_ID_LENGTH + 1] = "";
 bool wifiConnected = false;
 bool mqttConnected = false;
-
-volatile bool dataReady = false;
+bool fifoAcquisition = false;
+bool sampleStreaming = MQTT_STREAM_SAMPLES;
+bool statusRequested = false;
+bool metricsRequested = false;
+volatile uint32_t fifoNotifyInterval = 1;
+uint32_t acquisitionIntervalMicros = 1000000UL / SAMPLE_RATE_HZ;
+DetectorSample sampleBurst[FIFO_BURST_MAX_SAMPLES];
+DetectorSample lastRawSample = {};
+bool filterPrimed = false;
+WaveformBlockEncoder waveformEncoder(SAMPLE_RATE_HZ, WAVEFORM_SCALE);
+uint8_t waveformPayload[WAVEFORM_MAX_PAYLOAD_SIZE];
 
 void IRAM_ATTR onMPUInterrupt() {
-    dataReady = true;
+    if (mpuFifo.recordInterrupt() % fifoNotifyInterval != 0 || acquisitionTaskHandle == nullptr) {
+        return;
+    }
+
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+    vTaskNotifyGiveFromISR(acquisitionTaskHandle, &higherPriorityTaskWoken);
+    if (higherPriorityTaskWoken) {
+        portYIELD_FROM_ISR();
+    }
 }
 
 void connectWiFi() {
@@ -65,160 +139,715 @@ void connectWiFi() {
 void connectMQTT() {
     if (!wifiConnected) return;
 
-    if (mqttAlert.connect(deviceId.c_str())) {
+    if (mqttAlert.connect(deviceId)) {
         mqttConnected = true;
+        mqttAlert.subscribeCommands(deviceId);
         alertManager.sendStatus("online");
     } else {
         mqttConnected = false;
     }
 }
 
+CommandStatus queueDetectorCommand(const DetectorCommand& command) {
+    return detectorCommands.push(command) ? COMMAND_OK : COMMAND_BUSY;
+}
+
+CommandStatus handleResetCommand(const CommandArguments& arguments) {
+    DetectorCommand command = {COMMAND_RESET_DETECTOR, 0, false, 0.0f, 0.0f};
+    return queueDetectorCommand(command);
+}
+
+CommandStatus handleStatusCommand(const CommandArguments& arguments) {
+    statusRequested = true;
+    return COMMAND_OK;
+}
+
+CommandStatus handleMetricsCommand(const CommandArguments& arguments) {
+    metricsRequested = true;
+    return COMMAND_OK;
+}
+
+CommandStatus handleThresholdsCommand(const CommandArguments& arguments) {
+    float trigger;
+    float detrigger;
+    uint32_t channel = 0;
+    if (!arguments.getNumber("trigger", trigger) || !arguments.getNumber("detrigger", detrigger) ||
+        (arguments.has("channel") && !arguments.getUnsigned("channel", channel))) {
+        return COMMAND_MALFORMED;
+    }
+    if (channel >= detector.getChannelCount() || !(detrigger > 0.0f) || !(trigger > detrigger)) {
+        return COMMAND_REJECTED;
+    }
+
+    DetectorCommand command = {COMMAND_SET_THRESHOLDS, static_cast<uint8_t>(channel), false, trigger, detrigger};
+    return queueDetectorCommand(command);
+}
+
+CommandStatus handleStreamCommand(const CommandArguments& arguments) {
+    DetectorCommand command = {COMMAND_SET_STREAMING, 0, arguments.getBool("enabled", true), 0.0f, 0.0f};
+    return queueDetectorCommand(command);
+}
+
+CommandStatus handleCaptureCommand(const CommandArguments& arguments) {
+    if (eventRecorder.getSamples() == nullptr) {
+        return COMMAND_REJECTED;
+    }
+
+    DetectorCommand command = {COMMAND_TRIGGER_CAPTURE, 0, true, 0.0f, 0.0f};
+    return queueDetectorCommand(command);
+}
+
+CommandStatus handleLowPowerCommand(const CommandArguments& arguments) {
+    bool enabled = arguments.getBool("enabled", true);
+    if (enabled && !fifoAcquisition) {
+        return COMMAND_REJECTED;
+    }
+
+    DetectorCommand command = {COMMAND_SET_LOW_POWER, 0, enabled, 0.0f, 0.0f};
+    return queueDetectorCommand(command);
+}
+
+const CommandHandler COMMAND_TABLE[] = {
+    {"reset", handleResetCommand},
+    {"status", handleStatusCommand},
+    {"metrics", handleMetricsCommand},
+    {"thresholds", handleThresholdsCommand},
+    {"stream", handleStreamCommand},
+    {"capture", handleCaptureCommand},
+    {"low_power", handleLowPowerCommand}
+};
+
+CommandDispatcher commandDispatcher(COMMAND_TABLE, sizeof(COMMAND_TABLE) / sizeof(COMMAND_TABLE[0]));
+
 void mqttCallback(char* topic, byte* payload, unsigned int length) {
-    String message = "";
-    for (unsigned int i = 0; i < length; i++) {
-        message += (char)payload[i];
+    CommandResult result = commandDispatcher.dispatch(payload, length);
+
+    Serial.printf("MQTT command on %s: %s -> %s\n", topic,
+                  result.name[0] != '\0' ? result.name : "?", commandStatusName(result.status));
+
+    if (mqttConnected) {
+        mqttAlert.publishCommandResult(result, deviceId);
     }
+}
+
+void initNetworkServices() {
+    static bool initialized = false;
+    if (!wifiConnected || initialized) return;
+    initialized = true;
 
-    Serial.println("MQTT message received: " + String(topic) + " -> " + message);
+    timebase.begin(TIMEBASE_PPS_PIN);
 
-    if (message == "reset") {
-        detector.reset();
-        Serial.println("Detector reset");
-    } else if (message == "status") {
-        alertManager.sendStatus("alive");
+    mqttAlert.init();
+    mqttAlert.setCallback(mqttCallback);
+    mqttAlert.setTimebase(&timebase);
+
+    if (WEBHOOK_DEVICE_NOTIFICATIONS) {
+        webhookAlert.setPushoverCredentials(PUSHOVER_TOKEN, PUSHOVER_USER);
+        webhookAlert.setTelegramCredentials(TELEGRAM_BOT_TOKEN, TELEGRAM_CHAT_ID);
+        webhookAlert.setDiscordWebhook(DISCORD_WEBHOOK_URL);
+        webhookAlert.begin();
     }
 }
 
-void setup() {
-    Serial.begin(115200);
-    while (!Serial) {
-        delay(10);
+void publishPreliminary(const PreliminaryEvent& event) {
+    if (!preliminaryEvents.push(event)) {
+        Serial.println("Preliminary event queue full, estimate dropped");
+        return;
     }
 
-    Serial.println("Earthquake Alert System Starting...");
+    if (networkTaskHandle != nullptr) {
+        xTaskNotifyGive(networkTaskHandle);
+    }
+}
 
-    deviceId = "ESP32_" + WiFi.macAddress();
-    deviceId.replace(":", "");
-    Serial.println("Device ID: " + deviceId);
+void processSample(const DetectorSample& filtered) {
+    uint32_t start = Instrumentation::cycles();
+    detector.addSample(filtered);
+    instrumentation.record(STAGE_DETECTOR, start);
+    instrumentation.recordSample(filtered.timestamp);
 
-    localAlert.init();
-    Serial.println("Local alert system initialized");
+    if (sampleStreaming || detector.isTriggered() || eventRecorder.getState() != CAPTURE_IDLE ||
+        eventRecorder.isCapturePending()) {
+        const AccelSample& sample = toAccelSample(filtered);
+        eventRecorder.addSample(sample, detector);
 
-    if (!eventQueue.init()) {
-        Serial.println("Event queue initialization failed");
+        if (sampleStreaming) {
+            sampleStream.push(sample);
+        }
+
+        if (ML_CONFIRMATION_ENABLED && detector.isTriggered()) {
+            mlConfirmation.update(sample);
+        }
+
+        if (PWAVE_ENABLED && detector.isTriggered() && pWaveEstimator.update(sample, micros64())) {
+            publishPreliminary(pWaveEstimator.getEstimate());
+        }
     }
 
-    Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN);
+    if (!detector.isTriggered() && !detector.hasConfirmedEvent()) {
+        mlConfirmation.cancel();
+        pWaveEstimator.cancel();
+        return;
+    }
 
-    if (!mpu.begin(MPU6050_I2C_ADDRESS)) {
-        Serial.println("Failed to find MPU6050 chip");
-        while (1) {
-            localAlert.soundAlarm(500, 200);
-            delay(500);
+    EarthquakeEvent event = detector.getCurrentEvent();
+
+    static AlertLevel lastAlertLevel = AlertLevel::NEGLIGIBLE;
+    if (event.alertLevel != lastAlertLevel) {
+        lastAlertLevel = event.alertLevel;
+        localAlert.setAlertLevel(event.alertLevel);
+
+        Serial.printf("Alert Level: %s, PGA: %.4f g, STA/LTA: %.2f\n",
+                      alertLevelName(event.alertLevel), event.pga, detector.getStaLtaRatio());
+    }
+
+    if (event.confirmed && event.duration > 0) {
+        if (ML_CONFIRMATION_ENABLED) {
+            MlDecision decision = mlConfirmation.evaluate();
+            if (decision.overBudget) {
+                Serial.printf("ML inference over budget (%lu us), accepting event\n",
+                              static_cast<unsigned long>(decision.inferenceMicros));
+            } else if (!decision.accepted) {
+                Serial.printf("Event rejected by ML confirmation (p=%.2f)\n", decision.probability);
+                eventRecorder.cancel();
+                detector.rearm();
+                return;
+            }
         }
+
+        Serial.println("CONFIRMED EARTHQUAKE EVENT!");
+        Serial.printf("Magnitude: %.2f, PGA: %.4f g, CAV: %.4f g*s, Duration: %lu ms\n",
+                      event.magnitude, event.pga, event.cav, event.duration);
+
+        alertManager.sendAlert(event, ALERT_LOCAL);
+
+        if (!confirmedEvents.push(event)) {
+            Serial.println("Confirmed event queue full, event dropped");
+        }
+
+        detector.rearm();
     }
+}
 
-    Serial.println("MPU6050 Found!");
+void processHeldSample(const DetectorSample& sample) {
+    DetectorSample held = sample;
+    for (int i = 0; i < LOW_POWER_UPSAMPLE_FACTOR; i++) {
+        held.timestamp = sample.timestamp + i * 1000000ULL / SAMPLE_RATE_HZ;
+        processSample(held);
+    }
+}
 
-    mpu.setAccelerometerRange(MPU6050_RANGE_2_G);
-    mpu.setGyroRange(MPU6050_RANGE_250_DEG);
-    mpu.setFilterBandwidth(MPU6050_BAND_21_HZ);
+void setFullRateNotifyInterval() {
+    fifoNotifyInterval = std::max(1, SAMPLE_RATE_HZ * FIFO_DRAIN_INTERVAL_MS / 1000);
+    acquisitionIntervalMicros = fifoNotifyInterval * 1000000UL / SAMPLE_RATE_HZ;
+}
 
-    detector.init();
-    Serial.println("Earthquake detector initialized");
+bool enterFullRate() {
+    filterBank.prime(lastRawSample);
+    bool configured = mpuFifo.setMotionWake(false, LOW_POWER_MOTION_THRESHOLD_MG, LOW_POWER_MOTION_DURATION_MS) &&
+                      mpuFifo.setLowPassFilter(MPU_DLPF_CONFIG) &&
+                      mpuFifo.setSampleRate(SAMPLE_RATE_HZ);
+    setFullRateNotifyInterval();
 
-    connectWiFi();
+    if (!configured) {
+        Serial.println("Failed to restore full-rate acquisition");
+    }
+    return configured;
+}
 
-    if (wifiConnected) {
-        mqttAlert.init();
-        mqttAlert.setCallback(mqttCallback);
-        connectMQTT();
+bool enterLowRate() {
+    lowRateFilterBank.prime(lastRawSample);
+    bool configured = mpuFifo.setLowPassFilter(LOW_POWER_DLPF_CONFIG) &&
+                      mpuFifo.setSampleRate(LOW_POWER_SAMPLE_RATE_HZ) &&
+                      mpuFifo.setMotionWake(true, LOW_POWER_MOTION_THRESHOLD_MG, LOW_POWER_MOTION_DURATION_MS);
+    fifoNotifyInterval = 1;
+    acquisitionIntervalMicros = LOW_POWER_DRAIN_INTERVAL_MS * 1000UL;
 
-        webhookAlert.setPushoverCredentials(PUSHOVER_TOKEN, PUSHOVER_USER);
-        webhookAlert.setTelegramCredentials(TELEGRAM_BOT_TOKEN, TELEGRAM_CHAT_ID);
-        webhookAlert.setDiscordWebhook(DISCORD_WEBHOOK_URL);
+    if (!configured) {
+        Serial.println("Low-power acquisition setup failed, staying at full rate");
     }
+    return configured;
+}
 
-    alertManager.init(&localAlert, &mqttAlert, &webhookAlert);
-    alertManager.setDeviceId(deviceId);
+void updatePowerMode() {
+    bool active = detector.isTriggered() || eventRecorder.getState() != CAPTURE_IDLE;
+    unsigned long now = millis();
 
-    localAlert.setAlertLevel("NEGLIGIBLE");
-    Serial.println("System ready - monitoring for earthquakes");
+    if (!powerManager.update(detector.getStaLtaRatio(), active, mpuFifo.takeMotion(), now)) {
+        return;
+    }
+
+    if (powerManager.isLowPower()) {
+        if (!enterLowRate()) {
+            powerManager.holdFullRate(now);
+            enterFullRate();
+        }
+    } else {
+        enterFullRate();
+        Serial.printf("Full-rate acquisition resumed (STA/LTA %.2f)\n", detector.getStaLtaRatio());
+    }
+
+    if (networkTaskHandle != nullptr) {
+        xTaskNotifyGive(networkTaskHandle);
+    }
 }
 
-void loop() {
-    unsigned long currentTime = millis();
+void primeFilters(const DetectorSample& raw) {
+    if (filterPrimed) {
+        return;
+    }
+
+    filterBank.prime(raw);
+    filterPrimed = true;
+}
+
+void snapshotWarmState() {
+    static unsigned long lastSnapshotTime = 0;
+    unsigned long now = millis();
+
+    if (!WARM_START_ENABLED || now - lastSnapshotTime < WARM_START_SNAPSHOT_INTERVAL_MS) {
+        return;
+    }
+    lastSnapshotTime = now;
 
-    if (wifiConnected) {
-        if (!mqttAlert.isConnected()) {
-            connectMQTT();
+    DetectorWarmState state;
+    if (detector.captureWarmState(state)) {
+        warmStateSnapshots.push(state);
+    }
+}
+
+void applyDetectorCommands() {
+    DetectorCommand command;
+    while (detectorCommands.pop(command)) {
+        switch (command.type) {
+            case COMMAND_RESET_DETECTOR:
+                detector.rearm();
+                Serial.println("Detector reset");
+                break;
+
+            case COMMAND_SET_THRESHOLDS:
+                if (detector.setChannelThresholds(command.channel, command.trigger, command.detrigger)) {
+                    Serial.printf("Channel %u thresholds set to %.2f / %.2f\n", command.channel,
+                                  command.trigger, command.detrigger);
+                }
+                break;
+
+            case COMMAND_SET_STREAMING:
+                sampleStreaming = command.enabled;
+                Serial.printf("Sample streaming %s\n", sampleStreaming ? "enabled" : "disabled");
+                break;
+
+            case COMMAND_TRIGGER_CAPTURE:
+                eventRecorder.requestCapture();
+                Serial.println("Manual capture requested");
+                break;
+
+            case COMMAND_SET_LOW_POWER:
+                if (!command.enabled && powerManager.isLowPower()) {
+                    enterFullRate();
+                }
+                powerManager.begin(command.enabled && fifoAcquisition, millis());
+                Serial.printf("Low-power mode %s\n", powerManager.isEnabled() ? "enabled" : "disabled");
+                break;
+
+            case COMMAND_RESTORE_WARM_STATE: {
+                DetectorWarmState current;
+                if (detector.isTriggered() || detector.captureWarmState(current)) {
+                    Serial.println("Detector already warm, held snapshot not applied");
+                } else if (detector.restoreWarmState(command.warmState)) {
+                    Serial.println("Detector warm-started from flash snapshot after clock sync");
+                }
+                break;
+            }
         }
+    }
+}
+
+void acquireSamples(TickType_t& lastWakeTime) {
+    if (fifoAcquisition) {
+        bool lowPower = powerManager.isLowPower();
+        if (lowPower) {
+            powerManager.sleep(LOW_POWER_DRAIN_INTERVAL_MS);
+        } else {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ACQUISITION_WAIT_TIMEOUT_MS));
+            instrumentation.recordWake(micros(), acquisitionIntervalMicros);
+        }
+
+        uint32_t start = Instrumentation::cycles();
+        size_t count = mpuFifo.drain(sampleBurst, FIFO_BURST_MAX_SAMPLES);
+        instrumentation.record(STAGE_SENSOR_READ, start);
+        if (count > 0) {
+            primeFilters(sampleBurst[0]);
+            lastRawSample = sampleBurst[count - 1];
+        }
+
+        start = Instrumentation::cycles();
+        (lowPower ? lowRateFilterBank : filterBank).process(sampleBurst, sampleBurst, count);
+        instrumentation.record(STAGE_FILTER, start);
+        for (size_t i = 0; i < count; i++) {
+            if (lowPower) {
+                processHeldSample(sampleBurst[i]);
+            } else {
+                processSample(sampleBurst[i]);
+            }
+        }
+
+        updatePowerMode();
+        return;
+    }
+
+    vTaskDelayUntil(&lastWakeTime, pdMS_TO_TICKS(1000 / SAMPLE_RATE_HZ));
+    instrumentation.recordWake(micros(), acquisitionIntervalMicros);
+
+    uint32_t start = Instrumentation::cycles();
+    sensors_event_t a, g, temp;
+    mpu.getEvent(&a, &g, &temp);
+    instrumentation.record(STAGE_SENSOR_READ, start);
+
+    AccelSample raw;
+    raw.x = a.acceleration.x;
+    raw.y = a.acceleration.y;
+    raw.z = a.acceleration.z;
+    raw.timestamp = micros64();
+
+    DetectorSample converted = convertSample<DetectorSample>(raw);
+    primeFilters(converted);
+
+    start = Instrumentation::cycles();
+    DetectorSample filtered = filterBank.process(converted);
+    instrumentation.record(STAGE_FILTER, start);
+    processSample(filtered);
+}
+
+void acquisitionTask(void* parameter) {
+    TickType_t lastWakeTime = xTaskGetTickCount();
+
+    for (;;) {
+        applyDetectorCommands();
+        acquireSamples(lastWakeTime);
+        snapshotWarmState();
+        localAlert.update();
+
+        statusStaLtaRatio.store(detector.getStaLtaRatio(), std::memory_order_relaxed);
+        statusPga.store(detector.getCurrentPGA(), std::memory_order_relaxed);
+    }
+}
+
+void dispatchPreliminaryEvents() {
+    PreliminaryEvent event;
+    while (preliminaryEvents.pop(event)) {
+        event.onsetTime = timebase.toUtcMicros(event.onsetTime);
+        event.issuedTime = timebase.toUtcMicros(event.issuedTime);
+
+        Serial.printf("Preliminary alert #%u: tau_c %.2f s, Pd %.3f cm, M %.1f, %lu ms after onset\n",
+                      event.update, event.tauC, event.pd, event.magnitude,
+                      static_cast<unsigned long>((event.issuedTime - event.onsetTime) / 1000ULL));
+
+        if (wifiConnected && mqttConnected) {
+            mqttAlert.publishPreliminaryAlert(event, deviceId);
+        }
+    }
+}
+
+void dispatchConfirmedEvents() {
+    EarthquakeEvent event;
+    while (confirmedEvents.pop(event)) {
+        event.startTime = timebase.toUtcMicros(event.startTime);
+
+        if (wifiConnected && mqttConnected) {
+            uint32_t start = Instrumentation::cycles();
+            alertManager.sendAlert(event, ALERT_REMOTE);
+            instrumentation.record(STAGE_ALERT_BROADCAST, start);
+        } else {
+            eventQueue.addEvent(event, deviceId);
+        }
+    }
+}
+
+void flushWaveformBlock() {
+    if (waveformEncoder.empty()) {
+        return;
+    }
+
+    if (mqttConnected) {
+        size_t length = waveformEncoder.encode(waveformPayload, sizeof(waveformPayload));
+        if (length > 0) {
+            mqttAlert.publishWaveform(waveformPayload, length, deviceId);
+        }
+    }
+    waveformEncoder.reset();
+}
+
+void streamSamples() {
+    AccelSample sample;
+    while (sampleStream.pop(sample)) {
+        if (!MQTT_STREAM_BINARY) {
+            if (mqttConnected) {
+                mqttAlert.publishData(sample.x, sample.y, sample.z, deviceId);
+            }
+            continue;
+        }
+
+        sample.timestamp = timebase.toUtcMicros(sample.timestamp);
+        if (!waveformEncoder.isContinuous(sample)) {
+            flushWaveformBlock();
+        }
+        waveformEncoder.add(sample);
+        if (waveformEncoder.full()) {
+            flushWaveformBlock();
+        }
+    }
+}
+
+void radioUp() {
+    powerManager.setRadioActive(true);
+    connectWiFi();
+    initNetworkServices();
+    connectMQTT();
+}
+
+void radioDown() {
+    if (mqttConnected) {
+        alertManager.sendStatus("sleeping");
         mqttAlert.loop();
     }
 
-    if (currentTime - lastSampleTime >= sampleInterval) {
-        lastSampleTime = currentTime;
+    WiFi.disconnect(true);
+    WiFi.mode(WIFI_OFF);
+    wifiConnected = false;
+    mqttConnected = false;
+    powerManager.setRadioActive(false);
+    Serial.println("Radio off, alerts are queued until the next heartbeat");
+}
 
-        sensors_event_t a, g, temp;
-        mpu.getEvent(&a, &g, &temp);
+void manageRadio(unsigned long now) {
+    static unsigned long radioChangeTime = 0;
 
-        float ax = filterX.process(a.acceleration.x);
-        float ay = filterY.process(a.acceleration.y);
-        float az = filterZ.process(a.acceleration.z);
+    bool radioActive = powerManager.isRadioActive();
+    if (!powerManager.isLowPower()) {
+        if (!radioActive) {
+            radioUp();
+            radioChangeTime = now;
+        }
+        return;
+    }
 
-        ax = kalmanX.update(ax);
-        ay = kalmanY.update(ay);
-        az = kalmanZ.update(az);
+    if (radioActive) {
+        bool drained = confirmedEvents.empty() && preliminaryEvents.empty() && eventQueue.getUnsentCount() == 0;
+        if ((drained || !mqttConnected) && now - radioChangeTime >= LOW_POWER_RADIO_WINDOW_MS) {
+            radioDown();
+            radioChangeTime = now;
+        }
+    } else if (now - radioChangeTime >= LOW_POWER_HEARTBEAT_INTERVAL_MS) {
+        Serial.println("Low-power heartbeat, reconnecting");
+        radioUp();
+        radioChangeTime = now;
+    }
+}
 
-        detector.addSample(ax, ay, az);
+void restoreHeldWarmState() {
+    DetectorCommand command = {COMMAND_RESTORE_WARM_STATE, 0, false, 0.0f, 0.0f, DetectorWarmState()};
+    if (warmStartStore.loadPending(command.warmState, timebase.nowMicros()) == WARM_START_FLASH &&
+        queueDetectorCommand(command) != COMMAND_OK) {
+        Serial.println("Detector command queue full, held warm-start snapshot dropped");
+    }
+}
 
-        bool wasTriggered = detector.isTriggered();
+void networkTask(void* parameter) {
+    connectWiFi();
+    initNetworkServices();
+    connectMQTT();
 
-        if (wasTriggered) {
-            EarthquakeEvent event = detector.getCurrentEvent();
+    unsigned long lastStatusTime = 0;
+    unsigned long lastCaptureUploadTime = 0;
 
-            static String lastAlertLevel = "";
-            if (event.alertLevel != lastAlertLevel) {
-                lastAlertLevel = event.alertLevel;
-                localAlert.setAlertLevel(event.alertLevel);
+    for (;;) {
+        unsigned long currentTime = millis();
+        manageRadio(currentTime);
+        timebase.update();
 
-                Serial.printf("Alert Level: %s, PGA: %.4f g, STA/LTA: %.2f\n",
-                              event.alertLevel.c_str(), event.pga, detector.getStaLtaRatio());
+        if (wifiConnected) {
+            if (!mqttAlert.isConnected()) {
+                connectMQTT();
             }
+            uint32_t start = Instrumentation::cycles();
+            mqttAlert.loop();
+            instrumentation.record(STAGE_MQTT_LOOP, start);
+        }
 
-            if (event.confirmed && event.duration > 0) {
-                Serial.println("CONFIRMED EARTHQUAKE EVENT!");
-                Serial.printf("Magnitude: %.2f, PGA: %.4f g, CAV: %.4f g*s, Duration: %lu ms\n",
-                              event.magnitude, event.pga, event.cav, event.duration);
+        dispatchPreliminaryEvents();
+        dispatchConfirmedEvents();
+        streamSamples();
 
-                if (wifiConnected && mqttConnected) {
-                    alertManager.sendAlert(event, ALERT_ALL);
-                } else {
-                    eventQueue.addEvent(event, deviceId);
-                    alertManager.sendAlert(event, ALERT_LOCAL);
+        if (wifiConnected && mqttConnected && eventQueue.getUnsentCount() > 0) {
+            eventQueue.processBatch(MQTT_BATCH_MAX_EVENTS, [](const QueuedEvent* const* batch, size_t count) {
+                const EarthquakeEvent* events[MQTT_BATCH_MAX_EVENTS];
+                for (size_t i = 0; i < count; i++) {
+                    events[i] = &batch[i]->event;
                 }
+                return mqttAlert.publishAlertBatch(events, count, batch[0]->deviceId);
+            });
+            eventQueue.clearSentEvents();
+        }
+
+        if (WARM_START_ENABLED && warmStartStore.hasPending() && timebase.isSynchronized()) {
+            restoreHeldWarmState();
+        }
 
-                detector.reset();
+        DetectorWarmState warmState;
+        while (warmStateSnapshots.pop(warmState)) {
+            warmStartStore.save(warmState, currentTime, timebase.nowMicros());
+        }
+
+        if (eventRecorder.isReady()) {
+            captureStore.save(eventRecorder, timebase);
+            eventRecorder.release();
+        }
+
+        if (wifiConnected && mqttConnected && currentTime - lastCaptureUploadTime >= CAPTURE_UPLOAD_INTERVAL_MS) {
+            lastCaptureUploadTime = currentTime;
+            captureStore.uploadNextChunk([](const uint8_t* payload, size_t length) {
+                return mqttAlert.publishCapture(payload, length, deviceId);
+            });
+        }
+
+        if (statusRequested && mqttConnected) {
+            statusRequested = false;
+            alertManager.sendStatus("alive");
+        }
+
+        if (metricsRequested || currentTime - lastStatusTime >= STATUS_INTERVAL_MS) {
+            lastStatusTime = currentTime;
+            metricsRequested = false;
+
+            MetricsReport metrics;
+            instrumentation.collect(metrics, mpuFifo.getOverflowCount(),
+                                    sampleStream.getDroppedCount() + confirmedEvents.getDroppedCount() +
+                                        preliminaryEvents.getDroppedCount());
+
+            Serial.printf("Status - STA/LTA: %.2f, PGA: %.6f g, Queue: %d unsent, Dropped: %u, Heap: %u (min %u), "
+                          "Rate: %d Hz, Sleeps: %u, Motion wakes: %u, Clock: %s (%.1f ppm, %ld us)\n",
+                          statusStaLtaRatio.load(std::memory_order_relaxed),
+                          statusPga.load(std::memory_order_relaxed),
+                          eventQueue.getUnsentCount(), metrics.droppedSamples,
+                          metrics.heap.freeBytes, metrics.heap.minFreeBytes, powerManager.getSampleRate(),
+                          powerManager.getSleepCount(), powerManager.getMotionWakeCount(),
+                          timeSourceName(timebase.getSource()), timebase.getDriftPpm(),
+                          static_cast<long>(timebase.getLastErrorMicros()));
+
+            if (mqttConnected) {
+                alertManager.sendStatus(powerManager.isLowPower() ? "low_power" : "monitoring", &metrics);
             }
         }
+
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(NETWORK_TASK_PERIOD_MS));
+    }
+}
+
+void setup() {
+    Serial.begin(115200);
+    while (!Serial) {
+        delay(10);
+    }
+
+    Serial.println("Earthquake Alert System Starting...");
+
+    uint8_t mac[6];
+    WiFi.macAddress(mac);
+    snprintf(deviceId, sizeof(deviceId), "ESP32_%02X%02X%02X%02X%02X%02X",
+             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    Serial.printf("Device ID: %s\n", deviceId);
+
+    localAlert.init();
+    Serial.println("Local alert system initialized");
+
+    if (!eventQueue.init()) {
+        Serial.println("Event queue initialization failed");
+    }
+
+    captureStore.init();
+
+    if (eventRecorder.begin()) {
+        Serial.printf("Event recorder ready (%s)\n", eventRecorder.usesPsram() ? "PSRAM" : "heap");
+    } else {
+        Serial.println("Event recorder allocation failed, waveform capture disabled");
+    }
+
+    Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN);
+
+    if (!mpu.begin(MPU6050_I2C_ADDRESS)) {
+        Serial.println("Failed to find MPU6050 chip");
+        while (1) {
+            localAlert.soundAlarm(500, 200);
+            delay(200);
+            localAlert.update();
+            delay(500);
+        }
     }
 
-    if (wifiConnected && mqttConnected && eventQueue.getUnsentCount() > 0) {
-        eventQueue.processQueue([](const QueuedEvent& queuedEvent) {
-            return mqttAlert.publishAlert(queuedEvent.event, queuedEvent.deviceId);
-        });
-        eventQueue.clearSentEvents();
+    Serial.println("MPU6050 Found!");
+
+    mpu.setAccelerometerRange(MPU6050_RANGE_2_G);
+    mpu.setGyroRange(MPU6050_RANGE_250_DEG);
+    mpu.setFilterBandwidth(MPU6050_BAND_21_HZ);
+
+    if (ACQUISITION_USE_FIFO) {
+        Wire.setClock(I2C_CLOCK_HZ);
+        fifoAcquisition = mpuFifo.begin(SAMPLE_RATE_HZ);
+        setFullRateNotifyInterval();
+
+        if (fifoAcquisition) {
+            Serial.println("MPU6050 FIFO acquisition enabled");
+        } else {
+            Serial.println("MPU6050 FIFO setup failed, falling back to polling");
+        }
     }
 
-    static unsigned long lastStatusTime = 0;
-    if (currentTime - lastStatusTime >= 60000) {
-        lastStatusTime = currentTime;
+#if !DETECTION_FIXED_POINT
+    detector.addConfiguredChannels();
+#endif
+    detector.init();
+    instrumentation.begin();
+    Serial.println("Earthquake detector initialized");
 
-        Serial.printf("Status - STA/LTA: %.2f, PGA: %.6f g, Queue: %d unsent\n",
-                      detector.getStaLtaRatio(), detector.getCurrentPGA(), eventQueue.getUnsentCount());
+    if (WARM_START_ENABLED) {
+        warmStartStore.begin();
 
-        if (mqttConnected) {
-            alertManager.sendStatus("monitoring");
+        DetectorWarmState warmState;
+        WarmStartSource source = warmStartStore.load(warmState, systemUtcMicros());
+        if (source != WARM_START_NONE && detector.restoreWarmState(warmState)) {
+            Serial.printf("Detector warm-started from %s snapshot\n", warmStartSourceName(source));
+        } else {
+            Serial.println(warmStartStore.hasPending() ? "Detector cold until the held snapshot can be checked"
+                                                       : "No usable warm-start snapshot, waiting for a full LTA window");
         }
     }
+
+    powerManager.begin(LOW_POWER_MODE_ENABLED && fifoAcquisition, millis());
+    if (powerManager.isEnabled()) {
+        Serial.printf("Low-power mode enabled (%d Hz when quiet)\n", LOW_POWER_SAMPLE_RATE_HZ);
+    } else if (LOW_POWER_MODE_ENABLED) {
+        Serial.println("Low-power mode requires FIFO acquisition, disabled");
+    }
+
+    alertManager.init(&localAlert, &mqttAlert, WEBHOOK_DEVICE_NOTIFICATIONS ? &webhookAlert : nullptr);
+    alertManager.setDeviceId(deviceId);
+
+    localAlert.setAlertLevel(AlertLevel::NEGLIGIBLE);
+
+    xTaskCreatePinnedToCore(acquisitionTask, "acquisition", ACQUISITION_TASK_STACK_SIZE, nullptr,
+                            ACQUISITION_TASK_PRIORITY, &acquisitionTaskHandle, ACQUISITION_TASK_CORE);
+    xTaskCreatePinnedToCore(networkTask, "network", NETWORK_TASK_STACK_SIZE, nullptr,
+                            NETWORK_TASK_PRIORITY, &networkTaskHandle, NETWORK_TASK_CORE);
+
+    if (fifoAcquisition) {
+        pinMode(INTERRUPT_PIN, INPUT);
+        attachInterrupt(digitalPinToInterrupt(INTERRUPT_PIN), onMPUInterrupt, RISING);
+    }
+
+    Serial.println("System ready - monitoring for earthquakes");
+}
+
+void loop() {
+    vTaskDelete(nullptr);
 }
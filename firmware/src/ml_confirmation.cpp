@@ -0,0 +1,162 @@
+#include "ml_confirmation.h"
+#include <cmath>
+
+DeviceFeatureAccumulator::DeviceFeatureAccumulator(uint16_t sampleRate)
+    : sampleRate(sampleRate) {
+    reset();
+}
+
+void DeviceFeatureAccumulator::reset() {
+    count = 0;
+    peak = 0.0f;
+    sumMagnitude = 0.0;
+    sumMagnitudeSquared = 0.0;
+    sumZ = 0.0;
+    sumZSquared = 0.0;
+    sumZCubed = 0.0;
+    sumZFourth = 0.0;
+    sumDeltaZSquared = 0.0;
+    lastZ = 0.0f;
+    zeroCrossings = 0;
+}
+
+void DeviceFeatureAccumulator::update(const AccelSample& sample) {
+    float magnitude = std::sqrt(sample.x * sample.x + sample.y * sample.y + sample.z * sample.z);
+    double z = sample.z;
+    double zSquared = z * z;
+
+    if (count > 0) {
+        double delta = z - lastZ;
+        sumDeltaZSquared += delta * delta;
+        if (lastZ * sample.z < 0.0f) {
+            zeroCrossings++;
+        }
+    }
+
+    peak = std::max(peak, magnitude);
+    sumMagnitude += magnitude;
+    sumMagnitudeSquared += static_cast<double>(magnitude) * magnitude;
+    sumZ += z;
+    sumZSquared += zSquared;
+    sumZCubed += zSquared * z;
+    sumZFourth += zSquared * zSquared;
+    lastZ = sample.z;
+    count++;
+}
+
+uint32_t DeviceFeatureAccumulator::getSampleCount() const {
+    return count;
+}
+
+void DeviceFeatureAccumulator::finalize(float* features) const {
+    for (int i = 0; i < DEVICE_FEATURE_COUNT; i++) {
+        features[i] = 0.0f;
+    }
+    if (count == 0) {
+        return;
+    }
+
+    double n = count;
+    double rms = std::sqrt(sumMagnitudeSquared / n);
+
+    features[FEATURE_DURATION] = n / sampleRate;
+    features[FEATURE_PGA] = peak / 9.81f;
+    features[FEATURE_CAV] = sumMagnitude / sampleRate / 9.81;
+    features[FEATURE_RMS] = rms / 9.81;
+    features[FEATURE_CREST_FACTOR] = rms > 0.0 ? peak / rms : 0.0;
+    features[FEATURE_LOG_ENERGY] = std::log(sumMagnitudeSquared / sampleRate + 1e-10);
+    features[FEATURE_ZERO_CROSSING_RATE] = zeroCrossings / n;
+
+    if (sumZSquared > 0.0) {
+        features[FEATURE_DOMINANT_FREQUENCY] =
+            std::sqrt(sumDeltaZSquared / sumZSquared) * sampleRate / (2.0 * M_PI);
+    }
+
+    double mean = sumZ / n;
+    double meanSquared = mean * mean;
+    double m2 = sumZSquared / n - meanSquared;
+    double m4 = sumZFourth / n - 4.0 * mean * sumZCubed / n + 6.0 * meanSquared * sumZSquared / n -
+                3.0 * meanSquared * meanSquared;
+    if (m2 > 0.0) {
+        features[FEATURE_KURTOSIS] = m4 / (m2 * m2) - 3.0;
+    }
+}
+
+static int8_t saturateInt8(int32_t value, int32_t low) {
+    return static_cast<int8_t>(std::min<int32_t>(127, std::max<int32_t>(low, value)));
+}
+
+float QuantizedClassifier::predict(const float* features) {
+    int8_t* input = arena;
+    int8_t* hidden = arena + ML_FEATURE_COUNT;
+
+    for (int i = 0; i < ML_FEATURE_COUNT; i++) {
+        float standardized = (features[i] - ML_FEATURE_MEAN[i]) * ML_FEATURE_INV_STD[i];
+        input[i] = saturateInt8(static_cast<int32_t>(std::lround(standardized / ML_INPUT_SCALE)), -127);
+    }
+
+    const int64_t rounding = 1LL << (30 + ML_HIDDEN_SHIFT);
+    for (int unit = 0; unit < ML_HIDDEN_UNITS; unit++) {
+        const int8_t* weights = ML_HIDDEN_WEIGHTS + unit * ML_FEATURE_COUNT;
+        int32_t accumulator = ML_HIDDEN_BIAS[unit];
+        for (int i = 0; i < ML_FEATURE_COUNT; i++) {
+            accumulator += static_cast<int32_t>(weights[i]) * input[i];
+        }
+        if (accumulator <= 0) {
+            hidden[unit] = 0;
+            continue;
+        }
+        int64_t scaled = (static_cast<int64_t>(accumulator) * ML_HIDDEN_MULTIPLIER + rounding) >>
+                         (31 + ML_HIDDEN_SHIFT);
+        hidden[unit] = saturateInt8(static_cast<int32_t>(scaled), 0);
+    }
+
+    int32_t output = ML_OUTPUT_BIAS;
+    for (int unit = 0; unit < ML_HIDDEN_UNITS; unit++) {
+        output += static_cast<int32_t>(ML_OUTPUT_WEIGHTS[unit]) * hidden[unit];
+    }
+
+    return 1.0f / (1.0f + std::exp(-output * ML_OUTPUT_SCALE));
+}
+
+MlConfirmation::MlConfirmation(uint16_t sampleRate)
+    : accumulator(sampleRate), active(false), overruns(0) {}
+
+void MlConfirmation::update(const AccelSample& sample) {
+    if (!active) {
+        accumulator.reset();
+        active = true;
+    }
+    accumulator.update(sample);
+}
+
+void MlConfirmation::cancel() {
+    active = false;
+}
+
+MlDecision MlConfirmation::evaluate() {
+    MlDecision decision = {true, false, 1.0f, 0};
+    active = false;
+    if (accumulator.getSampleCount() == 0) {
+        return decision;
+    }
+
+    unsigned long start = micros();
+    float features[DEVICE_FEATURE_COUNT];
+    accumulator.finalize(features);
+    decision.probability = classifier.predict(features);
+    decision.inferenceMicros = micros() - start;
+
+    if (decision.inferenceMicros > ML_INFERENCE_BUDGET_US) {
+        decision.overBudget = true;
+        overruns++;
+        return decision;
+    }
+
+    decision.accepted = decision.probability >= ML_CONFIRM_THRESHOLD;
+    return decision;
+}
+
+uint32_t MlConfirmation::getOverrunCount() const {
+    return overruns;
+}
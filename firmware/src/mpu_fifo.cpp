@@ -0,0 +1,256 @@
+#include "mpu_fifo.h"
+
+#define MPU_REG_SMPLRT_DIV 0x19
+#define MPU_REG_CONFIG 0x1A
+#define MPU_REG_ACCEL_CONFIG 0x1C
+#define MPU_REG_MOT_THR 0x1F
+#define MPU_REG_MOT_DUR 0x20
+#define MPU_REG_FIFO_EN 0x23
+#define MPU_REG_INT_PIN_CFG 0x37
+#define MPU_REG_INT_ENABLE 0x38
+#define MPU_REG_INT_STATUS 0x3A
+#define MPU_REG_USER_CTRL 0x6A
+#define MPU_REG_FIFO_COUNT_H 0x72
+#define MPU_REG_FIFO_R_W 0x74
+
+#define MPU_FIFO_EN_ACCEL 0x08
+#define MPU_USER_CTRL_FIFO_EN 0x40
+#define MPU_USER_CTRL_FIFO_RESET 0x04
+#define MPU_INT_DATA_RDY 0x01
+#define MPU_INT_FIFO_OFLOW 0x10
+#define MPU_INT_MOTION 0x40
+#define MPU_INT_PIN_RD_CLEAR 0x10
+#define MPU_INT_PIN_LATCH 0x20
+#define MPU_CONFIG_DLPF_MASK 0x07
+#define MPU_ACCEL_HPF_MASK 0x07
+#define MPU_ACCEL_HPF_0_63_HZ 0x04
+#define MPU_MOTION_MG_PER_LSB 2
+
+#define MPU_GYRO_OUTPUT_RATE_HZ 1000
+#define MPU_FIFO_SIZE_BYTES 1024
+#define MPU_FIFO_BYTES_PER_SAMPLE 6
+#define MPU_FIFO_SAMPLES_PER_READ 20
+#define MPU_STANDARD_GRAVITY 9.80665f
+
+MPU6050Fifo::MPU6050Fifo(TwoWire& wire, uint8_t address)
+    : wire(wire),
+      address(address),
+      sampleRateHz(0),
+      samplePeriodUs(0),
+      metersPerSecondSquaredPerCount(0.0f),
+      interruptCount(0),
+      samplesDrained(0),
+      lastSampleMicros(0),
+      overflowCount(0),
+      motionWake(false),
+      motionSeen(false) {}
+
+bool MPU6050Fifo::begin(int sampleRateHz) {
+    this->sampleRateHz = std::max(1, std::min(sampleRateHz, MPU_GYRO_OUTPUT_RATE_HZ));
+    samplePeriodUs = 1000000UL / this->sampleRateHz;
+
+    uint8_t accelConfig = 0;
+    if (!readRegisters(MPU_REG_ACCEL_CONFIG, &accelConfig, 1)) {
+        return false;
+    }
+    float countsPerG = 16384.0f / (1 << ((accelConfig >> 3) & 0x03));
+    metersPerSecondSquaredPerCount = MPU_STANDARD_GRAVITY / countsPerG;
+
+    uint8_t divider = static_cast<uint8_t>(MPU_GYRO_OUTPUT_RATE_HZ / this->sampleRateHz - 1);
+    motionWake = false;
+
+    bool configured = writeRegister(MPU_REG_SMPLRT_DIV, divider) &&
+                      writeRegister(MPU_REG_INT_PIN_CFG, MPU_INT_PIN_RD_CLEAR) &&
+                      writeRegister(MPU_REG_FIFO_EN, MPU_FIFO_EN_ACCEL) &&
+                      writeRegister(MPU_REG_INT_ENABLE, MPU_INT_DATA_RDY | MPU_INT_FIFO_OFLOW);
+    if (!configured) {
+        return false;
+    }
+
+    resetFifo();
+    return true;
+}
+
+bool MPU6050Fifo::setSampleRate(int sampleRateHz) {
+    int rate = std::max(1, std::min(sampleRateHz, MPU_GYRO_OUTPUT_RATE_HZ));
+    uint8_t divider = static_cast<uint8_t>(MPU_GYRO_OUTPUT_RATE_HZ / rate - 1);
+    if (!writeRegister(MPU_REG_SMPLRT_DIV, divider)) {
+        return false;
+    }
+
+    this->sampleRateHz = rate;
+    samplePeriodUs = 1000000UL / rate;
+    resetFifo();
+    return true;
+}
+
+bool MPU6050Fifo::setLowPassFilter(uint8_t dlpfConfig) {
+    return updateRegister(MPU_REG_CONFIG, MPU_CONFIG_DLPF_MASK, dlpfConfig);
+}
+
+bool MPU6050Fifo::setMotionWake(bool enabled, uint16_t thresholdMg, uint8_t durationMs) {
+    uint8_t threshold = static_cast<uint8_t>(
+        std::max(1, std::min(thresholdMg / MPU_MOTION_MG_PER_LSB, 255)));
+    uint8_t pinConfig = MPU_INT_PIN_RD_CLEAR | (enabled ? MPU_INT_PIN_LATCH : 0);
+    uint8_t interrupts = (enabled ? MPU_INT_MOTION : MPU_INT_DATA_RDY) | MPU_INT_FIFO_OFLOW;
+
+    bool configured = updateRegister(MPU_REG_ACCEL_CONFIG, MPU_ACCEL_HPF_MASK,
+                                     enabled ? MPU_ACCEL_HPF_0_63_HZ : 0) &&
+                      writeRegister(MPU_REG_MOT_THR, threshold) &&
+                      writeRegister(MPU_REG_MOT_DUR, std::max<uint8_t>(1, durationMs)) &&
+                      writeRegister(MPU_REG_INT_PIN_CFG, pinConfig) &&
+                      writeRegister(MPU_REG_INT_ENABLE, interrupts);
+    if (!configured) {
+        return false;
+    }
+
+    motionWake = enabled;
+    motionSeen = false;
+    resetFifo();
+    return true;
+}
+
+bool MPU6050Fifo::takeMotion() {
+    bool seen = motionSeen;
+    motionSeen = false;
+    return seen;
+}
+
+uint32_t IRAM_ATTR MPU6050Fifo::recordInterrupt() {
+    uint32_t index = interruptCount;
+    interruptMicros[index % MPU_FIFO_TIMESTAMP_SLOTS] = micros64();
+    interruptCount = index + 1;
+    return index + 1;
+}
+
+size_t MPU6050Fifo::drain(AccelSample* samples, size_t maxSamples) {
+    RawAccelSample raw[FIFO_BURST_MAX_SAMPLES];
+    size_t count = drain(raw, std::min(maxSamples, static_cast<size_t>(FIFO_BURST_MAX_SAMPLES)));
+
+    for (size_t i = 0; i < count; i++) {
+        samples[i].x = raw[i].x * metersPerSecondSquaredPerCount;
+        samples[i].y = raw[i].y * metersPerSecondSquaredPerCount;
+        samples[i].z = raw[i].z * metersPerSecondSquaredPerCount;
+        samples[i].timestamp = raw[i].timestamp;
+    }
+
+    return count;
+}
+
+size_t MPU6050Fifo::drain(RawAccelSample* samples, size_t maxSamples) {
+    uint8_t status = 0;
+    readRegisters(MPU_REG_INT_STATUS, &status, 1);
+    if (status & MPU_INT_MOTION) {
+        motionSeen = true;
+    }
+
+    uint16_t fifoBytes = readFifoCount();
+    if ((status & MPU_INT_FIFO_OFLOW) || fifoBytes >= MPU_FIFO_SIZE_BYTES) {
+        overflowCount++;
+        resetFifo();
+        return 0;
+    }
+
+    size_t available = fifoBytes / MPU_FIFO_BYTES_PER_SAMPLE;
+    size_t toRead = std::min(available, maxSamples);
+    size_t produced = 0;
+
+    while (produced < toRead) {
+        size_t chunk = std::min(toRead - produced, static_cast<size_t>(MPU_FIFO_SAMPLES_PER_READ));
+        uint8_t raw[MPU_FIFO_SAMPLES_PER_READ * MPU_FIFO_BYTES_PER_SAMPLE];
+
+        if (!readRegisters(MPU_REG_FIFO_R_W, raw, chunk * MPU_FIFO_BYTES_PER_SAMPLE)) {
+            break;
+        }
+
+        for (size_t i = 0; i < chunk; i++) {
+            const uint8_t* bytes = raw + i * MPU_FIFO_BYTES_PER_SAMPLE;
+            int16_t countsX = static_cast<int16_t>((bytes[0] << 8) | bytes[1]);
+            int16_t countsY = static_cast<int16_t>((bytes[2] << 8) | bytes[3]);
+            int16_t countsZ = static_cast<int16_t>((bytes[4] << 8) | bytes[5]);
+
+            RawAccelSample& sample = samples[produced + i];
+            sample.x = countsX;
+            sample.y = countsY;
+            sample.z = countsZ;
+            sample.timestamp = timestampFor(samplesDrained);
+            samplesDrained++;
+        }
+
+        produced += chunk;
+    }
+
+    return produced;
+}
+
+uint64_t MPU6050Fifo::timestampFor(uint32_t sampleIndex) {
+    uint32_t interrupts = interruptCount;
+
+    if (!motionWake && sampleIndex < interrupts && interrupts - sampleIndex <= MPU_FIFO_TIMESTAMP_SLOTS) {
+        lastSampleMicros = interruptMicros[sampleIndex % MPU_FIFO_TIMESTAMP_SLOTS];
+    } else {
+        lastSampleMicros += samplePeriodUs;
+    }
+
+    return lastSampleMicros;
+}
+
+int MPU6050Fifo::getSampleRate() const {
+    return sampleRateHz;
+}
+
+uint32_t MPU6050Fifo::getOverflowCount() const {
+    return overflowCount;
+}
+
+uint16_t MPU6050Fifo::readFifoCount() {
+    uint8_t count[2] = {0, 0};
+    if (!readRegisters(MPU_REG_FIFO_COUNT_H, count, 2)) {
+        return 0;
+    }
+    return static_cast<uint16_t>((count[0] << 8) | count[1]);
+}
+
+void MPU6050Fifo::resetFifo() {
+    writeRegister(MPU_REG_USER_CTRL, MPU_USER_CTRL_FIFO_RESET);
+    writeRegister(MPU_REG_USER_CTRL, MPU_USER_CTRL_FIFO_EN);
+
+    noInterrupts();
+    interruptCount = 0;
+    interrupts();
+    samplesDrained = 0;
+    lastSampleMicros = micros64();
+}
+
+bool MPU6050Fifo::writeRegister(uint8_t reg, uint8_t value) {
+    wire.beginTransmission(address);
+    wire.write(reg);
+    wire.write(value);
+    return wire.endTransmission() == 0;
+}
+
+bool MPU6050Fifo::updateRegister(uint8_t reg, uint8_t mask, uint8_t value) {
+    uint8_t current = 0;
+    if (!readRegisters(reg, &current, 1)) {
+        return false;
+    }
+    return writeRegister(reg, (current & ~mask) | (value & mask));
+}
+
+bool MPU6050Fifo::readRegisters(uint8_t reg, uint8_t* buffer, size_t length) {
+    wire.beginTransmission(address);
+    wire.write(reg);
+    if (wire.endTransmission(false) != 0) {
+        return false;
+    }
+
+    size_t received = wire.requestFrom(address, static_cast<uint8_t>(length));
+    if (received != length) {
+        return false;
+    }
+
+    for (size_t i = 0; i < length; i++) {
+        buffer[i] = wire.read();
+    }
+    return true;
+}
@@ -0,0 +1,26 @@
+#include <Arduino.h>
+#include <chrono>
+
+static HalClockSource clockSource = halSystemMicros;
+
+void halSetClockSource(HalClockSource source) {
+    clockSource = source != nullptr ? source : halSystemMicros;
+}
+
+uint64_t halSystemMicros() {
+    static const auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+unsigned long millis() {
+    return static_cast<unsigned long>(clockSource() / 1000);
+}
+
+unsigned long micros() {
+    return static_cast<unsigned long>(clockSource());
+}
+
+uint64_t micros64() {
+    return clockSource();
+}
@@ -0,0 +1,50 @@
+#include <Preferences.h>
+#include <map>
+#include <vector>
+
+static std::map<std::string, std::vector<uint8_t>> entries;
+
+void halPreferencesReset() {
+    entries.clear();
+}
+
+Preferences::Preferences() : open(false), readOnly(false) {}
+
+bool Preferences::begin(const char* name, bool readOnlyMode) {
+    space = name;
+    open = true;
+    readOnly = readOnlyMode;
+    return true;
+}
+
+void Preferences::end() {
+    open = false;
+}
+
+size_t Preferences::getBytes(const char* key, void* buffer, size_t length) {
+    auto entry = entries.find(path(key));
+    if (!open || entry == entries.end() || length < entry->second.size()) {
+        return 0;
+    }
+
+    memcpy(buffer, entry->second.data(), entry->second.size());
+    return entry->second.size();
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t length) {
+    if (!open || readOnly) {
+        return 0;
+    }
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(value);
+    entries[path(key)].assign(bytes, bytes + length);
+    return length;
+}
+
+bool Preferences::remove(const char* key) {
+    return open && !readOnly && entries.erase(path(key)) > 0;
+}
+
+std::string Preferences::path(const char* key) const {
+    return space + "/" + key;
+}
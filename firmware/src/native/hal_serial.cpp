@@ -0,0 +1,20 @@
+#include <Arduino.h>
+#include <stdarg.h>
+
+HalSerial Serial;
+
+size_t HalSerial::print(const char* text) {
+    return fputs(text, stdout) >= 0 ? strlen(text) : 0;
+}
+
+size_t HalSerial::println(const char* text) {
+    return print(text) + print("\n");
+}
+
+int HalSerial::printf(const char* format, ...) {
+    va_list arguments;
+    va_start(arguments, format);
+    int length = vprintf(format, arguments);
+    va_end(arguments);
+    return length;
+}
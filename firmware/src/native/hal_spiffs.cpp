@@ -0,0 +1,111 @@
+#include <SPIFFS.h>
+
+HalSpiffs SPIFFS;
+
+static size_t writeBudget = SIZE_MAX;
+
+void halSpiffsLimitWrites(size_t bytes) {
+    writeBudget = bytes;
+}
+
+File::File() : writable(false), offset(0) {}
+
+File::File(std::shared_ptr<std::vector<uint8_t>> data, bool writable, size_t position)
+    : data(std::move(data)), writable(writable), offset(position) {}
+
+File::operator bool() const {
+    return data != nullptr;
+}
+
+size_t File::read(uint8_t* buffer, size_t length) {
+    if (!data || offset >= data->size()) {
+        return 0;
+    }
+
+    size_t count = std::min(length, data->size() - offset);
+    memcpy(buffer, data->data() + offset, count);
+    offset += count;
+    return count;
+}
+
+size_t File::write(const uint8_t* buffer, size_t length) {
+    if (!data || !writable) {
+        return 0;
+    }
+
+    size_t count = std::min(length, writeBudget);
+    if (writeBudget != SIZE_MAX) {
+        writeBudget -= count;
+    }
+
+    if (offset + count > data->size()) {
+        data->resize(offset + count);
+    }
+    memcpy(data->data() + offset, buffer, count);
+    offset += count;
+    return count;
+}
+
+bool File::seek(uint32_t position) {
+    if (!data || position > data->size()) {
+        return false;
+    }
+    offset = position;
+    return true;
+}
+
+size_t File::position() const {
+    return offset;
+}
+
+size_t File::size() const {
+    return data ? data->size() : 0;
+}
+
+void File::close() {
+    data.reset();
+}
+
+bool HalSpiffs::begin(bool) {
+    return true;
+}
+
+bool HalSpiffs::format() {
+    files.clear();
+    return true;
+}
+
+File HalSpiffs::open(const char* path, const char* mode) {
+    auto entry = files.find(path);
+
+    if (strcmp(mode, FILE_READ) == 0) {
+        return entry != files.end() ? File(entry->second, false, 0) : File();
+    }
+
+    if (strcmp(mode, FILE_WRITE) == 0 || entry == files.end()) {
+        auto data = std::make_shared<std::vector<uint8_t>>();
+        files[path] = data;
+        return File(data, true, 0);
+    }
+
+    return File(entry->second, true, entry->second->size());
+}
+
+bool HalSpiffs::exists(const char* path) const {
+    return files.count(path) > 0;
+}
+
+bool HalSpiffs::remove(const char* path) {
+    return files.erase(path) > 0;
+}
+
+bool HalSpiffs::rename(const char* from, const char* to) {
+    auto entry = files.find(from);
+    if (entry == files.end() || files.count(to) > 0) {
+        return false;
+    }
+
+    files[to] = entry->second;
+    files.erase(entry);
+    return true;
+}
@@ -0,0 +1,87 @@
+#include <Arduino.h>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include "config.h"
+#include "waveform_replay.h"
+
+static void usage(const char* program) {
+    fprintf(stderr,
+            "usage: %s <waveform.npy> [--rate HZ] [--gain G] [--axis x|y|z] [--fixed]\n"
+            "          [--repeat N] [--expect-events N] [--quiet]\n",
+            program);
+}
+
+static bool parseOptions(int argc, char** argv, ReplayOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--rate" && hasValue) {
+            options.sampleRate = atoi(argv[++i]);
+        } else if (arg == "--gain" && hasValue) {
+            options.gain = static_cast<float>(atof(argv[++i]));
+        } else if (arg == "--axis" && hasValue) {
+            const char* axis = argv[++i];
+            options.axis = axis[0] == 'x' ? 0 : axis[0] == 'y' ? 1 : 2;
+        } else if (arg == "--fixed") {
+            options.fixedPoint = true;
+        } else if (arg == "--repeat" && hasValue) {
+            options.repeat = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--expect-events" && hasValue) {
+            options.expectedEvents = atoi(argv[++i]);
+        } else if (arg == "--quiet") {
+            options.quiet = true;
+        } else if (arg[0] != '-' && options.path == nullptr) {
+            options.path = argv[i];
+        } else {
+            return false;
+        }
+    }
+
+    return options.path != nullptr && options.sampleRate > 0;
+}
+
+int main(int argc, char** argv) {
+    ReplayOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    Waveform waveform;
+    if (!loadNpy(options.path, waveform)) {
+        return 2;
+    }
+
+    double duration = static_cast<double>(waveform.frames()) / options.sampleRate;
+    printf("replay %s: %zu frames x %zu channels at %d Hz (%.1f s), gain %g, %s pipeline\n",
+           options.path, waveform.frames(), waveform.channels, options.sampleRate, duration, options.gain,
+           options.fixedPoint ? "fixed-point" : "float");
+
+    ReplayStats stats;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int pass = 0; pass < options.repeat; pass++) {
+        ReplayOptions passOptions = options;
+        passOptions.quiet = options.quiet || pass > 0;
+
+        stats = replayWaveform(waveform, passOptions);
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double samples = static_cast<double>(waveform.frames()) * options.repeat;
+
+    printf("summary: triggers=%zu preliminary=%zu confirmed=%zu peak_ratio=%.2f peak_pga=%.5f g "
+           "peak_cav=%.5f g*s\n",
+           stats.triggers, stats.preliminaryAlerts, stats.confirmedEvents, stats.peakRatio, stats.peakPga,
+           stats.peakCav);
+    printf("timing: %.0f samples in %.3f ms, %.2f us/sample, %.0fx real time\n", samples, elapsed * 1000.0,
+           elapsed * 1e6 / samples, elapsed > 0.0 ? duration * options.repeat / elapsed : 0.0);
+
+    if (options.expectedEvents >= 0 && static_cast<int>(stats.confirmedEvents) != options.expectedEvents) {
+        fprintf(stderr, "expected %d confirmed events, got %zu\n", options.expectedEvents, stats.confirmedEvents);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,217 @@
+#include <Arduino.h>
+#include <fstream>
+#include <string>
+#include "earthquake_detector.h"
+#include "filter_bank.h"
+#include "fixed_point.h"
+#include "fixed_point_detector.h"
+#include "pwave_estimator.h"
+#include "waveform_replay.h"
+
+static uint64_t replayMicros = 0;
+
+static uint64_t replayClock() {
+    return replayMicros;
+}
+
+static bool headerValue(const std::string& header, const char* key, std::string& value) {
+    size_t position = header.find(key);
+    if (position == std::string::npos) {
+        return false;
+    }
+
+    position = header.find(':', position);
+    if (position == std::string::npos) {
+        return false;
+    }
+
+    size_t begin = header.find_first_not_of(" '", position + 1);
+    size_t end = header[begin] == '(' ? header.find(')', begin) + 1 : header.find_first_of("',", begin);
+    value = header.substr(begin, end - begin);
+    return true;
+}
+
+template <typename T>
+static void appendValues(std::ifstream& input, size_t count, std::vector<double>& values) {
+    std::vector<T> raw(count);
+    input.read(reinterpret_cast<char*>(raw.data()), count * sizeof(T));
+    values.assign(raw.begin(), raw.begin() + input.gcount() / sizeof(T));
+}
+
+bool loadNpy(const char* path, Waveform& waveform) {
+    std::ifstream input(path, std::ios::binary);
+    char magic[8];
+    if (!input.read(magic, sizeof(magic)) || memcmp(magic, "\x93NUMPY", 6) != 0) {
+        fprintf(stderr, "%s: not a .npy file\n", path);
+        return false;
+    }
+
+    uint32_t headerLength = 0;
+    if (magic[6] == 1) {
+        uint8_t length[2];
+        input.read(reinterpret_cast<char*>(length), sizeof(length));
+        headerLength = length[0] | (length[1] << 8);
+    } else {
+        uint8_t length[4];
+        input.read(reinterpret_cast<char*>(length), sizeof(length));
+        headerLength = length[0] | (length[1] << 8) | (length[2] << 16) | (static_cast<uint32_t>(length[3]) << 24);
+    }
+
+    std::string header(headerLength, '\0');
+    input.read(&header[0], headerLength);
+
+    std::string descr;
+    std::string order;
+    std::string shape;
+    if (!headerValue(header, "'descr'", descr) || !headerValue(header, "'fortran_order'", order) ||
+        !headerValue(header, "'shape'", shape)) {
+        fprintf(stderr, "%s: malformed .npy header\n", path);
+        return false;
+    }
+    if (order.compare(0, 4, "True") == 0) {
+        fprintf(stderr, "%s: Fortran-ordered arrays are not supported\n", path);
+        return false;
+    }
+
+    size_t frames = 0;
+    size_t channels = 1;
+    if (sscanf(shape.c_str(), "(%zu, %zu)", &frames, &channels) < 1) {
+        fprintf(stderr, "%s: unsupported shape %s\n", path, shape.c_str());
+        return false;
+    }
+    if (channels != 1 && channels != 3) {
+        fprintf(stderr, "%s: expected 1 or 3 channels, got %zu\n", path, channels);
+        return false;
+    }
+
+    size_t count = frames * channels;
+    if (descr == "<f8") {
+        appendValues<double>(input, count, waveform.values);
+    } else if (descr == "<f4") {
+        appendValues<float>(input, count, waveform.values);
+    } else if (descr == "<i4") {
+        appendValues<int32_t>(input, count, waveform.values);
+    } else if (descr == "<i2") {
+        appendValues<int16_t>(input, count, waveform.values);
+    } else {
+        fprintf(stderr, "%s: unsupported dtype %s\n", path, descr.c_str());
+        return false;
+    }
+
+    waveform.channels = channels;
+    if (waveform.values.size() != count) {
+        fprintf(stderr, "%s: truncated data (%zu of %zu values)\n", path, waveform.values.size(), count);
+        return false;
+    }
+    return true;
+}
+
+static AccelSample frameAt(const Waveform& waveform, size_t frame, const ReplayOptions& options,
+                           uint64_t timestamp) {
+    AccelSample sample = {0.0f, 0.0f, 0.0f, timestamp};
+    float* axes[3] = {&sample.x, &sample.y, &sample.z};
+
+    if (waveform.channels == 3) {
+        for (int axis = 0; axis < 3; axis++) {
+            *axes[axis] = static_cast<float>(waveform.values[frame * 3 + axis]) * options.gain;
+        }
+    } else {
+        *axes[options.axis] = static_cast<float>(waveform.values[frame]) * options.gain;
+    }
+
+    return sample;
+}
+
+template <typename Detector, typename FilterBank, typename Sample>
+static ReplayStats replay(const Waveform& waveform, const ReplayOptions& options, Detector& detector,
+                          FilterBank& filterBank) {
+    ReplayStats stats;
+    PWaveEstimator pWave(options.sampleRate);
+    bool wasTriggered = false;
+
+    detector.init();
+    filterBank.reset();
+
+    for (size_t frame = 0; frame < waveform.frames(); frame++) {
+        replayMicros = static_cast<uint64_t>(frame) * 1000000ULL / options.sampleRate;
+        Sample raw = convertSample<Sample>(frameAt(waveform, frame, options, replayMicros));
+        if (frame == 0) {
+            filterBank.prime(raw);
+        }
+        Sample filtered = filterBank.process(raw);
+        detector.addSample(filtered);
+
+        float ratio = detector.getStaLtaRatio();
+        stats.peakRatio = std::max(stats.peakRatio, ratio);
+        bool triggered = detector.isTriggered();
+
+        if (triggered && !wasTriggered) {
+            stats.triggers++;
+            if (stats.triggers == 1) {
+                stats.firstOnset = detector.getCurrentEvent().startTime;
+            }
+            if (!options.quiet) {
+                printf("trigger      t=%8.3f s  ratio=%.2f\n", replayMicros / 1e6, ratio);
+            }
+        }
+
+        if (triggered && pWave.update(toAccelSample(filtered), replayMicros)) {
+            PreliminaryEvent estimate = pWave.getEstimate();
+            stats.preliminaryAlerts++;
+            if (!options.quiet) {
+                printf("preliminary  t=%8.3f s  +%lu ms  tau_c=%.2f s  Pd=%.4f cm  M=%.1f\n",
+                       replayMicros / 1e6, static_cast<unsigned long>((estimate.issuedTime - estimate.onsetTime) / 1000), estimate.tauC,
+                       estimate.pd, estimate.magnitude);
+            }
+        } else if (!triggered) {
+            pWave.cancel();
+        }
+
+        if (wasTriggered && !triggered) {
+            EarthquakeEvent event = detector.getCurrentEvent();
+            stats.peakPga = std::max(stats.peakPga, event.pga);
+            stats.peakCav = std::max(stats.peakCav, event.cav);
+            if (!options.quiet) {
+                printf("detrigger    t=%8.3f s  duration=%lu ms  pga=%.5f g  cav=%.5f g*s  level=%s  %s\n",
+                       replayMicros / 1e6, event.duration, event.pga, event.cav,
+                       alertLevelName(event.alertLevel), event.confirmed ? "CONFIRMED" : "rejected");
+            }
+            if (event.confirmed) {
+                stats.confirmedEvents++;
+                detector.rearm();
+            }
+        }
+
+        wasTriggered = triggered;
+    }
+
+    return stats;
+}
+
+ReplayStats replayWaveform(const Waveform& waveform, const ReplayOptions& options) {
+    float highCutoff = std::min(FILTER_HIGH_CUTOFF_HZ, 0.45f * options.sampleRate);
+    BandpassDesign design =
+        designButterworthBandpass(options.sampleRate, FILTER_LOW_CUTOFF_HZ, highCutoff, FILTER_ORDER);
+
+    ReplayStats stats;
+    halSetClockSource(replayClock);
+
+    if (options.fixedPoint) {
+        FixedPointDetector detector(options.sampleRate, STA_WINDOW_SEC, LTA_WINDOW_SEC,
+                                    STA_LTA_TRIGGER_THRESHOLD, STA_LTA_DETRIGGER_THRESHOLD, STA_LTA_MODE);
+        FixedAxisFilterBank filterBank(toFixedDesign(design), FIXED_KALMAN_GAINS);
+        stats = replay<FixedPointDetector, FixedAxisFilterBank, RawAccelSample>(
+            waveform, options, detector, filterBank);
+    } else {
+        EarthquakeDetector detector(options.sampleRate, STA_WINDOW_SEC, LTA_WINDOW_SEC,
+                                    STA_LTA_TRIGGER_THRESHOLD, STA_LTA_DETRIGGER_THRESHOLD, STA_LTA_MODE);
+        AxisFilterBank filterBank(design, KALMAN_PROCESS_NOISE, KALMAN_MEASUREMENT_NOISE);
+        detector.addConfiguredChannels();
+        stats = replay<EarthquakeDetector, AxisFilterBank, AccelSample>(waveform, options, detector,
+                                                                        filterBank);
+    }
+
+    halSetClockSource(nullptr);
+
+    return stats;
+}
@@ -0,0 +1,109 @@
+#include "power_manager.h"
+#include <driver/gpio.h>
+#include <esp_sleep.h>
+
+PowerManager::PowerManager(uint8_t wakePin, float wakeRatio, unsigned long holdMillis)
+    : wakePin(wakePin),
+      wakeRatio(wakeRatio),
+      holdMillis(holdMillis),
+      enabled(false),
+      lastActivity(0),
+      mode(POWER_FULL_RATE),
+      radioActive(true),
+      sleepCount(0),
+      motionWakeCount(0) {}
+
+void PowerManager::begin(bool enabled, unsigned long now) {
+    this->enabled = enabled;
+    holdFullRate(now);
+}
+
+bool PowerManager::isEnabled() const {
+    return enabled;
+}
+
+PowerMode PowerManager::getMode() const {
+    return static_cast<PowerMode>(mode.load(std::memory_order_relaxed));
+}
+
+bool PowerManager::isLowPower() const {
+    return getMode() == POWER_LOW_RATE;
+}
+
+int PowerManager::getSampleRate() const {
+    return isLowPower() ? LOW_POWER_SAMPLE_RATE_HZ : SAMPLE_RATE_HZ;
+}
+
+bool PowerManager::update(float staLtaRatio, bool active, bool motion, unsigned long now) {
+    if (!enabled) {
+        return false;
+    }
+
+    bool energetic = active || motion || staLtaRatio >= wakeRatio;
+    if (energetic) {
+        lastActivity = now;
+    }
+
+    if (isLowPower()) {
+        if (!energetic) {
+            return false;
+        }
+        if (motion) {
+            motionWakeCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        mode.store(POWER_FULL_RATE, std::memory_order_relaxed);
+        return true;
+    }
+
+    if (now - lastActivity < holdMillis) {
+        return false;
+    }
+
+    mode.store(POWER_LOW_RATE, std::memory_order_relaxed);
+    return true;
+}
+
+void PowerManager::holdFullRate(unsigned long now) {
+    lastActivity = now;
+    mode.store(POWER_FULL_RATE, std::memory_order_relaxed);
+}
+
+WakeReason PowerManager::sleep(uint32_t timeoutMs) {
+    if (radioActive.load(std::memory_order_relaxed)) {
+        return ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeoutMs)) > 0 ? WAKE_INTERRUPT : WAKE_TIMER;
+    }
+
+    gpio_num_t pin = static_cast<gpio_num_t>(wakePin);
+    Serial.flush();
+
+    gpio_intr_disable(pin);
+    gpio_wakeup_enable(pin, GPIO_INTR_HIGH_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+    esp_sleep_enable_timer_wakeup(static_cast<uint64_t>(timeoutMs) * 1000ULL);
+    esp_light_sleep_start();
+
+    esp_sleep_wakeup_cause_t cause = esp_sleep_get_wakeup_cause();
+    gpio_wakeup_disable(pin);
+    gpio_set_intr_type(pin, GPIO_INTR_POSEDGE);
+    gpio_intr_enable(pin);
+    ulTaskNotifyTake(pdTRUE, 0);
+
+    sleepCount.fetch_add(1, std::memory_order_relaxed);
+    return cause == ESP_SLEEP_WAKEUP_GPIO ? WAKE_INTERRUPT : WAKE_TIMER;
+}
+
+void PowerManager::setRadioActive(bool active) {
+    radioActive.store(active, std::memory_order_relaxed);
+}
+
+bool PowerManager::isRadioActive() const {
+    return radioActive.load(std::memory_order_relaxed);
+}
+
+uint32_t PowerManager::getSleepCount() const {
+    return sleepCount.load(std::memory_order_relaxed);
+}
+
+uint32_t PowerManager::getMotionWakeCount() const {
+    return motionWakeCount.load(std::memory_order_relaxed);
+}
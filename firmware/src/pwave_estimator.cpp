@@ -0,0 +1,89 @@
+#include "pwave_estimator.h"
+#include <cmath>
+
+PWaveEstimator::PWaveEstimator(int sampleRate, float minWindowSec, float maxWindowSec,
+                               float updateIntervalSec)
+    : sampleRate(sampleRate),
+      dt(1.0f / sampleRate),
+      pole(std::exp(-2.0f * static_cast<float>(M_PI) * PWAVE_HIGHPASS_HZ / sampleRate)),
+      minWindowSamples(std::max<uint32_t>(1, std::lround(minWindowSec * sampleRate))),
+      maxWindowSamples(std::max<uint32_t>(minWindowSamples, std::lround(maxWindowSec * sampleRate))),
+      updateIntervalSamples(std::max<uint32_t>(1, std::lround(updateIntervalSec * sampleRate))),
+      active(false),
+      estimate() {}
+
+bool PWaveEstimator::update(const AccelSample& sample, uint64_t now) {
+    if (!active) {
+        active = true;
+        count = 0;
+        nextIssue = minWindowSamples;
+        velocity = 0.0f;
+        displacement = 0.0f;
+        velocityHighPass.reset();
+        displacementHighPass[0].reset();
+        displacementHighPass[1].reset();
+        sumVelocitySquared = 0.0;
+        sumDisplacementSquared = 0.0;
+        peakDisplacement = 0.0f;
+        peakAcceleration = 0.0f;
+        estimate = PreliminaryEvent();
+        estimate.onsetTime = sample.timestamp;
+    }
+
+    if (count >= maxWindowSamples) {
+        return false;
+    }
+
+    velocity += sample.z * dt;
+    float filteredVelocity = velocityHighPass.process(velocity, pole);
+    displacement += filteredVelocity * dt;
+    float filteredDisplacement = displacementHighPass[1].process(
+        displacementHighPass[0].process(displacement, pole), pole);
+
+    sumVelocitySquared += static_cast<double>(filteredVelocity) * filteredVelocity;
+    sumDisplacementSquared += static_cast<double>(filteredDisplacement) * filteredDisplacement;
+    peakDisplacement = std::max(peakDisplacement, std::abs(filteredDisplacement));
+    peakAcceleration = std::max(peakAcceleration,
+                                std::sqrt(sample.x * sample.x + sample.y * sample.y + sample.z * sample.z));
+    count++;
+
+    if (count < nextIssue) {
+        return false;
+    }
+    nextIssue = std::min(maxWindowSamples, nextIssue + updateIntervalSamples);
+    if (nextIssue == count) {
+        nextIssue = maxWindowSamples + 1;
+    }
+
+    estimate.issuedTime = now;
+    estimate.window = static_cast<float>(count) / sampleRate;
+    estimate.update++;
+    estimate.tauC = sumVelocitySquared > 0.0
+        ? 2.0f * static_cast<float>(M_PI) * std::sqrt(sumDisplacementSquared / sumVelocitySquared)
+        : 0.0f;
+    estimate.pd = peakDisplacement * 100.0f;
+    estimate.magnitude = magnitudeFromTauC(estimate.tauC);
+    estimate.pga = peakAcceleration / 9.81f;
+    estimate.damaging = estimate.pd >= PWAVE_PD_DAMAGING_CM || estimate.magnitude >= PWAVE_MAGNITUDE_DAMAGING;
+    return true;
+}
+
+void PWaveEstimator::cancel() {
+    active = false;
+}
+
+bool PWaveEstimator::isActive() const {
+    return active;
+}
+
+PreliminaryEvent PWaveEstimator::getEstimate() const {
+    return estimate;
+}
+
+float PWaveEstimator::magnitudeFromTauC(float tauC) {
+    if (tauC <= 0.0f) {
+        return 0.0f;
+    }
+    float magnitude = 3.373f * std::log10(tauC) + 5.787f;
+    return std::max(0.0f, std::min(10.0f, magnitude));
+}
@@ -0,0 +1,209 @@
+#include "timebase.h"
+#include <algorithm>
+#include <sys/time.h>
+
+#ifdef ARDUINO
+#include <esp_sntp.h>
+
+static Timebase* sntpTimebase = nullptr;
+
+static void onSntpSync(struct timeval* tv) {
+    if (sntpTimebase != nullptr && tv != nullptr) {
+        sntpTimebase->recordSntp(micros64(),
+                                 static_cast<uint64_t>(tv->tv_sec) * 1000000ULL + static_cast<uint64_t>(tv->tv_usec));
+    }
+}
+#endif
+
+const char* timeSourceName(TimeSource source) {
+    switch (source) {
+        case TIME_SOURCE_SNTP: return "sntp";
+        case TIME_SOURCE_PPS: return "pps";
+        default: return "none";
+    }
+}
+
+uint64_t systemUtcMicros() {
+    struct timeval now;
+    if (gettimeofday(&now, nullptr) != 0) {
+        return 0;
+    }
+
+    uint64_t micros = static_cast<uint64_t>(now.tv_sec) * 1000000ULL + static_cast<uint64_t>(now.tv_usec);
+    return isUtcMicros(micros) ? micros : 0;
+}
+
+Timebase::Timebase()
+    : mapping{0, 0, 0, TIME_SOURCE_NONE},
+      sequence(0),
+      lastMeasureLocal(0),
+      lastErrorMicros(0),
+      syncCount(0),
+      sntpCount(0),
+      sntpSeen(0),
+      sntpLocal(0),
+      sntpUtc(0),
+      ppsLocal(0),
+      ppsCount(0),
+      ppsSeen(0),
+      lastPpsLocal(0),
+      ppsPin(-1) {}
+
+void Timebase::begin(int pin) {
+    ppsPin = pin;
+
+#ifdef ARDUINO
+    sntpTimebase = this;
+    sntp_set_time_sync_notification_cb(onSntpSync);
+    sntp_set_sync_interval(TIMEBASE_SNTP_INTERVAL_MS);
+    configTime(0, 0, TIMEBASE_NTP_SERVER, TIMEBASE_NTP_SERVER_BACKUP);
+
+    if (ppsPin >= 0) {
+        pinMode(ppsPin, INPUT);
+        attachInterruptArg(digitalPinToInterrupt(ppsPin), handlePps, this, RISING);
+    }
+#endif
+}
+
+void IRAM_ATTR Timebase::handlePps(void* arg) {
+    Timebase* timebase = static_cast<Timebase*>(arg);
+    uint64_t edge = micros64();
+
+    portENTER_CRITICAL_ISR(&timebase->edgeLock);
+    timebase->ppsLocal = edge;
+    timebase->ppsCount++;
+    portEXIT_CRITICAL_ISR(&timebase->edgeLock);
+}
+
+void Timebase::recordSntp(uint64_t localMicros, uint64_t utcMicros) {
+    portENTER_CRITICAL(&edgeLock);
+    sntpLocal = localMicros;
+    sntpUtc = utcMicros;
+    sntpCount++;
+    portEXIT_CRITICAL(&edgeLock);
+}
+
+void Timebase::update() {
+    portENTER_CRITICAL(&edgeLock);
+    uint32_t pps = ppsCount;
+    uint64_t edge = ppsLocal;
+    uint32_t sntp = sntpCount;
+    uint64_t sntpLocalMicros = sntpLocal;
+    uint64_t sntpUtcMicros = sntpUtc;
+    portEXIT_CRITICAL(&edgeLock);
+
+    if (pps != ppsSeen) {
+        ppsSeen = pps;
+        Mapping current = load();
+
+        if (current.source != TIME_SOURCE_NONE) {
+            uint64_t estimate = apply(current, edge);
+            uint64_t second = (estimate + 500000ULL) / 1000000ULL * 1000000ULL;
+            int64_t error = static_cast<int64_t>(second - estimate);
+            if (error > -TIMEBASE_PPS_CAPTURE_US && error < TIMEBASE_PPS_CAPTURE_US) {
+                lastPpsLocal = edge;
+                discipline(edge, second, TIME_SOURCE_PPS);
+            }
+        }
+    }
+
+    if (sntp != sntpSeen) {
+        sntpSeen = sntp;
+        bool ppsLocked = lastPpsLocal != 0 && micros64() - lastPpsLocal < TIMEBASE_PPS_TIMEOUT_MS * 1000ULL;
+        int64_t error = static_cast<int64_t>(sntpUtcMicros - apply(load(), sntpLocalMicros));
+
+        if (!ppsLocked || error > TIMEBASE_STEP_THRESHOLD_US || error < -TIMEBASE_STEP_THRESHOLD_US) {
+            discipline(sntpLocalMicros, sntpUtcMicros, TIME_SOURCE_SNTP);
+        }
+    }
+}
+
+void Timebase::discipline(uint64_t localMicros, uint64_t utcMicros, TimeSource source) {
+    Mapping current = load();
+    Mapping next = current;
+    int64_t error = 0;
+
+    if (current.source == TIME_SOURCE_NONE) {
+        next.anchorLocal = localMicros;
+        next.offset = static_cast<int64_t>(utcMicros - localMicros);
+    } else {
+        uint64_t predicted = apply(current, localMicros);
+        error = static_cast<int64_t>(utcMicros - predicted);
+
+        if (error > TIMEBASE_STEP_THRESHOLD_US || error < -TIMEBASE_STEP_THRESHOLD_US) {
+            next.anchorLocal = localMicros;
+            next.offset = static_cast<int64_t>(utcMicros - localMicros);
+        } else {
+            int64_t interval = static_cast<int64_t>(localMicros - lastMeasureLocal);
+            if (interval > 0) {
+                int64_t correction = static_cast<int64_t>(TIMEBASE_DRIFT_GAIN * error * 1e9f / interval);
+                int64_t drift = current.driftPpb + correction;
+                int64_t limit = TIMEBASE_MAX_DRIFT_PPM * 1000LL;
+                next.driftPpb = static_cast<int32_t>(std::max<int64_t>(-limit, std::min<int64_t>(limit, drift)));
+            }
+            next.anchorLocal = localMicros;
+            next.offset = static_cast<int64_t>(predicted - localMicros) +
+                          static_cast<int64_t>(TIMEBASE_PHASE_GAIN * error);
+        }
+    }
+
+    next.source = source;
+    publish(next);
+    lastMeasureLocal = localMicros;
+    lastErrorMicros.store(static_cast<int32_t>(std::max<int64_t>(INT32_MIN, std::min<int64_t>(INT32_MAX, error))),
+                          std::memory_order_relaxed);
+    syncCount.store(syncCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void Timebase::publish(const Mapping& next) {
+    uint32_t current = sequence.load(std::memory_order_relaxed);
+    sequence.store(current + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    mapping = next;
+    sequence.store(current + 2, std::memory_order_release);
+}
+
+Timebase::Mapping Timebase::load() const {
+    Mapping snapshot;
+    uint32_t before;
+    do {
+        before = sequence.load(std::memory_order_acquire);
+        snapshot = mapping;
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((before & 1U) != 0 || sequence.load(std::memory_order_relaxed) != before);
+    return snapshot;
+}
+
+uint64_t Timebase::apply(const Mapping& mapping, uint64_t localMicros) {
+    int64_t elapsed = static_cast<int64_t>(localMicros - mapping.anchorLocal);
+    return static_cast<uint64_t>(static_cast<int64_t>(localMicros) + mapping.offset +
+                                 elapsed * mapping.driftPpb / 1000000000LL);
+}
+
+uint64_t Timebase::toUtcMicros(uint64_t localMicros) const {
+    return apply(load(), localMicros);
+}
+
+uint64_t Timebase::nowMicros() const {
+    return toUtcMicros(micros64());
+}
+
+bool Timebase::isSynchronized() const {
+    return getSource() != TIME_SOURCE_NONE;
+}
+
+TimeSource Timebase::getSource() const {
+    return load().source;
+}
+
+int32_t Timebase::getLastErrorMicros() const {
+    return lastErrorMicros.load(std::memory_order_relaxed);
+}
+
+float Timebase::getDriftPpm() const {
+    return load().driftPpb / 1000.0f;
+}
+
+uint32_t Timebase::getSyncCount() const {
+    return syncCount.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,135 @@
+#include "warm_start.h"
+#include "event_journal.h"
+
+RTC_NOINIT_ATTR static WarmStartRecord rtcRecord;
+
+static uint32_t recordCrc(const WarmStartRecord& record) {
+    return journalCrc32(reinterpret_cast<const uint8_t*>(&record),
+                        sizeof(WarmStartRecord) - sizeof(record.crc));
+}
+
+const char* warmStartSourceName(WarmStartSource source) {
+    switch (source) {
+        case WARM_START_RTC: return "RTC";
+        case WARM_START_FLASH: return "flash";
+        default: return "none";
+    }
+}
+
+WarmStartStore::WarmStartStore()
+    : flashReady(false), sequence(0), lastFlashWrite(0), flashWritten(false), pending(false), pendingRecord() {}
+
+bool WarmStartStore::begin() {
+    flashReady = preferences.begin(WARM_START_NAMESPACE, false);
+    if (!flashReady) {
+        Serial.println("Warm-start storage unavailable, snapshots kept in RTC memory only");
+    }
+    return flashReady;
+}
+
+WarmStartSource WarmStartStore::load(DetectorWarmState& state, uint64_t nowUtcMicros) {
+    WarmStartRecord flashRecord;
+    bool flashRead = flashReady &&
+                     preferences.getBytes(WARM_START_KEY, &flashRecord, sizeof(flashRecord)) == sizeof(flashRecord) &&
+                     isValid(flashRecord);
+    bool rtcRead = isValid(rtcRecord);
+
+    if (flashRead) {
+        sequence = std::max(sequence, flashRecord.sequence);
+    }
+    if (rtcRead) {
+        sequence = std::max(sequence, rtcRecord.sequence);
+    }
+
+    bool flashValid = flashRead && isFresh(flashRecord, nowUtcMicros, true);
+    bool rtcValid = rtcRead && isFresh(rtcRecord, nowUtcMicros, false);
+
+    if (rtcValid && (!flashValid || rtcRecord.sequence >= flashRecord.sequence)) {
+        state = rtcRecord.detector;
+        return WARM_START_RTC;
+    }
+
+    if (flashValid) {
+        state = flashRecord.detector;
+        return WARM_START_FLASH;
+    }
+
+    if (flashRead && !isUtcMicros(nowUtcMicros) && isUtcMicros(flashRecord.savedAtMicros)) {
+        pendingRecord = flashRecord;
+        pending = true;
+        Serial.println("Warm-start flash snapshot held until the clock is set");
+        return WARM_START_NONE;
+    }
+
+    if (flashRead || rtcRead) {
+        Serial.println("Warm-start snapshot is too old or its age is unknown, starting cold");
+    }
+    return WARM_START_NONE;
+}
+
+bool WarmStartStore::hasPending() const {
+    return pending;
+}
+
+WarmStartSource WarmStartStore::loadPending(DetectorWarmState& state, uint64_t nowUtcMicros) {
+    if (!pending || !isUtcMicros(nowUtcMicros)) {
+        return WARM_START_NONE;
+    }
+
+    pending = false;
+    if (!isFresh(pendingRecord, nowUtcMicros, true)) {
+        Serial.println("Held warm-start snapshot is too old, staying cold");
+        return WARM_START_NONE;
+    }
+
+    state = pendingRecord.detector;
+    return WARM_START_FLASH;
+}
+
+void WarmStartStore::save(const DetectorWarmState& state, unsigned long now, uint64_t utcMicros) {
+    encode(++sequence, state, utcMicros, rtcRecord);
+
+    if (!flashReady || (flashWritten && now - lastFlashWrite < WARM_START_FLASH_INTERVAL_MS)) {
+        return;
+    }
+
+    if (preferences.putBytes(WARM_START_KEY, &rtcRecord, sizeof(rtcRecord)) == sizeof(rtcRecord)) {
+        lastFlashWrite = now;
+        flashWritten = true;
+    } else {
+        Serial.println("Warm-start snapshot write failed");
+    }
+}
+
+void WarmStartStore::clear() {
+    memset(&rtcRecord, 0, sizeof(rtcRecord));
+    pending = false;
+    if (flashReady) {
+        preferences.remove(WARM_START_KEY);
+    }
+}
+
+void WarmStartStore::encode(uint32_t sequence, const DetectorWarmState& state, uint64_t utcMicros,
+                            WarmStartRecord& record) {
+    memset(&record, 0, sizeof(record));
+    record.magic = WARM_START_MAGIC;
+    record.version = WARM_START_VERSION;
+    record.fixedPoint = DETECTION_FIXED_POINT ? 1 : 0;
+    record.savedAtMicros = isUtcMicros(utcMicros) ? utcMicros : 0;
+    record.sequence = sequence;
+    record.detector = state;
+    record.crc = recordCrc(record);
+}
+
+bool WarmStartStore::isValid(const WarmStartRecord& record) {
+    return record.magic == WARM_START_MAGIC && record.version == WARM_START_VERSION &&
+           record.fixedPoint == (DETECTION_FIXED_POINT ? 1 : 0) && record.crc == recordCrc(record);
+}
+
+bool WarmStartStore::isFresh(const WarmStartRecord& record, uint64_t nowUtcMicros, bool persistent) {
+    if (!isUtcMicros(record.savedAtMicros) || !isUtcMicros(nowUtcMicros)) {
+        return !persistent;
+    }
+    return nowUtcMicros >= record.savedAtMicros &&
+           nowUtcMicros - record.savedAtMicros <= WARM_START_MAX_AGE_MS * 1000ULL;
+}
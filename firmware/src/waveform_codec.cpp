@@ -0,0 +1,116 @@
+#include "waveform_codec.h"
+
+static size_t writeVarint(uint8_t* output, uint32_t value) {
+    size_t length = 0;
+    while (value >= 0x80) {
+        output[length++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    output[length++] = static_cast<uint8_t>(value);
+    return length;
+}
+
+static uint32_t zigzag(int32_t value) {
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+static void writeLe16(uint8_t* output, uint16_t value) {
+    output[0] = static_cast<uint8_t>(value);
+    output[1] = static_cast<uint8_t>(value >> 8);
+}
+
+static void writeLe32(uint8_t* output, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        output[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+static void writeLe64(uint8_t* output, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        output[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+int16_t quantizeCounts(float value, float scale) {
+    float scaled = value / scale;
+    if (scaled >= 32767.0f) {
+        return 32767;
+    }
+    if (scaled <= -32768.0f) {
+        return -32768;
+    }
+    return static_cast<int16_t>(lroundf(scaled));
+}
+
+WaveformBlockEncoder::WaveformBlockEncoder(uint16_t sampleRate, float scale)
+    : sampleRate(sampleRate), scale(scale), baseTimestamp(0), lastTimestamp(0), sampleCount(0) {}
+
+bool WaveformBlockEncoder::add(const AccelSample& sample) {
+    if (full()) {
+        return false;
+    }
+
+    if (sampleCount == 0) {
+        baseTimestamp = sample.timestamp;
+    }
+
+    counts[0][sampleCount] = quantizeCounts(sample.x, scale);
+    counts[1][sampleCount] = quantizeCounts(sample.y, scale);
+    counts[2][sampleCount] = quantizeCounts(sample.z, scale);
+    lastTimestamp = sample.timestamp;
+    sampleCount++;
+    return true;
+}
+
+bool WaveformBlockEncoder::full() const {
+    return sampleCount >= WAVEFORM_BLOCK_SAMPLES;
+}
+
+bool WaveformBlockEncoder::empty() const {
+    return sampleCount == 0;
+}
+
+bool WaveformBlockEncoder::isContinuous(const AccelSample& sample) const {
+    if (sampleCount == 0) {
+        return true;
+    }
+
+    uint64_t period = 1000000ULL / sampleRate;
+    return sample.timestamp - lastTimestamp <= period * 2;
+}
+
+size_t WaveformBlockEncoder::getSampleCount() const {
+    return sampleCount;
+}
+
+size_t WaveformBlockEncoder::encode(uint8_t* output, size_t capacity) const {
+    if (capacity < WAVEFORM_MAX_PAYLOAD_SIZE) {
+        return 0;
+    }
+
+    uint32_t scaleBits;
+    memcpy(&scaleBits, &scale, sizeof(scaleBits));
+
+    output[0] = WAVEFORM_FORMAT_VERSION;
+    output[1] = WAVEFORM_FLAG_DELTA_ZIGZAG;
+    writeLe16(output + 2, static_cast<uint16_t>(sampleCount));
+    writeLe16(output + 4, sampleRate);
+    writeLe32(output + 6, scaleBits);
+    writeLe64(output + 10, baseTimestamp);
+
+    size_t length = WAVEFORM_HEADER_SIZE;
+    for (int axis = 0; axis < WAVEFORM_AXIS_COUNT; axis++) {
+        int32_t previous = 0;
+        for (size_t i = 0; i < sampleCount; i++) {
+            int32_t current = counts[axis][i];
+            length += writeVarint(output + length, zigzag(current - previous));
+            previous = current;
+        }
+    }
+
+    return length;
+}
+
+void WaveformBlockEncoder::reset() {
+    sampleCount = 0;
+}
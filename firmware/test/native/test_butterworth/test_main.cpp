@@ -0,0 +1,131 @@
+#include <unity.h>
+#include <complex>
+#include "filter_bank.h"
+
+#define TEST_RATE 100.0
+#define TEST_LOW_HZ 0.5
+#define TEST_HIGH_HZ 10.0
+
+static float responseAt(const BandpassDesign& design, double frequency, double sampleRate) {
+    std::complex<double> z = std::polar(1.0, 2.0 * butterworth_detail::kPi * frequency / sampleRate);
+    std::complex<double> inverse = 1.0 / z;
+    std::complex<double> inverseSquared = inverse * inverse;
+    std::complex<double> response = 1.0;
+
+    for (int i = 0; i < design.sectionCount; i++) {
+        const BiquadCoefficients& c = design.sections[i];
+        std::complex<double> numerator = static_cast<double>(c.b0) + static_cast<double>(c.b1) * inverse +
+                                         static_cast<double>(c.b2) * inverseSquared;
+        std::complex<double> denominator =
+            1.0 + static_cast<double>(c.a1) * inverse + static_cast<double>(c.a2) * inverseSquared;
+        response *= numerator / denominator;
+    }
+    return static_cast<float>(std::abs(response));
+}
+
+static double centerFrequency(double sampleRate, double low, double high) {
+    double warpedLow = std::tan(butterworth_detail::kPi * low / sampleRate);
+    double warpedHigh = std::tan(butterworth_detail::kPi * high / sampleRate);
+    return sampleRate / butterworth_detail::kPi * std::atan(std::sqrt(warpedLow * warpedHigh));
+}
+
+static float measuredGain(const BandpassDesign& design, double frequency, double sampleRate) {
+    ButterworthFilter filter(design);
+    float peak = 0.0f;
+    int settle = static_cast<int>(20.0 * sampleRate);
+    int measure = static_cast<int>(10.0 * sampleRate);
+
+    for (int i = 0; i < settle + measure; i++) {
+        double phase = 2.0 * butterworth_detail::kPi * frequency * i / sampleRate;
+        float output = filter.process(static_cast<float>(std::sin(phase)));
+        if (i >= settle) {
+            peak = std::max(peak, std::abs(output));
+        }
+    }
+    return peak;
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_order_sets_section_count(void) {
+    for (int order = 1; order <= FILTER_MAX_SECTIONS; order++) {
+        BandpassDesign design = designButterworthBandpass(TEST_RATE, TEST_LOW_HZ, TEST_HIGH_HZ, order);
+        TEST_ASSERT_EQUAL_INT(order, design.sectionCount);
+    }
+    TEST_ASSERT_EQUAL_INT(FILTER_ORDER, FILTER_BANDPASS_DESIGN.sectionCount);
+    TEST_ASSERT_EQUAL_INT(FILTER_MAX_SECTIONS,
+                          designButterworthBandpass(TEST_RATE, TEST_LOW_HZ, TEST_HIGH_HZ, 9).sectionCount);
+}
+
+void test_sections_are_stable(void) {
+    for (int order = 1; order <= FILTER_MAX_SECTIONS; order++) {
+        BandpassDesign design = designButterworthBandpass(TEST_RATE, TEST_LOW_HZ, TEST_HIGH_HZ, order);
+        for (int i = 0; i < design.sectionCount; i++) {
+            const BiquadCoefficients& c = design.sections[i];
+            TEST_ASSERT_LESS_THAN(1.0f, std::abs(c.a2));
+            TEST_ASSERT_LESS_THAN(1.0f + c.a2, std::abs(c.a1));
+        }
+    }
+}
+
+void test_rejects_dc_and_nyquist(void) {
+    for (int order = 1; order <= FILTER_MAX_SECTIONS; order++) {
+        BandpassDesign design = designButterworthBandpass(TEST_RATE, TEST_LOW_HZ, TEST_HIGH_HZ, order);
+        TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0f, responseAt(design, 0.0, TEST_RATE));
+        TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0f, responseAt(design, TEST_RATE / 2.0, TEST_RATE));
+    }
+}
+
+void test_unity_gain_at_center_and_half_power_at_cutoffs(void) {
+    double center = centerFrequency(TEST_RATE, TEST_LOW_HZ, TEST_HIGH_HZ);
+
+    for (int order = 1; order <= FILTER_MAX_SECTIONS; order++) {
+        BandpassDesign design = designButterworthBandpass(TEST_RATE, TEST_LOW_HZ, TEST_HIGH_HZ, order);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, 1.0f, responseAt(design, center, TEST_RATE));
+        TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.70710678f, responseAt(design, TEST_LOW_HZ, TEST_RATE));
+        TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.70710678f, responseAt(design, TEST_HIGH_HZ, TEST_RATE));
+    }
+}
+
+void test_rolloff_steepens_with_order(void) {
+    float previous = 1.0f;
+    for (int order = 1; order <= FILTER_MAX_SECTIONS; order++) {
+        BandpassDesign design = designButterworthBandpass(TEST_RATE, TEST_LOW_HZ, TEST_HIGH_HZ, order);
+        float stopband = responseAt(design, 4.0 * TEST_HIGH_HZ, TEST_RATE);
+        TEST_ASSERT_LESS_THAN(previous, stopband);
+        previous = stopband;
+    }
+}
+
+void test_filtered_sine_matches_designed_response(void) {
+    BandpassDesign design = designButterworthBandpass(TEST_RATE, TEST_LOW_HZ, TEST_HIGH_HZ, FILTER_ORDER);
+    const double frequencies[] = {0.1, TEST_LOW_HZ, 2.0, TEST_HIGH_HZ, 30.0};
+
+    for (double frequency : frequencies) {
+        float expected = responseAt(design, frequency, TEST_RATE);
+        TEST_ASSERT_FLOAT_WITHIN(0.01f, expected, measuredGain(design, frequency, TEST_RATE));
+    }
+}
+
+void test_configured_bandpass_passes_seismic_band(void) {
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.70710678f,
+                             responseAt(FILTER_BANDPASS_DESIGN, FILTER_LOW_CUTOFF_HZ, SAMPLE_RATE_HZ));
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.70710678f,
+                             responseAt(FILTER_BANDPASS_DESIGN, FILTER_HIGH_CUTOFF_HZ, SAMPLE_RATE_HZ));
+    TEST_ASSERT_GREATER_THAN(0.95f, responseAt(FILTER_BANDPASS_DESIGN, 1.0, SAMPLE_RATE_HZ));
+    TEST_ASSERT_GREATER_THAN(0.95f, responseAt(FILTER_BANDPASS_DESIGN, 10.0, SAMPLE_RATE_HZ));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_order_sets_section_count);
+    RUN_TEST(test_sections_are_stable);
+    RUN_TEST(test_rejects_dc_and_nyquist);
+    RUN_TEST(test_unity_gain_at_center_and_half_power_at_cutoffs);
+    RUN_TEST(test_rolloff_steepens_with_order);
+    RUN_TEST(test_filtered_sine_matches_designed_response);
+    RUN_TEST(test_configured_bandpass_passes_seismic_band);
+    return UNITY_END();
+}
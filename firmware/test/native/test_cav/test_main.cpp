@@ -0,0 +1,88 @@
+#include <unity.h>
+#include "earthquake_detector.h"
+
+#define TEST_RATE 100
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_cumulative_integrates_absolute_acceleration(void) {
+    CavAccumulator cav(TEST_RATE, CAV_CUMULATIVE);
+    cav.start();
+
+    double expected = 0.0;
+    for (int i = 0; i < 5 * TEST_RATE; i++) {
+        float acceleration = 0.02f * std::sin(i * 0.2f);
+        cav.update(acceleration);
+        expected += std::abs(acceleration) / TEST_RATE;
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, static_cast<float>(expected), cav.getCAV());
+}
+
+void test_cumulative_constant_input_is_rate_times_time(void) {
+    CavAccumulator cav(TEST_RATE, CAV_CUMULATIVE);
+    for (int i = 0; i < 2 * TEST_RATE; i++) {
+        cav.update(-0.1f);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.2f, cav.getCAV());
+}
+
+void test_standardized_skips_quiet_bins(void) {
+    CavAccumulator cav(TEST_RATE, CAV_STANDARDIZED);
+    int binSamples = static_cast<int>(CAV_STANDARDIZED_BIN_SEC * TEST_RATE);
+    float quiet = 0.5f * CAV_STANDARDIZED_THRESHOLD_G;
+    float strong = 4.0f * CAV_STANDARDIZED_THRESHOLD_G;
+
+    for (int i = 0; i < binSamples; i++) {
+        cav.update(quiet);
+    }
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, cav.getCAV());
+
+    for (int i = 0; i < binSamples; i++) {
+        cav.update(i == binSamples / 2 ? strong : quiet);
+    }
+    float loudBin = ((binSamples - 1) * quiet + strong) / TEST_RATE;
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, loudBin, cav.getCAV());
+
+    for (int i = 0; i < binSamples; i++) {
+        cav.update(quiet);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, loudBin, cav.getCAV());
+}
+
+void test_standardized_counts_open_bin_once_it_exceeds(void) {
+    CavAccumulator cav(TEST_RATE, CAV_STANDARDIZED);
+    float quiet = 0.5f * CAV_STANDARDIZED_THRESHOLD_G;
+    float strong = 2.0f * CAV_STANDARDIZED_THRESHOLD_G;
+
+    for (int i = 0; i < 10; i++) {
+        cav.update(quiet);
+    }
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, cav.getCAV());
+
+    cav.update(-strong);
+    TEST_ASSERT_FLOAT_WITHIN(1e-7f, (10 * quiet + strong) / TEST_RATE, cav.getCAV());
+}
+
+void test_start_discards_previous_event(void) {
+    CavAccumulator cav(TEST_RATE, CAV_CUMULATIVE);
+    for (int i = 0; i < TEST_RATE; i++) {
+        cav.update(0.5f);
+    }
+    cav.start();
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, cav.getCAV());
+
+    cav.update(0.5f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-7f, 0.005f, cav.getCAV());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_cumulative_integrates_absolute_acceleration);
+    RUN_TEST(test_cumulative_constant_input_is_rate_times_time);
+    RUN_TEST(test_standardized_skips_quiet_bins);
+    RUN_TEST(test_standardized_counts_open_bin_once_it_exceeds);
+    RUN_TEST(test_start_discards_previous_event);
+    return UNITY_END();
+}
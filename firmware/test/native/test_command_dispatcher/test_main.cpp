@@ -0,0 +1,195 @@
+#include <unity.h>
+#include "command_dispatcher.h"
+
+static int calls;
+static float lastTrigger;
+static bool lastEnabled;
+
+static CommandStatus handleReset(const CommandArguments& arguments) {
+    calls++;
+    return COMMAND_OK;
+}
+
+static CommandStatus handleThresholds(const CommandArguments& arguments) {
+    calls++;
+    float detrigger;
+    if (!arguments.getNumber("trigger", lastTrigger) || !arguments.getNumber("detrigger", detrigger)) {
+        return COMMAND_MALFORMED;
+    }
+    return lastTrigger > detrigger ? COMMAND_OK : COMMAND_REJECTED;
+}
+
+static CommandStatus handleStream(const CommandArguments& arguments) {
+    calls++;
+    lastEnabled = arguments.getBool("enabled", true);
+    return COMMAND_OK;
+}
+
+static const CommandHandler TABLE[] = {
+    {"reset", handleReset},
+    {"thresholds", handleThresholds},
+    {"stream", handleStream}
+};
+
+static CommandDispatcher dispatcher(TABLE, sizeof(TABLE) / sizeof(TABLE[0]));
+
+static CommandResult dispatchText(const char* text) {
+    char payload[256];
+    size_t length = strlen(text);
+    memcpy(payload, text, length);
+    return dispatcher.dispatch(reinterpret_cast<uint8_t*>(payload), length);
+}
+
+static bool parseText(CommandArguments& arguments, const char* text) {
+    return arguments.parse(text, strlen(text));
+}
+
+void setUp(void) {
+    calls = 0;
+    lastTrigger = 0.0f;
+    lastEnabled = false;
+}
+
+void tearDown(void) {}
+
+void test_bare_command_name_is_routed(void) {
+    CommandResult result = dispatchText("  reset\r\n");
+    TEST_ASSERT_EQUAL_STRING("reset", result.name);
+    TEST_ASSERT_EQUAL(COMMAND_OK, result.status);
+    TEST_ASSERT_EQUAL_INT(1, calls);
+}
+
+void test_json_command_passes_arguments(void) {
+    CommandResult result = dispatchText("{\"command\": \"thresholds\", \"trigger\": 6.5, \"detrigger\": 2}");
+    TEST_ASSERT_EQUAL_STRING("thresholds", result.name);
+    TEST_ASSERT_EQUAL(COMMAND_OK, result.status);
+    TEST_ASSERT_EQUAL_FLOAT(6.5f, lastTrigger);
+
+    result = dispatchText("{\"command\":\"thresholds\",\"trigger\":1,\"detrigger\":2}");
+    TEST_ASSERT_EQUAL(COMMAND_REJECTED, result.status);
+}
+
+void test_missing_boolean_uses_fallback(void) {
+    TEST_ASSERT_EQUAL(COMMAND_OK, dispatchText("{\"command\":\"stream\"}").status);
+    TEST_ASSERT_TRUE(lastEnabled);
+
+    TEST_ASSERT_EQUAL(COMMAND_OK, dispatchText("{\"command\":\"stream\",\"enabled\":false}").status);
+    TEST_ASSERT_FALSE(lastEnabled);
+}
+
+void test_unknown_command(void) {
+    CommandResult result = dispatchText("{\"command\":\"reboot\"}");
+    TEST_ASSERT_EQUAL_STRING("reboot", result.name);
+    TEST_ASSERT_EQUAL(COMMAND_UNKNOWN, result.status);
+
+    TEST_ASSERT_EQUAL(COMMAND_UNKNOWN, dispatchText("rese").status);
+    TEST_ASSERT_EQUAL(COMMAND_UNKNOWN, dispatchText("resets").status);
+    TEST_ASSERT_EQUAL_INT(0, calls);
+}
+
+void test_long_names_are_truncated_in_result(void) {
+    CommandResult result = dispatchText("abcdefghijklmnopqrstuvwxyz0123");
+    TEST_ASSERT_EQUAL_size_t(COMMAND_NAME_MAX_LENGTH, strlen(result.name));
+    TEST_ASSERT_EQUAL(COMMAND_UNKNOWN, result.status);
+}
+
+void test_malformed_payloads(void) {
+    const char* payloads[] = {
+        "",
+        "   ",
+        "{",
+        "{}",
+        "{\"command\":5}",
+        "{\"command\":\"reset\"",
+        "{\"command\":\"reset\",}",
+        "{\"command\":\"reset\"} x",
+        "{\"command\":\"reset\",\"args\":{\"a\":1}}",
+        "{\"command\":\"reset\",\"list\":[1]}",
+        "{command:\"reset\"}",
+        "{\"command\":\"reset\",\"a\":1,\"b\":2,\"c\":3,\"d\":4,\"e\":5,\"f\":6,\"g\":7,\"h\":8}"
+    };
+
+    for (const char* payload : payloads) {
+        CommandResult result = dispatchText(payload);
+        TEST_ASSERT_EQUAL(COMMAND_MALFORMED, result.status);
+    }
+    TEST_ASSERT_EQUAL_INT(0, calls);
+}
+
+void test_argument_types(void) {
+    CommandArguments arguments;
+    TEST_ASSERT_TRUE(parseText(arguments,
+        "{ \"s\" : \"a\\\"b\", \"n\": -1.25e2, \"u\": 3, \"t\": true, \"z\": null }"));
+    TEST_ASSERT_EQUAL_size_t(5, arguments.size());
+
+    const char* text;
+    size_t length;
+    TEST_ASSERT_TRUE(arguments.getString("s", text, length));
+    TEST_ASSERT_EQUAL_size_t(4, length);
+    TEST_ASSERT_FALSE(arguments.getString("n", text, length));
+
+    float number;
+    TEST_ASSERT_TRUE(arguments.getNumber("n", number));
+    TEST_ASSERT_EQUAL_FLOAT(-125.0f, number);
+    TEST_ASSERT_FALSE(arguments.getNumber("s", number));
+
+    uint32_t value;
+    TEST_ASSERT_TRUE(arguments.getUnsigned("u", value));
+    TEST_ASSERT_EQUAL_UINT32(3, value);
+    TEST_ASSERT_FALSE(arguments.getUnsigned("n", value));
+
+    TEST_ASSERT_TRUE(arguments.getBool("t", false));
+    TEST_ASSERT_TRUE(arguments.getBool("z", true));
+    TEST_ASSERT_TRUE(arguments.has("z"));
+    TEST_ASSERT_FALSE(arguments.has("missing"));
+}
+
+void test_invalid_numbers_are_rejected(void) {
+    CommandArguments arguments;
+    TEST_ASSERT_FALSE(parseText(arguments, "{\"n\":01}"));
+    TEST_ASSERT_FALSE(parseText(arguments, "{\"n\":1.}"));
+    TEST_ASSERT_FALSE(parseText(arguments, "{\"n\":-}"));
+    TEST_ASSERT_FALSE(parseText(arguments, "{\"n\":1e}"));
+    TEST_ASSERT_FALSE(parseText(arguments, "{\"n\":tru}"));
+    TEST_ASSERT_EQUAL_size_t(0, arguments.size());
+
+    float number;
+    uint32_t value;
+    TEST_ASSERT_TRUE(parseText(arguments, "{\"big\":1e99,\"wide\":4294967296}"));
+    TEST_ASSERT_FALSE(arguments.getNumber("big", number));
+    TEST_ASSERT_FALSE(arguments.getUnsigned("wide", value));
+}
+
+void test_embedded_nul_bytes_are_rejected(void) {
+    calls = 0;
+    char payload[] = {'r', 'e', 's', 'e', 't', '\0', '\0', '\0'};
+    CommandResult result = dispatcher.dispatch(reinterpret_cast<uint8_t*>(payload), sizeof(payload));
+
+    TEST_ASSERT_EQUAL_UINT8(COMMAND_MALFORMED, result.status);
+    TEST_ASSERT_EQUAL_INT(0, calls);
+
+    char prefixed[] = {'r', 'e', 's', '\0', 't'};
+    result = dispatcher.dispatch(reinterpret_cast<uint8_t*>(prefixed), sizeof(prefixed));
+    TEST_ASSERT_EQUAL_UINT8(COMMAND_MALFORMED, result.status);
+    TEST_ASSERT_EQUAL_INT(0, calls);
+}
+
+void test_name_prefixes_do_not_match(void) {
+    TEST_ASSERT_EQUAL_UINT8(COMMAND_UNKNOWN, dispatchText("rese").status);
+    TEST_ASSERT_EQUAL_UINT8(COMMAND_UNKNOWN, dispatchText("resets").status);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_bare_command_name_is_routed);
+    RUN_TEST(test_json_command_passes_arguments);
+    RUN_TEST(test_missing_boolean_uses_fallback);
+    RUN_TEST(test_unknown_command);
+    RUN_TEST(test_long_names_are_truncated_in_result);
+    RUN_TEST(test_malformed_payloads);
+    RUN_TEST(test_argument_types);
+    RUN_TEST(test_invalid_numbers_are_rejected);
+    RUN_TEST(test_embedded_nul_bytes_are_rejected);
+    RUN_TEST(test_name_prefixes_do_not_match);
+    return UNITY_END();
+}
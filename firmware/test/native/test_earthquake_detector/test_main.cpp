@@ -0,0 +1,172 @@
+#include <unity.h>
+#include "earthquake_detector.h"
+
+#define TEST_RATE 100
+
+static AccelSample sampleAt(int index, float x, float y, float z) {
+    AccelSample sample;
+    sample.x = x;
+    sample.y = y;
+    sample.z = z;
+    sample.timestamp = static_cast<uint64_t>(index) * (1000000ULL / TEST_RATE);
+    return sample;
+}
+
+static uint32_t noiseState;
+
+static float noise() {
+    noiseState = noiseState * 1664525u + 1013904223u;
+    return (static_cast<float>(noiseState >> 8) / 16777216.0f - 0.5f) * 0.07f;
+}
+
+static AccelSample motionAt(int index, float eventStartSec, float amplitude, float frequency) {
+    const float pi = static_cast<float>(butterworth_detail::kPi);
+    float t = static_cast<float>(index) / TEST_RATE;
+    float offset = std::min(t - eventStartSec, eventStartSec + 8.0f - t);
+    float envelope = 0.0f;
+    if (offset >= 2.0f) {
+        envelope = amplitude;
+    } else if (offset > 0.0f) {
+        envelope = amplitude * (0.5f - 0.5f * std::cos(pi * offset / 2.0f));
+    }
+    float signal = envelope * std::sin(2.0f * pi * frequency * t);
+    return sampleAt(index, noise() + signal, noise(), noise() + 0.5f * signal);
+}
+
+static EarthquakeDetector primaryDetector() {
+    return EarthquakeDetector(TEST_RATE, STA_WINDOW_SEC, LTA_WINDOW_SEC, STA_LTA_TRIGGER_THRESHOLD,
+                              STA_LTA_DETRIGGER_THRESHOLD, STA_LTA_SLIDING, CAV_CUMULATIVE);
+}
+
+void setUp(void) {
+    noiseState = 12345u;
+}
+
+void tearDown(void) {}
+
+void test_bandpassed_rest_has_no_ground_motion(void) {
+    EarthquakeDetector detector(TEST_RATE, STA_WINDOW_SEC, LTA_WINDOW_SEC, STA_LTA_TRIGGER_THRESHOLD,
+                                STA_LTA_DETRIGGER_THRESHOLD);
+    detector.init();
+
+    for (int i = 0; i < TEST_RATE; i++) {
+        detector.addSample(sampleAt(i, 0.0f, 0.0f, 0.0f));
+    }
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, detector.getCurrentPGA());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, detector.calculateSTA());
+
+    detector.addSample(sampleAt(TEST_RATE, 0.0f, 0.0f, -0.981f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.1f, detector.getCurrentPGA());
+}
+
+void test_channel_bank_is_bounded(void) {
+    EarthquakeDetector detector = primaryDetector();
+    TEST_ASSERT_EQUAL_size_t(1, detector.getChannelCount());
+
+    for (size_t i = 1; i < DETECTOR_MAX_CHANNELS; i++) {
+        TEST_ASSERT_TRUE(detector.addChannel(LOCAL_DETECTOR_CHANNEL));
+    }
+    TEST_ASSERT_FALSE(detector.addChannel(LOCAL_DETECTOR_CHANNEL));
+    TEST_ASSERT_EQUAL_size_t(DETECTOR_MAX_CHANNELS, detector.getChannelCount());
+
+    TEST_ASSERT_FALSE(detector.setChannelThresholds(DETECTOR_MAX_CHANNELS, 6.0f, 2.0f));
+    TEST_ASSERT_FALSE(detector.setChannelThresholds(1, 2.0f, 2.0f));
+    TEST_ASSERT_FALSE(detector.setChannelThresholds(1, 6.0f, 0.0f));
+    TEST_ASSERT_TRUE(detector.setChannelThresholds(1, 6.0f, 2.0f));
+}
+
+void test_event_needs_required_votes(void) {
+    EarthquakeDetector detector = primaryDetector();
+    detector.addChannel(LOCAL_DETECTOR_CHANNEL);
+    detector.setChannelThresholds(1, 1000.0f, 500.0f);
+    detector.setVotesRequired(2);
+    detector.init();
+
+    uint32_t seenChannels = 0;
+    for (int i = 0; i < 45 * TEST_RATE; i++) {
+        detector.addSample(motionAt(i, 35.0f, 0.5f, 3.0f));
+        seenChannels |= detector.getTriggeredChannels();
+        TEST_ASSERT_FALSE(detector.isTriggered());
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, seenChannels);
+    TEST_ASSERT_FALSE(detector.hasConfirmedEvent());
+}
+
+void test_votes_are_clamped_to_channel_count(void) {
+    EarthquakeDetector detector = primaryDetector();
+    detector.setVotesRequired(3);
+    detector.init();
+
+    bool triggered = false;
+    for (int i = 0; i < 45 * TEST_RATE; i++) {
+        detector.addSample(motionAt(i, 35.0f, 0.5f, 3.0f));
+        triggered = triggered || detector.isTriggered();
+    }
+    TEST_ASSERT_TRUE(triggered);
+}
+
+void test_onset_is_earliest_voting_channel(void) {
+    EarthquakeDetector detector = primaryDetector();
+    detector.addChannel(LOCAL_DETECTOR_CHANNEL);
+    detector.setVotesRequired(2);
+    detector.init();
+
+    uint64_t channelOnset[2] = {0, 0};
+    uint64_t detectorOnset = 0;
+    for (int i = 0; i < 50 * TEST_RATE; i++) {
+        AccelSample sample = motionAt(i, 35.0f, 0.5f, 3.0f);
+        detector.addSample(sample);
+
+        uint32_t mask = detector.getTriggeredChannels();
+        for (int channel = 0; channel < 2; channel++) {
+            if ((mask & (1UL << channel)) && channelOnset[channel] == 0) {
+                channelOnset[channel] = sample.timestamp;
+            }
+        }
+        if (detector.isTriggered() && detectorOnset == 0) {
+            detectorOnset = sample.timestamp;
+            TEST_ASSERT_EQUAL_UINT32(3, mask);
+        }
+    }
+
+    TEST_ASSERT_TRUE(channelOnset[1] > 0);
+    TEST_ASSERT_TRUE(channelOnset[0] > channelOnset[1]);
+    TEST_ASSERT_EQUAL_UINT64(std::max(channelOnset[0], channelOnset[1]), detectorOnset);
+    TEST_ASSERT_EQUAL_UINT64(std::min(channelOnset[0], channelOnset[1]), detector.getCurrentEvent().startTime);
+    TEST_ASSERT_TRUE(detector.hasConfirmedEvent());
+}
+
+void test_band_channel_ignores_out_of_band_motion(void) {
+    EarthquakeDetector lowFrequency = primaryDetector();
+    EarthquakeDetector inBand = primaryDetector();
+    lowFrequency.addChannel(BAND_DETECTOR_CHANNEL);
+    inBand.addChannel(BAND_DETECTOR_CHANNEL);
+    lowFrequency.init();
+    inBand.init();
+
+    uint32_t lowMask = 0;
+    uint32_t inBandMask = 0;
+    for (int i = 0; i < 45 * TEST_RATE; i++) {
+        lowFrequency.addSample(motionAt(i, 35.0f, 0.5f, 0.3f));
+        lowMask |= lowFrequency.getTriggeredChannels();
+    }
+    noiseState = 12345u;
+    for (int i = 0; i < 45 * TEST_RATE; i++) {
+        inBand.addSample(motionAt(i, 35.0f, 0.5f, 5.0f));
+        inBandMask |= inBand.getTriggeredChannels();
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(0, lowMask & 2);
+    TEST_ASSERT_EQUAL_UINT32(2, inBandMask & 2);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_bandpassed_rest_has_no_ground_motion);
+    RUN_TEST(test_channel_bank_is_bounded);
+    RUN_TEST(test_event_needs_required_votes);
+    RUN_TEST(test_votes_are_clamped_to_channel_count);
+    RUN_TEST(test_onset_is_earliest_voting_channel);
+    RUN_TEST(test_band_channel_ignores_out_of_band_motion);
+    return UNITY_END();
+}
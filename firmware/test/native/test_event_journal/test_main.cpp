@@ -0,0 +1,127 @@
+#include <unity.h>
+#include "event_journal.h"
+
+static EarthquakeEvent sampleEvent() {
+    EarthquakeEvent event = EarthquakeEvent();
+    event.magnitude = 4.2f;
+    event.pga = 0.12f;
+    event.pgaAxes.x = 0.05f;
+    event.pgaAxes.y = 0.07f;
+    event.pgaAxes.z = 0.12f;
+    event.pgv = 3.5f;
+    event.cav = 0.2f;
+    event.startTime = 1700000000123456ULL;
+    event.duration = 8500;
+    event.alertLevel = AlertLevel::STRONG;
+    event.confirmed = true;
+    return event;
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_event_record_round_trip(void) {
+    JournalRecord record;
+    encodeEventRecord(42, sampleEvent(), "ESP32_TEST", record);
+
+    TEST_ASSERT_TRUE(isValidRecord(record));
+    TEST_ASSERT_EQUAL_UINT32(42, record.sequence);
+    TEST_ASSERT_EQUAL_UINT8(JOURNAL_RECORD_EVENT, record.type);
+
+    EarthquakeEvent decoded;
+    char deviceId[DEVICE_ID_LENGTH + 1];
+    decodeEventRecord(record, decoded, deviceId, sizeof(deviceId));
+
+    TEST_ASSERT_EQUAL_STRING("ESP32_TEST", deviceId);
+    TEST_ASSERT_EQUAL_FLOAT(4.2f, decoded.magnitude);
+    TEST_ASSERT_EQUAL_FLOAT(0.07f, decoded.pgaAxes.y);
+    TEST_ASSERT_EQUAL_UINT64(1700000000123456ULL, decoded.startTime);
+    TEST_ASSERT_EQUAL_UINT32(8500, decoded.duration);
+    TEST_ASSERT_TRUE(decoded.alertLevel == AlertLevel::STRONG);
+    TEST_ASSERT_TRUE(decoded.confirmed);
+}
+
+void test_device_id_is_truncated_to_capacity(void) {
+    JournalRecord record;
+    encodeEventRecord(1, sampleEvent(), "ESP32_A_VERY_LONG_DEVICE_IDENTIFIER", record);
+
+    EarthquakeEvent decoded;
+    char deviceId[8];
+    decodeEventRecord(record, decoded, deviceId, sizeof(deviceId));
+
+    TEST_ASSERT_EQUAL_STRING("ESP32_A", deviceId);
+}
+
+void test_any_flipped_byte_fails_validation(void) {
+    JournalRecord record;
+    encodeEventRecord(7, sampleEvent(), "ESP32_TEST", record);
+
+    for (size_t i = 0; i < sizeof(record); i++) {
+        JournalRecord damaged = record;
+        reinterpret_cast<uint8_t*>(&damaged)[i] ^= 0x10;
+        TEST_ASSERT_FALSE(isValidRecord(damaged));
+    }
+}
+
+void test_sent_records(void) {
+    JournalRecord sent;
+    JournalRecord sentThrough;
+    encodeSentRecord(9, sent);
+    encodeSentThroughRecord(12, sentThrough);
+
+    TEST_ASSERT_TRUE(isValidRecord(sent));
+    TEST_ASSERT_TRUE(isValidRecord(sentThrough));
+    TEST_ASSERT_EQUAL_UINT8(JOURNAL_RECORD_SENT, sent.type);
+    TEST_ASSERT_EQUAL_UINT8(JOURNAL_RECORD_SENT_THROUGH, sentThrough.type);
+    TEST_ASSERT_EQUAL_UINT32(12, sentThrough.sequence);
+}
+
+void test_unknown_record_type_is_rejected(void) {
+    JournalRecord record;
+    encodeSentRecord(3, record);
+    record.type = 9;
+    record.crc = journalCrc32(reinterpret_cast<const uint8_t*>(&record), sizeof(record) - sizeof(record.crc));
+
+    TEST_ASSERT_FALSE(isValidRecord(record));
+}
+
+void test_legacy_record_upgrade(void) {
+    LegacyJournalRecord legacy;
+    memset(&legacy, 0, sizeof(legacy));
+    legacy.magic = JOURNAL_LEGACY_RECORD_MAGIC;
+    legacy.sequence = 5;
+    legacy.type = JOURNAL_RECORD_EVENT;
+    legacy.pga = 0.2f;
+    legacy.startTime = 123456;
+    legacy.duration = 6000;
+    strcpy(legacy.alertLevel, "moderate");
+    strcpy(legacy.deviceId, "ESP32_OLD");
+    legacy.crc = journalCrc32(reinterpret_cast<const uint8_t*>(&legacy), sizeof(legacy) - sizeof(legacy.crc));
+
+    JournalRecord record;
+    TEST_ASSERT_TRUE(upgradeLegacyRecord(legacy, record));
+    TEST_ASSERT_TRUE(isValidRecord(record));
+    TEST_ASSERT_EQUAL_UINT64(123456000ULL, record.startTime);
+    TEST_ASSERT_EQUAL_UINT32(5, record.sequence);
+
+    legacy.pga = 0.3f;
+    TEST_ASSERT_FALSE(upgradeLegacyRecord(legacy, record));
+}
+
+void test_crc32_matches_reference(void) {
+    const char* text = "123456789";
+    TEST_ASSERT_EQUAL_UINT32(0xCBF43926UL, journalCrc32(reinterpret_cast<const uint8_t*>(text), strlen(text)));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_event_record_round_trip);
+    RUN_TEST(test_device_id_is_truncated_to_capacity);
+    RUN_TEST(test_any_flipped_byte_fails_validation);
+    RUN_TEST(test_sent_records);
+    RUN_TEST(test_unknown_record_type_is_rejected);
+    RUN_TEST(test_legacy_record_upgrade);
+    RUN_TEST(test_crc32_matches_reference);
+    return UNITY_END();
+}
@@ -0,0 +1,149 @@
+#include <unity.h>
+#include "event_queue.h"
+
+static EarthquakeEvent sampleEvent(uint32_t index) {
+    EarthquakeEvent event = EarthquakeEvent();
+    event.magnitude = 3.0f + index * 0.1f;
+    event.pga = 0.05f;
+    event.startTime = 1700000000000000ULL + index * 1000000ULL;
+    event.duration = 6000;
+    event.alertLevel = AlertLevel::LIGHT;
+    return event;
+}
+
+static size_t journalSize() {
+    File journal = SPIFFS.open(JOURNAL_FILE, FILE_READ);
+    size_t size = journal.size();
+    journal.close();
+    return size;
+}
+
+static void appendRaw(const uint8_t* data, size_t length) {
+    File journal = SPIFFS.open(JOURNAL_FILE, FILE_APPEND);
+    journal.write(data, length);
+    journal.close();
+}
+
+static bool sendAll(const QueuedEvent* const* batch, size_t count) {
+    return true;
+}
+
+void setUp(void) {
+    SPIFFS.format();
+    halSpiffsLimitWrites(SIZE_MAX);
+}
+
+void tearDown(void) {
+    halSpiffsLimitWrites(SIZE_MAX);
+}
+
+void test_events_survive_reload(void) {
+    EventQueue queue;
+    TEST_ASSERT_TRUE(queue.init());
+    for (uint32_t i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(queue.addEvent(sampleEvent(i), "ESP32_TEST"));
+    }
+
+    EventQueue reloaded;
+    TEST_ASSERT_TRUE(reloaded.init());
+    TEST_ASSERT_EQUAL_INT(3, reloaded.getUnsentCount());
+    TEST_ASSERT_EQUAL_size_t(3 * sizeof(JournalRecord), journalSize());
+}
+
+void test_sent_batches_are_not_reloaded(void) {
+    EventQueue queue;
+    queue.init();
+    for (uint32_t i = 0; i < 4; i++) {
+        queue.addEvent(sampleEvent(i), "ESP32_TEST");
+    }
+    TEST_ASSERT_TRUE(queue.processBatch(2, sendAll));
+
+    EventQueue reloaded;
+    reloaded.init();
+    TEST_ASSERT_EQUAL_INT(0, reloaded.getUnsentCount());
+}
+
+void test_torn_tail_is_compacted_before_next_append(void) {
+    EventQueue queue;
+    queue.init();
+    queue.addEvent(sampleEvent(0), "ESP32_TEST");
+    queue.addEvent(sampleEvent(1), "ESP32_TEST");
+
+    JournalRecord torn;
+    encodeEventRecord(3, sampleEvent(2), "ESP32_TEST", torn);
+    appendRaw(reinterpret_cast<const uint8_t*>(&torn), sizeof(torn) / 2);
+
+    EventQueue reloaded;
+    TEST_ASSERT_TRUE(reloaded.init());
+    TEST_ASSERT_EQUAL_INT(2, reloaded.getUnsentCount());
+    TEST_ASSERT_EQUAL_size_t(0, journalSize() % sizeof(JournalRecord));
+
+    TEST_ASSERT_TRUE(reloaded.addEvent(sampleEvent(3), "ESP32_TEST"));
+
+    EventQueue again;
+    again.init();
+    TEST_ASSERT_EQUAL_INT(3, again.getUnsentCount());
+}
+
+void test_short_write_realigns_journal(void) {
+    EventQueue queue;
+    queue.init();
+    queue.addEvent(sampleEvent(0), "ESP32_TEST");
+
+    halSpiffsLimitWrites(sizeof(JournalRecord) / 3);
+    TEST_ASSERT_FALSE(queue.addEvent(sampleEvent(1), "ESP32_TEST"));
+    TEST_ASSERT_EQUAL_size_t(sizeof(JournalRecord) / 3, journalSize() % sizeof(JournalRecord));
+
+    halSpiffsLimitWrites(SIZE_MAX);
+    TEST_ASSERT_TRUE(queue.addEvent(sampleEvent(2), "ESP32_TEST"));
+    TEST_ASSERT_EQUAL_size_t(3 * sizeof(JournalRecord), journalSize());
+
+    EventQueue reloaded;
+    reloaded.init();
+    TEST_ASSERT_EQUAL_INT(3, reloaded.getUnsentCount());
+}
+
+void test_failed_watermark_stops_batch_flush(void) {
+    EventQueue queue;
+    queue.init();
+    for (uint32_t i = 0; i < 4; i++) {
+        queue.addEvent(sampleEvent(i), "ESP32_TEST");
+    }
+
+    size_t batches = 0;
+    halSpiffsLimitWrites(0);
+    TEST_ASSERT_TRUE(queue.processBatch(2, [&](const QueuedEvent* const* batch, size_t count) {
+        batches++;
+        return true;
+    }));
+    TEST_ASSERT_EQUAL_size_t(1, batches);
+    TEST_ASSERT_EQUAL_INT(2, queue.getUnsentCount());
+}
+
+void test_corrupt_record_is_skipped(void) {
+    EventQueue queue;
+    queue.init();
+    queue.addEvent(sampleEvent(0), "ESP32_TEST");
+
+    JournalRecord damaged;
+    encodeEventRecord(2, sampleEvent(1), "ESP32_TEST", damaged);
+    damaged.pga = 1.0f;
+    appendRaw(reinterpret_cast<const uint8_t*>(&damaged), sizeof(damaged));
+    queue.addEvent(sampleEvent(2), "ESP32_TEST");
+
+    EventQueue reloaded;
+    reloaded.init();
+    TEST_ASSERT_EQUAL_INT(2, reloaded.getUnsentCount());
+    TEST_ASSERT_EQUAL_size_t(2 * sizeof(JournalRecord), journalSize());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_events_survive_reload);
+    RUN_TEST(test_sent_batches_are_not_reloaded);
+    RUN_TEST(test_torn_tail_is_compacted_before_next_append);
+    RUN_TEST(test_short_write_realigns_journal);
+    RUN_TEST(test_failed_watermark_stops_batch_flush);
+    RUN_TEST(test_corrupt_record_is_skipped);
+    return UNITY_END();
+}
@@ -0,0 +1,62 @@
+#include <unity.h>
+#include "filter_bank.h"
+
+#define TEST_SAMPLES 2000
+
+static AccelSample sampleAt(int index) {
+    AccelSample sample;
+    sample.x = 0.3f * std::sin(index * 0.21f) + 0.05f * std::sin(index * 2.3f);
+    sample.y = -0.2f * std::cos(index * 0.07f) + 0.4f;
+    sample.z = 9.81f + 0.1f * std::sin(index * 0.9f);
+    sample.timestamp = static_cast<uint64_t>(index) * 10000ULL;
+    return sample;
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_matches_per_axis_butterworth_and_kalman(void) {
+    AxisFilterBank bank(FILTER_BANDPASS_DESIGN, KALMAN_PROCESS_NOISE, KALMAN_MEASUREMENT_NOISE);
+    ButterworthFilter filters[3] = {ButterworthFilter(FILTER_BANDPASS_DESIGN), ButterworthFilter(FILTER_BANDPASS_DESIGN),
+                                    ButterworthFilter(FILTER_BANDPASS_DESIGN)};
+    KalmanFilter kalman[3] = {KalmanFilter(KALMAN_PROCESS_NOISE, KALMAN_MEASUREMENT_NOISE),
+                              KalmanFilter(KALMAN_PROCESS_NOISE, KALMAN_MEASUREMENT_NOISE),
+                              KalmanFilter(KALMAN_PROCESS_NOISE, KALMAN_MEASUREMENT_NOISE)};
+
+    for (int i = 0; i < TEST_SAMPLES; i++) {
+        AccelSample input = sampleAt(i);
+        AccelSample output = bank.process(input);
+
+        TEST_ASSERT_FLOAT_WITHIN(1e-5f, kalman[0].update(filters[0].process(input.x)), output.x);
+        TEST_ASSERT_FLOAT_WITHIN(1e-5f, kalman[1].update(filters[1].process(input.y)), output.y);
+        TEST_ASSERT_FLOAT_WITHIN(1e-5f, kalman[2].update(filters[2].process(input.z)), output.z);
+        TEST_ASSERT_EQUAL_UINT64(input.timestamp, output.timestamp);
+    }
+}
+
+void test_batch_matches_single_sample_processing(void) {
+    AxisFilterBank single(FILTER_BANDPASS_DESIGN);
+    AxisFilterBank batch(FILTER_BANDPASS_DESIGN);
+    static AccelSample input[TEST_SAMPLES];
+    static AccelSample output[TEST_SAMPLES];
+
+    for (int i = 0; i < TEST_SAMPLES; i++) {
+        input[i] = sampleAt(i);
+    }
+    batch.process(input, output, TEST_SAMPLES);
+
+    for (int i = 0; i < TEST_SAMPLES; i++) {
+        AccelSample expected = single.process(input[i]);
+        TEST_ASSERT_EQUAL_FLOAT(expected.x, output[i].x);
+        TEST_ASSERT_EQUAL_FLOAT(expected.y, output[i].y);
+        TEST_ASSERT_EQUAL_FLOAT(expected.z, output[i].z);
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_matches_per_axis_butterworth_and_kalman);
+    RUN_TEST(test_batch_matches_single_sample_processing);
+    return UNITY_END();
+}
@@ -0,0 +1,154 @@
+#include <unity.h>
+#include "filter_bank.h"
+#include "fixed_point.h"
+#include "fixed_point_detector.h"
+
+#define TEST_RATE SAMPLE_RATE_HZ
+#define TEST_SAMPLES (70 * TEST_RATE)
+#define TEST_EVENT_START_SEC 40.0f
+#define TEST_EVENT_PEAK 1.5f
+
+static uint32_t noiseState;
+
+static float noise() {
+    noiseState = noiseState * 1664525u + 1013904223u;
+    return (static_cast<float>(noiseState >> 8) / 16777216.0f - 0.5f) * 0.07f;
+}
+
+static AccelSample groundMotionAt(int index) {
+    float t = static_cast<float>(index) / TEST_RATE;
+    float offset = t - TEST_EVENT_START_SEC;
+    float envelope = 0.0f;
+    if (offset >= 0.0f) {
+        envelope = TEST_EVENT_PEAK * std::min(1.0f, offset) * std::exp(-std::max(0.0f, offset - 1.0f) / 6.0f);
+    }
+    float phase = 2.0f * static_cast<float>(butterworth_detail::kPi) * 3.0f * t;
+
+    AccelSample sample;
+    sample.x = noise() + envelope * std::sin(phase);
+    sample.y = noise() + 0.6f * envelope * std::cos(phase * 1.3f);
+    sample.z = 9.80665f + noise() + 0.4f * envelope * std::sin(phase * 0.7f);
+    sample.timestamp = static_cast<uint64_t>(index) * (1000000ULL / TEST_RATE);
+    return sample;
+}
+
+void setUp(void) {
+    noiseState = 12345u;
+}
+
+void tearDown(void) {}
+
+void test_isqrt64_is_floor_square_root(void) {
+    const uint64_t values[] = {0, 1, 2, 3, 4, 15, 16, 17, 1000000, 4294967295ULL, 3ULL * 32768 * 32768,
+                               0xFFFFFFFFFFFFFFFFULL};
+    for (uint64_t value : values) {
+        uint64_t root = isqrt64(value);
+        TEST_ASSERT_TRUE(root * root <= value);
+        TEST_ASSERT_TRUE((root + 1) * (root + 1) > value || root == 0xFFFFFFFFULL);
+    }
+}
+
+void test_conversions_round_and_saturate(void) {
+    TEST_ASSERT_EQUAL_INT32(1 << 28, toFixed(1.0, FIXED_COEFFICIENT_FRACTION_BITS));
+    TEST_ASSERT_EQUAL_INT32(-(1 << 27), toFixed(-0.5, FIXED_COEFFICIENT_FRACTION_BITS));
+    TEST_ASSERT_EQUAL_INT32(ACCEL_COUNTS_PER_G, accelerationToCounts(1.0f));
+    TEST_ASSERT_EQUAL_INT16(INT16_MAX, saturateInt16(40000));
+    TEST_ASSERT_EQUAL_INT16(INT16_MIN, saturateInt16(-40000));
+
+    AccelSample sample = {1.0f, -2.5f, 9.80665f, 42};
+    RawAccelSample raw = toRawAccelSample(sample);
+    TEST_ASSERT_EQUAL_INT16(ACCEL_COUNTS_PER_G, raw.z);
+    TEST_ASSERT_EQUAL_UINT64(42, raw.timestamp);
+
+    AccelSample back = toAccelSample(raw);
+    float step = 9.80665f / ACCEL_COUNTS_PER_G;
+    TEST_ASSERT_FLOAT_WITHIN(step, sample.x, back.x);
+    TEST_ASSERT_FLOAT_WITHIN(step, sample.y, back.y);
+    TEST_ASSERT_FLOAT_WITHIN(step, sample.z, back.z);
+}
+
+void test_fixed_design_matches_float_coefficients(void) {
+    const float resolution = 1.0f / (1 << FIXED_COEFFICIENT_FRACTION_BITS);
+    TEST_ASSERT_EQUAL_INT(FILTER_BANDPASS_DESIGN.sectionCount, FIXED_BANDPASS_DESIGN.sectionCount);
+
+    for (int i = 0; i < FILTER_BANDPASS_DESIGN.sectionCount; i++) {
+        const BiquadCoefficients& c = FILTER_BANDPASS_DESIGN.sections[i];
+        const FixedBiquadCoefficients& f = FIXED_BANDPASS_DESIGN.sections[i];
+        TEST_ASSERT_FLOAT_WITHIN(resolution, c.b0, f.b0 * resolution);
+        TEST_ASSERT_FLOAT_WITHIN(resolution, c.b2, f.b2 * resolution);
+        TEST_ASSERT_FLOAT_WITHIN(resolution, c.a1, f.a1 * resolution);
+        TEST_ASSERT_FLOAT_WITHIN(resolution, c.a2, f.a2 * resolution);
+    }
+}
+
+void test_fixed_filter_bank_tracks_float_bank(void) {
+    AxisFilterBank floating(FILTER_BANDPASS_DESIGN, KALMAN_PROCESS_NOISE, KALMAN_MEASUREMENT_NOISE);
+    FixedAxisFilterBank fixed(FIXED_BANDPASS_DESIGN, FIXED_KALMAN_GAINS);
+    RawAccelSample first = toRawAccelSample(groundMotionAt(0));
+    floating.prime(toAccelSample(first));
+    fixed.prime(first);
+
+    for (int i = 0; i < TEST_SAMPLES; i++) {
+        RawAccelSample raw = toRawAccelSample(groundMotionAt(i));
+        RawAccelSample expected = toRawAccelSample(floating.process(toAccelSample(raw)));
+        RawAccelSample output = fixed.process(raw);
+
+        TEST_ASSERT_INT_WITHIN(5, expected.x, output.x);
+        TEST_ASSERT_INT_WITHIN(5, expected.y, output.y);
+        TEST_ASSERT_INT_WITHIN(5, expected.z, output.z);
+    }
+}
+
+void test_fixed_detector_matches_float_detector(void) {
+    AxisFilterBank floatingBank(FILTER_BANDPASS_DESIGN, KALMAN_PROCESS_NOISE, KALMAN_MEASUREMENT_NOISE);
+    FixedAxisFilterBank fixedBank(FIXED_BANDPASS_DESIGN, FIXED_KALMAN_GAINS);
+    EarthquakeDetector floating(TEST_RATE, STA_WINDOW_SEC, LTA_WINDOW_SEC, STA_LTA_TRIGGER_THRESHOLD,
+                                STA_LTA_DETRIGGER_THRESHOLD, STA_LTA_SLIDING, CAV_CUMULATIVE);
+    FixedPointDetector fixed(TEST_RATE, STA_WINDOW_SEC, LTA_WINDOW_SEC, STA_LTA_TRIGGER_THRESHOLD,
+                             STA_LTA_DETRIGGER_THRESHOLD, STA_LTA_SLIDING, CAV_CUMULATIVE);
+    floating.init();
+    fixed.init();
+
+    RawAccelSample first = toRawAccelSample(groundMotionAt(0));
+    floatingBank.prime(toAccelSample(first));
+    fixedBank.prime(first);
+
+    EarthquakeEvent floatingEvent = EarthquakeEvent();
+    EarthquakeEvent fixedEvent = EarthquakeEvent();
+    bool floatingWasTriggered = false;
+    bool fixedWasTriggered = false;
+
+    for (int i = 0; i < TEST_SAMPLES; i++) {
+        RawAccelSample raw = toRawAccelSample(groundMotionAt(i));
+        floating.addSample(floatingBank.process(toAccelSample(raw)));
+        fixed.addSample(fixedBank.process(raw));
+
+        if (floatingWasTriggered && !floating.isTriggered()) {
+            floatingEvent = floating.getCurrentEvent();
+        }
+        if (fixedWasTriggered && !fixed.isTriggered()) {
+            fixedEvent = fixed.getCurrentEvent();
+        }
+        floatingWasTriggered = floating.isTriggered();
+        fixedWasTriggered = fixed.isTriggered();
+    }
+
+    TEST_ASSERT_TRUE(floatingEvent.confirmed);
+    TEST_ASSERT_TRUE(fixedEvent.confirmed);
+    TEST_ASSERT_UINT64_WITHIN(200000, static_cast<uint64_t>(TEST_EVENT_START_SEC * 1e6f), floatingEvent.startTime);
+    TEST_ASSERT_UINT64_WITHIN(1000000 / TEST_RATE, floatingEvent.startTime, fixedEvent.startTime);
+    TEST_ASSERT_UINT32_WITHIN(100, floatingEvent.duration, fixedEvent.duration);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f * floatingEvent.pga, floatingEvent.pga, fixedEvent.pga);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f * floatingEvent.cav, floatingEvent.cav, fixedEvent.cav);
+    TEST_ASSERT_EQUAL(floatingEvent.alertLevel, fixedEvent.alertLevel);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_isqrt64_is_floor_square_root);
+    RUN_TEST(test_conversions_round_and_saturate);
+    RUN_TEST(test_fixed_design_matches_float_coefficients);
+    RUN_TEST(test_fixed_filter_bank_tracks_float_bank);
+    RUN_TEST(test_fixed_detector_matches_float_detector);
+    return UNITY_END();
+}
@@ -0,0 +1,102 @@
+#include <unity.h>
+#include "json_pool.h"
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_allocations_are_aligned_and_bounded(void) {
+    StaticJsonPool<64> pool;
+
+    void* first = pool.allocate(3);
+    void* second = pool.allocate(5);
+    TEST_ASSERT_NOT_NULL(first);
+    TEST_ASSERT_NOT_NULL(second);
+    TEST_ASSERT_EQUAL_UINT32(0, reinterpret_cast<uintptr_t>(first) % 8);
+    TEST_ASSERT_EQUAL_UINT32(0, reinterpret_cast<uintptr_t>(second) % 8);
+    TEST_ASSERT_EQUAL_size_t(32, pool.getUsed());
+
+    TEST_ASSERT_NULL(pool.allocate(32));
+    TEST_ASSERT_NOT_NULL(pool.allocate(24));
+    TEST_ASSERT_NULL(pool.allocate(1));
+    TEST_ASSERT_NULL(pool.allocate(SIZE_MAX));
+}
+
+void test_pool_resets_when_every_block_is_freed(void) {
+    StaticJsonPool<64> pool;
+
+    void* first = pool.allocate(8);
+    void* second = pool.allocate(8);
+    pool.deallocate(first);
+    TEST_ASSERT_EQUAL_size_t(32, pool.getUsed());
+
+    pool.deallocate(second);
+    TEST_ASSERT_EQUAL_size_t(0, pool.getUsed());
+    TEST_ASSERT_EQUAL_PTR(first, pool.allocate(8));
+}
+
+void test_last_block_is_resized_in_place(void) {
+    StaticJsonPool<64> pool;
+
+    uint8_t* block = static_cast<uint8_t*>(pool.allocate(8));
+    memset(block, 0xAB, 8);
+    TEST_ASSERT_EQUAL_PTR(block, pool.reallocate(block, 40));
+    TEST_ASSERT_EQUAL_size_t(48, pool.getUsed());
+    TEST_ASSERT_EQUAL_UINT8(0xAB, block[7]);
+
+    TEST_ASSERT_EQUAL_PTR(block, pool.reallocate(block, 4));
+    TEST_ASSERT_EQUAL_size_t(16, pool.getUsed());
+    TEST_ASSERT_NULL(pool.reallocate(block, 64));
+}
+
+void test_inner_block_is_moved_when_it_grows(void) {
+    StaticJsonPool<96> pool;
+
+    uint8_t* inner = static_cast<uint8_t*>(pool.allocate(8));
+    memcpy(inner, "abcdefg", 8);
+    pool.allocate(8);
+
+    uint8_t* moved = static_cast<uint8_t*>(pool.reallocate(inner, 16));
+    TEST_ASSERT_NOT_NULL(moved);
+    TEST_ASSERT_TRUE(moved != inner);
+    TEST_ASSERT_EQUAL_STRING("abcdefg", reinterpret_cast<const char*>(moved));
+    TEST_ASSERT_NULL(pool.reallocate(moved, 64));
+}
+
+void test_document_serializes_from_pool(void) {
+    StaticJsonPool<8192> pool;
+    {
+        JsonDocument doc(&pool);
+        doc["device_id"] = "ESP32_A";
+        doc["events"].to<JsonArray>().add<JsonObject>()["pga"] = 2;
+
+        char payload[64];
+        serializeJson(doc, payload, sizeof(payload));
+        TEST_ASSERT_FALSE(doc.overflowed());
+        TEST_ASSERT_EQUAL_STRING("{\"device_id\":\"ESP32_A\",\"events\":[{\"pga\":2}]}", payload);
+        TEST_ASSERT_TRUE(pool.getUsed() > 0);
+    }
+    TEST_ASSERT_EQUAL_size_t(0, pool.getUsed());
+}
+
+void test_document_reports_overflow_when_pool_is_full(void) {
+    StaticJsonPool<256> pool;
+    JsonDocument doc(&pool);
+
+    for (int i = 0; i < 64; i++) {
+        doc.add(i);
+    }
+
+    TEST_ASSERT_TRUE(doc.overflowed());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_allocations_are_aligned_and_bounded);
+    RUN_TEST(test_pool_resets_when_every_block_is_freed);
+    RUN_TEST(test_last_block_is_resized_in_place);
+    RUN_TEST(test_inner_block_is_moved_when_it_grows);
+    RUN_TEST(test_document_serializes_from_pool);
+    RUN_TEST(test_document_reports_overflow_when_pool_is_full);
+    return UNITY_END();
+}
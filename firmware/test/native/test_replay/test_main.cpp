@@ -0,0 +1,86 @@
+#include <unity.h>
+#include "waveform_replay.h"
+
+#define TEST_EVENT_FIXTURE "../data/synthetic_event.npy"
+#define TEST_QUIET_FIXTURE "../data/iris_sample.npy"
+#define TEST_EXPECTED_ONSET_MICROS 40470000ULL
+#define TEST_EXPECTED_PGA 0.1600f
+#define TEST_EXPECTED_CAV 0.4460f
+
+static ReplayStats replayFixture(bool fixedPoint) {
+    Waveform fixture;
+    TEST_ASSERT_TRUE(loadNpy(TEST_EVENT_FIXTURE, fixture));
+
+    ReplayOptions options;
+    options.path = TEST_EVENT_FIXTURE;
+    options.sampleRate = 100;
+    options.fixedPoint = fixedPoint;
+    options.quiet = true;
+    return replayWaveform(fixture, options);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_fixture_loads(void) {
+    Waveform fixture;
+    TEST_ASSERT_TRUE(loadNpy(TEST_EVENT_FIXTURE, fixture));
+    TEST_ASSERT_EQUAL_size_t(3, fixture.channels);
+    TEST_ASSERT_EQUAL_size_t(6000, fixture.frames());
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 9.80665f, static_cast<float>(fixture.values[2]));
+}
+
+void test_float_pipeline_confirms_fixture_event(void) {
+    ReplayStats stats = replayFixture(false);
+
+    TEST_ASSERT_EQUAL_size_t(1, stats.triggers);
+    TEST_ASSERT_EQUAL_size_t(1, stats.confirmedEvents);
+    TEST_ASSERT_UINT64_WITHIN(50000, TEST_EXPECTED_ONSET_MICROS, stats.firstOnset);
+    TEST_ASSERT_FLOAT_WITHIN(0.003f, TEST_EXPECTED_PGA, stats.peakPga);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, TEST_EXPECTED_CAV, stats.peakCav);
+    TEST_ASSERT_TRUE(stats.preliminaryAlerts > 0);
+}
+
+void test_fixed_pipeline_confirms_fixture_event(void) {
+    ReplayStats stats = replayFixture(true);
+
+    TEST_ASSERT_EQUAL_size_t(1, stats.triggers);
+    TEST_ASSERT_EQUAL_size_t(1, stats.confirmedEvents);
+    TEST_ASSERT_UINT64_WITHIN(50000, TEST_EXPECTED_ONSET_MICROS, stats.firstOnset);
+    TEST_ASSERT_FLOAT_WITHIN(0.003f, TEST_EXPECTED_PGA, stats.peakPga);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, TEST_EXPECTED_CAV, stats.peakCav);
+}
+
+void test_pipelines_agree_on_fixture(void) {
+    ReplayStats floating = replayFixture(false);
+    ReplayStats fixed = replayFixture(true);
+
+    TEST_ASSERT_EQUAL_UINT64(floating.firstOnset, fixed.firstOnset);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f * floating.peakPga, floating.peakPga, fixed.peakPga);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f * floating.peakCav, floating.peakCav, fixed.peakCav);
+}
+
+void test_short_recording_never_triggers(void) {
+    Waveform quiet;
+    TEST_ASSERT_TRUE(loadNpy(TEST_QUIET_FIXTURE, quiet));
+
+    ReplayOptions options;
+    options.path = TEST_QUIET_FIXTURE;
+    options.sampleRate = 100;
+    options.quiet = true;
+    ReplayStats stats = replayWaveform(quiet, options);
+
+    TEST_ASSERT_EQUAL_size_t(0, stats.triggers);
+    TEST_ASSERT_EQUAL_size_t(0, stats.confirmedEvents);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_fixture_loads);
+    RUN_TEST(test_float_pipeline_confirms_fixture_event);
+    RUN_TEST(test_fixed_pipeline_confirms_fixture_event);
+    RUN_TEST(test_pipelines_agree_on_fixture);
+    RUN_TEST(test_short_recording_never_triggers);
+    return UNITY_END();
+}
@@ -0,0 +1,82 @@
+#include <unity.h>
+#include "ring_buffer.h"
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_starts_empty(void) {
+    RingBuffer<int, 4> buffer;
+    TEST_ASSERT_TRUE(buffer.empty());
+    TEST_ASSERT_FALSE(buffer.full());
+    TEST_ASSERT_EQUAL_size_t(0, buffer.size());
+    TEST_ASSERT_EQUAL_size_t(4, buffer.capacity());
+}
+
+void test_indexes_oldest_first_before_wrapping(void) {
+    RingBuffer<int, 4> buffer;
+    buffer.push(10);
+    buffer.push(11);
+    buffer.push(12);
+
+    TEST_ASSERT_EQUAL_size_t(3, buffer.size());
+    TEST_ASSERT_FALSE(buffer.full());
+    TEST_ASSERT_EQUAL_INT(10, buffer[0]);
+    TEST_ASSERT_EQUAL_INT(12, buffer[2]);
+    TEST_ASSERT_EQUAL_INT(12, buffer.newest());
+    TEST_ASSERT_EQUAL_INT(11, buffer.newest(1));
+}
+
+void test_overwrites_oldest_once_full(void) {
+    RingBuffer<int, 4> buffer;
+    for (int i = 0; i < 10; i++) {
+        buffer.push(i);
+    }
+
+    TEST_ASSERT_TRUE(buffer.full());
+    TEST_ASSERT_EQUAL_size_t(4, buffer.size());
+    for (size_t i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL_INT(6 + static_cast<int>(i), buffer[i]);
+    }
+    TEST_ASSERT_EQUAL_INT(9, buffer.newest());
+    TEST_ASSERT_EQUAL_INT(6, buffer.newest(3));
+}
+
+void test_matches_window_of_last_pushes_at_every_step(void) {
+    RingBuffer<int, 5> buffer;
+    for (int pushed = 1; pushed <= 23; pushed++) {
+        buffer.push(pushed * 7);
+        size_t expected = pushed < 5 ? pushed : 5;
+        TEST_ASSERT_EQUAL_size_t(expected, buffer.size());
+        for (size_t i = 0; i < expected; i++) {
+            int value = (pushed - static_cast<int>(expected) + 1 + static_cast<int>(i)) * 7;
+            TEST_ASSERT_EQUAL_INT(value, buffer[i]);
+            TEST_ASSERT_EQUAL_INT(value, buffer.newest(expected - 1 - i));
+        }
+    }
+}
+
+void test_clear_resets_position(void) {
+    RingBuffer<int, 3> buffer;
+    buffer.push(1);
+    buffer.push(2);
+    buffer.push(3);
+    buffer.push(4);
+    buffer.clear();
+
+    TEST_ASSERT_TRUE(buffer.empty());
+    buffer.push(5);
+    TEST_ASSERT_EQUAL_size_t(1, buffer.size());
+    TEST_ASSERT_EQUAL_INT(5, buffer[0]);
+    TEST_ASSERT_EQUAL_INT(5, buffer.newest());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_starts_empty);
+    RUN_TEST(test_indexes_oldest_first_before_wrapping);
+    RUN_TEST(test_overwrites_oldest_once_full);
+    RUN_TEST(test_matches_window_of_last_pushes_at_every_step);
+    RUN_TEST(test_clear_resets_position);
+    return UNITY_END();
+}
@@ -0,0 +1,116 @@
+#include <unity.h>
+#include "earthquake_detector.h"
+
+#define TEST_WINDOW 16
+
+static float valueAt(int index) {
+    return std::abs(std::sin(index * 0.73f) * 3.0f + std::cos(index * 0.11f)) + ((index % 29 == 0) ? 5.0f : 0.0f);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_empty_window_reports_zero(void) {
+    SlidingWindowMax<TEST_WINDOW> peak;
+    TEST_ASSERT_TRUE(peak.empty());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, peak.max());
+}
+
+void test_matches_brute_force_maximum(void) {
+    SlidingWindowMax<64> peak;
+    peak.setWindow(TEST_WINDOW);
+    float history[1000];
+
+    for (int i = 0; i < 1000; i++) {
+        history[i] = valueAt(i);
+        peak.push(history[i]);
+
+        float expected = 0.0f;
+        for (int j = std::max(0, i - TEST_WINDOW + 1); j <= i; j++) {
+            expected = std::max(expected, history[j]);
+        }
+        TEST_ASSERT_EQUAL_FLOAT(expected, peak.max());
+    }
+}
+
+void test_peak_expires_after_window(void) {
+    SlidingWindowMax<TEST_WINDOW> peak;
+    peak.setWindow(4);
+    peak.push(9.0f);
+    peak.push(1.0f);
+    peak.push(2.0f);
+    peak.push(1.0f);
+    TEST_ASSERT_EQUAL_FLOAT(9.0f, peak.max());
+
+    peak.push(0.5f);
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, peak.max());
+}
+
+void test_monotonic_decreasing_input_fills_capacity(void) {
+    SlidingWindowMax<TEST_WINDOW> peak;
+    for (int i = 0; i < 5 * TEST_WINDOW; i++) {
+        peak.push(static_cast<float>(1000 - i));
+        int oldest = std::max(0, i - TEST_WINDOW + 1);
+        TEST_ASSERT_EQUAL_FLOAT(static_cast<float>(1000 - oldest), peak.max());
+    }
+}
+
+void test_window_is_clamped_to_capacity(void) {
+    SlidingWindowMax<TEST_WINDOW> peak;
+    peak.setWindow(10 * TEST_WINDOW);
+    peak.push(7.0f);
+    for (int i = 0; i < TEST_WINDOW - 1; i++) {
+        peak.push(1.0f);
+    }
+    TEST_ASSERT_EQUAL_FLOAT(7.0f, peak.max());
+    peak.push(1.0f);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, peak.max());
+
+    peak.setWindow(0);
+    peak.push(3.0f);
+    peak.push(2.0f);
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, peak.max());
+}
+
+void test_pga_tracker_reports_peaks_in_g(void) {
+    PgaTracker tracker(4);
+    AccelSample sample = {0.0f, 0.0f, 0.0f, 0};
+
+    sample.x = -4.905f;
+    tracker.update(sample, 9.81f);
+    sample.x = 0.0f;
+    sample.y = 1.962f;
+    tracker.update(sample, 1.962f);
+
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f, tracker.getPGA());
+    AxisPeaks peaks = tracker.getAxisPeaks();
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.5f, peaks.x);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.2f, peaks.y);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, peaks.z);
+
+    sample.y = 0.0f;
+    for (int i = 0; i < 3; i++) {
+        tracker.update(sample, 0.981f);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.2f, tracker.getPGA());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, tracker.getAxisPeaks().x);
+
+    tracker.update(sample, 0.981f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.1f, tracker.getPGA());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, tracker.getAxisPeaks().y);
+
+    tracker.reset();
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, tracker.getPGA());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_window_reports_zero);
+    RUN_TEST(test_matches_brute_force_maximum);
+    RUN_TEST(test_peak_expires_after_window);
+    RUN_TEST(test_monotonic_decreasing_input_fills_capacity);
+    RUN_TEST(test_window_is_clamped_to_capacity);
+    RUN_TEST(test_pga_tracker_reports_peaks_in_g);
+    return UNITY_END();
+}
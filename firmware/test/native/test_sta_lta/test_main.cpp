@@ -0,0 +1,186 @@
+#include <unity.h>
+#include "earthquake_detector.h"
+
+#define TEST_STA 10
+#define TEST_LTA 50
+
+static EnergyBuffer energies;
+static BasicEnergyBuffer<uint32_t> counts;
+
+static float energyAt(int index) {
+    return 1.0f + 0.5f * std::sin(index * 0.37f) + ((index % 7 == 0) ? 3.0f : 0.0f);
+}
+
+static uint32_t countAt(int index) {
+    return 1000u + static_cast<uint32_t>((index * 7919) % 4001);
+}
+
+static float bruteSta(const EnergyBuffer& buffer) {
+    double sum = 0.0;
+    for (int age = 0; age < TEST_STA; age++) {
+        sum += buffer.newest(age);
+    }
+    return static_cast<float>(sum / TEST_STA);
+}
+
+static float bruteLta(const EnergyBuffer& buffer) {
+    double sum = 0.0;
+    for (int age = TEST_STA; age < TEST_LTA; age++) {
+        sum += buffer.newest(age);
+    }
+    return static_cast<float>(sum / (TEST_LTA - TEST_STA));
+}
+
+void setUp(void) {
+    energies.clear();
+    counts.clear();
+}
+
+void tearDown(void) {}
+
+void test_not_ready_until_lta_window_fills(void) {
+    StaLtaEngine engine(TEST_STA, TEST_LTA, STA_LTA_SLIDING);
+    for (int i = 0; i < TEST_LTA - 1; i++) {
+        energies.push(energyAt(i));
+        engine.update(energies);
+        TEST_ASSERT_FALSE(engine.isReady());
+        TEST_ASSERT_EQUAL_FLOAT(0.0f, engine.getLTA());
+        TEST_ASSERT_EQUAL_FLOAT(0.0f, engine.getRatio());
+    }
+
+    energies.push(energyAt(TEST_LTA - 1));
+    engine.update(energies);
+    TEST_ASSERT_TRUE(engine.isReady());
+}
+
+void test_sliding_sums_match_brute_force_windows(void) {
+    StaLtaEngine engine(TEST_STA, TEST_LTA, STA_LTA_SLIDING);
+    for (int i = 0; i < 20 * TEST_LTA; i++) {
+        energies.push(energyAt(i));
+        engine.update(energies);
+
+        if (i + 1 >= TEST_STA) {
+            TEST_ASSERT_FLOAT_WITHIN(1e-4f, bruteSta(energies), engine.getSTA());
+        }
+        if (engine.isReady()) {
+            float lta = bruteLta(energies);
+            TEST_ASSERT_FLOAT_WITHIN(1e-4f, lta, engine.getLTA());
+            TEST_ASSERT_FLOAT_WITHIN(1e-3f, bruteSta(energies) / lta, engine.getRatio());
+        }
+    }
+}
+
+void test_sliding_ratio_rises_on_energy_step(void) {
+    StaLtaEngine engine(TEST_STA, TEST_LTA, STA_LTA_SLIDING);
+    for (int i = 0; i < 2 * TEST_LTA; i++) {
+        energies.push(1.0f);
+        engine.update(energies);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.0f, engine.getRatio());
+
+    for (int i = 0; i < TEST_STA; i++) {
+        energies.push(25.0f);
+        engine.update(energies);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 25.0f, engine.getRatio());
+    TEST_ASSERT_TRUE(engine.ratioExceeds(staLtaThresholdQ8(24.0f)));
+    TEST_ASSERT_FALSE(engine.ratioExceeds(staLtaThresholdQ8(26.0f)));
+}
+
+void test_recursive_averages_match_exponential_reference(void) {
+    StaLtaEngine engine(TEST_STA, TEST_LTA, STA_LTA_RECURSIVE);
+    double sta = 0.0;
+    double lta = 0.0;
+    for (int i = 0; i < 10 * TEST_LTA; i++) {
+        float energy = energyAt(i);
+        energies.push(energy);
+        engine.update(energies);
+
+        if (i == 0) {
+            sta = energy;
+            lta = energy;
+        } else {
+            sta += (energy - sta) / TEST_STA;
+            lta += (energy - lta) / TEST_LTA;
+        }
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, static_cast<float>(sta), engine.getSTA());
+        if (engine.isReady()) {
+            TEST_ASSERT_FLOAT_WITHIN(1e-4f, static_cast<float>(lta), engine.getLTA());
+        }
+    }
+}
+
+void test_fixed_engine_sums_are_exact(void) {
+    FixedStaLtaEngine engine(TEST_STA, TEST_LTA, STA_LTA_SLIDING);
+    for (int i = 0; i < 20 * TEST_LTA; i++) {
+        counts.push(countAt(i));
+        engine.update(counts);
+        if (!engine.isReady()) {
+            continue;
+        }
+
+        int64_t staSum = 0;
+        int64_t ltaSum = 0;
+        for (int age = 0; age < TEST_STA; age++) {
+            staSum += counts.newest(age);
+        }
+        for (int age = TEST_STA; age < TEST_LTA; age++) {
+            ltaSum += counts.newest(age);
+        }
+
+        TEST_ASSERT_EQUAL_FLOAT(static_cast<float>(staSum) / TEST_STA, engine.getSTA());
+        TEST_ASSERT_EQUAL_FLOAT(static_cast<float>(ltaSum) / (TEST_LTA - TEST_STA), engine.getLTA());
+
+        uint32_t thresholdQ8 = staLtaThresholdQ8(1.0f);
+        bool exceeds = (staSum * (TEST_LTA - TEST_STA)) << STA_LTA_RATIO_FRACTION_BITS >
+                       ltaSum * TEST_STA * thresholdQ8;
+        TEST_ASSERT_EQUAL(exceeds, engine.ratioExceeds(thresholdQ8));
+    }
+}
+
+void test_fixed_and_float_engines_agree_on_trigger(void) {
+    StaLtaEngine floating(TEST_STA, TEST_LTA, STA_LTA_SLIDING);
+    FixedStaLtaEngine fixed(TEST_STA, TEST_LTA, STA_LTA_SLIDING);
+    uint32_t thresholdQ8 = staLtaThresholdQ8(3.0f);
+    bool fired = false;
+
+    for (int i = 0; i < 4 * TEST_LTA; i++) {
+        uint32_t count = (i >= 3 * TEST_LTA && i < 3 * TEST_LTA + TEST_STA) ? 40000u : 10000u;
+        counts.push(count);
+        energies.push(static_cast<float>(count));
+        fixed.update(counts);
+        floating.update(energies);
+
+        TEST_ASSERT_FLOAT_WITHIN(1e-3f, floating.getRatio(), fixed.getRatio());
+        TEST_ASSERT_EQUAL(floating.ratioExceeds(thresholdQ8), fixed.ratioExceeds(thresholdQ8));
+        fired = fired || fixed.ratioExceeds(thresholdQ8);
+    }
+    TEST_ASSERT_TRUE(fired);
+    TEST_ASSERT_FALSE(fixed.ratioExceeds(thresholdQ8));
+}
+
+void test_reset_discards_history(void) {
+    StaLtaEngine engine(TEST_STA, TEST_LTA, STA_LTA_SLIDING);
+    for (int i = 0; i < 2 * TEST_LTA; i++) {
+        energies.push(energyAt(i));
+        engine.update(energies);
+    }
+    engine.reset();
+    energies.clear();
+
+    TEST_ASSERT_FALSE(engine.isReady());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, engine.getSTA());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, engine.getLTA());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_not_ready_until_lta_window_fills);
+    RUN_TEST(test_sliding_sums_match_brute_force_windows);
+    RUN_TEST(test_sliding_ratio_rises_on_energy_step);
+    RUN_TEST(test_recursive_averages_match_exponential_reference);
+    RUN_TEST(test_fixed_engine_sums_are_exact);
+    RUN_TEST(test_fixed_and_float_engines_agree_on_trigger);
+    RUN_TEST(test_reset_discards_history);
+    return UNITY_END();
+}
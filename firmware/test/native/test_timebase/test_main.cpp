@@ -0,0 +1,109 @@
+#include <unity.h>
+#include "timebase.h"
+
+#define TEST_UTC 1700000000000000ULL
+
+static uint64_t fakeNow = 0;
+
+static uint64_t fakeClock() {
+    return fakeNow;
+}
+
+static void synchronize(Timebase& timebase, uint64_t localMicros, uint64_t utcMicros) {
+    timebase.recordSntp(localMicros, utcMicros);
+    timebase.update();
+}
+
+void setUp(void) {
+    fakeNow = 0;
+    halSetClockSource(fakeClock);
+}
+
+void tearDown(void) {
+    halSetClockSource(nullptr);
+}
+
+void test_unsynchronized_until_first_sample(void) {
+    Timebase timebase;
+    timebase.update();
+
+    TEST_ASSERT_FALSE(timebase.isSynchronized());
+    TEST_ASSERT_EQUAL_UINT8(TIME_SOURCE_NONE, timebase.getSource());
+    TEST_ASSERT_EQUAL_UINT32(0, timebase.getSyncCount());
+    TEST_ASSERT_FALSE(isUtcMicros(timebase.toUtcMicros(5000000)));
+}
+
+void test_first_sntp_sample_sets_offset(void) {
+    Timebase timebase;
+    synchronize(timebase, 1000000, TEST_UTC);
+
+    TEST_ASSERT_EQUAL_UINT8(TIME_SOURCE_SNTP, timebase.getSource());
+    TEST_ASSERT_EQUAL_UINT64(TEST_UTC, timebase.toUtcMicros(1000000));
+    TEST_ASSERT_EQUAL_UINT64(TEST_UTC + 2000000, timebase.toUtcMicros(3000000));
+    TEST_ASSERT_EQUAL_INT32(0, timebase.getLastErrorMicros());
+    TEST_ASSERT_EQUAL_UINT32(1, timebase.getSyncCount());
+}
+
+void test_update_without_new_sample_keeps_mapping(void) {
+    Timebase timebase;
+    synchronize(timebase, 1000000, TEST_UTC);
+    timebase.update();
+    timebase.update();
+
+    TEST_ASSERT_EQUAL_UINT32(1, timebase.getSyncCount());
+}
+
+void test_small_error_is_slewed(void) {
+    Timebase timebase;
+    synchronize(timebase, 1000000, TEST_UTC);
+    synchronize(timebase, 11000000, TEST_UTC + 10000100);
+
+    TEST_ASSERT_EQUAL_INT32(100, timebase.getLastErrorMicros());
+    TEST_ASSERT_EQUAL_UINT64(TEST_UTC + 10000000 + static_cast<uint64_t>(TIMEBASE_PHASE_GAIN * 100),
+                             timebase.toUtcMicros(11000000));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, TIMEBASE_DRIFT_GAIN * 100.0f / 10.0f, timebase.getDriftPpm());
+}
+
+void test_drift_estimate_is_clamped(void) {
+    Timebase fast;
+    synchronize(fast, 1000000, TEST_UTC);
+    synchronize(fast, 2000000, TEST_UTC + 1001000);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, TIMEBASE_MAX_DRIFT_PPM, fast.getDriftPpm());
+
+    Timebase slow;
+    synchronize(slow, 1000000, TEST_UTC);
+    synchronize(slow, 2000000, TEST_UTC + 999000);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, -TIMEBASE_MAX_DRIFT_PPM, slow.getDriftPpm());
+}
+
+void test_large_error_steps_the_clock(void) {
+    Timebase timebase;
+    synchronize(timebase, 1000000, TEST_UTC);
+
+    uint64_t stepped = TEST_UTC + 1000000 + TIMEBASE_STEP_THRESHOLD_US + 100000;
+    synchronize(timebase, 2000000, stepped);
+
+    TEST_ASSERT_EQUAL_INT32(TIMEBASE_STEP_THRESHOLD_US + 100000, timebase.getLastErrorMicros());
+    TEST_ASSERT_EQUAL_UINT64(stepped, timebase.toUtcMicros(2000000));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, timebase.getDriftPpm());
+}
+
+void test_now_follows_the_local_clock(void) {
+    Timebase timebase;
+    synchronize(timebase, 1000000, TEST_UTC);
+
+    fakeNow = 4500000;
+    TEST_ASSERT_EQUAL_UINT64(TEST_UTC + 3500000, timebase.nowMicros());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_unsynchronized_until_first_sample);
+    RUN_TEST(test_first_sntp_sample_sets_offset);
+    RUN_TEST(test_update_without_new_sample_keeps_mapping);
+    RUN_TEST(test_small_error_is_slewed);
+    RUN_TEST(test_drift_estimate_is_clamped);
+    RUN_TEST(test_large_error_steps_the_clock);
+    RUN_TEST(test_now_follows_the_local_clock);
+    return UNITY_END();
+}
@@ -0,0 +1,211 @@
+#include <unity.h>
+#include "warm_start.h"
+
+#define TEST_UTC 1700000000000000ULL
+#define TEST_MAX_AGE_MICROS (WARM_START_MAX_AGE_MS * 1000ULL)
+
+static DetectorWarmState sampleState(float background) {
+    DetectorWarmState state = DetectorWarmState();
+    state.sampleRate = SAMPLE_RATE_HZ;
+    state.channelCount = 1;
+    state.staWindowSamples[0] = 100;
+    state.ltaWindowSamples[0] = 3000;
+    state.background[0] = background;
+    return state;
+}
+
+static void writeFlash(uint32_t sequence, float background, uint64_t utcMicros) {
+    WarmStartRecord record;
+    WarmStartStore::encode(sequence, sampleState(background), utcMicros, record);
+
+    Preferences preferences;
+    preferences.begin(WARM_START_NAMESPACE, false);
+    preferences.putBytes(WARM_START_KEY, &record, sizeof(record));
+    preferences.end();
+}
+
+static WarmStartRecord readFlash() {
+    WarmStartRecord record = WarmStartRecord();
+    Preferences preferences;
+    preferences.begin(WARM_START_NAMESPACE, true);
+    preferences.getBytes(WARM_START_KEY, &record, sizeof(record));
+    preferences.end();
+    return record;
+}
+
+void setUp(void) {
+    halPreferencesReset();
+    WarmStartStore store;
+    store.clear();
+}
+
+void tearDown(void) {}
+
+void test_encoded_record_is_valid(void) {
+    WarmStartRecord record;
+    WarmStartStore::encode(7, sampleState(0.002f), TEST_UTC, record);
+
+    TEST_ASSERT_TRUE(WarmStartStore::isValid(record));
+    TEST_ASSERT_EQUAL_UINT32(7, record.sequence);
+    TEST_ASSERT_EQUAL_UINT64(TEST_UTC, record.savedAtMicros);
+}
+
+void test_any_flipped_byte_fails_validation(void) {
+    WarmStartRecord record;
+    WarmStartStore::encode(7, sampleState(0.002f), TEST_UTC, record);
+
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(&record);
+    for (size_t i = 0; i < sizeof(record); i++) {
+        bytes[i] ^= 0x01;
+        TEST_ASSERT_FALSE(WarmStartStore::isValid(record));
+        bytes[i] ^= 0x01;
+    }
+    TEST_ASSERT_TRUE(WarmStartStore::isValid(record));
+}
+
+void test_unsynchronized_save_time_is_not_recorded(void) {
+    WarmStartRecord record;
+    WarmStartStore::encode(1, sampleState(0.002f), 123456, record);
+
+    TEST_ASSERT_EQUAL_UINT64(0, record.savedAtMicros);
+    TEST_ASSERT_TRUE(WarmStartStore::isValid(record));
+}
+
+void test_freshness_window(void) {
+    WarmStartRecord record;
+    WarmStartStore::encode(1, sampleState(0.002f), TEST_UTC, record);
+
+    TEST_ASSERT_TRUE(WarmStartStore::isFresh(record, TEST_UTC, true));
+    TEST_ASSERT_TRUE(WarmStartStore::isFresh(record, TEST_UTC + TEST_MAX_AGE_MICROS, true));
+    TEST_ASSERT_FALSE(WarmStartStore::isFresh(record, TEST_UTC + TEST_MAX_AGE_MICROS + 1, true));
+    TEST_ASSERT_FALSE(WarmStartStore::isFresh(record, TEST_UTC - 1, false));
+}
+
+void test_unknown_age_is_only_trusted_from_rtc(void) {
+    WarmStartRecord record;
+    WarmStartStore::encode(1, sampleState(0.002f), 0, record);
+
+    TEST_ASSERT_TRUE(WarmStartStore::isFresh(record, TEST_UTC, false));
+    TEST_ASSERT_FALSE(WarmStartStore::isFresh(record, TEST_UTC, true));
+
+    WarmStartStore::encode(1, sampleState(0.002f), TEST_UTC, record);
+    TEST_ASSERT_TRUE(WarmStartStore::isFresh(record, 0, false));
+    TEST_ASSERT_FALSE(WarmStartStore::isFresh(record, 0, true));
+}
+
+void test_rtc_snapshot_is_preferred_when_newer(void) {
+    WarmStartStore writer;
+    writer.begin();
+    writer.save(sampleState(0.004f), 0, TEST_UTC);
+    writeFlash(0, 0.001f, TEST_UTC);
+
+    WarmStartStore store;
+    store.begin();
+    DetectorWarmState state;
+    TEST_ASSERT_EQUAL(WARM_START_RTC, store.load(state, TEST_UTC + 1000000));
+    TEST_ASSERT_EQUAL_FLOAT(0.004f, state.background[0]);
+}
+
+void test_flash_snapshot_is_used_without_rtc(void) {
+    writeFlash(3, 0.001f, TEST_UTC);
+
+    WarmStartStore store;
+    store.begin();
+    DetectorWarmState state;
+    TEST_ASSERT_EQUAL(WARM_START_FLASH, store.load(state, TEST_UTC + 1000000));
+    TEST_ASSERT_EQUAL_FLOAT(0.001f, state.background[0]);
+}
+
+void test_stale_snapshots_start_cold(void) {
+    WarmStartStore writer;
+    writer.begin();
+    writer.save(sampleState(0.004f), 0, TEST_UTC);
+
+    WarmStartStore store;
+    store.begin();
+    DetectorWarmState state;
+    TEST_ASSERT_EQUAL(WARM_START_NONE, store.load(state, TEST_UTC + TEST_MAX_AGE_MICROS + 1));
+}
+
+void test_sequence_continues_past_rejected_records(void) {
+    writeFlash(50, 0.001f, TEST_UTC);
+
+    WarmStartStore store;
+    store.begin();
+    DetectorWarmState state;
+    TEST_ASSERT_EQUAL(WARM_START_NONE, store.load(state, TEST_UTC + TEST_MAX_AGE_MICROS + 1));
+
+    store.save(sampleState(0.003f), 0, TEST_UTC + TEST_MAX_AGE_MICROS + 1);
+    WarmStartRecord saved = readFlash();
+    TEST_ASSERT_TRUE(WarmStartStore::isValid(saved));
+    TEST_ASSERT_EQUAL_UINT32(51, saved.sequence);
+}
+
+void test_power_cycle_holds_flash_until_clock_is_set(void) {
+    writeFlash(4, 0.001f, TEST_UTC);
+
+    WarmStartStore store;
+    store.begin();
+    DetectorWarmState state;
+    TEST_ASSERT_EQUAL(WARM_START_NONE, store.load(state, 0));
+    TEST_ASSERT_TRUE(store.hasPending());
+
+    TEST_ASSERT_EQUAL(WARM_START_NONE, store.loadPending(state, 0));
+    TEST_ASSERT_TRUE(store.hasPending());
+
+    TEST_ASSERT_EQUAL(WARM_START_FLASH, store.loadPending(state, TEST_UTC + 60000000ULL));
+    TEST_ASSERT_EQUAL_FLOAT(0.001f, state.background[0]);
+    TEST_ASSERT_FALSE(store.hasPending());
+}
+
+void test_power_cycle_drops_held_snapshot_that_is_too_old(void) {
+    writeFlash(4, 0.001f, TEST_UTC);
+
+    WarmStartStore store;
+    store.begin();
+    DetectorWarmState state;
+    TEST_ASSERT_EQUAL(WARM_START_NONE, store.load(state, 0));
+
+    TEST_ASSERT_EQUAL(WARM_START_NONE, store.loadPending(state, TEST_UTC + TEST_MAX_AGE_MICROS + 1));
+    TEST_ASSERT_FALSE(store.hasPending());
+}
+
+void test_soft_reset_uses_rtc_without_holding_flash(void) {
+    WarmStartStore writer;
+    writer.begin();
+    writer.save(sampleState(0.004f), 0, TEST_UTC);
+
+    WarmStartStore store;
+    store.begin();
+    DetectorWarmState state;
+    TEST_ASSERT_EQUAL(WARM_START_RTC, store.load(state, 0));
+    TEST_ASSERT_FALSE(store.hasPending());
+}
+
+void test_flash_saved_without_clock_is_not_held(void) {
+    writeFlash(4, 0.001f, 0);
+
+    WarmStartStore store;
+    store.begin();
+    DetectorWarmState state;
+    TEST_ASSERT_EQUAL(WARM_START_NONE, store.load(state, 0));
+    TEST_ASSERT_FALSE(store.hasPending());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_encoded_record_is_valid);
+    RUN_TEST(test_any_flipped_byte_fails_validation);
+    RUN_TEST(test_unsynchronized_save_time_is_not_recorded);
+    RUN_TEST(test_freshness_window);
+    RUN_TEST(test_unknown_age_is_only_trusted_from_rtc);
+    RUN_TEST(test_rtc_snapshot_is_preferred_when_newer);
+    RUN_TEST(test_flash_snapshot_is_used_without_rtc);
+    RUN_TEST(test_stale_snapshots_start_cold);
+    RUN_TEST(test_sequence_continues_past_rejected_records);
+    RUN_TEST(test_power_cycle_holds_flash_until_clock_is_set);
+    RUN_TEST(test_power_cycle_drops_held_snapshot_that_is_too_old);
+    RUN_TEST(test_soft_reset_uses_rtc_without_holding_flash);
+    RUN_TEST(test_flash_saved_without_clock_is_not_held);
+    return UNITY_END();
+}
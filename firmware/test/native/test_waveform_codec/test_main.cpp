@@ -0,0 +1,135 @@
+#include <unity.h>
+#include "waveform_codec.h"
+
+#define TEST_SCALE 0.001f
+#define TEST_RATE 100
+#define TEST_BASE_TIMESTAMP 1700000000000000ULL
+
+static AccelSample sampleAt(size_t index, float x, float y, float z) {
+    AccelSample sample;
+    sample.x = x;
+    sample.y = y;
+    sample.z = z;
+    sample.timestamp = TEST_BASE_TIMESTAMP + index * (1000000ULL / TEST_RATE);
+    return sample;
+}
+
+static uint64_t readLe(const uint8_t* input, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; i++) {
+        value |= static_cast<uint64_t>(input[i]) << (8 * i);
+    }
+    return value;
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_quantize_rounds_and_clamps(void) {
+    TEST_ASSERT_EQUAL_INT16(1234, quantizeCounts(1.2344f, TEST_SCALE));
+    TEST_ASSERT_EQUAL_INT16(-1235, quantizeCounts(-1.2346f, TEST_SCALE));
+    TEST_ASSERT_EQUAL_INT16(32767, quantizeCounts(100.0f, TEST_SCALE));
+    TEST_ASSERT_EQUAL_INT16(-32768, quantizeCounts(-100.0f, TEST_SCALE));
+}
+
+void test_header_layout(void) {
+    WaveformBlockEncoder encoder(TEST_RATE, TEST_SCALE);
+    encoder.add(sampleAt(0, 0.0f, 0.0f, 0.0f));
+    encoder.add(sampleAt(1, 0.0f, 0.0f, 0.0f));
+
+    uint8_t payload[WAVEFORM_MAX_PAYLOAD_SIZE];
+    size_t length = encoder.encode(payload, sizeof(payload));
+    TEST_ASSERT_EQUAL_size_t(WAVEFORM_HEADER_SIZE + 6, length);
+
+    uint32_t scaleBits;
+    float scale = TEST_SCALE;
+    memcpy(&scaleBits, &scale, sizeof(scaleBits));
+
+    TEST_ASSERT_EQUAL_UINT8(WAVEFORM_FORMAT_VERSION, payload[0]);
+    TEST_ASSERT_EQUAL_UINT8(WAVEFORM_FLAG_DELTA_ZIGZAG, payload[1]);
+    TEST_ASSERT_EQUAL_UINT16(2, readLe(payload + 2, 2));
+    TEST_ASSERT_EQUAL_UINT16(TEST_RATE, readLe(payload + 4, 2));
+    TEST_ASSERT_EQUAL_UINT32(scaleBits, readLe(payload + 6, 4));
+    TEST_ASSERT_EQUAL_UINT64(TEST_BASE_TIMESTAMP, readLe(payload + 10, 8));
+}
+
+void test_axes_are_delta_zigzag_varints(void) {
+    WaveformBlockEncoder encoder(TEST_RATE, TEST_SCALE);
+    encoder.add(sampleAt(0, 0.0f, 0.300f, -32.768f));
+    encoder.add(sampleAt(1, 0.001f, 0.300f, 32.767f));
+    encoder.add(sampleAt(2, -0.001f, 0.0f, 32.767f));
+
+    uint8_t payload[WAVEFORM_MAX_PAYLOAD_SIZE];
+    size_t length = encoder.encode(payload, sizeof(payload));
+
+    const uint8_t expected[] = {
+        0x00, 0x02, 0x03,
+        0xD8, 0x04, 0x00, 0xD7, 0x04,
+        0xFF, 0xFF, 0x03, 0xFE, 0xFF, 0x07, 0x00
+    };
+    TEST_ASSERT_EQUAL_size_t(WAVEFORM_HEADER_SIZE + sizeof(expected), length);
+    TEST_ASSERT_EQUAL_MEMORY(expected, payload + WAVEFORM_HEADER_SIZE, sizeof(expected));
+}
+
+void test_full_block_fits_payload_bound(void) {
+    WaveformBlockEncoder encoder(TEST_RATE, TEST_SCALE);
+    for (size_t i = 0; i < WAVEFORM_BLOCK_SAMPLES; i++) {
+        float swing = (i % 2 == 0) ? -40.0f : 40.0f;
+        TEST_ASSERT_TRUE(encoder.add(sampleAt(i, swing, -swing, swing)));
+    }
+
+    TEST_ASSERT_TRUE(encoder.full());
+    TEST_ASSERT_FALSE(encoder.add(sampleAt(WAVEFORM_BLOCK_SAMPLES, 0.0f, 0.0f, 0.0f)));
+
+    uint8_t payload[WAVEFORM_MAX_PAYLOAD_SIZE];
+    size_t length = encoder.encode(payload, sizeof(payload));
+    TEST_ASSERT_GREATER_THAN(WAVEFORM_HEADER_SIZE, length);
+    TEST_ASSERT_LESS_OR_EQUAL(WAVEFORM_MAX_PAYLOAD_SIZE, length);
+}
+
+void test_encode_requires_worst_case_capacity(void) {
+    WaveformBlockEncoder encoder(TEST_RATE, TEST_SCALE);
+    encoder.add(sampleAt(0, 0.0f, 0.0f, 0.0f));
+
+    uint8_t payload[WAVEFORM_MAX_PAYLOAD_SIZE];
+    TEST_ASSERT_EQUAL_size_t(0, encoder.encode(payload, WAVEFORM_MAX_PAYLOAD_SIZE - 1));
+}
+
+void test_continuity_allows_one_missed_sample(void) {
+    WaveformBlockEncoder encoder(TEST_RATE, TEST_SCALE);
+    TEST_ASSERT_TRUE(encoder.isContinuous(sampleAt(5, 0.0f, 0.0f, 0.0f)));
+
+    encoder.add(sampleAt(0, 0.0f, 0.0f, 0.0f));
+    TEST_ASSERT_TRUE(encoder.isContinuous(sampleAt(1, 0.0f, 0.0f, 0.0f)));
+    TEST_ASSERT_TRUE(encoder.isContinuous(sampleAt(2, 0.0f, 0.0f, 0.0f)));
+    TEST_ASSERT_FALSE(encoder.isContinuous(sampleAt(3, 0.0f, 0.0f, 0.0f)));
+}
+
+void test_reset_starts_a_new_block(void) {
+    WaveformBlockEncoder encoder(TEST_RATE, TEST_SCALE);
+    encoder.add(sampleAt(0, 1.0f, 1.0f, 1.0f));
+    encoder.reset();
+
+    TEST_ASSERT_TRUE(encoder.empty());
+    TEST_ASSERT_EQUAL_size_t(0, encoder.getSampleCount());
+
+    encoder.add(sampleAt(7, 0.0f, 0.0f, 0.0f));
+    uint8_t payload[WAVEFORM_MAX_PAYLOAD_SIZE];
+    encoder.encode(payload, sizeof(payload));
+    TEST_ASSERT_EQUAL_UINT16(1, readLe(payload + 2, 2));
+    TEST_ASSERT_EQUAL_UINT64(sampleAt(7, 0.0f, 0.0f, 0.0f).timestamp, readLe(payload + 10, 8));
+    TEST_ASSERT_EQUAL_UINT8(0x00, payload[WAVEFORM_HEADER_SIZE]);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_quantize_rounds_and_clamps);
+    RUN_TEST(test_header_layout);
+    RUN_TEST(test_axes_are_delta_zigzag_varints);
+    RUN_TEST(test_full_block_fits_payload_bound);
+    RUN_TEST(test_encode_requires_worst_case_capacity);
+    RUN_TEST(test_continuity_allows_one_missed_sample);
+    RUN_TEST(test_reset_starts_a_new_block);
+    return UNITY_END();
+}
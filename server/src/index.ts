@@ -6,6 +6,14 @@ import { WebSocket, WebSocketServer } from 'ws';
 import { MQTTService } from './services/mqtt.service';
 import { AlertService } from './services/alert.service';
 import { DatabaseService } from './services/database.service';
+import { IngestService } from './services/ingest.service';
+import { ArchiveService } from './services/archive.service';
+import {
+  AssociationResult,
+  CoincidenceService,
+  triggerFromAlert,
+  triggerFromPreliminary
+} from './services/coincidence.service';
 import { createLogger } from './utils/logger';
 import { alertRoutes } from './routes/alert.routes';
 import { statusRoutes } from './routes/status.routes';
@@ -29,6 +37,11 @@ const mqttService = new MQTTService(
 
 const databaseService = new DatabaseService(logger);
 const alertService = new AlertService(databaseService, logger);
+const archiveService = process.env.ARCHIVE_DIR
+  ? new ArchiveService(process.env.ARCHIVE_DIR, logger)
+  : null;
+const ingestService = new IngestService(databaseService, logger, {}, archiveService);
+const coincidenceService = new CoincidenceService(logger);
 
 app.use('/api/alerts', alertRoutes(alertService));
 app.use('/api/status', statusRoutes(mqttService, databaseService));
@@ -37,7 +50,8 @@ app.get('/health', (req, res) => {
   res.json({
     status: 'healthy',
     timestamp: new Date().toISOString(),
-    mqtt: mqttService.isConnected() ? 'connected' : 'disconnected'
+    mqtt: mqttService.isConnected() ? 'connected' : 'disconnected',
+    ingest: ingestService.getStats()
   });
 });
 
@@ -86,12 +100,34 @@ function broadcastToClients(data: object): void {
   });
 }
 
+async function handleNetworkEvent(association: AssociationResult): Promise<void> {
+  if (!association.event) {
+    return;
+  }
+
+  await alertService.processNetworkEvent(association.event);
+
+  broadcastToClients({
+    type: 'network_event',
+    data: association.event,
+    created: association.created,
+    timestamp: new Date().toISOString()
+  });
+}
+
 mqttService.on('alert', async (alert) => {
   logger.info('Earthquake alert received', alert);
 
   await databaseService.saveAlert(alert);
 
-  await alertService.processAlert(alert);
+  const association = coincidenceService.associate(triggerFromAlert(alert, Date.now()));
+  if (association.event) {
+    await handleNetworkEvent(association);
+  } else if (coincidenceService.canCorroborate(alert.device_id)) {
+    logger.info('Single-station alert left to network confirmation', { device: alert.device_id });
+  } else {
+    await alertService.processAlert(alert);
+  }
 
   broadcastToClients({
     type: 'earthquake_alert',
@@ -100,17 +136,70 @@ mqttService.on('alert', async (alert) => {
   });
 });
 
-mqttService.on('data', (data) => {
+mqttService.on('preliminary', async (alert) => {
+  logger.info('Preliminary earthquake alert received', alert);
+
+  await handleNetworkEvent(coincidenceService.associate(triggerFromPreliminary(alert, Date.now())));
+
+  broadcastToClients({
+    type: 'preliminary_alert',
+    data: alert,
+    timestamp: new Date().toISOString()
+  });
+});
+
+mqttService.on('command_ack', (ack) => {
+  logger.info('Device command acknowledged', ack);
+
   broadcastToClients({
-    type: 'sensor_data',
-    data: data,
+    type: 'command_ack',
+    data: ack,
     timestamp: new Date().toISOString()
   });
 });
 
-mqttService.on('status', async (status) => {
+mqttService.on('data', (data) => {
+  ingestService.ingestData(data);
+});
+
+mqttService.on('waveform', (deviceId: string, payload: Buffer) => {
+  ingestService.ingestWaveform(deviceId, payload);
+});
+
+mqttService.on('capture', (deviceId: string, payload: Buffer) => {
+  ingestService.ingestCaptureChunk(deviceId, payload);
+});
+
+mqttService.on('status', (status) => {
   logger.debug('Device status update', status);
-  await databaseService.updateDeviceStatus(status);
+  coincidenceService.registerStation(status.device_id, status.location);
+  ingestService.ingestStatus(status);
+});
+
+ingestService.on('update', (updates) => {
+  broadcastToClients({
+    type: 'sensor_update',
+    data: updates,
+    timestamp: new Date().toISOString()
+  });
+});
+
+ingestService.on('capture', (capture) => {
+  logger.info('Event capture received', { deviceId: capture.device_id, captureId: capture.capture_id });
+
+  broadcastToClients({
+    type: 'capture_complete',
+    data: {
+      device_id: capture.device_id,
+      capture_id: capture.capture_id,
+      trigger_time: capture.trigger_time,
+      clock_synced: capture.clock_synced,
+      sample_rate: capture.sample_rate,
+      sample_count: capture.sample_count,
+      manual: capture.manual
+    },
+    timestamp: new Date().toISOString()
+  });
 });
 
 async function start(): Promise<void> {
@@ -118,12 +207,19 @@ async function start(): Promise<void> {
     await databaseService.connect();
     logger.info('Database connected');
 
+    ingestService.start();
+
     await mqttService.connect();
     logger.info('MQTT connected');
 
     mqttService.subscribe('earthquake/alert');
+    mqttService.subscribe('earthquake/alert/batch');
+    mqttService.subscribe('earthquake/alert/preliminary');
     mqttService.subscribe('earthquake/data');
     mqttService.subscribe('earthquake/status');
+    mqttService.subscribe('earthquake/command/ack');
+    mqttService.subscribe('earthquake/waveform/+');
+    mqttService.subscribe('earthquake/capture/+');
 
     const PORT = process.env.PORT || 3000;
     server.listen(PORT, () => {
@@ -138,10 +234,11 @@ async function start(): Promise<void> {
 process.on('SIGINT', async () => {
   logger.info('Shutting down...');
   await mqttService.disconnect();
+  await ingestService.stop();
   await databaseService.disconnect();
   process.exit(0);
 });
 
 start();
 
-export { app, mqttService, alertService, databaseService };
+export { app, mqttService, alertService, databaseService, ingestService, coincidenceService };
@@ -39,6 +39,23 @@ export function alertRoutes(alertService: AlertService): Router {
     }
   });
 
+  router.get('/network', async (req: Request, res: Response) => {
+    try {
+      const limit = parseInt(req.query.limit as string) || 50;
+      const events = await alertService.getNetworkEvents(limit);
+      res.json({
+        success: true,
+        count: events.length,
+        data: events
+      });
+    } catch (error) {
+      res.status(500).json({
+        success: false,
+        error: 'Failed to fetch network events'
+      });
+    }
+  });
+
   router.get('/stats', async (req: Request, res: Response) => {
     try {
       const stats = await alertService.getAlertStats();
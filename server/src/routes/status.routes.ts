@@ -2,6 +2,11 @@ import { Router, Request, Response } from 'express';
 import { MQTTService } from '../services/mqtt.service';
 import { DatabaseService } from '../services/database.service';
 
+interface CommandRequest {
+  command?: unknown;
+  args?: unknown;
+}
+
 export function statusRoutes(mqttService: MQTTService, databaseService: DatabaseService): Router {
   const router = Router();
 
@@ -48,6 +53,40 @@ export function statusRoutes(mqttService: MQTTService, databaseService: Database
     }
   });
 
+  router.get('/metrics', async (req: Request, res: Response) => {
+    try {
+      const stages = await databaseService.getStageLatencySummary();
+      res.json({
+        success: true,
+        count: stages.length,
+        data: stages
+      });
+    } catch (error) {
+      res.status(500).json({
+        success: false,
+        error: 'Failed to fetch metrics'
+      });
+    }
+  });
+
+  router.get('/devices/:deviceId/metrics', async (req: Request, res: Response) => {
+    try {
+      const { deviceId } = req.params;
+      const limit = parseInt(req.query.limit as string) || 60;
+      const metrics = await databaseService.getDeviceMetrics(deviceId, limit);
+      res.json({
+        success: true,
+        count: metrics.length,
+        data: metrics
+      });
+    } catch (error) {
+      res.status(500).json({
+        success: false,
+        error: 'Failed to fetch device metrics'
+      });
+    }
+  });
+
   router.get('/devices/:deviceId', async (req: Request, res: Response) => {
     try {
       const { deviceId } = req.params;
@@ -72,24 +111,53 @@ export function statusRoutes(mqttService: MQTTService, databaseService: Database
     }
   });
 
-  router.post('/devices/:deviceId/command', async (req: Request, res: Response) => {
-    try {
-      const { deviceId } = req.params;
-      const { command } = req.body;
+  const publishCommand = (target: string, body: CommandRequest, res: Response) => {
+    const { command, args } = body || {};
 
-      if (!command) {
-        return res.status(400).json({
-          success: false,
-          error: 'Command is required'
-        });
-      }
+    if (!command || typeof command !== 'string') {
+      return res.status(400).json({
+        success: false,
+        error: 'Command is required'
+      });
+    }
 
-      mqttService.publish(`earthquake/command/${deviceId}`, { command });
+    if (args !== undefined && (typeof args !== 'object' || args === null || Array.isArray(args))) {
+      return res.status(400).json({
+        success: false,
+        error: 'Command arguments must be an object'
+      });
+    }
 
-      res.json({
-        success: true,
-        message: `Command '${command}' sent to device ${deviceId}`
+    const parameters = (args ?? {}) as Record<string, unknown>;
+    if (Object.values(parameters).some(value => typeof value === 'object' && value !== null)) {
+      return res.status(400).json({
+        success: false,
+        error: 'Command argument values must be strings, numbers, booleans or null'
       });
+    }
+
+    mqttService.publish(`earthquake/command/${target}`, { ...parameters, command });
+
+    res.json({
+      success: true,
+      message: `Command '${command}' sent to ${target === 'all' ? 'all devices' : `device ${target}`}`
+    });
+  };
+
+  router.post('/devices/command', async (req: Request, res: Response) => {
+    try {
+      publishCommand('all', req.body, res);
+    } catch (error) {
+      res.status(500).json({
+        success: false,
+        error: 'Failed to send command'
+      });
+    }
+  });
+
+  router.post('/devices/:deviceId/command', async (req: Request, res: Response) => {
+    try {
+      publishCommand(req.params.deviceId, req.body, res);
     } catch (error) {
       res.status(500).json({
         success: false,
@@ -1,8 +1,12 @@
 import { Logger } from 'winston';
 import { DatabaseService } from './database.service';
 import { EarthquakeAlert } from './mqtt.service';
+import { NetworkEvent } from './coincidence.service';
 import https from 'https';
 
+const MAX_NOTIFIED_NETWORK_EVENTS = 1000;
+const HIGH_ALERT_LEVELS = ['STRONG', 'SEVERE', 'EXTREME'];
+
 interface NotificationConfig {
   pushover?: {
     token: string;
@@ -28,6 +32,7 @@ export class AlertService {
   private database: DatabaseService;
   private logger: Logger;
   private config: NotificationConfig;
+  private notifiedNetworkEvents: Set<string> = new Set();
 
   constructor(database: DatabaseService, logger: Logger) {
     this.database = database;
@@ -67,13 +72,52 @@ export class AlertService {
     await this.database.saveAlert(alert);
   }
 
+  async processNetworkEvent(event: NetworkEvent): Promise<boolean> {
+    await this.database.saveNetworkEvent(event);
+
+    if (this.notifiedNetworkEvents.has(event.event_id) ||
+        !(event.damaging || HIGH_ALERT_LEVELS.includes(event.alert_level))) {
+      return false;
+    }
+
+    this.notifiedNetworkEvents.add(event.event_id);
+    if (this.notifiedNetworkEvents.size > MAX_NOTIFIED_NETWORK_EVENTS) {
+      const [oldest] = this.notifiedNetworkEvents;
+      this.notifiedNetworkEvents.delete(oldest);
+    }
+
+    this.logger.info('Sending network event notifications', {
+      eventId: event.event_id,
+      stations: event.stations.length,
+      alertLevel: event.alert_level
+    });
+    await this.sendNotifications(this.networkEventAlert(event), this.formatNetworkMessage(event));
+    return true;
+  }
+
   private shouldSendNotification(alert: EarthquakeAlert): boolean {
-    const highAlertLevels = ['STRONG', 'SEVERE', 'EXTREME'];
-    return alert.event.confirmed && highAlertLevels.includes(alert.event.alert_level);
+    return alert.event.confirmed && HIGH_ALERT_LEVELS.includes(alert.event.alert_level);
   }
 
-  private async sendNotifications(alert: EarthquakeAlert): Promise<void> {
-    const message = this.formatAlertMessage(alert);
+  private networkEventAlert(event: NetworkEvent): EarthquakeAlert {
+    return {
+      device_id: event.stations.join(','),
+      timestamp: event.origin_time,
+      event: {
+        magnitude: event.magnitude,
+        pga: event.pga,
+        pgv: 0,
+        cav: 0,
+        duration: event.confirmed_at - event.origin_time,
+        alert_level: event.alert_level,
+        confirmed: true
+      },
+      location: event.location
+    };
+  }
+
+  private async sendNotifications(alert: EarthquakeAlert,
+                                  message: string = this.formatAlertMessage(alert)): Promise<void> {
 
     const promises: Promise<void>[] = [];
 
@@ -92,6 +136,18 @@ export class AlertService {
     await Promise.allSettled(promises);
   }
 
+  private formatNetworkMessage(event: NetworkEvent): string {
+    return `🚨 EARTHQUAKE ALERT!
+
+📍 Location: ${event.location.lat.toFixed(4)}, ${event.location.lon.toFixed(4)}
+📊 Magnitude: ${event.magnitude.toFixed(2)}
+⚡ PGA: ${event.pga.toFixed(4)} g
+🎚️ Alert Level: ${event.alert_level}${event.damaging ? ' (damaging)' : ''}
+📡 Stations: ${event.stations.length} of ${event.candidates} nearby (${event.stations.join(', ')})
+⏱️ Confirmed: ${((event.confirmed_at - event.origin_time) / 1000).toFixed(1)} s after onset
+🕐 Time: ${new Date(event.origin_time).toISOString()}`;
+  }
+
   private formatAlertMessage(alert: EarthquakeAlert): string {
     return `🚨 EARTHQUAKE ALERT!
 
@@ -249,6 +305,10 @@ export class AlertService {
     return this.database.getAlertsByDevice(deviceId, limit);
   }
 
+  async getNetworkEvents(limit: number = 50): Promise<NetworkEvent[]> {
+    return this.database.getRecentNetworkEvents(limit);
+  }
+
   async getAlertStats(): Promise<object> {
     return this.database.getAlertStats();
   }
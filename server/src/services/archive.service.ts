@@ -0,0 +1,251 @@
+import { promises as fs } from 'fs';
+import path from 'path';
+import { Logger } from 'winston';
+import { IngestBatch, SensorCapture, WaveformBlock } from './ingest.service';
+
+export const ARCHIVE_FORMAT = 'eqarchive';
+export const ARCHIVE_FORMAT_VERSION = 1;
+export const ARCHIVE_META_FILE = 'chunk.json';
+export const ARCHIVE_TIMESTAMP_COLUMN = 'timestamp_us.i64';
+export const ARCHIVE_AXIS_COLUMNS = ['x.i16', 'y.i16', 'z.i16'];
+
+const AXIS_COUNT = 3;
+const TIMESTAMP_DIGITS = 17;
+
+export type ArchiveChunkKind = 'stream' | 'capture';
+
+export interface ArchiveChunkMeta {
+  format: string;
+  version: number;
+  device_id: string;
+  kind: ArchiveChunkKind;
+  sample_rate: number;
+  scale: number;
+  clock_synced: boolean;
+  first_timestamp_us: number;
+  capture_id?: number;
+  trigger_time_us?: number;
+  pre_trigger_samples?: number;
+  manual?: boolean;
+  truncated?: boolean;
+}
+
+export interface ArchiveOptions {
+  chunkSamples: number;
+}
+
+export interface ArchiveStats {
+  chunks: number;
+  samples: number;
+  failed: number;
+}
+
+export const DEFAULT_ARCHIVE_OPTIONS: ArchiveOptions = {
+  chunkSamples: 360000
+};
+
+interface StreamChunk {
+  directory: string;
+  sampleRate: number;
+  scale: number;
+  clockSynced: boolean;
+  samples: number;
+  lastTimestampUs: number;
+}
+
+interface ColumnBuffers {
+  timestamps: Buffer;
+  axes: Buffer[];
+}
+
+export function archiveDeviceDirectory(deviceId: string): string {
+  const safe = deviceId.replace(/[^A-Za-z0-9_-]/g, '_');
+  return safe.length > 0 ? safe : '_';
+}
+
+export function chunkName(timestampUs: number, suffix?: number): string {
+  const name = Math.max(0, Math.floor(timestampUs)).toString().padStart(TIMESTAMP_DIGITS, '0');
+  return suffix === undefined ? name : `${name}-${suffix}`;
+}
+
+export function encodeColumns(counts: Int16Array, firstTimestampUs: number, sampleRate: number): ColumnBuffers {
+  const sampleCount = Math.floor(counts.length / AXIS_COUNT);
+  const periodUs = 1e6 / Math.max(1, sampleRate);
+  const timestamps = Buffer.alloc(sampleCount * 8);
+  const axes = Array.from({ length: AXIS_COUNT }, () => Buffer.alloc(sampleCount * 2));
+
+  for (let i = 0; i < sampleCount; i++) {
+    timestamps.writeBigInt64LE(BigInt(Math.round(firstTimestampUs + i * periodUs)), i * 8);
+    for (let axis = 0; axis < AXIS_COUNT; axis++) {
+      axes[axis].writeInt16LE(counts[i * AXIS_COUNT + axis], i * 2);
+    }
+  }
+
+  return { timestamps, axes };
+}
+
+export class ArchiveService {
+  private root: string;
+  private logger: Logger;
+  private options: ArchiveOptions;
+  private streams: Map<string, StreamChunk> = new Map();
+  private chunks: number = 0;
+  private samples: number = 0;
+  private failed: number = 0;
+
+  constructor(root: string, logger: Logger, options: Partial<ArchiveOptions> = {}) {
+    this.root = root;
+    this.logger = logger;
+    this.options = { ...DEFAULT_ARCHIVE_OPTIONS, ...options };
+  }
+
+  async writeBatch(batch: IngestBatch): Promise<number> {
+    let written = 0;
+
+    for (const [deviceId, blocks] of this.groupWaveforms(batch.waveforms)) {
+      try {
+        written += await this.appendStream(deviceId, blocks);
+      } catch (error) {
+        this.failed += blocks.reduce((sum, block) => sum + block.sample_count, 0);
+        this.streams.delete(deviceId);
+        this.logger.error('Failed to archive waveform blocks', { deviceId, error });
+      }
+    }
+
+    for (const capture of batch.captures) {
+      try {
+        written += await this.writeCapture(capture);
+      } catch (error) {
+        this.failed += capture.sample_count;
+        this.logger.error('Failed to archive capture', {
+          deviceId: capture.device_id,
+          captureId: capture.capture_id,
+          error
+        });
+      }
+    }
+
+    this.samples += written;
+    return written;
+  }
+
+  getStats(): ArchiveStats {
+    return { chunks: this.chunks, samples: this.samples, failed: this.failed };
+  }
+
+  private groupWaveforms(waveforms: WaveformBlock[]): Map<string, WaveformBlock[]> {
+    const grouped = new Map<string, WaveformBlock[]>();
+    for (const block of waveforms) {
+      const blocks = grouped.get(block.device_id);
+      if (blocks) {
+        blocks.push(block);
+      } else {
+        grouped.set(block.device_id, [block]);
+      }
+    }
+    return grouped;
+  }
+
+  private async appendStream(deviceId: string, blocks: WaveformBlock[]): Promise<number> {
+    let chunk = this.streams.get(deviceId);
+    let pending: ColumnBuffers[] = [];
+    let written = 0;
+
+    for (const block of blocks) {
+      if (block.sample_count === 0) {
+        continue;
+      }
+
+      if (!chunk || this.needsNewChunk(chunk, block)) {
+        if (chunk && pending.length > 0) {
+          await this.appendColumns(chunk.directory, pending);
+        }
+        pending = [];
+        chunk = await this.openStreamChunk(block);
+        this.streams.set(deviceId, chunk);
+      }
+
+      pending.push(encodeColumns(block.counts, block.timestamp_us, block.sample_rate));
+      chunk.samples += block.sample_count;
+      chunk.lastTimestampUs = block.timestamp_us + (block.sample_count - 1) * 1e6 / Math.max(1, block.sample_rate);
+      written += block.sample_count;
+    }
+
+    if (chunk && pending.length > 0) {
+      await this.appendColumns(chunk.directory, pending);
+    }
+    return written;
+  }
+
+  private needsNewChunk(chunk: StreamChunk, block: WaveformBlock): boolean {
+    return chunk.sampleRate !== block.sample_rate ||
+           chunk.scale !== block.scale ||
+           chunk.clockSynced !== block.clock_synced ||
+           block.timestamp_us <= chunk.lastTimestampUs ||
+           chunk.samples + block.sample_count > this.options.chunkSamples;
+  }
+
+  private async openStreamChunk(block: WaveformBlock): Promise<StreamChunk> {
+    const directory = path.join(this.root, archiveDeviceDirectory(block.device_id), 'stream',
+                                chunkName(block.timestamp_us));
+    await this.createChunk(directory, {
+      format: ARCHIVE_FORMAT,
+      version: ARCHIVE_FORMAT_VERSION,
+      device_id: block.device_id,
+      kind: 'stream',
+      sample_rate: block.sample_rate,
+      scale: block.scale,
+      clock_synced: block.clock_synced,
+      first_timestamp_us: block.timestamp_us
+    });
+
+    return {
+      directory,
+      sampleRate: block.sample_rate,
+      scale: block.scale,
+      clockSynced: block.clock_synced,
+      samples: 0,
+      lastTimestampUs: -1
+    };
+  }
+
+  private async writeCapture(capture: SensorCapture): Promise<number> {
+    const directory = path.join(this.root, archiveDeviceDirectory(capture.device_id), 'capture',
+                                chunkName(capture.trigger_time_us, capture.capture_id));
+    await this.createChunk(directory, {
+      format: ARCHIVE_FORMAT,
+      version: ARCHIVE_FORMAT_VERSION,
+      device_id: capture.device_id,
+      kind: 'capture',
+      sample_rate: capture.sample_rate,
+      scale: capture.scale,
+      clock_synced: capture.clock_synced,
+      first_timestamp_us: capture.first_timestamp_us,
+      capture_id: capture.capture_id,
+      trigger_time_us: capture.trigger_time_us,
+      pre_trigger_samples: capture.pre_trigger_samples,
+      manual: capture.manual,
+      truncated: capture.truncated
+    });
+
+    await this.appendColumns(directory, [
+      encodeColumns(capture.counts, capture.first_timestamp_us, capture.sample_rate)
+    ]);
+    return capture.sample_count;
+  }
+
+  private async createChunk(directory: string, meta: ArchiveChunkMeta): Promise<void> {
+    await fs.mkdir(directory, { recursive: true });
+    await Promise.all([ARCHIVE_TIMESTAMP_COLUMN, ...ARCHIVE_AXIS_COLUMNS].map(column =>
+      fs.writeFile(path.join(directory, column), Buffer.alloc(0))));
+    await fs.writeFile(path.join(directory, ARCHIVE_META_FILE), JSON.stringify(meta, null, 2));
+    this.chunks++;
+  }
+
+  private async appendColumns(directory: string, pending: ColumnBuffers[]): Promise<void> {
+    await Promise.all(ARCHIVE_AXIS_COLUMNS.map((column, axis) =>
+      fs.appendFile(path.join(directory, column), Buffer.concat(pending.map(columns => columns.axes[axis])))));
+    await fs.appendFile(path.join(directory, ARCHIVE_TIMESTAMP_COLUMN),
+                        Buffer.concat(pending.map(columns => columns.timestamps)));
+  }
+}
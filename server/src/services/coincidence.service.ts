@@ -0,0 +1,348 @@
+import { Logger } from 'winston';
+import { EarthquakeAlert, PreliminaryAlert } from './mqtt.service';
+
+export interface StationLocation {
+  lat: number;
+  lon: number;
+}
+
+export interface StationTrigger {
+  device_id: string;
+  location: StationLocation;
+  onset: number;
+  pga: number;
+  magnitude: number;
+  alert_level: string;
+  damaging: boolean;
+}
+
+export interface NetworkEvent {
+  event_id: string;
+  origin_time: number;
+  confirmed_at: number;
+  location: StationLocation;
+  stations: string[];
+  candidates: number;
+  magnitude: number;
+  pga: number;
+  alert_level: string;
+  damaging: boolean;
+}
+
+export interface AssociationResult {
+  event: NetworkEvent | null;
+  created: boolean;
+}
+
+export interface CoincidenceOptions {
+  radiusKm: number;
+  nearestStations: number;
+  minStations: number;
+  velocityKmPerSec: number;
+  slackMs: number;
+  gridDegrees: number;
+  eventWindowMs: number;
+}
+
+export const DEFAULT_COINCIDENCE_OPTIONS: CoincidenceOptions = {
+  radiusKm: 30,
+  nearestStations: 6,
+  minStations: 3,
+  velocityKmPerSec: 6,
+  slackMs: 2000,
+  gridDegrees: 0.25,
+  eventWindowMs: 120000
+};
+
+const EARTH_RADIUS_KM = 6371;
+const KM_PER_DEGREE = 111.32;
+const ALERT_LEVELS = ['NEGLIGIBLE', 'LIGHT', 'MODERATE', 'STRONG', 'SEVERE', 'EXTREME'];
+
+interface Station {
+  device_id: string;
+  location: StationLocation;
+  cell: string;
+  trigger: StationTrigger | null;
+}
+
+interface ActiveEvent {
+  event: NetworkEvent;
+  triggers: Map<string, StationTrigger>;
+}
+
+export function distanceKm(a: StationLocation, b: StationLocation): number {
+  const toRadians = (degrees: number) => degrees * Math.PI / 180;
+  const dLat = toRadians(b.lat - a.lat);
+  const dLon = toRadians(b.lon - a.lon);
+  const h = Math.sin(dLat / 2) ** 2 +
+            Math.cos(toRadians(a.lat)) * Math.cos(toRadians(b.lat)) * Math.sin(dLon / 2) ** 2;
+  return 2 * EARTH_RADIUS_KM * Math.asin(Math.min(1, Math.sqrt(h)));
+}
+
+export function isLocated(location: StationLocation | undefined): location is StationLocation {
+  return location !== undefined && Number.isFinite(location.lat) && Number.isFinite(location.lon) &&
+         Math.abs(location.lat) <= 90 && Math.abs(location.lon) <= 180 &&
+         !(location.lat === 0 && location.lon === 0);
+}
+
+export function triggerFromPreliminary(alert: PreliminaryAlert, receivedAt: number): StationTrigger {
+  return {
+    device_id: alert.device_id,
+    location: alert.location,
+    onset: alert.clock_synced && alert.onset_time_us !== undefined
+      ? alert.onset_time_us / 1000
+      : receivedAt - Math.max(0, alert.timestamp - alert.onset_time),
+    pga: alert.pga,
+    magnitude: alert.magnitude_estimate,
+    alert_level: alert.alert_level,
+    damaging: alert.damaging
+  };
+}
+
+export function triggerFromAlert(alert: EarthquakeAlert, receivedAt: number): StationTrigger {
+  const elapsed = alert.event.start_time !== undefined
+    ? alert.timestamp - alert.event.start_time
+    : alert.event.duration;
+
+  return {
+    device_id: alert.device_id,
+    location: alert.location,
+    onset: alert.clock_synced && alert.event.start_time_us !== undefined
+      ? alert.event.start_time_us / 1000
+      : receivedAt - Math.max(0, elapsed),
+    pga: alert.event.pga,
+    magnitude: alert.event.magnitude,
+    alert_level: alert.event.alert_level,
+    damaging: false
+  };
+}
+
+function median(values: number[]): number {
+  const sorted = [...values].sort((a, b) => a - b);
+  const middle = Math.floor(sorted.length / 2);
+  return sorted.length % 2 === 1 ? sorted[middle] : (sorted[middle - 1] + sorted[middle]) / 2;
+}
+
+export class CoincidenceService {
+  private logger: Logger;
+  private options: CoincidenceOptions;
+  private stations: Map<string, Station> = new Map();
+  private grid: Map<string, Set<string>> = new Map();
+  private active: ActiveEvent[] = [];
+
+  constructor(logger: Logger, options: Partial<CoincidenceOptions> = {}) {
+    this.logger = logger;
+    this.options = { ...DEFAULT_COINCIDENCE_OPTIONS, ...options };
+  }
+
+  registerStation(deviceId: string, location: StationLocation | undefined): boolean {
+    if (!isLocated(location)) {
+      return false;
+    }
+
+    const cell = this.cellKey(location);
+    const station = this.stations.get(deviceId);
+    if (station) {
+      if (station.cell !== cell) {
+        this.grid.get(station.cell)?.delete(deviceId);
+        station.cell = cell;
+        this.addToCell(cell, deviceId);
+      }
+      station.location = location;
+      return true;
+    }
+
+    this.stations.set(deviceId, { device_id: deviceId, location, cell, trigger: null });
+    this.addToCell(cell, deviceId);
+    return true;
+  }
+
+  associate(trigger: StationTrigger, now: number = Date.now()): AssociationResult {
+    this.prune(now);
+
+    if (!this.registerStation(trigger.device_id, trigger.location)) {
+      return { event: null, created: false };
+    }
+
+    const existing = this.findEvent(trigger);
+    if (existing) {
+      this.attach(existing, trigger);
+      return { event: existing.event, created: false };
+    }
+
+    const station = this.stations.get(trigger.device_id)!;
+    station.trigger = this.mergeTrigger(station.trigger, trigger);
+
+    const pivot = station.trigger;
+    const neighbours = this.nearestStations(station);
+    const coincident = neighbours
+      .filter(neighbour => neighbour.trigger !== null &&
+        Math.abs(neighbour.trigger.onset - pivot.onset) <= this.travelWindowMs(neighbour, station))
+      .map(neighbour => neighbour.trigger!);
+
+    if (coincident.length < this.options.minStations) {
+      return { event: null, created: false };
+    }
+
+    const triggers = new Map(coincident.map(coincidentTrigger => [coincidentTrigger.device_id, coincidentTrigger]));
+    const origin = Math.min(...coincident.map(coincidentTrigger => coincidentTrigger.onset));
+    const activeEvent: ActiveEvent = {
+      event: {
+        event_id: `net_${origin}_${Math.random().toString(36).substr(2, 9)}`,
+        origin_time: origin,
+        confirmed_at: now,
+        location: trigger.location,
+        stations: [],
+        candidates: neighbours.length,
+        magnitude: 0,
+        pga: 0,
+        alert_level: ALERT_LEVELS[0],
+        damaging: false
+      },
+      triggers
+    };
+    this.summarize(activeEvent);
+    this.active.push(activeEvent);
+
+    for (const device of triggers.keys()) {
+      this.stations.get(device)!.trigger = null;
+    }
+
+    this.logger.info('Network event confirmed', {
+      eventId: activeEvent.event.event_id,
+      stations: activeEvent.event.stations,
+      candidates: activeEvent.event.candidates,
+      latencyMs: now - origin
+    });
+    return { event: activeEvent.event, created: true };
+  }
+
+  canCorroborate(deviceId: string): boolean {
+    const station = this.stations.get(deviceId);
+    return station !== undefined && this.nearestStations(station).length >= this.options.minStations;
+  }
+
+  getActiveEvents(): NetworkEvent[] {
+    return this.active.map(activeEvent => activeEvent.event);
+  }
+
+  getStationCount(): number {
+    return this.stations.size;
+  }
+
+  private findEvent(trigger: StationTrigger): ActiveEvent | null {
+    for (const activeEvent of this.active) {
+      const { event } = activeEvent;
+      if (activeEvent.triggers.has(trigger.device_id)) {
+        return activeEvent;
+      }
+
+      const elapsed = trigger.onset - event.origin_time;
+      const reach = this.options.radiusKm + elapsed / 1000 * this.options.velocityKmPerSec;
+      if (elapsed >= -this.options.slackMs && elapsed <= this.options.eventWindowMs &&
+          distanceKm(trigger.location, event.location) <= Math.max(this.options.radiusKm, reach)) {
+        return activeEvent;
+      }
+    }
+    return null;
+  }
+
+  private attach(activeEvent: ActiveEvent, trigger: StationTrigger): void {
+    const current = activeEvent.triggers.get(trigger.device_id);
+    activeEvent.triggers.set(trigger.device_id, this.mergeTrigger(current || null, trigger));
+    this.summarize(activeEvent);
+  }
+
+  private mergeTrigger(current: StationTrigger | null, trigger: StationTrigger): StationTrigger {
+    if (!current || Math.abs(trigger.onset - current.onset) > this.options.slackMs) {
+      return trigger;
+    }
+
+    const stronger = trigger.pga > current.pga ? trigger : current;
+    return {
+      ...current,
+      location: trigger.location,
+      onset: Math.min(current.onset, trigger.onset),
+      pga: stronger.pga,
+      alert_level: stronger.alert_level,
+      magnitude: Math.max(current.magnitude, trigger.magnitude),
+      damaging: current.damaging || trigger.damaging
+    };
+  }
+
+  private summarize(activeEvent: ActiveEvent): void {
+    const triggers = Array.from(activeEvent.triggers.values());
+    const { event } = activeEvent;
+
+    event.stations = triggers.map(trigger => trigger.device_id);
+    event.location = {
+      lat: triggers.reduce((sum, trigger) => sum + trigger.location.lat, 0) / triggers.length,
+      lon: triggers.reduce((sum, trigger) => sum + trigger.location.lon, 0) / triggers.length
+    };
+    event.magnitude = median(triggers.map(trigger => trigger.magnitude));
+    event.pga = Math.max(...triggers.map(trigger => trigger.pga));
+    event.alert_level = triggers.reduce((level, trigger) =>
+      ALERT_LEVELS.indexOf(trigger.alert_level) > ALERT_LEVELS.indexOf(level) ? trigger.alert_level : level,
+      ALERT_LEVELS[0]);
+    event.damaging = triggers.filter(trigger => trigger.damaging).length >= this.options.minStations;
+  }
+
+  private travelWindowMs(a: Station, b: Station): number {
+    return distanceKm(a.location, b.location) / this.options.velocityKmPerSec * 1000 + this.options.slackMs;
+  }
+
+  private nearestStations(origin: Station): Station[] {
+    const { radiusKm, gridDegrees } = this.options;
+    const latSpan = Math.ceil(radiusKm / KM_PER_DEGREE / gridDegrees);
+    const lonScale = Math.max(Math.cos(origin.location.lat * Math.PI / 180), 1e-3);
+    const lonCells = Math.round(360 / gridDegrees);
+    const lonSpan = Math.min(Math.ceil(radiusKm / (KM_PER_DEGREE * lonScale) / gridDegrees), Math.floor((lonCells - 1) / 2));
+    const [latCell, lonCell] = origin.cell.split(':').map(Number);
+
+    const found: Array<{ station: Station; distance: number }> = [];
+    for (let dLat = -latSpan; dLat <= latSpan; dLat++) {
+      for (let dLon = -lonSpan; dLon <= lonSpan; dLon++) {
+        const devices = this.grid.get(`${latCell + dLat}:${(lonCell + dLon + lonCells) % lonCells}`);
+        for (const device of devices || []) {
+          const station = this.stations.get(device)!;
+          const distance = distanceKm(origin.location, station.location);
+          if (distance <= radiusKm) {
+            found.push({ station, distance });
+          }
+        }
+      }
+    }
+
+    return found
+      .sort((a, b) => a.distance - b.distance)
+      .slice(0, this.options.nearestStations)
+      .map(({ station }) => station);
+  }
+
+  private cellKey(location: StationLocation): string {
+    const lonCells = Math.round(360 / this.options.gridDegrees);
+    const latCell = Math.floor(location.lat / this.options.gridDegrees);
+    const lonCell = Math.floor((location.lon + 180) / this.options.gridDegrees) % lonCells;
+    return `${latCell}:${lonCell}`;
+  }
+
+  private addToCell(cell: string, deviceId: string): void {
+    const devices = this.grid.get(cell);
+    if (devices) {
+      devices.add(deviceId);
+    } else {
+      this.grid.set(cell, new Set([deviceId]));
+    }
+  }
+
+  private prune(now: number): void {
+    const cutoff = now - this.options.eventWindowMs;
+    this.active = this.active.filter(activeEvent => activeEvent.event.origin_time >= cutoff);
+
+    for (const station of this.stations.values()) {
+      if (station.trigger && station.trigger.onset < cutoff) {
+        station.trigger = null;
+      }
+    }
+  }
+}
@@ -1,5 +1,7 @@
 import { Logger } from 'winston';
-import { EarthquakeAlert, DeviceStatus } from './mqtt.service';
+import { EarthquakeAlert, DeviceClock, DeviceStatus, DeviceMetrics, SensorData } from './mqtt.service';
+import { IngestBatch, SensorCapture, WaveformBlock } from './ingest.service';
+import { NetworkEvent } from './coincidence.service';
 
 interface StoredAlert extends EarthquakeAlert {
   _id: string;
@@ -10,16 +12,87 @@ interface StoredDevice {
   device_id: string;
   status: string;
   lastSeen: Date;
+  metrics?: DeviceMetrics;
+  clock?: DeviceClock;
   location?: {
     lat: number;
     lon: number;
   };
 }
 
+export interface StoredMetrics extends DeviceMetrics {
+  device_id: string;
+  receivedAt: Date;
+}
+
+export interface StageLatencySummary {
+  stage: string;
+  devices: number;
+  count: number;
+  p50: number;
+  p99: number;
+  max: number;
+  worstDevice: string | null;
+}
+
+const MAX_METRICS_PER_DEVICE = 1440;
+const MAX_WAVEFORM_BLOCKS_PER_DEVICE = 600;
+const MAX_SAMPLES_PER_DEVICE = 6000;
+const MAX_CAPTURES_PER_DEVICE = 20;
+const MAX_NETWORK_EVENTS = 1000;
+
+function appendBounded<T>(store: Map<string, T[]>, key: string, items: T[], limit: number): void {
+  const history = store.get(key) || [];
+  history.push(...items);
+  if (history.length > limit) {
+    history.splice(0, history.length - limit);
+  }
+  store.set(key, history);
+}
+
+function newestFirst<T>(history: T[] | undefined, limit: number): T[] {
+  return (history || []).slice(-limit).reverse();
+}
+
+function groupByDevice<T extends { device_id: string }>(items: T[]): Map<string, T[]> {
+  const groups = new Map<string, T[]>();
+  for (const item of items) {
+    const group = groups.get(item.device_id);
+    if (group) {
+      group.push(item);
+    } else {
+      groups.set(item.device_id, [item]);
+    }
+  }
+  return groups;
+}
+
+function histogramPercentile(buckets: number[], bounds: number[], max: number, quantile: number): number {
+  const total = buckets.reduce((sum, count) => sum + count, 0);
+  if (total === 0) {
+    return 0;
+  }
+
+  const rank = Math.ceil(quantile * total);
+  let seen = 0;
+  for (let i = 0; i < bounds.length; i++) {
+    seen += buckets[i] || 0;
+    if (seen >= rank) {
+      return Math.min(bounds[i], max);
+    }
+  }
+  return max;
+}
+
 export class DatabaseService {
   private logger: Logger;
   private alerts: StoredAlert[] = [];
+  private networkEvents: NetworkEvent[] = [];
   private devices: Map<string, StoredDevice> = new Map();
+  private metrics: Map<string, StoredMetrics[]> = new Map();
+  private waveforms: Map<string, WaveformBlock[]> = new Map();
+  private samples: Map<string, SensorData[]> = new Map();
+  private captures: Map<string, SensorCapture[]> = new Map();
   private connected: boolean = false;
 
   constructor(logger: Logger) {
@@ -71,21 +144,158 @@ export class DatabaseService {
     return this.alerts.find(alert => alert._id === alertId) || null;
   }
 
+  async saveNetworkEvent(event: NetworkEvent): Promise<void> {
+    const index = this.networkEvents.findIndex(stored => stored.event_id === event.event_id);
+    if (index >= 0) {
+      this.networkEvents[index] = { ...event };
+    } else {
+      this.networkEvents.unshift({ ...event });
+      if (this.networkEvents.length > MAX_NETWORK_EVENTS) {
+        this.networkEvents.length = MAX_NETWORK_EVENTS;
+      }
+    }
+
+    this.logger.debug('Network event saved', { id: event.event_id, stations: event.stations.length });
+  }
+
+  async getRecentNetworkEvents(limit: number = 50): Promise<NetworkEvent[]> {
+    return this.networkEvents.slice(0, limit);
+  }
+
   async updateDeviceStatus(status: DeviceStatus): Promise<void> {
+    this.applyDeviceStatus(status);
+    this.logger.debug('Device status updated', { deviceId: status.device_id, status: status.status });
+  }
+
+  async saveIngestBatch(batch: IngestBatch): Promise<void> {
+    for (const status of batch.statuses) {
+      this.applyDeviceStatus(status);
+    }
+    for (const [deviceId, blocks] of groupByDevice(batch.waveforms)) {
+      appendBounded(this.waveforms, deviceId, blocks, MAX_WAVEFORM_BLOCKS_PER_DEVICE);
+    }
+    for (const [deviceId, samples] of groupByDevice(batch.data)) {
+      appendBounded(this.samples, deviceId, samples, MAX_SAMPLES_PER_DEVICE);
+    }
+    for (const [deviceId, captures] of groupByDevice(batch.captures)) {
+      appendBounded(this.captures, deviceId, captures, MAX_CAPTURES_PER_DEVICE);
+    }
+
+    this.logger.debug('Ingest batch saved', {
+      statuses: batch.statuses.length,
+      waveforms: batch.waveforms.length,
+      samples: batch.data.length,
+      captures: batch.captures.length
+    });
+  }
+
+  async getWaveforms(deviceId: string, limit: number = 10): Promise<WaveformBlock[]> {
+    return newestFirst(this.waveforms.get(deviceId), limit);
+  }
+
+  async getSensorData(deviceId: string, limit: number = 100): Promise<SensorData[]> {
+    return newestFirst(this.samples.get(deviceId), limit);
+  }
+
+  async getCaptures(deviceId: string, limit: number = 5): Promise<SensorCapture[]> {
+    return newestFirst(this.captures.get(deviceId), limit);
+  }
+
+  private applyDeviceStatus(status: DeviceStatus): void {
     const device = this.devices.get(status.device_id);
 
     if (device) {
       device.status = status.status;
       device.lastSeen = new Date(status.timestamp);
+      if (status.metrics) {
+        device.metrics = status.metrics;
+      }
+      if (status.location) {
+        device.location = status.location;
+      }
+      if (status.clock) {
+        device.clock = status.clock;
+      }
     } else {
       this.devices.set(status.device_id, {
         device_id: status.device_id,
         status: status.status,
-        lastSeen: new Date(status.timestamp)
+        lastSeen: new Date(status.timestamp),
+        metrics: status.metrics,
+        clock: status.clock,
+        location: status.location
       });
     }
 
-    this.logger.debug('Device status updated', { deviceId: status.device_id, status: status.status });
+    if (status.metrics) {
+      this.saveMetrics(status.device_id, status.metrics);
+    }
+  }
+
+  private saveMetrics(deviceId: string, metrics: DeviceMetrics): void {
+    const history = this.metrics.get(deviceId) || [];
+    history.unshift({ ...metrics, device_id: deviceId, receivedAt: new Date() });
+
+    if (history.length > MAX_METRICS_PER_DEVICE) {
+      history.length = MAX_METRICS_PER_DEVICE;
+    }
+    this.metrics.set(deviceId, history);
+  }
+
+  async getDeviceMetrics(deviceId: string, limit: number = 60): Promise<StoredMetrics[]> {
+    return (this.metrics.get(deviceId) || []).slice(0, limit);
+  }
+
+  async getStageLatencySummary(): Promise<StageLatencySummary[]> {
+    const summaries = new Map<string, {
+      devices: number;
+      buckets: number[];
+      bounds: number[];
+      max: number;
+      worstDevice: string | null;
+      worstP99: number;
+    }>();
+
+    for (const device of this.devices.values()) {
+      if (!device.metrics) {
+        continue;
+      }
+
+      const { bounds_us: bounds, stages, jitter } = device.metrics;
+      const histograms = { ...stages, jitter };
+
+      for (const [stage, histogram] of Object.entries(histograms)) {
+        const summary = summaries.get(stage) || {
+          devices: 0,
+          buckets: new Array(bounds.length + 1).fill(0),
+          bounds,
+          max: 0,
+          worstDevice: null,
+          worstP99: -1
+        };
+
+        summary.devices++;
+        histogram.h.forEach((count, i) => {
+          summary.buckets[i] = (summary.buckets[i] || 0) + count;
+        });
+        summary.max = Math.max(summary.max, histogram.max);
+        if (histogram.n > 0 && histogram.p99 > summary.worstP99) {
+          summary.worstP99 = histogram.p99;
+          summary.worstDevice = device.device_id;
+        }
+        summaries.set(stage, summary);
+      }
+    }
+
+    return Array.from(summaries.entries()).map(([stage, summary]) => ({
+      stage,
+      devices: summary.devices,
+      count: summary.buckets.reduce((sum, count) => sum + count, 0),
+      p50: histogramPercentile(summary.buckets, summary.bounds, summary.max, 0.5),
+      p99: histogramPercentile(summary.buckets, summary.bounds, summary.max, 0.99),
+      max: summary.max,
+      worstDevice: summary.worstDevice
+    }));
   }
 
   async getDeviceStatus(deviceId: string): Promise<StoredDevice | null> {
@@ -0,0 +1,581 @@
+import { EventEmitter } from 'events';
+import { Logger } from 'winston';
+import { ArchiveService } from './archive.service';
+import { DatabaseService } from './database.service';
+import { DeviceStatus, SensorData } from './mqtt.service';
+import { RingQueue } from '../utils/ring-queue';
+
+export const WAVEFORM_FORMAT_VERSION = 2;
+export const WAVEFORM_FLAG_DELTA_ZIGZAG = 0x01;
+export const WAVEFORM_HEADER_SIZE = 18;
+export const WAVEFORM_LEGACY_HEADER_SIZE = 14;
+export const WAVEFORM_MAX_VARINT_BYTES = 3;
+
+export const CAPTURE_CHUNK_VERSION = 1;
+export const CAPTURE_CHUNK_FLAG_FINAL = 0x01;
+export const CAPTURE_CHUNK_HEADER_SIZE = 16;
+
+export const CAPTURE_MAGIC = 0x50414345;
+export const CAPTURE_FORMAT_VERSION = 2;
+export const CAPTURE_HEADER_SIZE = 40;
+export const CAPTURE_LEGACY_HEADER_SIZE = 32;
+export const CAPTURE_FLAG_TRUNCATED = 0x01;
+export const CAPTURE_FLAG_MANUAL = 0x02;
+
+export const UTC_MIN_MICROS = 1577836800000000;
+
+const AXIS_COUNT = 3;
+
+export interface WaveformBlock {
+  device_id: string;
+  timestamp: number;
+  timestamp_us: number;
+  clock_synced: boolean;
+  sample_rate: number;
+  scale: number;
+  sample_count: number;
+  counts: Int16Array;
+}
+
+export interface CaptureChunk {
+  device_id: string;
+  capture_id: number;
+  offset: number;
+  total: number;
+  final: boolean;
+  data: Buffer;
+}
+
+export interface SensorCapture {
+  device_id: string;
+  capture_id: number;
+  truncated: boolean;
+  manual: boolean;
+  sample_rate: number;
+  scale: number;
+  trigger_time: number;
+  first_timestamp: number;
+  trigger_time_us: number;
+  first_timestamp_us: number;
+  clock_synced: boolean;
+  sample_count: number;
+  pre_trigger_samples: number;
+  counts: Int16Array;
+}
+
+export interface IngestBatch {
+  waveforms: WaveformBlock[];
+  data: SensorData[];
+  statuses: DeviceStatus[];
+  captures: SensorCapture[];
+}
+
+export interface DeviceActivity {
+  device_id: string;
+  timestamp: number;
+  samples: number;
+  latest: {
+    x: number;
+    y: number;
+    z: number;
+  };
+  peak: number;
+}
+
+export interface IngestOptions {
+  queueCapacity: number;
+  maxBatchSize: number;
+  flushIntervalMs: number;
+  broadcastIntervalMs: number;
+  maxPendingCaptures: number;
+  maxCaptureBytes: number;
+}
+
+export interface IngestStats {
+  devices: number;
+  queued: number;
+  dropped: number;
+  malformed: number;
+  batches: number;
+  records: number;
+  failed: number;
+  pending_captures: number;
+  archived: number;
+  archive_failed: number;
+}
+
+export const DEFAULT_INGEST_OPTIONS: IngestOptions = {
+  queueCapacity: 600,
+  maxBatchSize: 5000,
+  flushIntervalMs: 1000,
+  broadcastIntervalMs: 500,
+  maxPendingCaptures: 4,
+  maxCaptureBytes: 1024 * 1024
+};
+
+type IngestRecord =
+  | { kind: 'waveform'; waveform: WaveformBlock }
+  | { kind: 'data'; data: SensorData }
+  | { kind: 'status'; status: DeviceStatus }
+  | { kind: 'capture'; capture: SensorCapture };
+
+interface PendingCapture {
+  device_id: string;
+  buffer: Buffer;
+  received: number;
+  updatedAt: number;
+}
+
+export function isUtcMicros(micros: number): boolean {
+  return micros >= UTC_MIN_MICROS;
+}
+
+function readMicros(payload: Buffer, offset: number): number {
+  return Number(payload.readBigUInt64LE(offset));
+}
+
+export function decodeWaveformBlock(deviceId: string, payload: Buffer): WaveformBlock {
+  if (payload.length < WAVEFORM_LEGACY_HEADER_SIZE) {
+    throw new Error(`Waveform block is ${payload.length} bytes, shorter than its header`);
+  }
+
+  const version = payload.readUInt8(0);
+  if (version !== WAVEFORM_FORMAT_VERSION && version !== 1) {
+    throw new Error(`Unsupported waveform format version ${version}`);
+  }
+
+  const headerSize = version === 1 ? WAVEFORM_LEGACY_HEADER_SIZE : WAVEFORM_HEADER_SIZE;
+  if (payload.length < headerSize) {
+    throw new Error(`Waveform block is ${payload.length} bytes, shorter than its header`);
+  }
+
+  const flags = payload.readUInt8(1);
+  if ((flags & WAVEFORM_FLAG_DELTA_ZIGZAG) === 0) {
+    throw new Error(`Unsupported waveform encoding flags 0x${flags.toString(16)}`);
+  }
+
+  const sampleCount = payload.readUInt16LE(2);
+  const counts = new Int16Array(sampleCount * AXIS_COUNT);
+  let position = headerSize;
+
+  for (let axis = 0; axis < AXIS_COUNT; axis++) {
+    let previous = 0;
+    for (let i = 0; i < sampleCount; i++) {
+      let value = 0;
+      let length = 0;
+      let byte: number;
+      do {
+        if (position >= payload.length) {
+          throw new Error('Waveform block is truncated');
+        }
+        if (length === WAVEFORM_MAX_VARINT_BYTES) {
+          throw new Error('Waveform delta exceeds the 16-bit sample range');
+        }
+        byte = payload[position++];
+        value |= (byte & 0x7f) << (7 * length++);
+      } while (byte & 0x80);
+
+      previous += (value >>> 1) ^ -(value & 1);
+      counts[i * AXIS_COUNT + axis] = previous;
+    }
+  }
+
+  if (position !== payload.length) {
+    throw new Error(`Waveform block has ${payload.length - position} trailing bytes`);
+  }
+
+  const timestampUs = version === 1 ? payload.readUInt32LE(10) * 1000 : readMicros(payload, 10);
+  return {
+    device_id: deviceId,
+    timestamp: Math.floor(timestampUs / 1000),
+    timestamp_us: timestampUs,
+    clock_synced: isUtcMicros(timestampUs),
+    sample_rate: payload.readUInt16LE(4),
+    scale: payload.readFloatLE(6),
+    sample_count: sampleCount,
+    counts
+  };
+}
+
+export function decodeCaptureChunk(deviceId: string, payload: Buffer): CaptureChunk {
+  if (payload.length < CAPTURE_CHUNK_HEADER_SIZE) {
+    throw new Error(`Capture chunk is ${payload.length} bytes, shorter than its header`);
+  }
+
+  const version = payload.readUInt8(0);
+  if (version !== CAPTURE_CHUNK_VERSION) {
+    throw new Error(`Unsupported capture chunk version ${version}`);
+  }
+
+  const offset = payload.readUInt32LE(8);
+  const total = payload.readUInt32LE(12);
+  const data = payload.subarray(CAPTURE_CHUNK_HEADER_SIZE);
+  if (offset + data.length > total) {
+    throw new Error(`Capture chunk at ${offset} overruns the ${total} byte capture`);
+  }
+
+  return {
+    device_id: deviceId,
+    capture_id: payload.readUInt32LE(4),
+    offset,
+    total,
+    final: (payload.readUInt8(1) & CAPTURE_CHUNK_FLAG_FINAL) !== 0,
+    data
+  };
+}
+
+export function decodeCapture(deviceId: string, payload: Buffer): SensorCapture {
+  if (payload.length < CAPTURE_LEGACY_HEADER_SIZE || payload.readUInt32LE(0) !== CAPTURE_MAGIC) {
+    throw new Error('Capture is missing its header');
+  }
+
+  const version = payload.readUInt8(4);
+  if (version !== CAPTURE_FORMAT_VERSION && version !== 1) {
+    throw new Error(`Unsupported capture format version ${version}`);
+  }
+
+  const legacy = version === 1;
+  const headerSize = legacy ? CAPTURE_LEGACY_HEADER_SIZE : CAPTURE_HEADER_SIZE;
+  if (payload.length < headerSize) {
+    throw new Error('Capture is missing its header');
+  }
+
+  const sampleCount = payload.readUInt32LE(legacy ? 24 : 16);
+  const expected = headerSize + sampleCount * AXIS_COUNT * 2;
+  if (payload.length < expected) {
+    throw new Error(`Capture holds ${payload.length} bytes but its header needs ${expected}`);
+  }
+
+  const counts = new Int16Array(sampleCount * AXIS_COUNT);
+  for (let i = 0; i < counts.length; i++) {
+    counts[i] = payload.readInt16LE(headerSize + i * 2);
+  }
+
+  const triggerTimeUs = legacy ? payload.readUInt32LE(16) * 1000 : readMicros(payload, 24);
+  const firstTimestampUs = legacy ? payload.readUInt32LE(20) * 1000 : readMicros(payload, 32);
+  const flags = payload.readUInt8(5);
+  return {
+    device_id: deviceId,
+    capture_id: payload.readUInt32LE(12),
+    truncated: (flags & CAPTURE_FLAG_TRUNCATED) !== 0,
+    manual: (flags & CAPTURE_FLAG_MANUAL) !== 0,
+    sample_rate: payload.readUInt16LE(6),
+    scale: payload.readFloatLE(8),
+    trigger_time: Math.floor(triggerTimeUs / 1000),
+    first_timestamp: Math.floor(firstTimestampUs / 1000),
+    trigger_time_us: triggerTimeUs,
+    first_timestamp_us: firstTimestampUs,
+    clock_synced: isUtcMicros(triggerTimeUs),
+    sample_count: sampleCount,
+    pre_trigger_samples: payload.readUInt32LE(legacy ? 28 : 20),
+    counts
+  };
+}
+
+export class IngestService extends EventEmitter {
+  private database: DatabaseService;
+  private archive: ArchiveService | null;
+  private logger: Logger;
+  private options: IngestOptions;
+  private queues: Map<string, RingQueue<IngestRecord>> = new Map();
+  private activity: Map<string, DeviceActivity> = new Map();
+  private captures: Map<string, PendingCapture> = new Map();
+  private flushTimer: NodeJS.Timeout | null = null;
+  private broadcastTimer: NodeJS.Timeout | null = null;
+  private flushing: boolean = false;
+  private malformed: number = 0;
+  private batches: number = 0;
+  private records: number = 0;
+  private failed: number = 0;
+
+  constructor(database: DatabaseService, logger: Logger, options: Partial<IngestOptions> = {},
+              archive: ArchiveService | null = null) {
+    super();
+    this.database = database;
+    this.archive = archive;
+    this.logger = logger;
+    this.options = { ...DEFAULT_INGEST_OPTIONS, ...options };
+  }
+
+  start(): void {
+    if (this.flushTimer) {
+      return;
+    }
+
+    this.flushTimer = setInterval(() => {
+      this.flush();
+    }, this.options.flushIntervalMs);
+    this.broadcastTimer = setInterval(() => {
+      this.publishUpdates();
+    }, this.options.broadcastIntervalMs);
+    this.logger.info('Ingest pipeline started', { options: this.options });
+  }
+
+  async stop(): Promise<void> {
+    if (this.flushTimer) {
+      clearInterval(this.flushTimer);
+      this.flushTimer = null;
+    }
+    if (this.broadcastTimer) {
+      clearInterval(this.broadcastTimer);
+      this.broadcastTimer = null;
+    }
+
+    await this.flush();
+    this.publishUpdates();
+  }
+
+  ingestWaveform(deviceId: string, payload: Buffer): boolean {
+    let block: WaveformBlock;
+    try {
+      block = decodeWaveformBlock(deviceId, payload);
+    } catch (error) {
+      this.rejectPayload('waveform', deviceId, error);
+      return false;
+    }
+
+    if (block.sample_count === 0) {
+      return true;
+    }
+
+    const last = (block.sample_count - 1) * AXIS_COUNT;
+    let peak = 0;
+    for (let i = 0; i < block.counts.length; i++) {
+      peak = Math.max(peak, Math.abs(block.counts[i]));
+    }
+
+    this.recordActivity(deviceId, {
+      timestamp: block.timestamp + Math.round((block.sample_count - 1) * 1000 / Math.max(1, block.sample_rate)),
+      samples: block.sample_count,
+      latest: {
+        x: block.counts[last] * block.scale,
+        y: block.counts[last + 1] * block.scale,
+        z: block.counts[last + 2] * block.scale
+      },
+      peak: peak * block.scale
+    });
+    return this.enqueue(deviceId, { kind: 'waveform', waveform: block });
+  }
+
+  ingestData(data: SensorData): boolean {
+    const { x, y, z } = data.acceleration;
+    this.recordActivity(data.device_id, {
+      timestamp: data.timestamp,
+      samples: 1,
+      latest: { x, y, z },
+      peak: Math.max(Math.abs(x), Math.abs(y), Math.abs(z))
+    });
+    return this.enqueue(data.device_id, { kind: 'data', data });
+  }
+
+  ingestStatus(status: DeviceStatus): boolean {
+    return this.enqueue(status.device_id, { kind: 'status', status });
+  }
+
+  ingestCaptureChunk(deviceId: string, payload: Buffer): boolean {
+    let chunk: CaptureChunk;
+    try {
+      chunk = decodeCaptureChunk(deviceId, payload);
+    } catch (error) {
+      this.rejectPayload('capture chunk', deviceId, error);
+      return false;
+    }
+
+    if (chunk.total > this.options.maxCaptureBytes) {
+      this.rejectPayload('capture chunk', deviceId, new Error(`Capture of ${chunk.total} bytes exceeds the limit`));
+      return false;
+    }
+
+    const key = `${deviceId}/${chunk.capture_id}`;
+    let pending = this.captures.get(key);
+    if (!pending || pending.buffer.length !== chunk.total) {
+      if (chunk.offset !== 0) {
+        this.logger.warn('Capture chunk arrived without its start', { deviceId, captureId: chunk.capture_id });
+        return false;
+      }
+      this.evictCaptures(deviceId);
+      pending = { device_id: deviceId, buffer: Buffer.alloc(chunk.total), received: 0, updatedAt: 0 };
+      this.captures.set(key, pending);
+    }
+
+    if (chunk.offset > pending.received) {
+      this.logger.warn('Capture chunk skipped ahead, discarding capture', {
+        deviceId,
+        captureId: chunk.capture_id,
+        offset: chunk.offset,
+        received: pending.received
+      });
+      this.captures.delete(key);
+      return false;
+    }
+
+    chunk.data.copy(pending.buffer, chunk.offset);
+    pending.received = Math.max(pending.received, chunk.offset + chunk.data.length);
+    pending.updatedAt = Date.now();
+
+    if (!chunk.final) {
+      return true;
+    }
+
+    this.captures.delete(key);
+    let capture: SensorCapture;
+    try {
+      if (pending.received !== chunk.total) {
+        throw new Error(`Final chunk left the capture at ${pending.received} of ${chunk.total} bytes`);
+      }
+      capture = decodeCapture(deviceId, pending.buffer);
+    } catch (error) {
+      this.rejectPayload('capture', deviceId, error);
+      return false;
+    }
+
+    this.emit('capture', capture);
+    return this.enqueue(deviceId, { kind: 'capture', capture });
+  }
+
+  async flush(): Promise<number> {
+    if (this.flushing) {
+      return 0;
+    }
+
+    this.flushing = true;
+    let written = 0;
+    try {
+      let batchesLeft = Math.ceil(this.getQueuedCount() / this.options.maxBatchSize);
+      while (batchesLeft-- > 0) {
+        const { batch, size } = this.takeBatch();
+        if (size === 0) {
+          break;
+        }
+
+        try {
+          await this.database.saveIngestBatch(batch);
+          this.batches++;
+          this.records += size;
+          written += size;
+        } catch (error) {
+          this.failed += size;
+          this.logger.error('Failed to write ingest batch', { size, error });
+          break;
+        }
+
+        if (this.archive) {
+          await this.archive.writeBatch(batch);
+        }
+      }
+    } finally {
+      this.flushing = false;
+    }
+
+    return written;
+  }
+
+  publishUpdates(): void {
+    if (this.activity.size === 0) {
+      return;
+    }
+
+    const updates = Array.from(this.activity.values());
+    this.activity.clear();
+    this.emit('update', updates);
+  }
+
+  getQueuedCount(): number {
+    let queued = 0;
+    for (const queue of this.queues.values()) {
+      queued += queue.length;
+    }
+    return queued;
+  }
+
+  getStats(): IngestStats {
+    const archive = this.archive ? this.archive.getStats() : null;
+    let dropped = 0;
+    for (const queue of this.queues.values()) {
+      dropped += queue.droppedCount;
+    }
+
+    return {
+      devices: this.queues.size,
+      queued: this.getQueuedCount(),
+      dropped,
+      malformed: this.malformed,
+      batches: this.batches,
+      records: this.records,
+      failed: this.failed,
+      pending_captures: this.captures.size,
+      archived: archive ? archive.samples : 0,
+      archive_failed: archive ? archive.failed : 0
+    };
+  }
+
+  private enqueue(deviceId: string, record: IngestRecord): boolean {
+    let queue = this.queues.get(deviceId);
+    if (!queue) {
+      queue = new RingQueue<IngestRecord>(this.options.queueCapacity);
+      this.queues.set(deviceId, queue);
+    }
+    return queue.push(record);
+  }
+
+  private takeBatch(): { batch: IngestBatch; size: number } {
+    const batch: IngestBatch = { waveforms: [], data: [], statuses: [], captures: [] };
+    const queues = Array.from(this.queues.values()).filter(queue => queue.length > 0);
+    let remaining = this.options.maxBatchSize;
+
+    while (remaining > 0 && queues.length > 0) {
+      const share = Math.max(1, Math.floor(remaining / queues.length));
+      for (let i = queues.length - 1; i >= 0 && remaining > 0; i--) {
+        for (const record of queues[i].drain(Math.min(share, remaining))) {
+          switch (record.kind) {
+            case 'waveform': batch.waveforms.push(record.waveform); break;
+            case 'data': batch.data.push(record.data); break;
+            case 'status': batch.statuses.push(record.status); break;
+            case 'capture': batch.captures.push(record.capture); break;
+          }
+          remaining--;
+        }
+        if (queues[i].length === 0) {
+          queues.splice(i, 1);
+        }
+      }
+    }
+
+    return { batch, size: this.options.maxBatchSize - remaining };
+  }
+
+  private recordActivity(deviceId: string, update: Omit<DeviceActivity, 'device_id'>): void {
+    const current = this.activity.get(deviceId);
+    if (!current) {
+      this.activity.set(deviceId, { device_id: deviceId, ...update });
+      return;
+    }
+
+    current.samples += update.samples;
+    current.peak = Math.max(current.peak, update.peak);
+    if (update.timestamp >= current.timestamp) {
+      current.timestamp = update.timestamp;
+      current.latest = update.latest;
+    }
+  }
+
+  private evictCaptures(deviceId: string): void {
+    const pending = Array.from(this.captures.entries())
+      .filter(([, capture]) => capture.device_id === deviceId)
+      .sort(([, a], [, b]) => a.updatedAt - b.updatedAt);
+
+    while (pending.length >= this.options.maxPendingCaptures) {
+      const [key] = pending.shift()!;
+      this.captures.delete(key);
+      this.logger.warn('Dropping stalled capture upload', { deviceId, capture: key });
+    }
+  }
+
+  private rejectPayload(kind: string, deviceId: string, error: unknown): void {
+    this.malformed++;
+    this.logger.warn(`Rejected malformed ${kind}`, {
+      deviceId,
+      error: error instanceof Error ? error.message : String(error)
+    });
+  }
+}
@@ -5,6 +5,8 @@ import { Logger } from 'winston';
 export interface EarthquakeAlert {
   device_id: string;
   timestamp: number;
+  timestamp_us?: number;
+  clock_synced?: boolean;
   event: {
     magnitude: number;
     pga: number;
@@ -13,6 +15,8 @@ export interface EarthquakeAlert {
     duration: number;
     alert_level: string;
     confirmed: boolean;
+    start_time?: number;
+    start_time_us?: number;
   };
   location: {
     lat: number;
@@ -20,9 +24,56 @@ export interface EarthquakeAlert {
   };
 }
 
+export interface EarthquakeAlertBatch {
+  device_id: string;
+  timestamp: number;
+  timestamp_us?: number;
+  clock_synced?: boolean;
+  events: Array<EarthquakeAlert['event']>;
+  location: {
+    lat: number;
+    lon: number;
+  };
+}
+
+export interface PreliminaryAlert {
+  device_id: string;
+  timestamp: number;
+  timestamp_us?: number;
+  clock_synced?: boolean;
+  onset_time: number;
+  onset_time_us?: number;
+  latency_ms: number;
+  window: number;
+  update: number;
+  tau_c: number;
+  pd: number;
+  magnitude_estimate: number;
+  pga: number;
+  alert_level: string;
+  damaging: boolean;
+  location: {
+    lat: number;
+    lon: number;
+  };
+}
+
+export function expandAlertBatch(batch: EarthquakeAlertBatch): EarthquakeAlert[] {
+  return (batch.events || []).map(event => ({
+    device_id: batch.device_id,
+    timestamp: batch.timestamp,
+    timestamp_us: batch.timestamp_us,
+    clock_synced: batch.clock_synced,
+    event,
+    location: batch.location,
+  }));
+}
+
 export interface SensorData {
   device_id: string;
   timestamp: number;
+  timestamp_us?: number;
+  clock_synced?: boolean;
   acceleration: {
     x: number;
     y: number;
@@ -30,10 +81,58 @@ export interface SensorData {
   };
 }
 
+export interface LatencyHistogram {
+  n: number;
+  avg: number;
+  p50: number;
+  p99: number;
+  max: number;
+  h: number[];
+}
+
+export interface DeviceMetrics {
+  window_ms: number;
+  samples: number;
+  dropped: number;
+  fifo_overflows: number;
+  queue_drops: number;
+  heap: {
+    free: number;
+    min_free: number;
+    largest: number;
+    frag: number;
+  };
+  bounds_us: number[];
+  stages: Record<string, LatencyHistogram>;
+  jitter: LatencyHistogram;
+}
+
+export interface DeviceClock {
+  source: 'none' | 'sntp' | 'pps';
+  drift_ppm: number;
+  error_us: number;
+  syncs: number;
+}
+
 export interface DeviceStatus {
   device_id: string;
   status: string;
   timestamp: number;
+  timestamp_us?: number;
+  clock_synced?: boolean;
+  clock?: DeviceClock;
+  location?: {
+    lat: number;
+    lon: number;
+  };
+  metrics?: DeviceMetrics;
+}
+
+export interface CommandAck {
+  device_id: string;
+  command: string;
+  status: 'ok' | 'unknown' | 'malformed' | 'rejected' | 'busy';
+  timestamp: number;
 }
 
 export class MQTTService extends EventEmitter {
@@ -97,10 +196,27 @@ export class MQTTService extends EventEmitter {
   }
 
   private handleMessage(topic: string, payload: Buffer): void {
+    if (topic.startsWith('earthquake/waveform/')) {
+      this.emit('waveform', topic.substring('earthquake/waveform/'.length), payload);
+      return;
+    }
+    if (topic.startsWith('earthquake/capture/')) {
+      this.emit('capture', topic.substring('earthquake/capture/'.length), payload);
+      return;
+    }
+
     try {
       const data = JSON.parse(payload.toString());
 
-      if (topic.includes('/alert')) {
+      if (topic.endsWith('/command/ack')) {
+        this.emit('command_ack', data as CommandAck);
+      } else if (topic.endsWith('/alert/preliminary')) {
+        this.emit('preliminary', data as PreliminaryAlert);
+      } else if (topic.endsWith('/alert/batch')) {
+        for (const alert of expandAlertBatch(data as EarthquakeAlertBatch)) {
+          this.emit('alert', alert);
+        }
+      } else if (topic.includes('/alert')) {
         this.emit('alert', data as EarthquakeAlert);
       } else if (topic.includes('/data')) {
         this.emit('data', data as SensorData);
@@ -0,0 +1,53 @@
+export class RingQueue<T> {
+  private items: Array<T | undefined>;
+  private head: number = 0;
+  private count: number = 0;
+  private dropped: number = 0;
+
+  constructor(capacity: number) {
+    if (!Number.isInteger(capacity) || capacity < 1) {
+      throw new Error(`Invalid ring queue capacity: ${capacity}`);
+    }
+    this.items = new Array(capacity);
+  }
+
+  push(item: T): boolean {
+    const capacity = this.items.length;
+
+    if (this.count === capacity) {
+      this.items[this.head] = item;
+      this.head = (this.head + 1) % capacity;
+      this.dropped++;
+      return false;
+    }
+
+    this.items[(this.head + this.count) % capacity] = item;
+    this.count++;
+    return true;
+  }
+
+  drain(limit: number = this.count): T[] {
+    const taken = Math.max(0, Math.min(limit, this.count));
+    const drained: T[] = new Array(taken);
+
+    for (let i = 0; i < taken; i++) {
+      drained[i] = this.items[this.head] as T;
+      this.items[this.head] = undefined;
+      this.head = (this.head + 1) % this.items.length;
+    }
+    this.count -= taken;
+    return drained;
+  }
+
+  get length(): number {
+    return this.count;
+  }
+
+  get capacity(): number {
+    return this.items.length;
+  }
+
+  get droppedCount(): number {
+    return this.dropped;
+  }
+}
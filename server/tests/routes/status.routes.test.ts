@@ -0,0 +1,107 @@
+import express from 'express';
+import request from 'supertest';
+import { statusRoutes } from '../../src/routes/status.routes';
+import { MQTTService } from '../../src/services/mqtt.service';
+import { DatabaseService } from '../../src/services/database.service';
+import winston from 'winston';
+
+const mockLogger = winston.createLogger({
+  silent: true
+});
+
+describe('Status Routes', () => {
+  let app: express.Application;
+  let databaseService: DatabaseService;
+  let publish: jest.Mock;
+
+  beforeEach(async () => {
+    databaseService = new DatabaseService(mockLogger);
+    await databaseService.connect();
+
+    publish = jest.fn();
+    const mqttService = { publish, isConnected: () => true } as unknown as MQTTService;
+
+    app = express();
+    app.use(express.json());
+    app.use('/api/status', statusRoutes(mqttService, databaseService));
+  });
+
+  afterEach(async () => {
+    await databaseService.disconnect();
+  });
+
+  describe('POST /api/status/devices/:deviceId/command', () => {
+    it('should publish the command to the device topic', async () => {
+      const response = await request(app)
+        .post('/api/status/devices/ESP32_TEST/command')
+        .send({ command: 'reset' })
+        .expect(200);
+
+      expect(response.body.success).toBe(true);
+      expect(publish).toHaveBeenCalledWith('earthquake/command/ESP32_TEST', { command: 'reset' });
+    });
+
+    it('should merge arguments into the command payload', async () => {
+      await request(app)
+        .post('/api/status/devices/ESP32_TEST/command')
+        .send({ command: 'thresholds', args: { trigger: 6, detrigger: 2, channel: 1 } })
+        .expect(200);
+
+      expect(publish).toHaveBeenCalledWith('earthquake/command/ESP32_TEST', {
+        trigger: 6,
+        detrigger: 2,
+        channel: 1,
+        command: 'thresholds'
+      });
+    });
+
+    it('should not let arguments override the command name', async () => {
+      await request(app)
+        .post('/api/status/devices/ESP32_TEST/command')
+        .send({ command: 'stream', args: { command: 'reset', enabled: true } })
+        .expect(200);
+
+      expect(publish).toHaveBeenCalledWith('earthquake/command/ESP32_TEST', { command: 'stream', enabled: true });
+    });
+
+    it('should reject a missing command', async () => {
+      const response = await request(app)
+        .post('/api/status/devices/ESP32_TEST/command')
+        .send({})
+        .expect(400);
+
+      expect(response.body.success).toBe(false);
+      expect(publish).not.toHaveBeenCalled();
+    });
+
+    it('should reject non-object arguments', async () => {
+      await request(app)
+        .post('/api/status/devices/ESP32_TEST/command')
+        .send({ command: 'thresholds', args: [6, 2] })
+        .expect(400);
+
+      expect(publish).not.toHaveBeenCalled();
+    });
+
+    it('should reject nested argument values the device cannot parse', async () => {
+      await request(app)
+        .post('/api/status/devices/ESP32_TEST/command')
+        .send({ command: 'thresholds', args: { trigger: { value: 6 }, detrigger: 2 } })
+        .expect(400);
+
+      expect(publish).not.toHaveBeenCalled();
+    });
+  });
+
+  describe('POST /api/status/devices/command', () => {
+    it('should broadcast the command to every device', async () => {
+      const response = await request(app)
+        .post('/api/status/devices/command')
+        .send({ command: 'metrics' })
+        .expect(200);
+
+      expect(response.body.message).toContain('all devices');
+      expect(publish).toHaveBeenCalledWith('earthquake/command/all', { command: 'metrics' });
+    });
+  });
+});
@@ -1,6 +1,7 @@
 import { AlertService } from '../../src/services/alert.service';
 import { DatabaseService } from '../../src/services/database.service';
 import { EarthquakeAlert } from '../../src/services/mqtt.service';
+import { NetworkEvent } from '../../src/services/coincidence.service';
 import winston from 'winston';
 
 const mockLogger = winston.createLogger({
@@ -136,6 +137,38 @@ describe('AlertService', () => {
     });
   });
 
+  describe('processNetworkEvent', () => {
+    const event: NetworkEvent = {
+      event_id: 'net_test',
+      origin_time: Date.now() - 1500,
+      confirmed_at: Date.now(),
+      location: { lat: 37.7749, lon: -122.4194 },
+      stations: ['ESP32_A', 'ESP32_B', 'ESP32_C'],
+      candidates: 4,
+      magnitude: 5.5,
+      pga: 0.2,
+      alert_level: 'STRONG',
+      damaging: false
+    };
+
+    it('should notify once per network event however many stations report it', async () => {
+      expect(await alertService.processNetworkEvent(event)).toBe(true);
+      expect(await alertService.processNetworkEvent({ ...event, stations: [...event.stations, 'ESP32_D'] }))
+        .toBe(false);
+
+      const stored = await alertService.getNetworkEvents();
+      expect(stored).toHaveLength(1);
+      expect(stored[0].stations).toHaveLength(4);
+    });
+
+    it('should hold notifications until the event is strong or damaging', async () => {
+      const weak = { ...event, event_id: 'net_weak', alert_level: 'LIGHT', pga: 0.04 };
+
+      expect(await alertService.processNetworkEvent(weak)).toBe(false);
+      expect(await alertService.processNetworkEvent({ ...weak, damaging: true })).toBe(true);
+    });
+  });
+
   describe('getAlertStats', () => {
     it('should return statistics', async () => {
       const stats = await alertService.getAlertStats();
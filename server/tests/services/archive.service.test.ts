@@ -0,0 +1,142 @@
+import { promises as fs } from 'fs';
+import os from 'os';
+import path from 'path';
+import {
+  ArchiveService,
+  ARCHIVE_META_FILE,
+  archiveDeviceDirectory,
+  chunkName
+} from '../../src/services/archive.service';
+import { IngestBatch, SensorCapture, WaveformBlock } from '../../src/services/ingest.service';
+import winston from 'winston';
+
+const mockLogger = winston.createLogger({
+  silent: true
+});
+
+const SYNCED_US = 1700000000000000;
+
+function block(deviceId: string, timestampUs: number, samples: number[][], sampleRate: number = 100): WaveformBlock {
+  return {
+    device_id: deviceId,
+    timestamp: Math.floor(timestampUs / 1000),
+    timestamp_us: timestampUs,
+    clock_synced: timestampUs >= SYNCED_US,
+    sample_rate: sampleRate,
+    scale: 0.001,
+    sample_count: samples.length,
+    counts: Int16Array.from(samples.flat())
+  };
+}
+
+function batch(waveforms: WaveformBlock[], captures: SensorCapture[] = []): IngestBatch {
+  return { waveforms, data: [], statuses: [], captures };
+}
+
+async function readChunk(directory: string) {
+  const meta = JSON.parse(await fs.readFile(path.join(directory, ARCHIVE_META_FILE), 'utf8'));
+  const timestamps = await fs.readFile(path.join(directory, 'timestamp_us.i64'));
+  const axes = await Promise.all(['x.i16', 'y.i16', 'z.i16'].map(column => fs.readFile(path.join(directory, column))));
+
+  return {
+    meta,
+    timestamps: Array.from({ length: timestamps.length / 8 }, (_, i) => Number(timestamps.readBigInt64LE(i * 8))),
+    axes: axes.map(column => Array.from({ length: column.length / 2 }, (_, i) => column.readInt16LE(i * 2)))
+  };
+}
+
+describe('ArchiveService', () => {
+  let root: string;
+
+  beforeEach(async () => {
+    root = await fs.mkdtemp(path.join(os.tmpdir(), 'eqarchive-'));
+  });
+
+  afterEach(async () => {
+    await fs.rm(root, { recursive: true, force: true });
+  });
+
+  it('should append contiguous blocks to one columnar stream chunk', async () => {
+    const archive = new ArchiveService(root, mockLogger);
+
+    await archive.writeBatch(batch([block('ESP32_A', SYNCED_US, [[1, 2, 3], [4, 5, 6]])]));
+    await archive.writeBatch(batch([block('ESP32_A', SYNCED_US + 20000, [[7, 8, 9]])]));
+
+    const chunks = await fs.readdir(path.join(root, 'ESP32_A', 'stream'));
+    expect(chunks).toEqual([chunkName(SYNCED_US)]);
+
+    const chunk = await readChunk(path.join(root, 'ESP32_A', 'stream', chunks[0]));
+    expect(chunk.meta).toMatchObject({
+      format: 'eqarchive',
+      version: 1,
+      device_id: 'ESP32_A',
+      kind: 'stream',
+      sample_rate: 100,
+      clock_synced: true,
+      first_timestamp_us: SYNCED_US
+    });
+    expect(chunk.timestamps).toEqual([SYNCED_US, SYNCED_US + 10000, SYNCED_US + 20000]);
+    expect(chunk.axes).toEqual([[1, 4, 7], [2, 5, 8], [3, 6, 9]]);
+    expect(archive.getStats()).toEqual({ chunks: 1, samples: 3, failed: 0 });
+  });
+
+  it('should roll to a new chunk when the stream restarts or fills up', async () => {
+    const archive = new ArchiveService(root, mockLogger, { chunkSamples: 2 });
+
+    await archive.writeBatch(batch([
+      block('ESP32_A', SYNCED_US, [[1, 1, 1], [2, 2, 2]]),
+      block('ESP32_A', SYNCED_US + 20000, [[3, 3, 3]]),
+      block('ESP32_A', 5000000, [[4, 4, 4]])
+    ]));
+
+    const chunks = (await fs.readdir(path.join(root, 'ESP32_A', 'stream'))).sort();
+    expect(chunks).toEqual([chunkName(5000000), chunkName(SYNCED_US), chunkName(SYNCED_US + 20000)]);
+
+    const boot = await readChunk(path.join(root, 'ESP32_A', 'stream', chunks[0]));
+    expect(boot.meta.clock_synced).toBe(false);
+    expect(boot.axes[0]).toEqual([4]);
+  });
+
+  it('should write each capture as its own chunk', async () => {
+    const capture: SensorCapture = {
+      device_id: 'ESP32/B',
+      capture_id: 7,
+      truncated: false,
+      manual: true,
+      sample_rate: 100,
+      scale: 0.001,
+      trigger_time: Math.floor((SYNCED_US + 10000) / 1000),
+      first_timestamp: Math.floor(SYNCED_US / 1000),
+      trigger_time_us: SYNCED_US + 10000,
+      first_timestamp_us: SYNCED_US,
+      clock_synced: true,
+      sample_count: 2,
+      pre_trigger_samples: 1,
+      counts: Int16Array.from([1, 2, 3, 4, 5, 6])
+    };
+    const archive = new ArchiveService(root, mockLogger);
+
+    expect(await archive.writeBatch(batch([], [capture]))).toBe(2);
+
+    expect(archiveDeviceDirectory('ESP32/B')).toBe('ESP32_B');
+    const chunk = await readChunk(path.join(root, 'ESP32_B', 'capture', chunkName(SYNCED_US + 10000, 7)));
+    expect(chunk.meta).toMatchObject({
+      kind: 'capture',
+      device_id: 'ESP32/B',
+      capture_id: 7,
+      trigger_time_us: SYNCED_US + 10000,
+      pre_trigger_samples: 1,
+      manual: true
+    });
+    expect(chunk.axes).toEqual([[1, 4], [2, 5], [3, 6]]);
+  });
+
+  it('should count failed writes without throwing', async () => {
+    const file = path.join(root, 'blocked');
+    await fs.writeFile(file, '');
+    const archive = new ArchiveService(file, mockLogger);
+
+    expect(await archive.writeBatch(batch([block('ESP32_A', SYNCED_US, [[1, 2, 3]])]))).toBe(0);
+    expect(archive.getStats()).toMatchObject({ samples: 0, failed: 1 });
+  });
+});
@@ -0,0 +1,205 @@
+import {
+  CoincidenceService,
+  StationTrigger,
+  distanceKm,
+  triggerFromAlert,
+  triggerFromPreliminary
+} from '../../src/services/coincidence.service';
+import { EarthquakeAlert, PreliminaryAlert } from '../../src/services/mqtt.service';
+import winston from 'winston';
+
+const mockLogger = winston.createLogger({
+  silent: true
+});
+
+const ORIGIN = { lat: 37.7749, lon: -122.4194 };
+const NOW = 1700000000000;
+
+function trigger(deviceId: string, dLat: number, dLon: number, onset: number, pga: number = 0.01): StationTrigger {
+  return {
+    device_id: deviceId,
+    location: { lat: ORIGIN.lat + dLat, lon: ORIGIN.lon + dLon },
+    onset,
+    pga,
+    magnitude: 5.0,
+    alert_level: pga >= 0.15 ? 'STRONG' : 'NEGLIGIBLE',
+    damaging: false
+  };
+}
+
+describe('CoincidenceService', () => {
+  let service: CoincidenceService;
+
+  beforeEach(() => {
+    service = new CoincidenceService(mockLogger);
+  });
+
+  describe('distanceKm', () => {
+    it('should measure great-circle distance', () => {
+      expect(distanceKm(ORIGIN, ORIGIN)).toBe(0);
+      expect(distanceKm({ lat: 0, lon: 179.9 }, { lat: 0, lon: -179.9 })).toBeCloseTo(22.2, 1);
+    });
+  });
+
+  describe('associate', () => {
+    it('should not confirm on a single station', () => {
+      const result = service.associate(trigger('A', 0, 0, NOW), NOW);
+
+      expect(result).toEqual({ event: null, created: false });
+    });
+
+    it('should confirm once K nearby stations trigger inside the travel-time window', () => {
+      service.associate(trigger('A', 0, 0, NOW), NOW);
+      service.associate(trigger('B', 0.05, 0, NOW + 800), NOW + 800);
+      const result = service.associate(trigger('C', 0, 0.05, NOW + 1200), NOW + 1200);
+
+      expect(result.created).toBe(true);
+      expect(result.event!.stations.sort()).toEqual(['A', 'B', 'C']);
+      expect(result.event!.origin_time).toBe(NOW);
+      expect(result.event!.candidates).toBe(3);
+      expect(distanceKm(result.event!.location, ORIGIN)).toBeLessThan(5);
+    });
+
+    it('should ignore triggers that arrive outside the travel-time window', () => {
+      service.associate(trigger('A', 0, 0, NOW), NOW);
+      service.associate(trigger('B', 0.05, 0, NOW + 30000), NOW + 30000);
+      const result = service.associate(trigger('C', 0, 0.05, NOW + 60000), NOW + 60000);
+
+      expect(result.event).toBeNull();
+    });
+
+    it('should ignore stations beyond the association radius', () => {
+      service.associate(trigger('A', 0, 0, NOW), NOW);
+      service.associate(trigger('B', 1.0, 0, NOW + 500), NOW + 500);
+      const result = service.associate(trigger('C', 0, 1.0, NOW + 1000), NOW + 1000);
+
+      expect(result.event).toBeNull();
+    });
+
+    it('should only count the N nearest stations', () => {
+      const narrow = new CoincidenceService(mockLogger, { nearestStations: 3 });
+      narrow.registerStation('NEAR_1', { lat: ORIGIN.lat + 0.01, lon: ORIGIN.lon });
+      narrow.registerStation('NEAR_2', { lat: ORIGIN.lat - 0.01, lon: ORIGIN.lon });
+
+      narrow.associate(trigger('FAR_1', 0.1, 0, NOW), NOW);
+      narrow.associate(trigger('FAR_2', -0.1, 0, NOW + 100), NOW + 100);
+      const result = narrow.associate(trigger('A', 0, 0, NOW + 200), NOW + 200);
+
+      expect(result.event).toBeNull();
+    });
+
+    it('should attach later triggers to the existing event instead of creating another', () => {
+      service.associate(trigger('A', 0, 0, NOW), NOW);
+      service.associate(trigger('B', 0.05, 0, NOW + 500), NOW + 500);
+      const created = service.associate(trigger('C', 0, 0.05, NOW + 700), NOW + 700);
+
+      const later = service.associate(trigger('D', -0.05, 0, NOW + 1500, 0.2), NOW + 1500);
+      const repeat = service.associate(trigger('A', 0, 0, NOW, 0.3), NOW + 6000);
+
+      expect(later.created).toBe(false);
+      expect(later.event!.event_id).toBe(created.event!.event_id);
+      expect(repeat.event!.stations).toHaveLength(4);
+      expect(repeat.event!.pga).toBe(0.3);
+      expect(repeat.event!.alert_level).toBe('STRONG');
+      expect(service.getActiveEvents()).toHaveLength(1);
+    });
+
+    it('should skip stations without a configured location', () => {
+      const result = service.associate({ ...trigger('A', 0, 0, NOW), location: { lat: 0, lon: 0 } }, NOW);
+
+      expect(result.event).toBeNull();
+      expect(service.getStationCount()).toBe(0);
+    });
+
+    it('should expire events after the event window', () => {
+      service.associate(trigger('A', 0, 0, NOW), NOW);
+      service.associate(trigger('B', 0.05, 0, NOW + 500), NOW + 500);
+      service.associate(trigger('C', 0, 0.05, NOW + 700), NOW + 700);
+
+      service.associate(trigger('D', 5, 5, NOW + 200000), NOW + 200000);
+
+      expect(service.getActiveEvents()).toHaveLength(0);
+    });
+  });
+
+  describe('canCorroborate', () => {
+    it('should report whether enough registered stations are nearby to confirm an event', () => {
+      service.associate(trigger('A', 0, 0, NOW), NOW);
+      service.associate(trigger('B', 0.05, 0, NOW + 60000), NOW + 60000);
+
+      expect(service.canCorroborate('A')).toBe(false);
+
+      service.registerStation('C', { lat: ORIGIN.lat, lon: ORIGIN.lon + 0.05 });
+
+      expect(service.canCorroborate('A')).toBe(true);
+      expect(service.canCorroborate('unknown')).toBe(false);
+    });
+
+    it('should not count stations beyond the association radius', () => {
+      service.registerStation('A', ORIGIN);
+      service.registerStation('B', { lat: ORIGIN.lat + 1, lon: ORIGIN.lon });
+      service.registerStation('C', { lat: ORIGIN.lat, lon: ORIGIN.lon + 1 });
+
+      expect(service.canCorroborate('A')).toBe(false);
+    });
+  });
+
+  describe('trigger conversion', () => {
+    it('should estimate onset on the server clock from device-relative times', () => {
+      const preliminary: PreliminaryAlert = {
+        device_id: 'A', timestamp: 50600, onset_time: 50000, latency_ms: 600, window: 0.5, update: 1,
+        tau_c: 0.8, pd: 0.1, magnitude_estimate: 5.2, pga: 0.01, alert_level: 'NEGLIGIBLE', damaging: false,
+        location: ORIGIN
+      };
+      const alert: EarthquakeAlert = {
+        device_id: 'A',
+        timestamp: 64000,
+        event: {
+          magnitude: 4.8, pga: 0.05, pgv: 1, cav: 0.1, duration: 8000,
+          alert_level: 'LIGHT', confirmed: true, start_time: 50000
+        },
+        location: ORIGIN
+      };
+
+      expect(triggerFromPreliminary(preliminary, NOW).onset).toBe(NOW - 600);
+      expect(triggerFromAlert(alert, NOW).onset).toBe(NOW - 14000);
+    });
+
+    it('should use the absolute onset when the device clock is synchronized', () => {
+      const preliminary: PreliminaryAlert = {
+        device_id: 'A', timestamp: NOW - 2500, timestamp_us: (NOW - 2500) * 1000, clock_synced: true,
+        onset_time: NOW - 3000, onset_time_us: (NOW - 3000) * 1000 + 250, latency_ms: 500, window: 0.5, update: 1,
+        tau_c: 0.8, pd: 0.1, magnitude_estimate: 5.2, pga: 0.01, alert_level: 'NEGLIGIBLE', damaging: false,
+        location: ORIGIN
+      };
+      const alert: EarthquakeAlert = {
+        device_id: 'A',
+        timestamp: NOW - 1000,
+        clock_synced: true,
+        event: {
+          magnitude: 4.8, pga: 0.05, pgv: 1, cav: 0.1, duration: 8000,
+          alert_level: 'LIGHT', confirmed: true, start_time: NOW - 9000, start_time_us: (NOW - 9000) * 1000
+        },
+        location: ORIGIN
+      };
+
+      expect(triggerFromPreliminary(preliminary, NOW).onset).toBe(NOW - 2999.75);
+      expect(triggerFromAlert(alert, NOW).onset).toBe(NOW - 9000);
+    });
+
+    it('should ignore absolute onsets from unsynchronized devices', () => {
+      const alert: EarthquakeAlert = {
+        device_id: 'A',
+        timestamp: 64000,
+        clock_synced: false,
+        event: {
+          magnitude: 4.8, pga: 0.05, pgv: 1, cav: 0.1, duration: 8000,
+          alert_level: 'LIGHT', confirmed: true, start_time: 50000, start_time_us: 50000000
+        },
+        location: ORIGIN
+      };
+
+      expect(triggerFromAlert(alert, NOW).onset).toBe(NOW - 14000);
+    });
+  });
+});
@@ -1,11 +1,36 @@
 import { DatabaseService } from '../../src/services/database.service';
-import { EarthquakeAlert, DeviceStatus } from '../../src/services/mqtt.service';
+import { EarthquakeAlert, DeviceStatus, DeviceMetrics, LatencyHistogram } from '../../src/services/mqtt.service';
 import winston from 'winston';
 
 const mockLogger = winston.createLogger({
   silent: true
 });
 
+const BOUNDS_US = [2, 5, 10, 20, 50, 100, 200, 500, 1000, 5000, 20000];
+
+function histogram(buckets: number[], max: number): LatencyHistogram {
+  const n = buckets.reduce((sum, count) => sum + count, 0);
+  return { n, avg: 0, p50: 0, p99: max, max, h: buckets };
+}
+
+function metrics(detectorBuckets: number[], detectorMax: number): DeviceMetrics {
+  const empty = new Array(12).fill(0);
+  return {
+    window_ms: 60000,
+    samples: 6000,
+    dropped: 0,
+    fifo_overflows: 0,
+    queue_drops: 0,
+    heap: { free: 150000, min_free: 120000, largest: 110000, frag: 27 },
+    bounds_us: BOUNDS_US,
+    stages: {
+      sensor_read: histogram(empty, 0),
+      detector: histogram(detectorBuckets, detectorMax)
+    },
+    jitter: histogram(empty, 0)
+  };
+}
+
 describe('DatabaseService', () => {
   let databaseService: DatabaseService;
 
@@ -182,6 +207,58 @@ describe('DatabaseService', () => {
     });
   });
 
+  describe('device metrics', () => {
+    it('should keep the latest metrics on the device and a history', async () => {
+      const device_id = 'ESP32_METRICS_TEST';
+      const first = metrics([0, 0, 6000, 0, 0, 0, 0, 0, 0, 0, 0, 0], 9);
+      const second = metrics([0, 0, 5990, 10, 0, 0, 0, 0, 0, 0, 0, 0], 18);
+
+      await databaseService.updateDeviceStatus({ device_id, status: 'monitoring', timestamp: Date.now(), metrics: first });
+      await databaseService.updateDeviceStatus({ device_id, status: 'monitoring', timestamp: Date.now(), metrics: second });
+      await databaseService.updateDeviceStatus({ device_id, status: 'alive', timestamp: Date.now() });
+
+      const device = await databaseService.getDeviceStatus(device_id);
+      expect(device?.status).toBe('alive');
+      expect(device?.metrics?.stages.detector.max).toBe(18);
+
+      const history = await databaseService.getDeviceMetrics(device_id);
+      expect(history).toHaveLength(2);
+      expect(history[0].stages.detector.max).toBe(18);
+      expect(history[1].stages.detector.max).toBe(9);
+    });
+
+    it('should return no metrics for unknown devices', async () => {
+      expect(await databaseService.getDeviceMetrics('UNKNOWN')).toEqual([]);
+    });
+
+    it('should merge stage histograms across the fleet', async () => {
+      await databaseService.updateDeviceStatus({
+        device_id: 'FAST_DEVICE',
+        status: 'monitoring',
+        timestamp: Date.now(),
+        metrics: metrics([0, 0, 990, 0, 0, 0, 0, 0, 0, 0, 0, 0], 10)
+      });
+      await databaseService.updateDeviceStatus({
+        device_id: 'SLOW_DEVICE',
+        status: 'monitoring',
+        timestamp: Date.now(),
+        metrics: metrics([0, 0, 0, 0, 0, 0, 10, 0, 0, 0, 0, 0], 180)
+      });
+
+      const summary = await databaseService.getStageLatencySummary();
+      const detector = summary.find(s => s.stage === 'detector');
+
+      expect(detector).toBeDefined();
+      expect(detector?.devices).toBe(2);
+      expect(detector?.count).toBe(1000);
+      expect(detector?.p50).toBe(10);
+      expect(detector?.p99).toBe(10);
+      expect(detector?.max).toBe(180);
+      expect(detector?.worstDevice).toBe('SLOW_DEVICE');
+      expect(summary.some(s => s.stage === 'jitter')).toBe(true);
+    });
+  });
+
   describe('getAllDevices', () => {
     it('should return all devices', async () => {
       await databaseService.updateDeviceStatus({
@@ -0,0 +1,315 @@
+import {
+  IngestService,
+  DeviceActivity,
+  SensorCapture,
+  CAPTURE_MAGIC,
+  decodeCapture,
+  decodeWaveformBlock
+} from '../../src/services/ingest.service';
+import { DatabaseService } from '../../src/services/database.service';
+import { ArchiveService } from '../../src/services/archive.service';
+import { DeviceStatus } from '../../src/services/mqtt.service';
+import winston from 'winston';
+
+const mockLogger = winston.createLogger({
+  silent: true
+});
+
+const SCALE = 0.001;
+
+function varint(value: number): number[] {
+  const bytes: number[] = [];
+  while (value >= 0x80) {
+    bytes.push((value & 0x7f) | 0x80);
+    value >>>= 7;
+  }
+  bytes.push(value);
+  return bytes;
+}
+
+function encodeWaveform(samples: number[][], timestamp: number, sampleRate: number = 100): Buffer {
+  const header = Buffer.alloc(14);
+  header.writeUInt8(1, 0);
+  header.writeUInt8(0x01, 1);
+  header.writeUInt16LE(samples.length, 2);
+  header.writeUInt16LE(sampleRate, 4);
+  header.writeFloatLE(SCALE, 6);
+  header.writeUInt32LE(timestamp, 10);
+
+  const body: number[] = [];
+  for (let axis = 0; axis < 3; axis++) {
+    let previous = 0;
+    for (const sample of samples) {
+      const delta = sample[axis] - previous;
+      body.push(...varint(((delta << 1) ^ (delta >> 31)) >>> 0));
+      previous = sample[axis];
+    }
+  }
+  return Buffer.concat([header, Buffer.from(body)]);
+}
+
+function encodeWaveformV2(samples: number[][], timestampUs: number): Buffer {
+  const legacy = encodeWaveform(samples, 0);
+  const header = Buffer.alloc(18);
+  legacy.copy(header, 0, 0, 10);
+  header.writeUInt8(2, 0);
+  header.writeBigUInt64LE(BigInt(timestampUs), 10);
+  return Buffer.concat([header, legacy.subarray(14)]);
+}
+
+function encodeCapture(captureId: number, samples: number[][]): Buffer {
+  const capture = Buffer.alloc(32 + samples.length * 6);
+  capture.writeUInt32LE(CAPTURE_MAGIC, 0);
+  capture.writeUInt8(1, 4);
+  capture.writeUInt8(0x02, 5);
+  capture.writeUInt16LE(100, 6);
+  capture.writeFloatLE(SCALE, 8);
+  capture.writeUInt32LE(captureId, 12);
+  capture.writeUInt32LE(50000, 16);
+  capture.writeUInt32LE(45000, 20);
+  capture.writeUInt32LE(samples.length, 24);
+  capture.writeUInt32LE(1, 28);
+  samples.forEach((sample, i) => {
+    sample.forEach((count, axis) => capture.writeInt16LE(count, 32 + (i * 3 + axis) * 2));
+  });
+  return capture;
+}
+
+function encodeCaptureV2(captureId: number, samples: number[][], triggerUs: number, firstUs: number): Buffer {
+  const legacy = encodeCapture(captureId, samples);
+  const header = Buffer.alloc(40);
+  legacy.copy(header, 0, 0, 16);
+  header.writeUInt8(2, 4);
+  header.writeUInt32LE(samples.length, 16);
+  header.writeUInt32LE(1, 20);
+  header.writeBigUInt64LE(BigInt(triggerUs), 24);
+  header.writeBigUInt64LE(BigInt(firstUs), 32);
+  return Buffer.concat([header, legacy.subarray(32)]);
+}
+
+function captureChunk(captureId: number, capture: Buffer, offset: number, length: number): Buffer {
+  const header = Buffer.alloc(16);
+  const final = offset + length >= capture.length;
+  header.writeUInt8(1, 0);
+  header.writeUInt8(final ? 0x01 : 0, 1);
+  header.writeUInt32LE(captureId, 4);
+  header.writeUInt32LE(offset, 8);
+  header.writeUInt32LE(capture.length, 12);
+  return Buffer.concat([header, capture.subarray(offset, offset + length)]);
+}
+
+function status(deviceId: string): DeviceStatus {
+  return { device_id: deviceId, status: 'monitoring', timestamp: Date.now() };
+}
+
+describe('IngestService', () => {
+  let databaseService: DatabaseService;
+
+  beforeEach(async () => {
+    databaseService = new DatabaseService(mockLogger);
+    await databaseService.connect();
+  });
+
+  describe('decodeWaveformBlock', () => {
+    it('should decode zigzag varint deltas across the full 16-bit range', () => {
+      const samples = [[0, 5, -7], [1000, -1000, 3], [-32768, 32767, 0], [32767, -32768, 1]];
+
+      const block = decodeWaveformBlock('ESP32_A', encodeWaveform(samples, 123456));
+
+      expect(block.device_id).toBe('ESP32_A');
+      expect(block.timestamp).toBe(123456);
+      expect(block.timestamp_us).toBe(123456000);
+      expect(block.clock_synced).toBe(false);
+      expect(block.sample_rate).toBe(100);
+      expect(block.scale).toBeCloseTo(SCALE);
+      expect(Array.from(block.counts)).toEqual(samples.flat());
+    });
+
+    it('should decode 64-bit microsecond timestamps from v2 blocks', () => {
+      const samples = [[1, 2, 3], [4, 5, 6]];
+
+      const block = decodeWaveformBlock('ESP32_A', encodeWaveformV2(samples, 1700000000123456));
+
+      expect(block.timestamp_us).toBe(1700000000123456);
+      expect(block.timestamp).toBe(1700000000123);
+      expect(block.clock_synced).toBe(true);
+      expect(Array.from(block.counts)).toEqual(samples.flat());
+    });
+
+    it('should reject truncated blocks and unknown versions', () => {
+      const payload = encodeWaveform([[1, 2, 3], [4, 5, 6]], 0);
+      const future = Buffer.from(payload);
+      future.writeUInt8(9, 0);
+
+      expect(() => decodeWaveformBlock('ESP32_A', payload.subarray(0, payload.length - 1))).toThrow();
+      expect(() => decodeWaveformBlock('ESP32_A', future)).toThrow(/version/);
+      expect(() => decodeWaveformBlock('ESP32_A', Buffer.concat([payload, Buffer.from([0])]))).toThrow(/trailing/);
+    });
+  });
+
+  describe('decodeCapture', () => {
+    it('should read v2 headers with UTC microsecond trigger times', () => {
+      const capture = decodeCapture('ESP32_A', encodeCaptureV2(3, [[1, 2, 3], [4, 5, 6]], 1700000000500000, 1700000000490000));
+
+      expect(capture).toMatchObject({
+        capture_id: 3,
+        sample_count: 2,
+        pre_trigger_samples: 1,
+        trigger_time: 1700000000500,
+        trigger_time_us: 1700000000500000,
+        first_timestamp_us: 1700000000490000,
+        clock_synced: true
+      });
+      expect(Array.from(capture.counts)).toEqual([1, 2, 3, 4, 5, 6]);
+    });
+
+    it('should still accept v1 captures with boot-relative millisecond times', () => {
+      const capture = decodeCapture('ESP32_A', encodeCapture(3, [[1, 2, 3]]));
+
+      expect(capture).toMatchObject({ trigger_time: 50000, trigger_time_us: 50000000, clock_synced: false });
+    });
+  });
+
+  describe('batching', () => {
+    it('should write every device in one batch per flush', async () => {
+      const ingest = new IngestService(databaseService, mockLogger);
+      const saveBatch = jest.spyOn(databaseService, 'saveIngestBatch');
+
+      for (let device = 0; device < 50; device++) {
+        ingest.ingestWaveform(`ESP32_${device}`, encodeWaveform([[device, 0, 1000]], device * 1000));
+        ingest.ingestStatus(status(`ESP32_${device}`));
+      }
+
+      expect(await ingest.flush()).toBe(100);
+      expect(saveBatch).toHaveBeenCalledTimes(1);
+      expect(ingest.getQueuedCount()).toBe(0);
+      expect(await databaseService.getAllDevices()).toHaveLength(50);
+
+      const [block] = await databaseService.getWaveforms('ESP32_7');
+      expect(Array.from(block.counts)).toEqual([7, 0, 1000]);
+    });
+
+    it('should split large backlogs into fair batches', async () => {
+      const ingest = new IngestService(databaseService, mockLogger, { maxBatchSize: 10 });
+      const sizes: number[] = [];
+      jest.spyOn(databaseService, 'saveIngestBatch').mockImplementation(async (batch) => {
+        sizes.push(batch.waveforms.length);
+        if (sizes.length === 1) {
+          expect(new Set(batch.waveforms.map(block => block.device_id)).size).toBe(2);
+        }
+      });
+
+      for (let i = 0; i < 20; i++) {
+        ingest.ingestWaveform('ESP32_BUSY', encodeWaveform([[i, 0, 0]], i * 10));
+      }
+      ingest.ingestWaveform('ESP32_QUIET', encodeWaveform([[1, 1, 1]], 0));
+
+      expect(await ingest.flush()).toBe(21);
+      expect(sizes).toEqual([10, 10, 1]);
+    });
+
+    it('should keep only the newest records when a device overruns its queue', async () => {
+      const ingest = new IngestService(databaseService, mockLogger, { queueCapacity: 3 });
+
+      for (let i = 0; i < 5; i++) {
+        ingest.ingestWaveform('ESP32_A', encodeWaveform([[i, 0, 0]], i * 1000));
+      }
+      await ingest.flush();
+
+      expect(ingest.getStats().dropped).toBe(2);
+      const blocks = await databaseService.getWaveforms('ESP32_A');
+      expect(blocks.map(block => block.timestamp)).toEqual([4000, 3000, 2000]);
+    });
+
+    it('should count malformed payloads without queueing them', () => {
+      const ingest = new IngestService(databaseService, mockLogger);
+
+      expect(ingest.ingestWaveform('ESP32_A', Buffer.from([1, 1, 0]))).toBe(false);
+      expect(ingest.getStats()).toMatchObject({ malformed: 1, queued: 0 });
+    });
+
+    it('should report failed batches instead of throwing', async () => {
+      const ingest = new IngestService(databaseService, mockLogger);
+      jest.spyOn(databaseService, 'saveIngestBatch').mockRejectedValue(new Error('disk full'));
+
+      ingest.ingestStatus(status('ESP32_A'));
+
+      expect(await ingest.flush()).toBe(0);
+      expect(ingest.getStats().failed).toBe(1);
+    });
+
+    it('should archive waveforms only after the database write succeeds', async () => {
+      const archive = new ArchiveService('unused', mockLogger);
+      const writeBatch = jest.spyOn(archive, 'writeBatch').mockResolvedValue(1);
+      const ingest = new IngestService(databaseService, mockLogger, {}, archive);
+
+      ingest.ingestWaveform('ESP32_A', encodeWaveformV2([[1, 2, 3]], 1700000000000000));
+      await ingest.flush();
+
+      expect(writeBatch).toHaveBeenCalledTimes(1);
+      expect(writeBatch.mock.calls[0][0].waveforms).toHaveLength(1);
+
+      jest.spyOn(databaseService, 'saveIngestBatch').mockRejectedValue(new Error('disk full'));
+      ingest.ingestWaveform('ESP32_A', encodeWaveformV2([[4, 5, 6]], 1700000000010000));
+      await ingest.flush();
+
+      expect(writeBatch).toHaveBeenCalledTimes(1);
+    });
+  });
+
+  describe('publishUpdates', () => {
+    it('should coalesce samples into one update per device', () => {
+      const ingest = new IngestService(databaseService, mockLogger);
+      const updates: DeviceActivity[][] = [];
+      ingest.on('update', (batch: DeviceActivity[]) => updates.push(batch));
+
+      ingest.ingestWaveform('ESP32_A', encodeWaveform([[0, 0, 1000], [-250, 0, 1000]], 10000));
+      ingest.ingestWaveform('ESP32_A', encodeWaveform([[10, 20, 990]], 10020));
+      ingest.ingestData({ device_id: 'ESP32_B', timestamp: 5, acceleration: { x: 0.1, y: 0, z: 1 } });
+      ingest.publishUpdates();
+      ingest.publishUpdates();
+
+      expect(updates).toHaveLength(1);
+      const [a, b] = updates[0];
+      expect(a.samples).toBe(3);
+      expect(a.timestamp).toBe(10020);
+      expect(a.latest.z).toBeCloseTo(0.99);
+      expect(a.peak).toBeCloseTo(1.0);
+      expect(b.device_id).toBe('ESP32_B');
+    });
+  });
+
+  describe('ingestCaptureChunk', () => {
+    const samples = Array.from({ length: 200 }, (_, i) => [i, -i, 1000 + i]);
+    const capture = encodeCapture(7, samples);
+
+    it('should reassemble chunks into a capture, tolerating resent chunks', async () => {
+      const ingest = new IngestService(databaseService, mockLogger);
+      const completed: SensorCapture[] = [];
+      ingest.on('capture', (received: SensorCapture) => completed.push(received));
+
+      expect(ingest.ingestCaptureChunk('ESP32_A', captureChunk(7, capture, 0, 512))).toBe(true);
+      expect(ingest.ingestCaptureChunk('ESP32_A', captureChunk(7, capture, 512, 512))).toBe(true);
+      expect(ingest.ingestCaptureChunk('ESP32_A', captureChunk(7, capture, 512, 512))).toBe(true);
+      expect(completed).toHaveLength(0);
+      expect(ingest.ingestCaptureChunk('ESP32_A', captureChunk(7, capture, 1024, 512))).toBe(true);
+
+      expect(completed).toHaveLength(1);
+      expect(completed[0]).toMatchObject({ capture_id: 7, manual: true, sample_count: 200, trigger_time: 50000 });
+      expect(Array.from(completed[0].counts.subarray(597))).toEqual([199, -199, 1199]);
+
+      await ingest.flush();
+      expect(await databaseService.getCaptures('ESP32_A')).toHaveLength(1);
+      expect(ingest.getStats().pending_captures).toBe(0);
+    });
+
+    it('should discard a capture when a chunk is missing', () => {
+      const ingest = new IngestService(databaseService, mockLogger);
+
+      ingest.ingestCaptureChunk('ESP32_A', captureChunk(7, capture, 0, 512));
+
+      expect(ingest.ingestCaptureChunk('ESP32_A', captureChunk(7, capture, 1024, 512))).toBe(false);
+      expect(ingest.getStats().pending_captures).toBe(0);
+    });
+  });
+});
@@ -0,0 +1,131 @@
+import {
+  MQTTService,
+  EarthquakeAlert,
+  EarthquakeAlertBatch,
+  PreliminaryAlert,
+  expandAlertBatch
+} from '../../src/services/mqtt.service';
+import winston from 'winston';
+
+const mockLogger = winston.createLogger({
+  silent: true
+});
+
+const batch: EarthquakeAlertBatch = {
+  device_id: 'ESP32_BATCH_TEST',
+  timestamp: 123456,
+  events: [
+    {
+      magnitude: 3.1,
+      pga: 0.02,
+      pgv: 0.5,
+      cav: 0.01,
+      duration: 4000,
+      alert_level: 'WEAK',
+      confirmed: true,
+      start_time: 100000
+    },
+    {
+      magnitude: 4.8,
+      pga: 0.12,
+      pgv: 2.1,
+      cav: 0.2,
+      duration: 9000,
+      alert_level: 'MODERATE',
+      confirmed: true,
+      start_time: 110000
+    }
+  ],
+  location: {
+    lat: 37.7749,
+    lon: -122.4194
+  }
+};
+
+describe('MQTTService', () => {
+  describe('expandAlertBatch', () => {
+    it('should expand each batched event into a standalone alert', () => {
+      const alerts = expandAlertBatch(batch);
+
+      expect(alerts).toHaveLength(2);
+      expect(alerts[0].device_id).toBe('ESP32_BATCH_TEST');
+      expect(alerts[0].location).toEqual(batch.location);
+      expect(alerts[1].event.magnitude).toBe(4.8);
+      expect(alerts[1].event.alert_level).toBe('MODERATE');
+    });
+
+    it('should return no alerts for an empty batch', () => {
+      expect(expandAlertBatch({ ...batch, events: [] })).toEqual([]);
+    });
+  });
+
+  describe('handleMessage', () => {
+    let service: MQTTService;
+    let alerts: EarthquakeAlert[];
+
+    beforeEach(() => {
+      service = new MQTTService('mqtt://localhost:1883', mockLogger);
+      alerts = [];
+      service.on('alert', (alert: EarthquakeAlert) => alerts.push(alert));
+    });
+
+    it('should emit one alert per event on the batch topic', () => {
+      service['handleMessage']('earthquake/alert/batch', Buffer.from(JSON.stringify(batch)));
+
+      expect(alerts).toHaveLength(2);
+      expect(alerts.map(a => a.event.magnitude)).toEqual([3.1, 4.8]);
+    });
+
+    it('should still emit single alerts on the alert topic', () => {
+      const [single] = expandAlertBatch(batch);
+      service['handleMessage']('earthquake/alert', Buffer.from(JSON.stringify(single)));
+
+      expect(alerts).toHaveLength(1);
+      expect(alerts[0].event.magnitude).toBe(3.1);
+    });
+
+    it('should emit preliminary alerts without treating them as confirmed alerts', () => {
+      const preliminary: PreliminaryAlert = {
+        device_id: 'ESP32_BATCH_TEST',
+        timestamp: 100600,
+        onset_time: 100000,
+        latency_ms: 500,
+        window: 0.5,
+        update: 1,
+        tau_c: 0.9,
+        pd: 0.12,
+        magnitude_estimate: 5.6,
+        pga: 0.01,
+        alert_level: 'NEGLIGIBLE',
+        damaging: false,
+        location: batch.location
+      };
+      const received: PreliminaryAlert[] = [];
+      service.on('preliminary', (alert: PreliminaryAlert) => received.push(alert));
+
+      service['handleMessage']('earthquake/alert/preliminary', Buffer.from(JSON.stringify(preliminary)));
+
+      expect(received).toEqual([preliminary]);
+      expect(alerts).toHaveLength(0);
+    });
+
+    it('should pass binary waveform and capture payloads through undecoded', () => {
+      const received: Array<[string, string, Buffer]> = [];
+      service.on('waveform', (deviceId: string, payload: Buffer) => received.push(['waveform', deviceId, payload]));
+      service.on('capture', (deviceId: string, payload: Buffer) => received.push(['capture', deviceId, payload]));
+      const payload = Buffer.from([0x01, 0x01, 0x00, 0x00]);
+
+      service['handleMessage']('earthquake/waveform/ESP32_BIN', payload);
+      service['handleMessage']('earthquake/capture/ESP32_BIN', payload);
+
+      expect(received).toEqual([['waveform', 'ESP32_BIN', payload], ['capture', 'ESP32_BIN', payload]]);
+      expect(alerts).toHaveLength(0);
+    });
+
+    it('should ignore malformed payloads', () => {
+      service['handleMessage']('earthquake/alert/batch', Buffer.from('not json'));
+
+      expect(alerts).toHaveLength(0);
+    });
+  });
+});